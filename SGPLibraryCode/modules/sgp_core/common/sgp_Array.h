@@ -34,10 +34,15 @@
     To make all the array's methods thread-safe, pass in "CriticalSection" as the templated
     TypeOfCriticalSectionToUse parameter, instead of the default DummyCriticalSection.
 
-    @see OwnedArray, ReferenceCountedArray, StringArray, CriticalSection
+    The storage is allocated on the heap by ArrayAllocationBase. Arrays which are rebuilt
+    every frame can take it from a LinearArena instead, by passing an ArenaArrayAllocationBase
+    as the AllocationBaseType parameter.
+
+    @see OwnedArray, ReferenceCountedArray, StringArray, CriticalSection, ArenaArrayAllocationBase
 */
 template <typename ElementType,
-          typename TypeOfCriticalSectionToUse = DummyCriticalSection>
+          typename TypeOfCriticalSectionToUse = DummyCriticalSection,
+          class AllocationBaseType = ArrayAllocationBase <ElementType, TypeOfCriticalSectionToUse> >
 class Array
 {
 private:
@@ -54,7 +59,7 @@ public:
     /** Creates a copy of another array.
         @param other    the array to copy
     */
-    Array (const Array<ElementType, TypeOfCriticalSectionToUse>& other)
+    Array (const Array& other)
     {
         const ScopedLockType lock (other.getLock());
         numUsed = other.numUsed;
@@ -105,7 +110,7 @@ public:
     {
         if (this != &other)
         {
-            Array<ElementType, TypeOfCriticalSectionToUse> otherCopy (other);
+            Array otherCopy (other);
             swapWithArray (otherCopy);
         }
 
@@ -990,7 +995,7 @@ public:
 
 private:
     //==============================================================================
-    ArrayAllocationBase <ElementType, TypeOfCriticalSectionToUse> data;
+    AllocationBaseType data;
     int numUsed;
 
     inline void deleteAllElements() noexcept
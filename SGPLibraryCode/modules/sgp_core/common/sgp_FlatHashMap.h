@@ -0,0 +1,450 @@
+
+
+#ifndef __SGP_FLATHASHMAP_HEADER__
+#define __SGP_FLATHASHMAP_HEADER__
+
+#include "sgp_HashMap.h"
+#include "sgp_HeapBlock.h"
+
+
+//==============================================================================
+/**
+    Gives FlatHashMap the hash of a key before it is mixed into a slot index.
+
+    Any HashFunctionToUse class is called with a large upperLimit. For
+    DefaultHashFunctions the bits of the key are used as they are, which saves
+    the abs() and the modulo of its generateHash() on every lookup.
+*/
+template <class HashFunctionToUse>
+struct FlatHashMapKeyHash
+{
+    template <typename KeyType>
+    static uint32 getHash (const KeyType& key) noexcept     { return (uint32) HashFunctionToUse::generateHash (key, 0x7fffffff); }
+};
+
+template <>
+struct FlatHashMapKeyHash <DefaultHashFunctions>
+{
+    static uint32 getHash (const int key) noexcept          { return (uint32) key; }
+    static uint32 getHash (const uint32 key) noexcept       { return key; }
+    static uint32 getHash (const uint64& key) noexcept      { return (uint32) (key ^ (key >> 32)); }
+    static uint32 getHash (const String& key) noexcept      { return (uint32) key.hashCode(); }
+    static uint32 getHash (const void* key) noexcept
+    {
+        const uint64 address = (uint64) (size_t) key;
+        return (uint32) (address ^ (address >> 32));
+    }
+};
+
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, like HashMap, but stores
+    them in one contiguous block instead of one heap allocated entry per item.
+
+    The map uses open addressing with Robin Hood linear probing: every slot remembers
+    how far its item is from the slot its hash points to, an item being inserted takes
+    the place of any item which is closer to its own slot, and removing an item shifts
+    the following items of the run back. This keeps the probe sequences short even
+    when the table is 7/8 full, and a lookup for a missing key can stop as soon as it
+    reaches an item which is closer to its slot than the key would be.
+
+    The number of slots is always a power of two. The HashFunctionToUse class is the
+    same as for HashMap. The hash of a key (see FlatHashMapKeyHash) is multiplied by
+    the golden ratio and the top bits of the product are the slot index, so the raw
+    bits of sequential IDs or aligned addresses are spread over the table.
+
+    The API is the same as HashMap, so it can be swapped in:
+    @code
+    FlatHashMap<uint32, CStaticMeshInstance*> instances;
+    instances.set (sceneObjectID, instance);
+
+    for (FlatHashMap<uint32, CStaticMeshInstance*>::Iterator i (instances); i.next();)
+        delete i.getValue();
+    @endcode
+
+    Unlike HashMap, set() and remove() move other items around, so an iterator must
+    not be used after the map has been changed.
+
+    @see HashMap, DefaultHashFunctions
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionToUse = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    typedef PARAMETER_TYPE (KeyType)   KeyTypeParameter;
+    typedef PARAMETER_TYPE (ValueType) ValueTypeParameter;
+
+public:
+    //==============================================================================
+    /** Creates an empty hash-map.
+
+        The numberOfSlots parameter is rounded up to a power of two. The table grows
+        automatically when it is 7/8 full, or it can be resized manually using remapTable().
+    */
+    explicit FlatHashMap (const int numberOfSlots = defaultHashTableSize)
+       : numSlots (0), hashShift (32), totalNumItems (0)
+    {
+        allocateSlots (numberOfSlots);
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Removes all values from the map.
+        Note that this will clear the content, but won't affect the number of slots (see
+        remapTable and getNumSlots).
+    */
+    void clear()
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = numSlots; --i >= 0;)
+        {
+            if (distances[i] != 0)
+            {
+                entries[i].~Entry();
+                distances[i] = 0;
+            }
+        }
+
+        totalNumItems = 0;
+    }
+
+    //==============================================================================
+    /** Returns the current number of items in the map. */
+    inline int size() const noexcept
+    {
+        return totalNumItems;
+    }
+
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+        @param keyToLookFor    the key of the item being requested
+    */
+    inline ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findIndex (keyToLookFor);
+
+        return index >= 0 ? entries[index].value : ValueType();
+    }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the specied key. */
+    bool contains (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        return findIndex (keyToLookFor) >= 0;
+    }
+
+    /** Returns true if the hash contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = numSlots; --i >= 0;)
+            if (distances[i] != 0 && entries[i].value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an element in the hash-map.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findIndex (newKey);
+
+        if (index >= 0)
+        {
+            entries[index].value = newValue;
+            return;
+        }
+
+        if ((totalNumItems + 1) * 8 > numSlots * 7)
+            remapTable (numSlots * 2);
+
+        insertNewEntry (Entry (newKey, newValue));
+    }
+
+    /** Removes an item with the given key. */
+    void remove (KeyTypeParameter keyToRemove)
+    {
+        const ScopedLockType sl (getLock());
+        const int index = findIndex (keyToRemove);
+
+        if (index >= 0)
+            removeEntry (index);
+    }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots;)
+        {
+            // removeEntry() shifts the next item into this slot, so it is checked again
+            if (distances[i] != 0 && entries[i].value == valueToRemove)
+                removeEntry (i);
+            else
+                ++i;
+        }
+    }
+
+    /** Resizes the table. The number of slots is rounded up to a power of two, and to
+        at least what the current items need.
+        @see getNumSlots()
+    */
+    void remapTable (int newNumberOfSlots)
+    {
+        const ScopedLockType sl (getLock());
+        FlatHashMap newTable (jmax (newNumberOfSlots, (totalNumItems * 8) / 7 + 1));
+
+        for (int i = numSlots; --i >= 0;)
+            if (distances[i] != 0)
+                newTable.insertNewEntry (entries[i]);
+
+        swapWith (newTable);
+    }
+
+    /** Returns the number of slots of the table, which is always a power of two.
+        @see remapTable()
+    */
+    inline int getNumSlots() const noexcept
+    {
+        return numSlots;
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two hash-maps. */
+    void swapWith (FlatHashMap& otherHashMap) noexcept
+    {
+        const ScopedLockType lock1 (getLock());
+        const ScopedLockType lock2 (otherHashMap.getLock());
+
+        entries.swapWith (otherHashMap.entries);
+        distances.swapWith (otherHashMap.distances);
+        std::swap (numSlots, otherHashMap.numSlots);
+        std::swap (hashShift, otherHashMap.hashShift);
+        std::swap (totalNumItems, otherHashMap.totalNumItems);
+    }
+
+    //==============================================================================
+    /** Returns the CriticalSection that locks this structure.
+        To lock, you can call getLock().enter() and getLock().exit(), or preferably use
+        an object of ScopedLockType as an RAII lock for it.
+    */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** Returns the type of scoped lock to use for locking this array */
+    typedef typename TypeOfCriticalSectionToUse::ScopedLockType ScopedLockType;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        Entry (KeyTypeParameter k, ValueTypeParameter val)
+            : key (k), value (val)
+        {}
+
+        KeyType key;
+        ValueType value;
+    };
+
+public:
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        To use it, repeatedly call next() until it returns false, e.g.
+        @code
+        FlatHashMap <String, String> myMap;
+
+        FlatHashMap<String, String>::Iterator i (myMap);
+
+        while (i.next())
+        {
+            DBG (i.getKey() << " -> " << i.getValue());
+        }
+        @endcode
+
+        The items are visited in the order of their slots, which bears no resemblence to the
+        order in which they were added.
+
+        As soon as you call any non-const methods on the original hash-map, any iterators
+        that were created beforehand will cease to be valid, and should not be used.
+
+        @see FlatHashMap
+    */
+    class Iterator
+    {
+    public:
+        //==============================================================================
+        Iterator (const FlatHashMap& hashMapToIterate)
+            : hashMap (hashMapToIterate), index (-1)
+        {}
+
+        /** Moves to the next item, if one is available.
+            When this returns true, you can get the item's key and value using getKey() and
+            getValue(). If it returns false, the iteration has finished and you should stop.
+        */
+        bool next()
+        {
+            while (++index < hashMap.numSlots)
+                if (hashMap.distances[index] != 0)
+                    return true;
+
+            return false;
+        }
+
+        /** Returns the current item's key.
+            This should only be called when a call to next() has just returned true.
+        */
+        KeyType getKey() const
+        {
+            return isPositiveAndBelow (index, hashMap.numSlots) ? hashMap.entries[index].key : KeyType();
+        }
+
+        /** Returns the current item's value.
+            This should only be called when a call to next() has just returned true.
+        */
+        ValueType getValue() const
+        {
+            return isPositiveAndBelow (index, hashMap.numSlots) ? hashMap.entries[index].value : ValueType();
+        }
+
+    private:
+        //==============================================================================
+        const FlatHashMap& hashMap;
+        int index;
+
+        SGP_DECLARE_NON_COPYABLE (Iterator)
+    };
+
+private:
+    //==============================================================================
+    enum
+    {
+        defaultHashTableSize = 128,
+        minimumHashTableSize = 8,
+        maxProbeDistance = 255
+    };
+
+    friend class Iterator;
+
+    HeapBlock<Entry> entries;           // only the slots with a non-zero distance are constructed
+    HeapBlock<uint8> distances;         // 0 for an empty slot, otherwise the probe distance + 1
+    int numSlots, hashShift;
+    int totalNumItems;
+    TypeOfCriticalSectionToUse lock;
+
+    void allocateSlots (int numberOfSlots)
+    {
+        numSlots = minimumHashTableSize;
+        hashShift = 32 - 3;
+
+        while (numSlots < numberOfSlots)
+        {
+            numSlots *= 2;
+            --hashShift;
+        }
+
+        entries.malloc ((size_t) numSlots);
+        distances.calloc ((size_t) numSlots);
+    }
+
+    int getHomeSlot (KeyTypeParameter key) const noexcept
+    {
+        // Fibonacci hashing, the top bits of the product are well mixed even for
+        // sequential IDs or aligned addresses
+        const uint32 hash = FlatHashMapKeyHash<HashFunctionToUse>::getHash (key);
+        return (int) ((hash * 2654435769u) >> hashShift);
+    }
+
+    int findIndex (KeyTypeParameter key) const
+    {
+        int index = getHomeSlot (key);
+
+        for (int distance = 1; distance <= (int) distances[index]; ++distance)
+        {
+            if (distances[index] == distance && entries[index].key == key)
+                return index;
+
+            index = (index + 1) & (numSlots - 1);
+        }
+
+        return -1;
+    }
+
+    void insertNewEntry (const Entry& newEntry)
+    {
+        Entry carried (newEntry);
+        int index = getHomeSlot (carried.key);
+        int distance = 1;
+
+        for (;;)
+        {
+            if (distances[index] == 0)
+            {
+                new (entries + index) Entry (carried);
+                distances[index] = (uint8) distance;
+                ++totalNumItems;
+                return;
+            }
+
+            // Takes the place of an item which is closer to its home slot
+            if (distances[index] < distance)
+            {
+                std::swap (entries[index], carried);
+
+                const int displacedDistance = distances[index];
+                distances[index] = (uint8) distance;
+                distance = displacedDistance;
+            }
+
+            index = (index + 1) & (numSlots - 1);
+
+            if (++distance > maxProbeDistance)
+            {
+                remapTable (numSlots * 2);
+                insertNewEntry (carried);
+                return;
+            }
+        }
+    }
+
+    void removeEntry (int index)
+    {
+        entries[index].~Entry();
+        distances[index] = 0;
+        --totalNumItems;
+
+        // Moves the rest of the run back by one slot
+        for (int next = (index + 1) & (numSlots - 1); distances[next] > 1; next = (next + 1) & (numSlots - 1))
+        {
+            new (entries + index) Entry (entries[next]);
+            distances[index] = (uint8) (distances[next] - 1);
+
+            entries[next].~Entry();
+            distances[next] = 0;
+            index = next;
+        }
+    }
+
+    SGP_DECLARE_NON_COPYABLE (FlatHashMap)
+};
+
+
+#endif   // __SGP_FLATHASHMAP_HEADER__
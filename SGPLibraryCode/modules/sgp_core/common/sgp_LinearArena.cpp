@@ -0,0 +1,205 @@
+
+
+LinearArena::LinearArena (size_t initialBlockSize_) noexcept
+    : firstBlock (nullptr), currentBlock (nullptr), position (0),
+      initialBlockSize (jmax ((size_t) 256, initialBlockSize_)),
+      lastAllocation (nullptr), resetCount (0), numHeapAllocations (0)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    freeBlocks();
+}
+
+//==============================================================================
+void* LinearArena::allocate (size_t numBytes, size_t alignment)
+{
+    jassert (alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    if (currentBlock != nullptr)
+    {
+        char* const start = currentBlock->getData();
+        char* const p = alignPointer (start + position, alignment);
+
+        if ((size_t) (p - start) + numBytes <= currentBlock->size)
+        {
+            position = (size_t) (p - start) + numBytes;
+            lastAllocation = p;
+            return p;
+        }
+    }
+
+    return allocateInNextBlock (numBytes, alignment);
+}
+
+void* LinearArena::reallocate (void* block, size_t oldNumBytes, size_t newNumBytes, size_t alignment)
+{
+    if (block == nullptr)
+        return allocate (newNumBytes, alignment);
+
+    // The last allocation can simply be made longer or shorter
+    if (block == lastAllocation)
+    {
+        const size_t offset = (size_t) (static_cast <char*> (block) - currentBlock->getData());
+
+        if (offset + newNumBytes <= currentBlock->size)
+        {
+            position = offset + newNumBytes;
+            return block;
+        }
+    }
+
+    void* const newBlock = allocate (newNumBytes, alignment);
+    memcpy (newBlock, block, jmin (oldNumBytes, newNumBytes));
+    return newBlock;
+}
+
+void LinearArena::reset()
+{
+    if (firstBlock != nullptr && firstBlock->next != nullptr)
+    {
+        const size_t totalSize = getCapacity();
+        freeBlocks();
+        firstBlock = createBlock (totalSize);
+    }
+
+    currentBlock = firstBlock;
+    position = 0;
+    lastAllocation = nullptr;
+    ++resetCount;
+}
+
+//==============================================================================
+size_t LinearArena::getNumBytesUsed() const noexcept
+{
+    size_t numBytes = position;
+
+    for (Block* b = firstBlock; b != nullptr && b != currentBlock; b = b->next)
+        numBytes += b->size;
+
+    return numBytes;
+}
+
+size_t LinearArena::getCapacity() const noexcept
+{
+    size_t numBytes = 0;
+
+    for (Block* b = firstBlock; b != nullptr; b = b->next)
+        numBytes += b->size;
+
+    return numBytes;
+}
+
+//==============================================================================
+LinearArena::Block* LinearArena::createBlock (size_t size)
+{
+    Block* const block = static_cast <Block*> (std::malloc (sizeof (Block) + size));
+
+    if (block == nullptr)
+        throw std::bad_alloc();
+
+    block->next = nullptr;
+    block->size = size;
+    ++numHeapAllocations;
+    return block;
+}
+
+void LinearArena::freeBlocks() noexcept
+{
+    for (Block* b = firstBlock; b != nullptr;)
+    {
+        Block* const next = b->next;
+        std::free (b);
+        b = next;
+    }
+
+    firstBlock = currentBlock = nullptr;
+}
+
+void* LinearArena::allocateInNextBlock (size_t numBytes, size_t alignment)
+{
+    const size_t numBytesNeeded = numBytes + alignment;
+
+    // A block left behind by a rewind is used again if the allocation fits into it
+    if (currentBlock != nullptr && currentBlock->next != nullptr && currentBlock->next->size >= numBytesNeeded)
+    {
+        currentBlock = currentBlock->next;
+    }
+    else
+    {
+        const size_t previousSize = (currentBlock != nullptr) ? currentBlock->size : initialBlockSize / 2;
+        Block* const block = createBlock (jmax (numBytesNeeded, previousSize * 2));
+
+        if (currentBlock == nullptr)
+        {
+            block->next = firstBlock;
+            firstBlock = block;
+        }
+        else
+        {
+            block->next = currentBlock->next;
+            currentBlock->next = block;
+        }
+
+        currentBlock = block;
+    }
+
+    char* const p = alignPointer (currentBlock->getData(), alignment);
+    position = (size_t) (p - currentBlock->getData()) + numBytes;
+    lastAllocation = p;
+    return p;
+}
+
+//==============================================================================
+LinearArena::ScopedRewind::ScopedRewind (LinearArena& arenaToRewind) noexcept
+    : arena (arenaToRewind),
+      block (arenaToRewind.currentBlock),
+      position (arenaToRewind.position),
+      resetCount (arenaToRewind.resetCount)
+{
+}
+
+LinearArena::ScopedRewind::~ScopedRewind()
+{
+    // After a reset the blocks may have been merged, and everything is free anyway
+    if (arena.resetCount != resetCount)
+        return;
+
+    arena.currentBlock = (block != nullptr) ? static_cast <Block*> (block) : arena.firstBlock;
+    arena.position = position;
+    arena.lastAllocation = nullptr;
+}
+
+//==============================================================================
+LinearArena& LinearArena::getFrameArena()
+{
+    static LinearArena frameArena (256 * 1024);
+    return frameArena;
+}
+
+static ThreadLocalValue<LinearArena*>& getScratchArenaHolder()
+{
+    // Never deleted: threads which are stopped during static destruction (e.g. the
+    // workers of JobScheduler::getSharedScheduler()) still release their arenas
+    static ThreadLocalValue<LinearArena*>* const scratchArenas = new ThreadLocalValue<LinearArena*>();
+    return *scratchArenas;
+}
+
+LinearArena& LinearArena::getScratchArena()
+{
+    LinearArena*& arena = getScratchArenaHolder().get();
+
+    if (arena == nullptr)
+        arena = new LinearArena (64 * 1024);
+
+    return *arena;
+}
+
+void LinearArena::releaseScratchArena()
+{
+    LinearArena*& arena = getScratchArenaHolder().get();
+
+    deleteAndZero (arena);
+    getScratchArenaHolder().releaseCurrentThreadStorage();
+}
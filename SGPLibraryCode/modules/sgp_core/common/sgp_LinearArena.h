@@ -0,0 +1,302 @@
+
+
+#ifndef __SGP_LINEARARENA_HEADER__
+#define __SGP_LINEARARENA_HEADER__
+
+
+//==============================================================================
+/**
+    A linear ("bump pointer") allocator for short-lived memory.
+
+    allocate() hands out the next bytes of a block, and nothing is freed individually:
+    reset() makes the whole arena available again. When the current block is full,
+    another block is taken from the heap, and the next reset() replaces all blocks by
+    one block as big as all of them together. So after the first few cycles an arena
+    which is used the same way every cycle doesn't call the heap any more.
+
+    There is one arena for the per-frame data of the render thread, which is reset by
+    the render device at the end of every frame (see getFrameArena()), and one scratch
+    arena per thread for temporary data inside a function (see getScratchArena()).
+
+    An arena isn't thread-safe, it must only be used by one thread.
+
+    @see ArenaArrayAllocationBase
+*/
+class SGP_API  LinearArena
+{
+public:
+    //==============================================================================
+    /** Creates an arena. The first block is allocated when it is first used. */
+    explicit LinearArena (size_t initialBlockSize = 64 * 1024) noexcept;
+
+    /** Destructor. Frees all blocks. */
+    ~LinearArena();
+
+    //==============================================================================
+    /** Returns numBytes of memory, aligned to alignment (which must be a power of two).
+        The memory is not initialised, and stays valid until the arena is reset or
+        rewound past it.
+    */
+    void* allocate (size_t numBytes, size_t alignment = 16);
+
+    /** Changes the size of a block returned by allocate().
+
+        The last block allocated is grown in place if there is room for it, otherwise new
+        memory is allocated and the contents are copied. The old memory isn't reused before
+        the next reset.
+    */
+    void* reallocate (void* block, size_t oldNumBytes, size_t newNumBytes, size_t alignment = 16);
+
+    /** Makes all the memory of the arena available again, and merges the blocks that
+        were needed in this cycle into one.
+    */
+    void reset();
+
+    //==============================================================================
+    /** Returns the number of times reset() has been called.
+        Memory allocated before the count changed must not be used any more.
+    */
+    uint32 getResetCount() const noexcept               { return resetCount; }
+
+    /** Returns the number of bytes in use since the last reset. */
+    size_t getNumBytesUsed() const noexcept;
+
+    /** Returns the total size of the blocks. */
+    size_t getCapacity() const noexcept;
+
+    /** Returns the number of blocks taken from the heap since the arena was created.
+        This stops increasing once the arena has settled on a size.
+    */
+    int getNumHeapAllocations() const noexcept          { return numHeapAllocations; }
+
+    //==============================================================================
+    /** Rewinds an arena to where it was when this object was created.
+
+        This is how the scratch arenas are used: everything allocated from the arena
+        inside the scope is released when the scope ends.
+
+        @code
+        LinearArena::ScopedRewind rewind (LinearArena::getScratchArena());
+        float* distances = (float*) rewind.getArena().allocate (numObjects * sizeof (float));
+        @endcode
+    */
+    class SGP_API  ScopedRewind
+    {
+    public:
+        explicit ScopedRewind (LinearArena& arenaToRewind) noexcept;
+        ~ScopedRewind();
+
+        LinearArena& getArena() const noexcept          { return arena; }
+
+    private:
+        LinearArena& arena;
+        void* const block;
+        const size_t position;
+        const uint32 resetCount;
+
+        SGP_DECLARE_NON_COPYABLE (ScopedRewind)
+    };
+
+    //==============================================================================
+    /** Returns the arena for per-frame data.
+
+        It is reset by the render device's endScene(), so it must only be used by the
+        thread which renders, and memory taken from it is only valid until the end of
+        the frame.
+    */
+    static LinearArena& getFrameArena();
+
+    /** Returns the scratch arena of the calling thread.
+        Use it with a ScopedRewind, it is never reset otherwise.
+    */
+    static LinearArena& getScratchArena();
+
+    /** Deletes the scratch arena of the calling thread.
+        Thread calls this when its thread function returns.
+    */
+    static void releaseScratchArena();
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        Block* next;
+        size_t size;
+
+        char* getData() noexcept                        { return reinterpret_cast <char*> (this + 1); }
+    };
+
+    Block* firstBlock;
+    Block* currentBlock;
+    size_t position;                // offset of the free space in currentBlock
+    size_t initialBlockSize;
+    void* lastAllocation;
+    uint32 resetCount;
+    int numHeapAllocations;
+
+    Block* createBlock (size_t size);
+    void freeBlocks() noexcept;
+    void* allocateInNextBlock (size_t numBytes, size_t alignment);
+
+    static char* alignPointer (char* p, size_t alignment) noexcept
+    {
+        return reinterpret_cast <char*> ((reinterpret_cast <pointer_sized_int> (p) + (pointer_sized_int) alignment - 1)
+                                           & ~((pointer_sized_int) alignment - 1));
+    }
+
+    SGP_DECLARE_NON_COPYABLE (LinearArena)
+};
+
+//==============================================================================
+/** Used as the ArenaSourceType of an ArenaArrayAllocationBase to take the memory from
+    LinearArena::getFrameArena().
+*/
+struct FrameArenaSource
+{
+    static LinearArena& getArena()      { return LinearArena::getFrameArena(); }
+};
+
+/** Used as the ArenaSourceType of an ArenaArrayAllocationBase to take the memory from
+    LinearArena::getScratchArena().
+*/
+struct ScratchArenaSource
+{
+    static LinearArena& getArena()      { return LinearArena::getScratchArena(); }
+};
+
+//==============================================================================
+/**
+    An array storage class like ArrayAllocationBase, which takes its memory from a
+    LinearArena instead of the heap.
+
+    Use it as the third template parameter of Array, for arrays that are rebuilt every
+    frame:
+    @code
+    Array<CSGPTerrainChunk*, DummyCriticalSection,
+          ArenaArrayAllocationBase<CSGPTerrainChunk*, DummyCriticalSection> > visibleChunks;
+    @endcode
+
+    The storage becomes invalid when the arena is reset, so the array must be cleared
+    (e.g. with clearQuick()) before it is used after a reset. The new storage is then
+    allocated with the capacity the array had before, so an array which is filled the
+    same way each frame allocates once per frame, from the arena.
+
+    Nothing is freed or destroyed when the arena is reset, so the elements should be
+    pointers or other types without a destructor.
+
+    @see Array, ArrayAllocationBase, LinearArena
+*/
+template <class ElementType, class TypeOfCriticalSectionToUse, class ArenaSourceType = FrameArenaSource>
+class ArenaArrayAllocationBase  : public TypeOfCriticalSectionToUse
+{
+public:
+    //==============================================================================
+    /** Creates an empty array. */
+    ArenaArrayAllocationBase() noexcept
+        : numAllocated (0), capacityHint (0), resetCount (0)
+    {
+    }
+
+    //==============================================================================
+    /** Changes the amount of storage allocated.
+
+        This will retain any data currently held in the array, unless the arena has been
+        reset since it was allocated.
+
+        @param numElements  the number of elements that are needed
+    */
+    void setAllocatedSize (const int numElements)
+    {
+        LinearArena& arena = ArenaSourceType::getArena();
+        forgetStaleStorage (arena);
+
+        if (numAllocated != numElements)
+        {
+            if (numElements > 0)
+                elements.data = static_cast <ElementType*> (arena.reallocate (elements.data,
+                                                                              (size_t) numAllocated * sizeof (ElementType),
+                                                                              (size_t) numElements * sizeof (ElementType)));
+            else
+                elements.data = nullptr;
+
+            numAllocated = numElements;
+        }
+    }
+
+    /** Increases the amount of storage allocated if it is less than a given amount.
+        @param minNumElements  the minimum number of elements that are needed
+    */
+    void ensureAllocatedSize (const int minNumElements)
+    {
+        forgetStaleStorage (ArenaSourceType::getArena());
+
+        if (minNumElements > numAllocated)
+            setAllocatedSize (jmax (capacityHint, (minNumElements + minNumElements / 2 + 8) & ~7));
+    }
+
+    /** Minimises the amount of storage allocated so that it's no more than
+        the given number of elements. The arena memory is only released by a reset.
+    */
+    void shrinkToNoMoreThan (const int maxNumElements)
+    {
+        forgetStaleStorage (ArenaSourceType::getArena());
+
+        if (maxNumElements < numAllocated)
+        {
+            setAllocatedSize (maxNumElements);
+            capacityHint = jmin (capacityHint, maxNumElements);
+        }
+    }
+
+    /** Swap the contents of two objects. */
+    void swapWith (ArenaArrayAllocationBase& other) noexcept
+    {
+        std::swap (elements.data, other.elements.data);
+        std::swap (numAllocated, other.numAllocated);
+        std::swap (capacityHint, other.capacityHint);
+        std::swap (resetCount, other.resetCount);
+    }
+
+    //==============================================================================
+    /** A pointer to the storage, which works like the HeapBlock of ArrayAllocationBase. */
+    struct Elements
+    {
+        Elements() noexcept : data (nullptr) {}
+
+        inline operator ElementType*() const noexcept                           { return data; }
+        inline ElementType* getData() const noexcept                            { return data; }
+
+        template <typename IndexType>
+        inline ElementType& operator[] (IndexType index) const noexcept         { return data [index]; }
+
+        template <typename IndexType>
+        inline ElementType* operator+ (IndexType index) const noexcept          { return data + index; }
+
+        ElementType* data;
+    };
+
+    Elements elements;
+    int numAllocated;
+
+private:
+    int capacityHint;       // the capacity before the last reset
+    uint32 resetCount;
+
+    void forgetStaleStorage (LinearArena& arena) noexcept
+    {
+        if (resetCount != arena.getResetCount())
+        {
+            if (numAllocated > 0)
+                capacityHint = numAllocated;
+
+            elements.data = nullptr;
+            numAllocated = 0;
+            resetCount = arena.getResetCount();
+        }
+    }
+
+    SGP_DECLARE_NON_COPYABLE (ArenaArrayAllocationBase)
+};
+
+
+#endif   // __SGP_LINEARARENA_HEADER__
@@ -4,7 +4,9 @@
 
 /* 
  * Simple Ring Buffer FIFO, no locking version 
- * Note that with only one concurrent reader and one concurrent writer, you don't need extra locking to use these functions. 
+ * Note that m_in and m_out are plain integers without any memory barrier, so this is
+ * only safe when used from one thread. Use SPSCQueue or MPMCQueue (sgp_LockFreeQueue.h)
+ * to hand data over between threads.
  */ 
 template <class DataType>
 class RingFIFO
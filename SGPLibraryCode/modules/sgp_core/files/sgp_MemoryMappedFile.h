@@ -0,0 +1,70 @@
+#ifndef __SGP_MEMORYMAPPEDFILE_HEADER__
+#define __SGP_MEMORYMAPPEDFILE_HEADER__
+
+#include "sgp_File.h"
+
+//==============================================================================
+/**
+    Maps a file into virtual memory for easy reading and/or writing.
+
+    Pages of the file are only read from disk when they are first touched,
+    so large files can be used without copying all of them into a heap buffer.
+*/
+class SGP_API  MemoryMappedFile
+{
+public:
+    /** The read/write flags used when opening a memory mapped file. */
+    enum AccessMode
+    {
+        readOnly,   /**< Indicates that the memory can only be read. */
+        readWrite,  /**< Indicates that the memory can be read and written to - changes that are
+                         made will be flushed back to disk at the whim of the OS. */
+        copyOnWrite /**< Indicates that the memory can be read and written to, but changes are
+                         private to this process and never written back to the file. Only the
+                         pages that are written to will be copied. On Windows the whole file
+                         is read into private memory, so that it can still be replaced. */
+    };
+
+    /** Opens a file and maps it to an area of virtual memory.
+
+        The file should already exist, and should already be the size that you want to work with
+        when you call this. If the file is resized after being opened, the behaviour is undefined.
+
+        If the file exists and the operation succeeds, the getData() and getSize() methods will
+        return the location and size of the data that can be read or written. Note that the entire
+        file is not read into memory immediately - the OS simply creates a virtual mapping, which
+        will lazily pull the data into memory when blocks are accessed.
+
+        If the file can't be opened for some reason, the getData() method will return a null pointer.
+    */
+    MemoryMappedFile (const File& file, AccessMode mode);
+
+    /** Destructor. */
+    ~MemoryMappedFile();
+
+    /** Returns the address at which this file has been mapped, or a null pointer if
+        the file couldn't be successfully mapped.
+    */
+    void* getData() const noexcept              { return address; }
+
+    /** Returns the number of bytes of data that are available for reading or writing.
+        This will normally be the size of the file.
+    */
+    size_t getSize() const noexcept             { return length; }
+
+private:
+    //==============================================================================
+    void* address;
+    size_t length;
+
+   #if SGP_WINDOWS
+    void* fileHandle;
+   #else
+    int fileHandle;
+   #endif
+
+    SGP_DECLARE_NON_COPYABLE (MemoryMappedFile)
+};
+
+
+#endif   // __SGP_MEMORYMAPPEDFILE_HEADER__
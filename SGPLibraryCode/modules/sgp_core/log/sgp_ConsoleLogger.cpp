@@ -18,5 +18,10 @@ void ConsoleLogger::logMessage (const String& message, ESGPLOG_LEVEL ll)
 		return;
 
     DBG (message);
+#if SGP_WINDOWS
 	wprintf( L"%s\n", message.toWideCharPointer() );
+#else
+	// glibc would turn stdout wide oriented and drop later printf() output, %s also means char* there
+	printf( "%s\n", message.toUTF8().getAddress() );
+#endif
 }
\ No newline at end of file
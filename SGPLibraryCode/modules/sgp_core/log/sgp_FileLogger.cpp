@@ -1,8 +1,39 @@
+//==============================================================================
+class FileLogger::WriterThread  : public Thread
+{
+public:
+    WriterThread (FileLogger& owner_)
+        : Thread ("File Logger Writer"), owner (owner_)
+    {
+    }
+
+    void run()
+    {
+        // The file stays open while the logger exists
+        FileOutputStream out (owner.logFile);
+
+        while (! threadShouldExit())
+        {
+            recordsAvailable.wait (100);
+            owner.writePendingRecords (out);
+        }
+
+        owner.writePendingRecords (out);
+    }
 
+    WaitableEvent recordsAvailable;
+
+private:
+    FileLogger& owner;
+
+    SGP_DECLARE_NON_COPYABLE (WriterThread)
+};
+
+//==============================================================================
 FileLogger::FileLogger (const File& file,
                         const String& welcomeMessage,
                         const bool bAlwaysDelete)
-    : logFile (file)
+    : logFile (file), records (numLogRecords)
 {
     if( bAlwaysDelete )
 	{
@@ -12,6 +43,12 @@ FileLogger::FileLogger (const File& file,
     if (! file.exists())
         file.create();  // (to create the parent directories)
 
+    for (int i = 0; i < numLogRecords; ++i)
+        records[i].sequence = (uint32) i;
+
+    writerThread = new WriterThread (*this);
+    writerThread->startThread();
+
     String welcome;
     welcome << newLine
             << "**********************************************************" << newLine
@@ -21,17 +58,120 @@ FileLogger::FileLogger (const File& file,
     logMessage( welcome, ELL_NONE );
 }
 
-FileLogger::~FileLogger() {}
+FileLogger::~FileLogger()
+{
+    // The writer thread writes the remaining records before it exits
+    writerThread->signalThreadShouldExit();
+    writerThread->recordsAvailable.signal();
+    writerThread->stopThread (-1);
+    writerThread = nullptr;
+}
 
 //==============================================================================
 void FileLogger::logMessage (const String& message, ESGPLOG_LEVEL ll)
 {
 	if( ll < m_LogLevel )
 		return;
-    const ScopedLock sl (logLock);
-    DBG (message);
-    FileOutputStream out (logFile, 256);
-    out << message << newLine;
+
+    if (pushRecord (message, ll))
+        return;
+
+    // The ring is full. Errors give the writer thread some time to catch up
+    if (ll >= ELL_ERROR)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            writerThread->recordsAvailable.signal();
+            Thread::sleep (1);
+
+            if (pushRecord (message, ll))
+                return;
+        }
+    }
+
+    ++numDroppedMessages;
+}
+
+void FileLogger::flush()
+{
+    const uint32 position = enqueuePosition.get();
+
+    while ((int32) (flushedPosition.get() - position) < 0)
+    {
+        writerThread->recordsAvailable.signal();
+        Thread::sleep (1);
+    }
+}
+
+bool FileLogger::pushRecord (const String& message, ESGPLOG_LEVEL ll)
+{
+    LogRecord* record;
+    uint32 position = enqueuePosition.get();
+
+    // Claims a record, the sequence of a free record is equal to the enqueue position
+    for (;;)
+    {
+        record = records + (position & (numLogRecords - 1));
+        const int32 diff = (int32) (record->sequence.get() - position);
+
+        if (diff == 0)
+        {
+            if (enqueuePosition.compareAndSetBool (position + 1, position))
+                break;
+        }
+        else if (diff < 0)
+        {
+            return false;   // the writer thread has not read this record yet
+        }
+
+        position = enqueuePosition.get();
+    }
+
+    record->level = ll;
+    record->numBytes = message.copyToUTF8 (record->text, maxLogRecordBytes) - 1;
+    record->sequence = position + 1;
+
+    // Errors are written at once, other messages wait for the next batch
+    // unless the ring is filling up
+    if (ll >= ELL_ERROR || position - dequeuePosition.get() >= numLogRecords / 2)
+        writerThread->recordsAvailable.signal();
+
+    return true;
+}
+
+void FileLogger::writePendingRecords (FileOutputStream& out)
+{
+    uint32 position = dequeuePosition.get();
+    bool hasWritten = false;
+
+    for (;;)
+    {
+        LogRecord& record = records [position & (numLogRecords - 1)];
+
+        if (record.sequence.get() != position + 1)
+            break;
+
+        DBG (String::fromUTF8 (record.text, record.numBytes));
+        out.write (record.text, record.numBytes);
+        out << newLine;
+
+        // Gives the record back to logMessage()
+        record.sequence = position + numLogRecords;
+        dequeuePosition = ++position;
+        hasWritten = true;
+    }
+
+    const int numDropped = numDroppedMessages.exchange (0);
+    if (numDropped > 0)
+    {
+        out << "(" << numDropped << " log messages dropped)" << newLine;
+        hasWritten = true;
+    }
+
+    if (hasWritten)
+        out.flush();
+
+    flushedPosition = position;
 }
 
 
@@ -6,11 +6,19 @@
 #include "sgp_Logger.h"
 #include "../files/sgp_File.h"
 #include "../common/sgp_ScopedPointer.h"
+#include "../common/sgp_HeapBlock.h"
+#include "../common/sgp_Atomic.h"
 
 
 //==============================================================================
 /**
     A simple implemenation of a Logger that writes to a file.
+
+    logMessage() only copies the message into a preallocated ring of records, a
+    writer thread keeps the file open and writes the records in batches. When the
+    ring is full, debug, information and warning messages are dropped, and the
+    number of dropped messages is written to the log. Error messages wait a little
+    for the writer thread before they are dropped.
 */
 class SGP_API  FileLogger  : public Logger
 {
@@ -93,10 +101,38 @@ public:
     void logMessage (const String& message, ESGPLOG_LEVEL ll=ELL_INFORMATION);
 	void setLogLevel(ESGPLOG_LEVEL _level) { m_LogLevel = _level; }
 
+    /** Blocks until all messages logged so far have been written to the file. */
+    void flush();
+
 private:
     //==============================================================================
+    enum
+    {
+        numLogRecords = 1024,           // must be a power of two
+        maxLogRecordBytes = 500         // longer messages are truncated
+    };
+
+    struct LogRecord
+    {
+        Atomic<uint32> sequence;
+        ESGPLOG_LEVEL level;
+        int numBytes;
+        char text[maxLogRecordBytes];
+    };
+
+    class WriterThread;
+    friend class WriterThread;
+
     File logFile;
-    CriticalSection logLock;
+    HeapBlock<LogRecord> records;
+    Atomic<uint32> enqueuePosition;
+    Atomic<uint32> dequeuePosition;     // only changed by the writer thread
+    Atomic<uint32> flushedPosition;     // records before this one are in the file
+    Atomic<int> numDroppedMessages;
+    ScopedPointer<WriterThread> writerThread;
+
+    bool pushRecord (const String& message, ESGPLOG_LEVEL ll);
+    void writePendingRecords (FileOutputStream& out);
 
 
     SGP_DECLARE_NON_COPYABLE (FileLogger)
@@ -79,6 +79,11 @@ public:
 
 	virtual void setLogLevel( ESGPLOG_LEVEL _level ) = 0;
 
+    /** Returns true if messages of this level are written by this logger.
+        The SGP_LOG macros use this to skip building messages which would be filtered.
+    */
+    bool isLevelEnabled (ESGPLOG_LEVEL ll) const noexcept   { return ll >= m_LogLevel; }
+
 protected:
 	ESGPLOG_LEVEL	m_LogLevel;
     //==============================================================================
@@ -92,5 +97,29 @@ private:
     static Logger* currentLogger;
 };
 
+//==============================================================================
+/** Writes a message to the current logger, if one has been set and the level is not filtered.
+
+    The message is only built when it will be logged, so it can be used in loops:
+    @code
+    SGP_LOG (ELL_WARNING, "Missing texture " << textureName << " in chunk " << chunkIndex);
+    @endcode
+*/
+#define SGP_LOG(level, logtext) \
+    { \
+        sgp::Logger* const sgpCurrentLogger = sgp::Logger::getCurrentLogger(); \
+        if (sgpCurrentLogger != nullptr && sgpCurrentLogger->isLevelEnabled (level)) \
+        { \
+            sgp::String sgpLogBuf; \
+            sgpLogBuf << logtext; \
+            sgpCurrentLogger->writeToLog (sgpLogBuf, level); \
+        } \
+    }
+
+#define SGP_LOG_DEBUG(logtext)      SGP_LOG (sgp::ELL_DEBUG, logtext)
+#define SGP_LOG_INFO(logtext)       SGP_LOG (sgp::ELL_INFORMATION, logtext)
+#define SGP_LOG_WARNING(logtext)    SGP_LOG (sgp::ELL_WARNING, logtext)
+#define SGP_LOG_ERROR(logtext)      SGP_LOG (sgp::ELL_ERROR, logtext)
+
 
 #endif   // __SGP_LOGGER_HEADER__
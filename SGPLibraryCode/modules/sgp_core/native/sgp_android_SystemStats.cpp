@@ -243,11 +243,27 @@ String SystemStats::getUserRegion()      { return AndroidStatsHelpers::getLocale
 //==============================================================================
 SystemStats::CPUFlags::CPUFlags()
 {
-    // TODO
-    hasMMX = false;
-    hasSSE = false;
-    hasSSE2 = false;
-    has3DNow = false;
+    const StringArray flags (LinuxCPUInfoHelpers::getCpuFeatures());
+    hasMMX     = flags.contains ("mmx");
+    hasSSE     = flags.contains ("sse");
+    hasSSE2    = flags.contains ("sse2");
+    has3DNow   = flags.contains ("3dnow");
+    hasSSE41   = flags.contains ("sse4_1");
+    hasAVX     = flags.contains ("avx");
+    hasAVX2    = flags.contains ("avx2");
+    hasFMA     = flags.contains ("fma");
+    hasAVX512F = flags.contains ("avx512f");
+
+   #if defined (__aarch64__)
+    hasNEON    = true;  // always there on 64 bit ARM
+   #else
+    hasNEON    = flags.contains ("neon") || flags.contains ("asimd");
+   #endif
+
+    cacheLineSize = 64;
+    l2CacheSize = 0;
+    l3CacheSize = 0;
+    LinuxCPUInfoHelpers::getCacheSizes (cacheLineSize, l2CacheSize, l3CacheSize);
 
     numCpus = jmax (1, sysconf (_SC_NPROCESSORS_ONLN));
 }
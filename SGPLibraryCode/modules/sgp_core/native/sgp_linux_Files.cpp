@@ -309,9 +309,10 @@ bool Process::openDocument (const String& fileName, const String& parameters)
     String cmdString (fileName.replace (" ", "\\ ",false));
     cmdString << " " << parameters;
 
-    if (URL::isProbablyAWebsiteURL (fileName)
+    // (there is no URL class in sgp_core, anything with a scheme goes to the browser)
+    if (fileName.contains ("://")
          || cmdString.startsWithIgnoreCase ("file:")
-         || URL::isProbablyAnEmailAddress (fileName)
+         || cmdString.startsWithIgnoreCase ("mailto:")
          || File::createFileWithoutCheckingPath (fileName).isDirectory()
          || ! isFileExecutable (fileName))
     {
@@ -345,7 +346,7 @@ bool Process::openDocument (const String& fileName, const String& parameters)
 void File::revealToUser() const
 {
     if (isDirectory())
-        startAsProcess();
+        Process::openDocument (getFullPathName(), String::empty);
     else if (getParentDirectory().exists())
-        getParentDirectory().startAsProcess();
+        Process::openDocument (getParentDirectory().getFullPathName(), String::empty);
 }
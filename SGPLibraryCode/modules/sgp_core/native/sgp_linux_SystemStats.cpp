@@ -49,7 +49,7 @@ String SystemStats::getCpuVendor()
 
 int SystemStats::getCpuSpeedInMegaherz()
 {
-    return roundToInt (LinuxStatsHelpers::getCpuInfo ("cpu MHz").getFloatValue());
+    return (int) (LinuxStatsHelpers::getCpuInfo ("cpu MHz").getFloatValue() + 0.5f);
 }
 
 int SystemStats::getMemorySizeInMegabytes()
@@ -110,11 +110,24 @@ String SystemStats::getUserRegion()      { return getLocaleValue (_NL_IDENTIFICA
 //==============================================================================
 SystemStats::CPUFlags::CPUFlags()
 {
-    const String flags (LinuxStatsHelpers::getCpuInfo ("flags"));
-    hasMMX   = flags.contains ("mmx");
-    hasSSE   = flags.contains ("sse");
-    hasSSE2  = flags.contains ("sse2");
-    has3DNow = flags.contains ("3dnow");
+    const StringArray flags (LinuxCPUInfoHelpers::getCpuFeatures());
+    hasMMX     = flags.contains ("mmx");
+    hasSSE     = flags.contains ("sse");
+    hasSSE2    = flags.contains ("sse2");
+    has3DNow   = flags.contains ("3dnow");
+    hasSSE41   = flags.contains ("sse4_1");
+    hasAVX     = flags.contains ("avx");
+    hasAVX2    = flags.contains ("avx2");
+    hasFMA     = flags.contains ("fma");
+    hasAVX512F = flags.contains ("avx512f");
+
+    // "neon" on 32 bit ARM, "asimd" on 64 bit ARM
+    hasNEON    = flags.contains ("neon") || flags.contains ("asimd");
+
+    cacheLineSize = 64;
+    l2CacheSize = 0;
+    l3CacheSize = 0;
+    LinuxCPUInfoHelpers::getCacheSizes (cacheLineSize, l2CacheSize, l3CacheSize);
 
     numCpus = LinuxStatsHelpers::getCpuInfo ("processor").getIntValue() + 1;
 }
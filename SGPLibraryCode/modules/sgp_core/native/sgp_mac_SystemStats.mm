@@ -36,6 +36,25 @@ namespace SystemStatsHelpers
         a = la; b = lb; c = lc; d = ld;
     }
    #endif
+
+    // The hw.optional flags are only set when the OS also supports the feature
+    static bool getSysctlFlag (const char* name)
+    {
+        int value = 0;
+        size_t size = sizeof (value);
+        return sysctlbyname (name, &value, &size, nullptr, 0) == 0 && value != 0;
+    }
+
+    static int getSysctlSize (const char* name, const int defaultValue)
+    {
+        int64 value = 0;
+        size_t size = sizeof (value);
+
+        if (sysctlbyname (name, &value, &size, nullptr, 0) == 0 && value > 0)
+            return (int) (size == sizeof (int32) ? *(int32*) &value : value);
+
+        return defaultValue;
+    }
 }
 
 //==============================================================================
@@ -56,6 +75,17 @@ SystemStats::CPUFlags::CPUFlags()
     has3DNow = false;
    #endif
 
+    hasSSE41   = SystemStatsHelpers::getSysctlFlag ("hw.optional.sse4_1");
+    hasAVX     = SystemStatsHelpers::getSysctlFlag ("hw.optional.avx1_0");
+    hasAVX2    = SystemStatsHelpers::getSysctlFlag ("hw.optional.avx2_0");
+    hasFMA     = SystemStatsHelpers::getSysctlFlag ("hw.optional.fma");
+    hasAVX512F = SystemStatsHelpers::getSysctlFlag ("hw.optional.avx512f");
+    hasNEON    = SystemStatsHelpers::getSysctlFlag ("hw.optional.neon");
+
+    cacheLineSize = SystemStatsHelpers::getSysctlSize ("hw.cachelinesize", 64);
+    l2CacheSize   = SystemStatsHelpers::getSysctlSize ("hw.l2cachesize", 0);
+    l3CacheSize   = SystemStatsHelpers::getSysctlSize ("hw.l3cachesize", 0);
+
    #if SGP_IOS || (MAC_OS_X_VERSION_MIN_REQUIRED >= MAC_OS_X_VERSION_10_5)
     numCpus = (int) [[NSProcessInfo processInfo] activeProcessorCount];
    #else
@@ -424,6 +424,58 @@ size_t FileInputStream::readInternal (void* const buffer, const size_t numBytes)
     return (size_t) result;
 }
 
+//==============================================================================
+MemoryMappedFile::MemoryMappedFile (const File& file, MemoryMappedFile::AccessMode mode)
+    : address (nullptr),
+      length (0),
+      fileHandle (0)
+{
+    fileHandle = open (file.getFullPathName().toUTF8(),
+                       mode == readWrite ? (O_CREAT + O_RDWR) : O_RDONLY, 00644);
+
+    if (fileHandle != -1)
+    {
+        const int64 fileSize = file.getSize();
+
+        if (fileSize > 0)
+        {
+            int prot = PROT_READ;
+            int flags = MAP_SHARED;
+
+            if (mode == readWrite)
+            {
+                prot = PROT_READ | PROT_WRITE;
+            }
+            else if (mode == copyOnWrite)
+            {
+                prot = PROT_READ | PROT_WRITE;
+                flags = MAP_PRIVATE;
+            }
+
+            void* m = mmap (0, (size_t) fileSize, prot, flags, fileHandle, 0);
+
+            if (m != MAP_FAILED)
+            {
+                address = m;
+                length = (size_t) fileSize;
+            }
+        }
+    }
+    else
+    {
+        fileHandle = 0;
+    }
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (address != nullptr)
+        munmap (address, length);
+
+    if (fileHandle != 0)
+        close (fileHandle);
+}
+
 //==============================================================================
 void FileOutputStream::openHandle()
 {
@@ -862,6 +914,70 @@ void Thread::yield()
     sched_yield();
 }
 
+#if SGP_LINUX || SGP_ANDROID
+//==============================================================================
+namespace LinuxCPUInfoHelpers
+{
+    // Returns the feature list of the first CPU in /proc/cpuinfo, which only
+    // contains the features that the kernel supports ("flags" on x86, "Features" on ARM)
+    StringArray getCpuFeatures()
+    {
+        StringArray lines, features;
+        File ("/proc/cpuinfo").readLines (lines);
+
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            if (lines[i].startsWithIgnoreCase ("flags") || lines[i].startsWithIgnoreCase ("Features"))
+            {
+                features.addTokens (lines[i].fromFirstOccurrenceOf (":", false, false), false);
+                break;
+            }
+        }
+
+        return features;
+    }
+
+    // Reads the data caches of the first CPU from sysfs, the values are left unchanged if they can't be found
+    void getCacheSizes (int& cacheLineSize, int& l2CacheSize, int& l3CacheSize)
+    {
+        const File cacheFolder ("/sys/devices/system/cpu/cpu0/cache");
+
+        for (int i = 0;; ++i)
+        {
+            const File cache (cacheFolder.getChildFile ("index" + String (i)));
+
+            if (! cache.isDirectory())
+                break;
+
+            if (cache.getChildFile ("type").loadFileAsString().trim() == "Instruction")
+                continue;
+
+            const String sizeText (cache.getChildFile ("size").loadFileAsString().trim());
+            int size = sizeText.getIntValue();
+
+            if (sizeText.endsWithIgnoreCase ("K"))
+                size *= 1024;
+            else if (sizeText.endsWithIgnoreCase ("M"))
+                size *= 1024 * 1024;
+
+            switch (cache.getChildFile ("level").loadFileAsString().getIntValue())
+            {
+                case 1:
+                {
+                    const int lineSize = cache.getChildFile ("coherency_line_size").loadFileAsString().getIntValue();
+                    if (lineSize > 0)
+                        cacheLineSize = lineSize;
+                    break;
+                }
+                case 2:     l2CacheSize = size; break;
+                case 3:     l3CacheSize = size; break;
+                default:    break;
+            }
+        }
+    }
+}
+#endif
+
 //==============================================================================
 /* Remove this macro if you're having problems compiling the cpu affinity
    calls (the API for these has changed about quite a bit in various Linux
@@ -284,15 +284,12 @@ Result FileOutputStream::truncate()
     return SetEndOfFile ((HANDLE) fileHandle) ? Result::ok()
                                               : WindowsFileHelpers::getResultForLastError();
 }
-#if 0
 //==============================================================================
 MemoryMappedFile::MemoryMappedFile (const File& file, MemoryMappedFile::AccessMode mode)
     : address (nullptr),
       length (0),
       fileHandle (nullptr)
 {
-    jassert (mode == readOnly || mode == readWrite);
-
     DWORD accessMode = GENERIC_READ, createType = OPEN_EXISTING;
     DWORD protect = PAGE_READONLY, access = FILE_MAP_READ;
 
@@ -303,6 +300,38 @@ MemoryMappedFile::MemoryMappedFile (const File& file, MemoryMappedFile::AccessMo
         protect = PAGE_READWRITE;
         access = FILE_MAP_ALL_ACCESS;
     }
+    else if (mode == copyOnWrite)
+    {
+        // A file can't be deleted or replaced while a view of it is mapped, so the
+        // data is read into private pages here and the file is closed at once
+        HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(), GENERIC_READ, FILE_SHARE_READ, 0,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+
+        if (h != INVALID_HANDLE_VALUE)
+        {
+            const int64 fileSize = file.getSize();
+            void* m = VirtualAlloc (0, (SIZE_T) fileSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+            if (m != nullptr)
+            {
+                DWORD bytesRead = 0;
+
+                if (ReadFile (h, m, (DWORD) fileSize, &bytesRead, 0) && bytesRead == (DWORD) fileSize)
+                {
+                    address = m;
+                    length = (size_t) fileSize;
+                }
+                else
+                {
+                    VirtualFree (m, 0, MEM_RELEASE);
+                }
+            }
+
+            CloseHandle (h);
+        }
+
+        return;
+    }
 
     HANDLE h = CreateFile (file.getFullPathName().toWideCharPointer(), accessMode, FILE_SHARE_READ, 0,
                            createType, FILE_ATTRIBUTE_NORMAL, 0);
@@ -328,12 +357,17 @@ MemoryMappedFile::MemoryMappedFile (const File& file, MemoryMappedFile::AccessMo
 MemoryMappedFile::~MemoryMappedFile()
 {
     if (address != nullptr)
-        UnmapViewOfFile (address);
+    {
+        if (fileHandle != nullptr)
+            UnmapViewOfFile (address);
+        else
+            VirtualFree (address, 0, MEM_RELEASE);   // copyOnWrite data
+    }
 
     if (fileHandle != nullptr)
         CloseHandle ((HANDLE) fileHandle);
 }
-#endif
+
 //==============================================================================
 int64 File::getSize() const
 {
@@ -82,6 +82,68 @@ SystemStats::CPUFlags::CPUFlags()
     has3DNow = IsProcessorFeaturePresent (PF_3DNOW_INSTRUCTIONS_AVAILABLE) != 0;
    #endif
 
+    hasSSE41 = hasAVX = hasAVX2 = hasFMA = hasAVX512F = false;
+    hasNEON = false;
+
+   #if SGP_USE_INTRINSICS
+    int info [4];
+    __cpuid (info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid (info, 1);
+    hasSSE41 = (info[2] & (1 << 19)) != 0;
+
+    // AVX also needs the OS to save the YMM registers (OSXSAVE, then XCR0 bits 1 and 2)
+    const bool cpuHasAVX = (info[2] & (1 << 28)) != 0;
+    const bool cpuHasFMA = (info[2] & (1 << 12)) != 0;
+    uint64 enabledRegisters = 0;
+
+   #if _MSC_FULL_VER >= 160040219     // _xgetbv needs Visual Studio 2010 SP1
+    if ((info[2] & (1 << 27)) != 0)
+        enabledRegisters = _xgetbv (0);
+   #endif
+
+    const bool osSavesYMM = (enabledRegisters & 0x6) == 0x6;
+    const bool osSavesZMM = (enabledRegisters & 0xe6) == 0xe6;
+
+    hasAVX = cpuHasAVX && osSavesYMM;
+    hasFMA = cpuHasFMA && osSavesYMM;
+
+    if (maxLeaf >= 7)
+    {
+        __cpuidex (info, 7, 0);
+        hasAVX2    = osSavesYMM && (info[1] & (1 << 5)) != 0;
+        hasAVX512F = osSavesZMM && (info[1] & (1 << 16)) != 0;
+    }
+   #endif
+
+    cacheLineSize = 64;
+    l2CacheSize = 0;
+    l3CacheSize = 0;
+
+    DWORD bufferSize = 0;
+    GetLogicalProcessorInformation (nullptr, &bufferSize);
+
+    if (bufferSize > 0)
+    {
+        HeapBlock<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> processorInfo (bufferSize / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION) + 1);
+
+        if (GetLogicalProcessorInformation (processorInfo, &bufferSize))
+        {
+            for (int i = (int) (bufferSize / sizeof (SYSTEM_LOGICAL_PROCESSOR_INFORMATION)); --i >= 0;)
+            {
+                if (processorInfo[i].Relationship != RelationCache || processorInfo[i].Cache.Type == CacheInstruction)
+                    continue;
+
+                const CACHE_DESCRIPTOR& cache = processorInfo[i].Cache;
+
+                if (cache.Level == 1)       cacheLineSize = (int) cache.LineSize;
+                else if (cache.Level == 2)  l2CacheSize = (int) cache.Size;
+                else if (cache.Level == 3)  l3CacheSize = (int) cache.Size;
+            }
+        }
+    }
+
     SYSTEM_INFO systemInfo;
     GetNativeSystemInfo (&systemInfo);
     numCpus = (int) systemInfo.dwNumberOfProcessors;
@@ -78,6 +78,7 @@ namespace sgp
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
 */
+#include "common/sgp_LinearArena.cpp"
 #include "common/sgp_MemoryBlock.cpp"
 #include "common/sgp_Result.cpp"
 #include "common/sgp_Colour.cpp"
@@ -113,6 +114,7 @@ namespace sgp
 #include "threads/juce_ReadWriteLock.cpp"
 */
 #include "threads/sgp_Thread.cpp"
+#include "threads/sgp_JobScheduler.cpp"
 /*
 #include "threads/juce_ThreadPool.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
@@ -53,6 +53,12 @@ namespace sgp
 #ifndef __SGP_HASHMAP_HEADER__
  #include "common/sgp_HashMap.h"
 #endif
+#ifndef __SGP_FLATHASHMAP_HEADER__
+ #include "common/sgp_FlatHashMap.h"
+#endif
+#ifndef __SGP_LINEARARENA_HEADER__
+ #include "common/sgp_LinearArena.h"
+#endif
 #ifndef __SGP_LINKEDLISTPOINTER_HEADER__
  #include "common/sgp_LinkedListPointer.h"
 #endif
@@ -99,13 +105,13 @@ namespace sgp
 #ifndef __SGP_FILEOUTPUTSTREAM_HEADER__
  #include "files/sgp_FileOutputStream.h"
 #endif
+#ifndef __SGP_MEMORYMAPPEDFILE_HEADER__
+ #include "files/sgp_MemoryMappedFile.h"
+#endif
 /*
 #ifndef __JUCE_FILESEARCHPATH_JUCEHEADER__
  #include "files/juce_FileSearchPath.h"
 #endif
-#ifndef __JUCE_MEMORYMAPPEDFILE_JUCEHEADER__
- #include "files/juce_MemoryMappedFile.h"
-#endif
 #ifndef __JUCE_TEMPORARYFILE_JUCEHEADER__
  #include "files/juce_TemporaryFile.h"
 #endif
@@ -234,6 +240,9 @@ namespace sgp
 #ifndef __SGP_SYSTEMSTATS_HEADER__
  #include "system/sgp_SystemStats.h"
 #endif
+#ifndef __SGP_SIMDDISPATCH_HEADER__
+ #include "system/sgp_SIMDDispatch.h"
+#endif
 #ifndef __SGP_TARGETPLATFORM_HEADER__
  #include "system/sgp_TargetPlatform.h"
 #endif
@@ -322,6 +331,10 @@ namespace sgp
  #include "threads/sgp_SpinLock.h"
 #endif
 
+#ifndef __SGP_LOCKFREEQUEUE_HEADER__
+ #include "threads/sgp_LockFreeQueue.h"
+#endif
+
 #ifndef __SGP_THREAD_HEADER__
  #include "threads/sgp_Thread.h"
 #endif
@@ -340,6 +353,9 @@ namespace sgp
 #ifndef __SGP_WAITABLEEVENT_HEADER__
  #include "threads/sgp_WaitableEvent.h"
 #endif
+#ifndef __SGP_JOBSCHEDULER_HEADER__
+ #include "threads/sgp_JobScheduler.h"
+#endif
 /*
 #ifndef __JUCE_PERFORMANCECOUNTER_JUCEHEADER__
  #include "time/sgp_PerformanceCounter.h"
@@ -213,7 +213,12 @@ namespace sgp
 
 //==============================================================================
 // Declare some fake versions of nullptr and noexcept, for older compilers:
+#if SGP_GCC && (__cplusplus >= 201103L || defined (__GXX_EXPERIMENTAL_CXX0X__))
+ #define SGP_COMPILER_SUPPORTS_NOEXCEPT 1
+ #define SGP_COMPILER_SUPPORTS_NULLPTR 1
+#endif
 
+#if ! SGP_COMPILER_SUPPORTS_NOEXCEPT
  #ifdef noexcept
   #undef noexcept
  #endif
@@ -221,12 +226,14 @@ namespace sgp
  #if defined (_MSC_VER) && _MSC_VER > 1600
   #define _ALLOW_KEYWORD_MACROS 1 // (to stop VC2012 complaining)
  #endif
+#endif
 
-
+#if ! SGP_COMPILER_SUPPORTS_NULLPTR
  #ifdef nullptr
   #undef nullptr
  #endif
  #define nullptr (0)
+#endif
 
 
 #endif   // __SGP_PLATFORMDEFS_HEADER__
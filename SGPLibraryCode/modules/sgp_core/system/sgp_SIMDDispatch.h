@@ -0,0 +1,140 @@
+
+
+#ifndef __SGP_SIMDDISPATCH_HEADER__
+#define __SGP_SIMDDISPATCH_HEADER__
+
+#include "sgp_SystemStats.h"
+
+
+//==============================================================================
+/**
+    Chooses between several versions of a kernel function compiled for different
+    instruction sets, using the CPU features found by SystemStats.
+
+    A kernel is selected once, when its Kernel object is created, and is then called
+    through a plain function pointer. Creating the Kernel as a static object selects
+    it at startup:
+
+    @code
+    typedef void (*ScaleFunction) (float* dest, const float* src, float scale, int num);
+
+    static void scaleScalar (float* dest, const float* src, float scale, int num);
+    static void scaleSSE2 (float* dest, const float* src, float scale, int num);
+    static void scaleAVX2 (float* dest, const float* src, float scale, int num);   // compiled for AVX2 + FMA
+
+    static const SIMDDispatch::Kernel<ScaleFunction> scaleKernel
+        = SIMDDispatch::Kernel<ScaleFunction> (scaleScalar)
+            .withVersion (SIMDDispatch::sse2, scaleSSE2)
+            .withVersion (SIMDDispatch::avx2, scaleAVX2);
+
+    scaleKernel.get() (dest, src, 2.0f, num);
+    @endcode
+
+    The versions for an instruction set must be compiled for it (e.g. /arch:AVX2 or
+    -mavx2 -mfma for that one source file, or the target attribute with GCC), and must
+    only be called through a Kernel.
+
+    @see SystemStats
+*/
+class SGP_API  SIMDDispatch
+{
+public:
+    //==============================================================================
+    /** The instruction sets a kernel can have a version for.
+        A version for a later instruction set is preferred when it is supported.
+    */
+    enum InstructionSet
+    {
+        scalar = 0,         /**< Plain C++, always supported. */
+        sse2,
+        sse41,
+        avx,
+        avx2,               /**< AVX2 together with FMA3, as on all CPUs which have AVX2 so far. */
+        avx512f,
+        neon,
+
+        numInstructionSets
+    };
+
+    /** Returns true if the CPU and the OS support this instruction set. */
+    static bool isSupported (const InstructionSet instructionSet) noexcept
+    {
+        switch (instructionSet)
+        {
+            case scalar:    return true;
+            case sse2:      return SystemStats::hasSSE2();
+            case sse41:     return SystemStats::hasSSE41();
+            case avx:       return SystemStats::hasAVX();
+            case avx2:      return SystemStats::hasAVX2() && SystemStats::hasFMA();
+            case avx512f:   return SystemStats::hasAVX512F();
+            case neon:      return SystemStats::hasNEON();
+            default:        break;
+        }
+
+        return false;
+    }
+
+    /** Returns the best instruction set supported by this machine. */
+    static InstructionSet getBestInstructionSet() noexcept
+    {
+        for (int i = numInstructionSets; --i > scalar;)
+            if (isSupported ((InstructionSet) i))
+                return (InstructionSet) i;
+
+        return scalar;
+    }
+
+    /** Returns a readable name of an instruction set, e.g. for the log. */
+    static const char* getInstructionSetName (const InstructionSet instructionSet) noexcept
+    {
+        static const char* const names[] = { "Scalar", "SSE2", "SSE4.1", "AVX", "AVX2+FMA", "AVX-512F", "NEON" };
+        return isPositiveAndBelow ((int) instructionSet, (int) numInstructionSets) ? names [instructionSet] : "Unknown";
+    }
+
+    //==============================================================================
+    /** A function pointer which is set to the best supported version of a kernel.
+        FunctionType must be a function pointer type.
+    */
+    template <typename FunctionType>
+    class Kernel
+    {
+    public:
+        /** Creates a kernel which uses the scalar version until a better one is added. */
+        explicit Kernel (FunctionType scalarVersion) noexcept
+            : function (scalarVersion), instructionSet (scalar)
+        {
+            jassert (scalarVersion != nullptr);
+        }
+
+        /** Adds the version for an instruction set. It is used if the instruction set is
+            supported and better than the one of the current version.
+        */
+        Kernel& withVersion (const InstructionSet versionInstructionSet, FunctionType version) noexcept
+        {
+            if (version != nullptr && versionInstructionSet > instructionSet && isSupported (versionInstructionSet))
+            {
+                function = version;
+                instructionSet = versionInstructionSet;
+            }
+
+            return *this;
+        }
+
+        /** Returns the selected version. */
+        FunctionType get() const noexcept                       { return function; }
+
+        /** Returns the instruction set of the selected version. */
+        InstructionSet getInstructionSet() const noexcept       { return instructionSet; }
+
+    private:
+        FunctionType function;
+        InstructionSet instructionSet;
+    };
+
+private:
+    SIMDDispatch();
+    SGP_DECLARE_NON_COPYABLE (SIMDDispatch)
+};
+
+
+#endif   // __SGP_SIMDDISPATCH_HEADER__
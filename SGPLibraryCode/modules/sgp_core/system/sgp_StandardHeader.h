@@ -36,6 +36,7 @@
 #include <cstdlib>
 #include <cstdarg>
 #include <climits>
+#include <cfloat>
 #include <limits>
 #include <cmath>
 #include <cwchar>
@@ -90,7 +91,7 @@
 
 #if SGP_MSVC
 	#define STRNICMP _strnicmp
-#elif SGP_MAC || SGP_IOS
+#elif SGP_MAC || SGP_IOS || SGP_LINUX
 	#define STRNICMP strncasecmp
 #elif SGP_ANDROID
 	#define STRNICMP _strnicmp
@@ -121,6 +121,34 @@ public:
     /** Checks whether AMD 3DNOW instructions are available. */
     static bool has3DNow() noexcept             { return getCPUFlags().has3DNow; }
 
+    /** Checks whether Intel SSE4.1 instructions are available. */
+    static bool hasSSE41() noexcept             { return getCPUFlags().hasSSE41; }
+
+    /** Checks whether AVX instructions are available, and the OS saves the AVX registers. */
+    static bool hasAVX() noexcept               { return getCPUFlags().hasAVX; }
+
+    /** Checks whether AVX2 instructions are available, and the OS saves the AVX registers. */
+    static bool hasAVX2() noexcept              { return getCPUFlags().hasAVX2; }
+
+    /** Checks whether FMA3 (fused multiply-add) instructions are available. */
+    static bool hasFMA() noexcept               { return getCPUFlags().hasFMA; }
+
+    /** Checks whether AVX-512 Foundation instructions are available, and the OS saves the AVX-512 registers. */
+    static bool hasAVX512F() noexcept           { return getCPUFlags().hasAVX512F; }
+
+    /** Checks whether ARM NEON (Advanced SIMD) instructions are available. */
+    static bool hasNEON() noexcept              { return getCPUFlags().hasNEON; }
+
+    //==============================================================================
+    /** Returns the size of a data cache line in bytes, 64 if it can't be found out. */
+    static int getCacheLineSize() noexcept      { return getCPUFlags().cacheLineSize; }
+
+    /** Returns the size of the level 2 cache of one core in bytes, or 0 if it is unknown. */
+    static int getL2CacheSize() noexcept        { return getCPUFlags().l2CacheSize; }
+
+    /** Returns the size of the level 3 cache in bytes, or 0 if there is none or it is unknown. */
+    static int getL3CacheSize() noexcept        { return getCPUFlags().l3CacheSize; }
+
     //==============================================================================
     /** Finds out how much RAM is in the machine.
         @returns    the approximate number of megabytes of memory, or zero if
@@ -145,6 +173,16 @@ private:
         bool hasSSE : 1;
         bool hasSSE2 : 1;
         bool has3DNow : 1;
+        bool hasSSE41 : 1;
+        bool hasAVX : 1;
+        bool hasAVX2 : 1;
+        bool hasFMA : 1;
+        bool hasAVX512F : 1;
+        bool hasNEON : 1;
+
+        int cacheLineSize;
+        int l2CacheSize;
+        int l3CacheSize;
     };
 
     SystemStats();
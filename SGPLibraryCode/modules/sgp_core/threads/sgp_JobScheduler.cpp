@@ -0,0 +1,432 @@
+
+
+//==============================================================================
+// Job deque of one worker. The owner pushes and pops at the tail,
+// other threads steal from the head.
+class JobScheduler::WorkQueue
+{
+public:
+    WorkQueue() : capacity (0), head (0), numEntries (0)
+    {
+        grow();
+    }
+
+    void push (const JobEntry& entry)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (numEntries == capacity)
+            grow();
+
+        entries [(head + numEntries) & (capacity - 1)] = entry;
+        ++numEntries;
+    }
+
+    bool pop (JobEntry& entry)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (numEntries == 0)
+            return false;
+
+        --numEntries;
+        entry = entries [(head + numEntries) & (capacity - 1)];
+        return true;
+    }
+
+    bool steal (JobEntry& entry)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (numEntries == 0)
+            return false;
+
+        entry = entries [head];
+        head = (head + 1) & (capacity - 1);
+        --numEntries;
+        return true;
+    }
+
+    // Takes the newest entry of the counter, the later entries are moved down one place
+    bool popJobOf (const Counter* counter, JobEntry& entry)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+        const int mask = capacity - 1;
+
+        for (int i = numEntries; --i >= 0;)
+        {
+            if (entries [(head + i) & mask].counter != counter)
+                continue;
+
+            entry = entries [(head + i) & mask];
+
+            for (int j = i + 1; j < numEntries; ++j)
+                entries [(head + j - 1) & mask] = entries [(head + j) & mask];
+
+            --numEntries;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    SpinLock lock;
+    HeapBlock<JobEntry> entries;
+    int capacity, head, numEntries;
+
+    // Capacity is kept a power of two, entries are moved to start at 0
+    void grow()
+    {
+        const int newCapacity = jmax (64, capacity * 2);
+        HeapBlock<JobEntry> newEntries (newCapacity);
+
+        for (int i = 0; i < numEntries; ++i)
+            newEntries[i] = entries [(head + i) & (capacity - 1)];
+
+        entries.swapWith (newEntries);
+        capacity = newCapacity;
+        head = 0;
+    }
+
+    SGP_DECLARE_NON_COPYABLE (WorkQueue)
+};
+
+//==============================================================================
+class JobScheduler::WorkerThread  : public Thread
+{
+public:
+    WorkerThread (JobScheduler& owner_, int queueIndex_)
+        : Thread ("Job Scheduler Worker " + String (queueIndex_)),
+          owner (owner_), queueIndex (queueIndex_)
+    {
+    }
+
+    void run()
+    {
+        owner.runWorker (queueIndex);
+    }
+
+    WaitableEvent wakeUp;
+
+private:
+    JobScheduler& owner;
+    const int queueIndex;
+
+    SGP_DECLARE_NON_COPYABLE (WorkerThread)
+};
+
+//==============================================================================
+static char sharedSchedulerLock [sizeof (SpinLock)];    // (statically initialised to zeros)
+static JobScheduler* sharedScheduler = nullptr;
+
+// Stops the shared scheduler's workers during static destruction
+struct SharedSchedulerDeleter
+{
+    ~SharedSchedulerDeleter()       { deleteAndZero (sharedScheduler); }
+};
+
+static SharedSchedulerDeleter sharedSchedulerDeleter;
+
+JobScheduler& JobScheduler::getSharedScheduler()
+{
+    const SpinLock::ScopedLockType sl (*reinterpret_cast <SpinLock*> (sharedSchedulerLock));
+
+    // At least one worker, the engine's jobs (e.g. resource loading) aren't waited for
+    if (sharedScheduler == nullptr)
+        sharedScheduler = new JobScheduler (jmax (1, SystemStats::getNumCpus() - 1));
+
+    return *sharedScheduler;
+}
+
+//==============================================================================
+JobScheduler::JobScheduler (int numberOfWorkers, bool pinWorkersToCores)
+{
+    const int numCpus = SystemStats::getNumCpus();
+
+    if (numberOfWorkers < 0)
+        numberOfWorkers = jmax (0, numCpus - 1);
+
+    for (int i = 0; i <= numberOfWorkers; ++i)
+        queues.add (new WorkQueue());
+
+    for (int i = 0; i < numberOfWorkers; ++i)
+    {
+        WorkerThread* worker = new WorkerThread (*this, i + 1);
+
+        // Core 0 is left to the thread creating the jobs
+        if (pinWorkersToCores && numCpus > 1 && numCpus <= 32)
+            worker->setAffinityMask (1u << ((i + 1) % numCpus));
+
+        workers.add (worker);
+    }
+
+    for (int i = 0; i < workers.size(); ++i)
+        workers.getUnchecked(i)->startThread();
+}
+
+JobScheduler::~JobScheduler()
+{
+    for (int i = 0; i < workers.size(); ++i)
+        workers.getUnchecked(i)->signalThreadShouldExit();
+
+    // Workers going to sleep after this see they should exit
+    while (numSleepingWorkers.get() > 0)
+        wakeWorker();
+
+    for (int i = 0; i < workers.size(); ++i)
+        workers.getUnchecked(i)->stopThread (2000);
+
+    workers.clear();
+
+    for (int i = 0; i < queues.size(); ++i)
+    {
+        JobEntry entry;
+
+        while (queues.getUnchecked(i)->steal (entry))
+            cancelJob (entry);
+    }
+
+    queues.clear();
+}
+
+//==============================================================================
+void JobScheduler::addJob (Job* job, Counter* counter, Counter* dependency)
+{
+    jassert (job != nullptr);
+
+    if (counter != nullptr)
+        ++(counter->count);
+
+    JobEntry entry;
+    entry.job = job;
+    entry.counter = counter;
+
+    if (dependency != nullptr)
+    {
+        // Checked under the lock, the counter only reaches zero under it in runJob()
+        const SpinLock::ScopedLockType sl (dependency->lock);
+
+        if (dependency->count.get() > 0)
+        {
+            dependency->waitingJobs.add (entry);
+            return;
+        }
+    }
+
+    pushJob (entry);
+}
+
+void JobScheduler::waitForCounter (Counter& counter)
+{
+    // Registered before checking the count, so that the last job or a job queued
+    // later either is seen here or signals the event
+    ++(counter.numWaitingThreads);
+
+    while (! counter.isDone())
+    {
+        JobEntry entry;
+
+        if (findJobOf (counter, entry))
+            runJob (entry);
+        else if (! counter.isDone())
+            counter.jobsChanged.wait();
+    }
+
+    --(counter.numWaitingThreads);
+}
+
+bool JobScheduler::runPendingJob()
+{
+    JobEntry entry;
+
+    if (! findJob (currentQueueIndex.get(), entry))
+        return false;
+
+    runJob (entry);
+    return true;
+}
+
+//==============================================================================
+void JobScheduler::pushJob (const JobEntry& entry)
+{
+    Counter* const counter = entry.counter;
+
+    if (counter == nullptr)
+    {
+        queues.getUnchecked (currentQueueIndex.get())->push (entry);
+        ++numQueuedJobs;
+    }
+    else
+    {
+        // Under the counter's lock the job can't finish, so the counter isn't deleted
+        // before a thread waiting for it has been told about the job
+        const SpinLock::ScopedLockType sl (counter->lock);
+
+        queues.getUnchecked (currentQueueIndex.get())->push (entry);
+        ++numQueuedJobs;
+
+        if (counter->numWaitingThreads.get() > 0)
+            counter->jobsChanged.signal();
+    }
+
+    wakeWorker();
+}
+
+// Adds a job of a counter which no other thread waits for, without waking a worker
+void JobScheduler::queueJob (Job* job, Counter& counter)
+{
+    ++(counter.count);
+
+    JobEntry entry;
+    entry.job = job;
+    entry.counter = &counter;
+
+    queues.getUnchecked (currentQueueIndex.get())->push (entry);
+    ++numQueuedJobs;
+}
+
+void JobScheduler::wakeWorker()
+{
+    if (numSleepingWorkers.get() == 0)
+        return;
+
+    // Only one worker is woken, it wakes the next one if jobs are left (see findJob())
+    WorkerThread* worker = nullptr;
+    {
+        const SpinLock::ScopedLockType sl (sleepingWorkersLock);
+
+        if (sleepingWorkers.size() > 0)
+        {
+            worker = sleepingWorkers.remove (sleepingWorkers.size() - 1);
+            --numSleepingWorkers;
+        }
+    }
+
+    if (worker != nullptr)
+        worker->wakeUp.signal();
+}
+
+bool JobScheduler::findJob (const int queueIndex, JobEntry& entry)
+{
+    if (numQueuedJobs.get() == 0)
+        return false;
+
+    bool found = queues.getUnchecked (queueIndex)->pop (entry);
+
+    for (int i = 1; i < queues.size() && ! found; ++i)
+        found = queues.getUnchecked ((queueIndex + i) % queues.size())->steal (entry);
+
+    if (! found)
+        return false;
+
+    // Other jobs are left, the auto-reset event only woke one worker
+    if (--numQueuedJobs > 0)
+        wakeWorker();
+
+    return true;
+}
+
+bool JobScheduler::findJobOf (const Counter& counter, JobEntry& entry)
+{
+    if (numQueuedJobs.get() == 0)
+        return false;
+
+    // The calling thread's own queue first, that is where its jobs usually are
+    const int queueIndex = currentQueueIndex.get();
+    bool found = false;
+
+    for (int i = 0; i < queues.size() && ! found; ++i)
+        found = queues.getUnchecked ((queueIndex + i) % queues.size())->popJobOf (&counter, entry);
+
+    if (! found)
+        return false;
+
+    if (--numQueuedJobs > 0)
+        wakeWorker();
+
+    return true;
+}
+
+void JobScheduler::runJob (const JobEntry& entry)
+{
+    entry.job->runJob();
+
+    Array<JobEntry> readyJobs;
+    finishJob (entry, readyJobs);
+
+    for (int i = 0; i < readyJobs.size(); ++i)
+        pushJob (readyJobs.getReference (i));
+}
+
+void JobScheduler::cancelJob (const JobEntry& entry)
+{
+    Array<JobEntry> readyJobs;
+    finishJob (entry, readyJobs);
+
+    for (int i = 0; i < readyJobs.size(); ++i)
+        cancelJob (readyJobs.getReference (i));
+}
+
+void JobScheduler::finishJob (const JobEntry& entry, Array<JobEntry>& readyJobs)
+{
+    Counter* const counter = entry.counter;
+    if (counter == nullptr)
+        return;
+
+    // The count only reaches zero under the lock, and the waiting jobs are detached in
+    // the same lock section. A thread which has seen zero and deletes the counter takes
+    // the lock first (see ~Counter), so the counter isn't touched after it is deleted.
+    const SpinLock::ScopedLockType sl (counter->lock);
+
+    if (--(counter->count) > 0)
+        return;
+
+    readyJobs.swapWithArray (counter->waitingJobs);
+
+    if (counter->numWaitingThreads.get() > 0)
+        counter->jobsChanged.signal();
+}
+
+void JobScheduler::runWorker (const int queueIndex)
+{
+    currentQueueIndex = queueIndex;
+    WorkerThread* const thread = workers.getUnchecked (queueIndex - 1);
+
+    while (! thread->threadShouldExit())
+    {
+        JobEntry entry;
+
+        if (findJob (queueIndex, entry))
+        {
+            runJob (entry);
+            continue;
+        }
+
+        // Registered as sleeping before checking the queues again, so a job pushed
+        // in between either is found here or wakes this worker up
+        {
+            const SpinLock::ScopedLockType sl (sleepingWorkersLock);
+            sleepingWorkers.add (thread);
+            ++numSleepingWorkers;
+        }
+
+        if (numQueuedJobs.get() > 0 || thread->threadShouldExit())
+        {
+            // If it isn't in the list any more, a thread has taken it out and signals it,
+            // the next wait() then returns at once
+            const SpinLock::ScopedLockType sl (sleepingWorkersLock);
+            const int index = sleepingWorkers.indexOf (thread);
+
+            if (index >= 0)
+            {
+                sleepingWorkers.remove (index);
+                --numSleepingWorkers;
+            }
+        }
+        else
+        {
+            thread->wakeUp.wait();
+        }
+    }
+}
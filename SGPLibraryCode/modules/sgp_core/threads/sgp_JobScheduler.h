@@ -0,0 +1,238 @@
+
+
+#ifndef __SGP_JOBSCHEDULER_HEADER__
+#define __SGP_JOBSCHEDULER_HEADER__
+
+#include "sgp_Thread.h"
+#include "sgp_SpinLock.h"
+#include "sgp_WaitableEvent.h"
+#include "sgp_ThreadLocalValue.h"
+#include "../common/sgp_OwnedArray.h"
+
+
+//==============================================================================
+/**
+    A work-stealing job scheduler.
+
+    Each worker thread owns a deque of jobs: it pushes and pops its own jobs at one
+    end, and idle workers steal from the other end of the other deques. Jobs added
+    by threads which are not workers go into a shared deque that every worker
+    steals from.
+
+    Completion is tracked with Counter objects: a counter is incremented when a job
+    is added with it and decremented when the job has run. A job can also be added
+    with a dependency counter, it is not started before that counter reaches zero.
+
+    A thread waiting for a counter (waitForCounter(), parallelFor()) runs the pending
+    jobs of that counter itself, so the main thread helps with its own work while it
+    waits. It never picks up other jobs, which may block (e.g. file loading), and it
+    sleeps when the only jobs left for the counter are running on workers.
+
+    Jobs are not owned by the scheduler, they must stay alive until their counter
+    has reached zero.
+
+    @code
+    struct ScaleVertices
+    {
+        void operator() (int begin, int end) const
+        {
+            for (int i = begin; i < end; ++i)
+                vertices[i] *= scale;
+        }
+
+        Vector3D* vertices;
+        float scale;
+    };
+
+    ScaleVertices scaler = { vertices, 2.0f };
+    scheduler.parallelFor (0, numVertices, scaler);
+    @endcode
+*/
+class SGP_API  JobScheduler
+{
+public:
+    //==============================================================================
+    /** A unit of work run by the scheduler. */
+    class SGP_API  Job
+    {
+    public:
+        virtual ~Job() {}
+
+        /** Called by a worker thread, or by a thread waiting for a counter. */
+        virtual void runJob() = 0;
+    };
+
+    class Counter;
+
+private:
+    struct JobEntry
+    {
+        Job* job;
+        Counter* counter;
+    };
+
+public:
+    //==============================================================================
+    /** Counts the unfinished jobs added with it.
+
+        A counter must not be deleted while jobs added with it, or jobs depending
+        on it, are still pending.
+    */
+    class SGP_API  Counter
+    {
+    public:
+        Counter() noexcept {}
+
+        /** Waits for a worker which is still finishing the last job to let go of the counter. */
+        ~Counter()
+        {
+            const SpinLock::ScopedLockType sl (lock);
+            jassert (count.get() == 0);
+        }
+
+        /** Returns true when all jobs added with this counter have run. */
+        bool isDone() const noexcept            { return count.get() == 0; }
+
+        /** Returns the number of jobs which have not finished yet. */
+        int getNumPendingJobs() const noexcept  { return count.get(); }
+
+    private:
+        friend class JobScheduler;
+
+        Atomic<int> count;
+        SpinLock lock;
+        Array<JobEntry> waitingJobs;    // jobs depending on this counter
+
+        Atomic<int> numWaitingThreads;
+        WaitableEvent jobsChanged;      // signalled when the count reaches zero or a job of it is queued
+
+        SGP_DECLARE_NON_COPYABLE (Counter)
+    };
+
+    //==============================================================================
+    /** Creates the scheduler and starts its worker threads.
+
+        @param numberOfWorkers      the number of worker threads. A negative value uses
+                                    SystemStats::getNumCpus() - 1, leaving one core for the
+                                    thread that creates the jobs.
+        @param pinWorkersToCores    if true, worker i runs on core i + 1 only (see
+                                    Thread::setAffinityMask())
+    */
+    explicit JobScheduler (int numberOfWorkers = -1, bool pinWorkersToCores = false);
+
+    /** Stops the worker threads.
+        Jobs which have not been started are not run, but their counters are decremented
+        as if they had, so threads waiting for them (or jobs depending on them) don't hang.
+    */
+    ~JobScheduler();
+
+    /** Returns the scheduler shared by the engine, which is created on first use with
+        SystemStats::getNumCpus() - 1 workers (at least one), and deleted on shutdown.
+    */
+    static JobScheduler& getSharedScheduler();
+
+    //==============================================================================
+    /** Adds a job.
+
+        @param job                  the job to run, it is not deleted by the scheduler
+        @param counter              if not null, incremented now and decremented when the job has run
+        @param dependency           if not null, the job is only started once this counter is zero
+    */
+    void addJob (Job* job, Counter* counter = nullptr, Counter* dependency = nullptr);
+
+    /** Runs the pending jobs added with the counter on the calling thread until the
+        counter is zero. Jobs of other counters are left to the workers.
+    */
+    void waitForCounter (Counter& counter);
+
+    /** Runs one pending job on the calling thread, whichever counter it belongs to.
+        @returns false if no job could be found
+    */
+    bool runPendingJob();
+
+    /** Calls function (begin, end) for sub-ranges of [startIndex, endIndex) in parallel,
+        and returns when all of them have been called.
+
+        @param grainSize    the number of indices per job, 0 splits the range into
+                            about four jobs per thread
+    */
+    template <class FunctionType>
+    void parallelFor (int startIndex, int endIndex, FunctionType& function, int grainSize = 0)
+    {
+        const int numItems = endIndex - startIndex;
+        if (numItems <= 0)
+            return;
+
+        if (grainSize <= 0)
+            grainSize = jmax (1, numItems / ((getNumWorkers() + 1) * 4));
+
+        const int numJobs = (numItems + grainSize - 1) / grainSize;
+        if (numJobs == 1 || getNumWorkers() == 0)
+        {
+            function (startIndex, endIndex);
+            return;
+        }
+
+        RangeJob<FunctionType>* jobs = new RangeJob<FunctionType> [numJobs];
+        Counter counter;
+
+        for (int i = 0; i < numJobs; ++i)
+        {
+            jobs[i].function = &function;
+            jobs[i].begin = startIndex + i * grainSize;
+            jobs[i].end = jmin (endIndex, jobs[i].begin + grainSize);
+            queueJob (jobs + i, counter);
+        }
+
+        // One wake-up for all the jobs, each woken worker wakes the next one
+        wakeWorker();
+        waitForCounter (counter);
+        delete[] jobs;
+    }
+
+    //==============================================================================
+    /** Returns the number of worker threads. */
+    int getNumWorkers() const noexcept          { return workers.size(); }
+
+    /** Returns the number of jobs which have been added and not started yet. */
+    int getNumQueuedJobs() const noexcept       { return numQueuedJobs.get(); }
+
+private:
+    //==============================================================================
+    template <class FunctionType>
+    struct RangeJob  : public Job
+    {
+        void runJob()       { (*function) (begin, end); }
+
+        FunctionType* function;
+        int begin, end;
+    };
+
+    class WorkQueue;
+    class WorkerThread;
+    friend class WorkerThread;
+
+    OwnedArray<WorkQueue> queues;               // [0] is used by threads which are not workers
+    OwnedArray<WorkerThread> workers;
+    ThreadLocalValue<int> currentQueueIndex;
+
+    Atomic<int> numQueuedJobs;
+    Atomic<int> numSleepingWorkers;
+    SpinLock sleepingWorkersLock;
+    Array<WorkerThread*> sleepingWorkers;       // each one is woken by its own event, by one thread
+
+    void runWorker (int queueIndex);
+    void pushJob (const JobEntry& entry);
+    void queueJob (Job* job, Counter& counter);
+    bool findJob (int queueIndex, JobEntry& entry);
+    bool findJobOf (const Counter& counter, JobEntry& entry);
+    void runJob (const JobEntry& entry);
+    void cancelJob (const JobEntry& entry);
+    void finishJob (const JobEntry& entry, Array<JobEntry>& readyJobs);
+    void wakeWorker();
+
+    SGP_DECLARE_NON_COPYABLE (JobScheduler)
+};
+
+
+#endif   // __SGP_JOBSCHEDULER_HEADER__
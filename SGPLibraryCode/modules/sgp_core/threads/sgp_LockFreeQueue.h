@@ -0,0 +1,278 @@
+
+
+#ifndef __SGP_LOCKFREEQUEUE_HEADER__
+#define __SGP_LOCKFREEQUEUE_HEADER__
+
+#include "../common/sgp_Atomic.h"
+
+
+//==============================================================================
+/**
+    Helpers for the lock-free queues.
+
+    Atomic::get() is a read-modify-write on most platforms, so reading a position
+    which another thread writes would take the cache line away from that thread.
+    These read and write the raw value instead, with a full barrier after the load
+    (acquire) or before the store (release).
+*/
+namespace LockFreeQueueHelpers
+{
+    enum { cacheLineSize = 64 };
+
+    inline uint32 loadAcquire (const Atomic<uint32>& position) noexcept
+    {
+        const uint32 value = position.value;
+        Atomic<uint32>::memoryBarrier();
+        return value;
+    }
+
+    inline void storeRelease (Atomic<uint32>& position, const uint32 value) noexcept
+    {
+        Atomic<uint32>::memoryBarrier();
+        position.value = value;
+    }
+
+    inline uint32 roundUpToPowerOfTwo (const int capacity) noexcept
+    {
+        uint32 size = 2;
+        while ((int) size < capacity)
+            size <<= 1;
+
+        return size;
+    }
+}
+
+//==============================================================================
+/**
+    A bounded, lock-free queue for exactly one producer thread and one consumer thread.
+
+    Only one thread may call push() and only one (other) thread may call pop(). Each side
+    keeps a cached copy of the other side's position, and only reads the shared one when
+    the queue looks full or empty, so the two threads rarely touch the same cache line.
+
+    The element type is copied in and out, and must be default-constructible.
+
+    @see MPMCQueue
+*/
+template <typename ElementType>
+class SPSCQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue. The capacity is rounded up to a power of two. */
+    explicit SPSCQueue (const int capacity)
+        : mask (LockFreeQueueHelpers::roundUpToPowerOfTwo (capacity) - 1),
+          elements (new ElementType [mask + 1]),
+          cachedReadPosition (0), cachedWritePosition (0)
+    {
+    }
+
+    /** Destructor. */
+    ~SPSCQueue()
+    {
+        delete[] elements;
+    }
+
+    //==============================================================================
+    /** Adds an element, called by the producer thread.
+        @returns false if the queue is full
+    */
+    bool push (const ElementType& element)
+    {
+        const uint32 position = writePosition.value;      // only written by this thread
+
+        if (position - cachedReadPosition > mask)
+        {
+            cachedReadPosition = LockFreeQueueHelpers::loadAcquire (readPosition);
+
+            if (position - cachedReadPosition > mask)
+                return false;
+        }
+
+        elements [position & mask] = element;
+        LockFreeQueueHelpers::storeRelease (writePosition, position + 1);
+        return true;
+    }
+
+    /** Removes the oldest element, called by the consumer thread.
+        @returns false if the queue is empty
+    */
+    bool pop (ElementType& element)
+    {
+        const uint32 position = readPosition.value;       // only written by this thread
+
+        if (position == cachedWritePosition)
+        {
+            cachedWritePosition = LockFreeQueueHelpers::loadAcquire (writePosition);
+
+            if (position == cachedWritePosition)
+                return false;
+        }
+
+        element = elements [position & mask];
+        LockFreeQueueHelpers::storeRelease (readPosition, position + 1);
+        return true;
+    }
+
+    //==============================================================================
+    /** Returns the number of elements in the queue. This is only a snapshot when the
+        other thread is using the queue.
+    */
+    int getNumReady() const noexcept
+    {
+        return (int) (LockFreeQueueHelpers::loadAcquire (writePosition) - LockFreeQueueHelpers::loadAcquire (readPosition));
+    }
+
+    /** Returns the number of elements the queue can hold. */
+    int getCapacity() const noexcept        { return (int) mask + 1; }
+
+private:
+    //==============================================================================
+    const uint32 mask;
+    ElementType* const elements;
+
+    // The producer and consumer data are kept on separate cache lines
+    char padding0 [LockFreeQueueHelpers::cacheLineSize];
+    Atomic<uint32> writePosition;
+    uint32 cachedReadPosition;          // producer's copy of readPosition
+    char padding1 [LockFreeQueueHelpers::cacheLineSize];
+    Atomic<uint32> readPosition;
+    uint32 cachedWritePosition;         // consumer's copy of writePosition
+    char padding2 [LockFreeQueueHelpers::cacheLineSize];
+
+    SGP_DECLARE_NON_COPYABLE (SPSCQueue)
+};
+
+//==============================================================================
+/**
+    A bounded, lock-free queue for any number of producer and consumer threads.
+
+    This is Dmitry Vyukov's bounded MPMC queue: every cell has a sequence number which
+    tells a producer whether the cell is free for its position, and a consumer whether
+    the cell has been filled for its position. A thread claims a position with one
+    compare-and-swap, and then only touches its own cell.
+
+    The element type is copied in and out, and must be default-constructible.
+
+    @see SPSCQueue
+*/
+template <typename ElementType>
+class MPMCQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue. The capacity is rounded up to a power of two. */
+    explicit MPMCQueue (const int capacity)
+        : mask (LockFreeQueueHelpers::roundUpToPowerOfTwo (capacity) - 1),
+          cells (new Cell [mask + 1])
+    {
+        for (uint32 i = 0; i <= mask; ++i)
+            cells[i].sequence.value = i;
+
+        Atomic<uint32>::memoryBarrier();
+    }
+
+    /** Destructor. */
+    ~MPMCQueue()
+    {
+        delete[] cells;
+    }
+
+    //==============================================================================
+    /** Adds an element.
+        @returns false if the queue is full
+    */
+    bool push (const ElementType& element)
+    {
+        Cell* cell;
+        uint32 position = enqueuePosition.value;
+
+        for (;;)
+        {
+            cell = cells + (position & mask);
+            const int32 diff = (int32) (LockFreeQueueHelpers::loadAcquire (cell->sequence) - position);
+
+            if (diff == 0)
+            {
+                if (enqueuePosition.compareAndSetBool (position + 1, position))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;   // the consumer of the previous lap has not read this cell yet
+            }
+
+            position = enqueuePosition.value;
+        }
+
+        cell->element = element;
+        LockFreeQueueHelpers::storeRelease (cell->sequence, position + 1);
+        return true;
+    }
+
+    /** Removes the oldest element.
+        @returns false if the queue is empty
+    */
+    bool pop (ElementType& element)
+    {
+        Cell* cell;
+        uint32 position = dequeuePosition.value;
+
+        for (;;)
+        {
+            cell = cells + (position & mask);
+            const int32 diff = (int32) (LockFreeQueueHelpers::loadAcquire (cell->sequence) - (position + 1));
+
+            if (diff == 0)
+            {
+                if (dequeuePosition.compareAndSetBool (position + 1, position))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;   // the producer has not filled this cell yet
+            }
+
+            position = dequeuePosition.value;
+        }
+
+        element = cell->element;
+        LockFreeQueueHelpers::storeRelease (cell->sequence, position + mask + 1);
+        return true;
+    }
+
+    //==============================================================================
+    /** Returns the number of elements in the queue. This is only a snapshot when other
+        threads are using the queue.
+    */
+    int getNumReady() const noexcept
+    {
+        const int32 numReady = (int32) (LockFreeQueueHelpers::loadAcquire (enqueuePosition) - LockFreeQueueHelpers::loadAcquire (dequeuePosition));
+        return jlimit (0, (int) mask + 1, (int) numReady);
+    }
+
+    /** Returns the number of elements the queue can hold. */
+    int getCapacity() const noexcept        { return (int) mask + 1; }
+
+private:
+    //==============================================================================
+    struct Cell
+    {
+        Atomic<uint32> sequence;
+        ElementType element;
+    };
+
+    const uint32 mask;
+    Cell* const cells;
+
+    char padding0 [LockFreeQueueHelpers::cacheLineSize];
+    Atomic<uint32> enqueuePosition;
+    char padding1 [LockFreeQueueHelpers::cacheLineSize];
+    Atomic<uint32> dequeuePosition;
+    char padding2 [LockFreeQueueHelpers::cacheLineSize];
+
+    SGP_DECLARE_NON_COPYABLE (MPMCQueue)
+};
+
+
+#endif   // __SGP_LOCKFREEQUEUE_HEADER__
@@ -72,6 +72,7 @@ void Thread::threadEntryPoint()
     }
     SGP_CATCH_ALL_ASSERT
 
+    LinearArena::releaseScratchArena();
     currentThreadHolder->value.releaseCurrentThreadStorage();
     closeThreadHandle();
 }
@@ -58,7 +58,7 @@ struct SGPCreationParameters
 
 
 		//! Type of video driver used to render graphics.
-		/** This can currently be SGPDT_DIRECT3D11, and SGPDT_OPENGL.
+		/** This can currently be SGPDT_DIRECT3D11, SGPDT_OPENGL and SGPDT_NULL.
 		Default: SGPDT_OPENGL. */
 		SGP_DRIVER_TYPE DriverType;
 
@@ -0,0 +1,55 @@
+//! constructor
+SGPDeviceNull::SGPDeviceNull(const SGPCreationParameters& params)
+	: CreationParams(params), m_pRenderDevice(nullptr), m_pTimer(nullptr),
+	m_pRandomizer(nullptr), m_pSoundManager(nullptr),
+	m_pLogger(params.plog), m_UserEventReceiver(params.EventReceiver),
+	bClosing(false)
+{
+	jassert( params.DriverType == SGPDT_NULL );
+
+	m_pTimer = new CSGPEngineTimer();
+	m_pTimer->setTime(0);
+	m_pRandomizer = new Random();
+
+	m_VideoModeList.setDesktop(32, params.WindowWidth, params.WindowHeight);
+
+	m_pRenderDevice = createNullDriver(CreationParams);
+	if( !m_pRenderDevice && m_pLogger )
+		m_pLogger->writeToLog(String("Could not create Null driver."), ELL_ERROR);
+}
+
+//! destructor
+SGPDeviceNull::~SGPDeviceNull()
+{
+	m_pRenderDevice = nullptr;
+	m_pTimer = nullptr;
+	m_pRandomizer = nullptr;
+	m_pSoundManager = nullptr;
+}
+
+//! runs the device. Returns false if device wants to be deleted
+bool SGPDeviceNull::run()
+{
+	m_pTimer->tick();
+
+	return !bClosing;
+}
+
+void SGPDeviceNull::yield()
+{
+	Thread::yield();
+}
+
+void SGPDeviceNull::sleep(uint32 timeMs, bool)
+{
+	Thread::sleep((int)timeMs);
+}
+
+//! send the event to the right receiver
+bool SGPDeviceNull::postEventFromUser(const SSGPEvent& event)
+{
+	if (m_UserEventReceiver)
+		return m_UserEventReceiver->OnEvent(event);
+
+	return false;
+}
@@ -0,0 +1,80 @@
+#ifndef	__SGP_DEVICENULL_HEADER__
+#define __SGP_DEVICENULL_HEADER__
+
+/*
+	Device without window, event loop or input, created by createDeviceEx() for SGPDT_NULL
+	on platforms which have no window device (Linux, Mac...).
+	It only owns the null render device, the timer and the randomizer, so tests and benchmarks
+	can drive the engine and inspect the command log on headless machines.
+*/
+class SGPDeviceNull : public SGPDevice
+{
+public:
+
+	//! constructor
+	SGPDeviceNull(const SGPCreationParameters& params);
+	//! destructor
+	virtual ~SGPDeviceNull();
+
+	//! runs the device. Returns false if device wants to be deleted
+	virtual bool run();
+
+	virtual void yield();
+	virtual void sleep(uint32 timeMs, bool pauseTimer);
+
+	virtual ISGPRenderDevice* getRenderDevice() { return m_pRenderDevice; }
+	virtual ISGPSoundManager* getSoundManager() { return m_pSoundManager; }
+	virtual void setSoundManager(ISGPSoundManager* pSoundManager) { m_pSoundManager = pSoundManager; }
+	virtual Logger* getLogger() { return m_pLogger; }
+	virtual ISGPVideoModeList* getVideoModeList() { return &m_VideoModeList; }
+	virtual ISGPTimer* getTimer() { return m_pTimer; }
+	virtual Random* getRandomizer() const { return m_pRandomizer; }
+
+	// There is no window
+	virtual void setWindowCaption(const wchar_t* ) {}
+	virtual bool isWindowActive() const { return true; }
+	virtual bool isWindowFocused() const { return true; }
+	virtual bool isWindowMinimized() const { return false; }
+	virtual bool isFullscreen() const { return false; }
+
+	//! notifies the device that it should close itself
+	virtual void closeDevice() { bClosing = true; }
+
+	virtual void setEventReceiver(ISGPEventReceiver* receiver) { m_UserEventReceiver = receiver; }
+	virtual ISGPEventReceiver* getEventReceiver() { return m_UserEventReceiver; }
+	virtual bool postEventFromUser(const SSGPEvent& event);
+
+	virtual void setResizable(bool ) {}
+	virtual void minimizeWindow() {}
+	virtual void maximizeWindow() {}
+	virtual void restoreWindow() {}
+
+	virtual bool activateJoysticks(Array<SSGPJoystickInfo>& ) { return false; }
+	virtual bool setGammaRamp( float , float , float , float , float ) { return false; }
+	virtual bool getGammaRamp( float &, float &, float &, float &, float & ) { return false; }
+	virtual void clearSystemMessages() {}
+
+	virtual bool IsWin32Device() const {return false;}
+	virtual bool IsLinuxDevice() const {return false;}
+	virtual bool IsMacOSXDevice() const {return false;}
+	virtual bool IsIOSDevice() const {return false;}
+	virtual bool IsAndroidDevice() const {return false;}
+
+private:
+	SGPCreationParameters		CreationParams;
+	CVideoModeList				m_VideoModeList;
+
+	ScopedPointer<ISGPRenderDevice>			m_pRenderDevice;
+	ScopedPointer<ISGPTimer>				m_pTimer;
+	ScopedPointer<Random>					m_pRandomizer;
+	ScopedPointer<ISGPSoundManager>			m_pSoundManager;
+
+	Logger*						m_pLogger;
+	ISGPEventReceiver*			m_UserEventReceiver;
+
+	bool	bClosing;
+
+	SGP_DECLARE_NON_COPYABLE (SGPDeviceNull)
+};
+
+#endif		// __SGP_DEVICENULL_HEADER__
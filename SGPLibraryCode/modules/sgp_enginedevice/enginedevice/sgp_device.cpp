@@ -30,14 +30,10 @@ extern "C" SGP_API SGPDevice* SGP_CALLTYPE createDeviceEx(const SGPCreationParam
 #if SGP_WINDOWS
 	dev = new (std::nothrow) SGPDeviceWin32(params);
 
-#elif SGP_LINUX
-	dev = new (std::nothrow) SGPDeviceLinux(params);
-
-#elif SGP_MAC
-	dev = new (std::nothrow) SGPDeviceMacOSX(params);
-
-#elif SGP_IOS
-#elif SGP_ANDROID
+#else
+	// There is no window device on other platforms yet, only the null device can be created
+	if( params.DriverType == SGPDT_NULL )
+		dev = new (std::nothrow) SGPDeviceNull(params);
 
 #endif
 
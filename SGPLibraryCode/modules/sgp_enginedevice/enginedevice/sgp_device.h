@@ -8,7 +8,7 @@ class ISGPRenderDevice;
 //! Creates an SGP Engine device. The SGP device is the root object for using the engine.
 /** If you need more parameters to be passed to the creation of the SGP Engine device,
 use the createDeviceEx() function.
-\param deviceType: Type of the device. This can currently be SGPDT_OPENGL, SGPDT_DIRECT3D11
+\param deviceType: Type of the device. This can currently be SGPDT_OPENGL, SGPDT_DIRECT3D11, SGPDT_NULL
 \param windowWidth: Width of the window or the video mode in fullscreen mode.
 \param windowHeight: Height of the window or the video mode in fullscreen mode.
 \param bits: Bits per pixel in fullscreen mode. Ignored if windowed mode.
@@ -267,6 +267,9 @@ public:
 			case SGPDT_OPENGL:
 				return true;
 
+			case SGPDT_NULL:
+				return true;
+
 			default:
 				return false;
 		}
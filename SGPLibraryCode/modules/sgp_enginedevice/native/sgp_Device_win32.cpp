@@ -468,6 +468,13 @@ ISGPRenderDevice* SGPDeviceWin32::createDriver()
 			m_pLogger->writeToLog(String("Could not create OpenGL driver."), ELL_ERROR);
 		}
 		break;
+	case SGPDT_NULL:
+		pDEV = createNullDriver(CreationParams);
+		if (!pDEV)
+		{
+			m_pLogger->writeToLog(String("Could not create Null driver."), ELL_ERROR);
+		}
+		break;
 	default:
 		m_pLogger->writeToLog(String("Unable to create video driver of unknown type."), ELL_ERROR);
 		break;
@@ -18,5 +18,6 @@ namespace sgp
 
 namespace sgp
 {
+#include "enginedevice/sgp_DeviceNull.cpp"
 #include "enginedevice/sgp_device.cpp"
 }
\ No newline at end of file
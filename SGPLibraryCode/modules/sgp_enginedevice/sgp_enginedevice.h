@@ -28,6 +28,9 @@ namespace sgp
 #ifndef	__SGP_DEVICE_HEADER__
  #include "enginedevice/sgp_device.h"
 #endif
+#ifndef	__SGP_DEVICENULL_HEADER__
+ #include "enginedevice/sgp_DeviceNull.h"
+#endif
 
 #if SGP_WINDOWS
  #include "native/sgp_Device_win32.h"
@@ -0,0 +1,97 @@
+
+void AABBoxArray::clear() noexcept
+{
+	m_MinX.clearQuick(); m_MinY.clearQuick(); m_MinZ.clearQuick();
+	m_MaxX.clearQuick(); m_MaxY.clearQuick(); m_MaxZ.clearQuick();
+}
+
+void AABBoxArray::ensureStorageAllocated(int nNumBoxes)
+{
+	m_MinX.ensureStorageAllocated(nNumBoxes); m_MinY.ensureStorageAllocated(nNumBoxes); m_MinZ.ensureStorageAllocated(nNumBoxes);
+	m_MaxX.ensureStorageAllocated(nNumBoxes); m_MaxY.ensureStorageAllocated(nNumBoxes); m_MaxZ.ensureStorageAllocated(nNumBoxes);
+}
+
+void AABBoxArray::add(const AABBox& aabb)
+{
+	add(aabb.vcMin, aabb.vcMax);
+}
+
+void AABBoxArray::add(const Vector3D& vcMin, const Vector3D& vcMax)
+{
+	m_MinX.add(vcMin.x); m_MinY.add(vcMin.y); m_MinZ.add(vcMin.z);
+	m_MaxX.add(vcMax.x); m_MaxY.add(vcMax.y); m_MaxZ.add(vcMax.z);
+}
+
+AABBox AABBoxArray::getBox(int index) const
+{
+	return AABBox( Vector3D(m_MinX[index], m_MinY[index], m_MinZ[index]),
+		Vector3D(m_MaxX[index], m_MaxY[index], m_MaxZ[index]) );
+}
+
+void AABBoxArray::cullToMask(const Frustum& frustum, uint32* pVisibleMask) const
+{
+	for( int nStart = 0; nStart < size(); nStart += 32 )
+		pVisibleMask[nStart >> 5] = cullBlock(frustum, nStart, jmin(32, size() - nStart));
+}
+
+int AABBoxArray::cullToIndices(const Frustum& frustum, int* pVisibleIndices) const
+{
+	int nNumVisible = 0;
+	for( int nStart = 0; nStart < size(); nStart += 32 )
+	{
+		uint32 nMask = cullBlock(frustum, nStart, jmin(32, size() - nStart));
+		for( int i = nStart; nMask != 0; i++, nMask >>= 1 )
+		{
+			if( nMask & 1 )
+				pVisibleIndices[nNumVisible++] = i;
+		}
+	}
+	return nNumVisible;
+}
+
+/**
+ * The same test as AABBox::Cull(): a box is culled if its extreme point in the
+ * direction of the (outwards) plane normal is in front of any plane.
+ * The extreme point depends on the normal sign only, so the min / max
+ * arrays are selected once per plane and 4 boxes are tested without branch.
+ */
+uint32 AABBoxArray::cullBlock(const Frustum& frustum, int nStart, int nCount) const
+{
+	const uint32 nAllMask = (nCount == 32) ? 0xFFFFFFFF : ((1u << nCount) - 1);
+	uint32 nCulledMask = 0;
+
+	for( int p = 0; (p < Frustum::VF_PLANE_COUNT) && (nCulledMask != nAllMask); p++ )
+	{
+		const Plane& plane = frustum.planes[p];
+		const float nx = plane.m_vcNormal.x;
+		const float ny = plane.m_vcNormal.y;
+		const float nz = plane.m_vcNormal.z;
+		const float d = plane.m_fDistance;
+
+		const float* px = (nx >= 0.0f) ? m_MinX.begin() + nStart : m_MaxX.begin() + nStart;
+		const float* py = (ny >= 0.0f) ? m_MinY.begin() + nStart : m_MaxY.begin() + nStart;
+		const float* pz = (nz >= 0.0f) ? m_MinZ.begin() + nStart : m_MaxZ.begin() + nStart;
+
+		int i = 0;
+#if SGP_MATH_USE_SSE
+		const __m128 vnx = _mm_set1_ps(nx);
+		const __m128 vny = _mm_set1_ps(ny);
+		const __m128 vnz = _mm_set1_ps(nz);
+		const __m128 vd = _mm_set1_ps(d);
+		const __m128 vzero = _mm_setzero_ps();
+		for( ; i + 4 <= nCount; i += 4 )
+		{
+			__m128 dist = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(px + i), vnx), _mm_mul_ps(_mm_loadu_ps(py + i), vny));
+			dist = _mm_add_ps(_mm_add_ps(dist, _mm_mul_ps(_mm_loadu_ps(pz + i), vnz)), vd);
+			nCulledMask |= (uint32)_mm_movemask_ps(_mm_cmpgt_ps(dist, vzero)) << i;
+		}
+#endif
+		for( ; i < nCount; i++ )
+		{
+			if( ((px[i]*nx + py[i]*ny + pz[i]*nz) + d) > 0.0f )
+				nCulledMask |= 1u << i;
+		}
+	}
+
+	return ~nCulledMask & nAllMask;
+}
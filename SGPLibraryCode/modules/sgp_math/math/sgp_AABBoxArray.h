@@ -0,0 +1,46 @@
+#ifndef __SGP_AABBOXARRAY_HEADER__
+#define __SGP_AABBOXARRAY_HEADER__
+
+//==============================================================================
+/**
+** Array of axis aligned bounding boxes stored as structure of arrays
+** (MinX[], MinY[], MinZ[], MaxX[], MaxY[], MaxZ[]) for batch frustum culling.
+** Boxes are culled 4 at a time with SSE (see sgp_math.h), otherwise one at a time;
+** the result of each box is the same as AABBox::Intersects(const Frustum&).
+*/
+class AABBoxArray
+{
+public:
+	AABBoxArray() {}
+
+	inline int size() const noexcept { return m_MinX.size(); }
+
+	// Remove all boxes, keeping allocated memory
+	void clear() noexcept;
+	void ensureStorageAllocated(int nNumBoxes);
+
+	void add(const AABBox& aabb);
+	void add(const Vector3D& vcMin, const Vector3D& vcMax);
+
+	AABBox getBox(int index) const;
+
+	// bit (i & 31) of pVisibleMask[i >> 5] is set if box i is not culled by the frustum,
+	// pVisibleMask must hold (size() + 31) / 32 uint32
+	void cullToMask(const Frustum& frustum, uint32* pVisibleMask) const;
+
+	// Write index of boxes not culled by the frustum into pVisibleIndices (must hold size() ints),
+	// return the number of visible boxes
+	int  cullToIndices(const Frustum& frustum, int* pVisibleIndices) const;
+
+private:
+	// Visible bits of up to 32 boxes from nStart
+	uint32 cullBlock(const Frustum& frustum, int nStart, int nCount) const;
+
+private:
+	Array<float> m_MinX, m_MinY, m_MinZ;
+	Array<float> m_MaxX, m_MaxY, m_MaxZ;
+
+	SGP_DECLARE_NON_COPYABLE (AABBoxArray)
+};
+
+#endif		// __SGP_AABBOXARRAY_HEADER__
@@ -1,283 +1,301 @@
 
 
-CollNode::CollNode()
+//==============================================================================
+/**
+	Binned SAH builder of CollisionSet bounding volume hierarchy.
+	Top levels of the tree are built in the calling thread, subtrees smaller than
+	a threshold are built into their own node arrays as JobScheduler jobs,
+	then spliced into the final node array.
+*/
+class CollisionBVHBuilder
 {
-	triangle = NULL;
-	front = NULL;
-	back = NULL;
-}
-
-CollNode::~CollNode()
-{
-	if (front != NULL) 
-		delete front;
-	front = NULL;
-	if (back  != NULL) 
-		delete back;
-	back = NULL;
-
-	CollisionTriangle *curr = triangle;
-	while(curr != NULL)
+public:
+	CollisionBVHBuilder(const Array<CollisionTriangle>& Tris)
+		: triangles(Tris)
 	{
-		CollisionTriangle *next = curr->next;
-		delete curr;
-		curr = next;
+		const int numTris = triangles.size();
+		triMin.resize(numTris);
+		triMax.resize(numTris);
+		triCentroid.resize(numTris);
+		triIndex.resize(numTris);
+
+		for( int i=0; i<numTris; i++ )
+		{
+			const CollisionTriangle& tri = triangles.getReference(i);
+			Vector3D& vMin = triMin.getReference(i);
+			Vector3D& vMax = triMax.getReference(i);
+			vMin.Set( jmin(tri.v[0].x, tri.v[1].x, tri.v[2].x), jmin(tri.v[0].y, tri.v[1].y, tri.v[2].y), jmin(tri.v[0].z, tri.v[1].z, tri.v[2].z) );
+			vMax.Set( jmax(tri.v[0].x, tri.v[1].x, tri.v[2].x), jmax(tri.v[0].y, tri.v[1].y, tri.v[2].y), jmax(tri.v[0].z, tri.v[1].z, tri.v[2].z) );
+			triCentroid.getReference(i) = (vMin + vMax) * 0.5f;
+			triIndex.getReference(i) = (uint32)i;
+		}
 	}
-}
 
-#define DIFF_IN_PLANE 0.05f
+	void build(Array<CollisionBVHNode>& outNodes)
+	{
+		const uint32 numTris = (uint32)triangles.size();
+		JobScheduler& scheduler = JobScheduler::getSharedScheduler();
+		const int numThreads = scheduler.getNumWorkers() + 1;
 
-void CollNode::build(SortedSet <CollisionTriangle *> &triangles, const uint32 cutWeight, const uint32 diffWeight, const uint32 coplanarWeight)
-{
+		outNodes.clearQuick();
+		outNodes.ensureStorageAllocated( 2 * numTris );
+		outNodes.add( CollisionBVHNode() );
 
-	// Try to find the "best" triangle plane to split along
-	uint32 best = 0xFFFFFFFF;
-	uint32 bestIndex = 0;
+		// Subtrees smaller than this are built as parallel tasks
+		const uint32 taskThreshold = (numThreads > 1) ? jmax( MIN_TASK_TRIANGLES, numTris / (numThreads * 4) ) : numTris;
+		buildNode( outNodes, 0, 0, numTris, 0, taskThreshold );
 
-	for(int32 i = 0; i < triangles.size(); i++)
-	{
-		Vector3D norm;
-		norm.Cross(triangles[i]->v[2] - triangles[i]->v[0], triangles[i]->v[1] - triangles[i]->v[0]);
-		norm.Normalize();
-		float off = -(norm * triangles[i]->v[0]);
-
-		uint32 value = 0;
-		int32 diff = 0;
-		for(int32 j = 0; j < triangles.size(); j++)
+		if( tasks.size() > 0 )
 		{
-			uint32 pos = 0;
-			uint32 neg = 0;
+			// One job per subtree, the calling thread builds subtrees too while it waits
+			TaskRunner runner = { this };
+			scheduler.parallelFor( 0, tasks.size(), runner, 1 );
 
-			for(uint32 k = 0; k < 3; k++)
+			// Splice task nodes, the task root replaces its placeholder node
+			for( int i=0; i<tasks.size(); i++ )
 			{
-				float d = triangles[j]->v[k] * norm + off;
-				if(std::fabs(d) > DIFF_IN_PLANE)
+				const Array<CollisionBVHNode>& taskNodes = tasks[i]->nodes;
+				const uint32 indexOffset = (uint32)outNodes.size() - 1;
+
+				for( int j=1; j<taskNodes.size(); j++ )
 				{
-					if(d > 0) 
-						pos++;
-					else 
-						neg++;
+					CollisionBVHNode node = taskNodes[j];
+					if( node.count == 0 )
+						node.index += indexOffset;
+					outNodes.add( node );
 				}
-			}
 
-			if(pos)
-			{
-				if(neg)
-					value += cutWeight;
-				else 
-					diff += diffWeight;
-			} 
-			else 
-			{
-				if(neg) 
-					diff -= diffWeight;
-				else 
-					value += coplanarWeight;
+				CollisionBVHNode root = taskNodes[0];
+				if( root.count == 0 )
+					root.index += indexOffset;
+				outNodes.getReference( tasks[i]->nodeIndex ) = root;
 			}
 		}
-		value += std::abs(diff);
-
-		if(value < best)
-		{
-			best = value;
-			bestIndex = i;
-		}
 	}
 
-	// The "best" plane
-	normal.Cross(triangles[bestIndex]->v[2] - triangles[bestIndex]->v[0], triangles[bestIndex]->v[1] - triangles[bestIndex]->v[0]);
-	normal.Normalize();
-	offset = -(normal * triangles[bestIndex]->v[0]);
-
-	SortedSet <CollisionTriangle *> frontTris;
-	SortedSet <CollisionTriangle *> backTris;
+	// Triangle order after building, leaves reference triangles in this order
+	const Array<uint32>& getTriangleIndices() const { return triIndex; }
 
-	// Split into back and front list, and a list of triangles that are in the plane
-	for(int32 j = 0; j < triangles.size(); j++)
+private:
+	//==============================================================================
+	struct BuildTask
 	{
-		float d[3];
-		uint32 pos = 0;
-		uint32 neg = 0;
-		for(uint32 k = 0; k < 3; k++)
-		{
-			d[k] = triangles[j]->v[k] * normal + offset;
-			if(std::fabs(d[k]) > DIFF_IN_PLANE)
-			{
-				if(d[k] > 0)
-					pos++;
-				else
-					neg++;
-			}
-		}
+		int nodeIndex;						// Placeholder node in final node array
+		uint32 first;
+		uint32 count;
+		int depth;							// Depth of the placeholder node
+		Array<CollisionBVHNode> nodes;		// Nodes of the subtree, root is nodes[0]
+	};
+
+	struct Bin
+	{
+		Vector3D vcMin, vcMax;
+		uint32 count;
+	};
 
-		if(pos && neg)
-		{ 
-			// Plane cuts the triangle
-			frontTris.add(triangles[j]);
-			backTris.add(new CollisionTriangle(triangles[j]->v[0], triangles[j]->v[1], triangles[j]->v[2], triangles[j]->auxData));
-
-		} 
-		else if(pos)
-		{ 
-			// Front triangle
-			frontTris.add(triangles[j]);
-		} 
-		else if(neg)
-		{ 
-			// Back triangle
-			backTris.add(triangles[j]);
-		} 
-		else
-		{ 
-			// Triangle in the plane
-			triangles[j]->next = triangle;
-			triangle = triangles[j];
-		}
+	static const int NUM_BINS = 16;
+	static const uint32 MAX_LEAF_TRIANGLES = 4;
+	static const uint32 MIN_TASK_TRIANGLES = 1024;
 
+	static float getArea(const Vector3D& vMin, const Vector3D& vMax)
+	{
+		Vector3D d = vMax - vMin;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
 	}
 
-	if(frontTris.size() > 0)
+	static void growBounds(Vector3D& vMin, Vector3D& vMax, const Vector3D& vPointMin, const Vector3D& vPointMax)
 	{
-		front = new CollNode();
-		front->build(frontTris, cutWeight, diffWeight, coplanarWeight);
+		vMin.Set( jmin(vMin.x, vPointMin.x), jmin(vMin.y, vPointMin.y), jmin(vMin.z, vPointMin.z) );
+		vMax.Set( jmax(vMax.x, vPointMax.x), jmax(vMax.y, vPointMax.y), jmax(vMax.z, vPointMax.z) );
 	}
 
-	if(backTris.size() > 0)
+	// Builds tasks [begin, end), called by JobScheduler::parallelFor()
+	struct TaskRunner
 	{
-		back = new CollNode();
-		back->build(backTris, cutWeight, diffWeight, coplanarWeight);
-	}
-}
+		void operator() (int begin, int end) const
+		{
+			for( int i=begin; i<end; i++ )
+				owner->runTask( *owner->tasks[i] );
+		}
 
-bool CollNode::intersect(const Vector3D &v0, const Vector3D &v1, Vector3D *point, bool solid, void **auxData) const
-{
-	float d0 = (normal * v0) + offset;
-	float d1 = (normal * v1) + offset;
+		CollisionBVHBuilder* owner;
+	};
+
+	void runTask(BuildTask& task)
+	{
+		task.nodes.ensureStorageAllocated( 2 * task.count );
+		task.nodes.add( CollisionBVHNode() );
+		buildNode( task.nodes, 0, task.first, task.count, task.depth, 0 );
+	}
 
-	if(d0 > 0)
+	// Build node nodeIndex (at depth) from triIndex[first] to triIndex[first+count-1],
+	// if taskThreshold is not 0, child with no more than taskThreshold triangles is added as a task
+	void buildNode(Array<CollisionBVHNode>& outNodes, int nodeIndex, uint32 first, uint32 count, int depth, uint32 taskThreshold)
 	{
-		if(front != NULL && front->intersect(v0, v1, point, solid, auxData)) 
-			return true;
-		if(d1 < 0)
+		Vector3D vMin(FLT_MAX, FLT_MAX, FLT_MAX), vMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		Vector3D cMin(FLT_MAX, FLT_MAX, FLT_MAX), cMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		for( uint32 i=first; i<first+count; i++ )
 		{
-			if(isect(v0, v1, point, auxData)) 
-				return true;
-			if(back != NULL && back->intersect(v0, v1, point, solid, auxData))
-				return true;
+			uint32 t = triIndex[i];
+			growBounds( vMin, vMax, triMin[t], triMax[t] );
+			growBounds( cMin, cMax, triCentroid[t], triCentroid[t] );
 		}
-	} 
-	else 
-	{
-		if(back != NULL && back->intersect(v0, v1, point, solid, auxData)) 
-			return true;
-		if(d1 > 0)
+
 		{
-			if(!solid && isect(v0, v1, point, auxData))
-				return true;
-			if(front != NULL && front->intersect(v0, v1, point, solid, auxData))
-				return true;
+			CollisionBVHNode& node = outNodes.getReference(nodeIndex);
+			node.vcMin = vMin;
+			node.vcMax = vMax;
+			node.index = first;
+			node.count = count;
 		}
-	}
 
-	return false;
-}
+		// Nodes at the depth limit stay leaves, whatever their triangle number
+		if( (count <= 1) || (depth >= CollisionSet::MAX_TREE_DEPTH) )
+			return;
 
+		// Binned SAH on all three axes
+		const float cExtent[3] = { cMax.x - cMin.x, cMax.y - cMin.y, cMax.z - cMin.z };
+		const float cStart[3] = { cMin.x, cMin.y, cMin.z };
 
-bool CollNode::isect(const Vector3D &v0, const Vector3D &v1, Vector3D *point, void **auxData) const 
-{
-	CollisionTriangle *curr = triangle;
+		float bestCost = FLT_MAX;
+		int bestAxis = -1;
+		int bestSplit = 0;
+
+		for( int axis=0; axis<3; axis++ )
+		{
+			if( cExtent[axis] <= 0.0f )
+				continue;
 
-	float k = (normal * v0 + offset) / (normal * (v0 - v1));
-	Vector3D p = v0 + (v1 - v0) * k;
+			Bin bins[NUM_BINS];
+			for( int b=0; b<NUM_BINS; b++ )
+			{
+				bins[b].vcMin.Set(FLT_MAX, FLT_MAX, FLT_MAX);
+				bins[b].vcMax.Set(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+				bins[b].count = 0;
+			}
 
-	while(curr != NULL)
-	{
-		// Find interpolation constant
-		uint32 prev = 2;
-		bool result = true;
-		for(uint32 i = 0; i < 3; i++)
+			const float binScale = NUM_BINS / cExtent[axis];
+			for( uint32 i=first; i<first+count; i++ )
+			{
+				uint32 t = triIndex[i];
+				Bin& bin = bins[ getBinIndex(triCentroid[t], axis, cStart[axis], binScale) ];
+				growBounds( bin.vcMin, bin.vcMax, triMin[t], triMax[t] );
+				bin.count++;
+			}
+
+			// Sweep from right to left for the right side area and count
+			float rightArea[NUM_BINS];
+			uint32 rightCount[NUM_BINS];
+			Vector3D rMin(FLT_MAX, FLT_MAX, FLT_MAX), rMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			uint32 nRight = 0;
+			for( int b=NUM_BINS-1; b>0; b-- )
+			{
+				if( bins[b].count > 0 )
+					growBounds( rMin, rMax, bins[b].vcMin, bins[b].vcMax );
+				nRight += bins[b].count;
+				rightArea[b] = (nRight > 0) ? getArea(rMin, rMax) : 0.0f;
+				rightCount[b] = nRight;
+			}
+
+			Vector3D lMin(FLT_MAX, FLT_MAX, FLT_MAX), lMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+			uint32 nLeft = 0;
+			for( int b=0; b<NUM_BINS-1; b++ )
+			{
+				if( bins[b].count > 0 )
+					growBounds( lMin, lMax, bins[b].vcMin, bins[b].vcMax );
+				nLeft += bins[b].count;
+
+				// split between bin b and b+1
+				if( nLeft == 0 || rightCount[b+1] == 0 )
+					continue;
+				float cost = getArea(lMin, lMax) * nLeft + rightArea[b+1] * rightCount[b+1];
+				if( cost < bestCost )
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = b;
+				}
+			}
+		}
+
+		// All centroids at the same point, can not be split
+		if( bestAxis == -1 )
+			return;
+
+		// Split cost (traversal cost 1) against leaf cost, in unit of triangle test
+		const float nodeArea = getArea(vMin, vMax);
+		const float splitCost = 1.0f + ((nodeArea > 0.0f) ? (bestCost / nodeArea) : (float)count);
+		if( (count <= MAX_LEAF_TRIANGLES) && (splitCost >= (float)count) )
+			return;
+
+		// Partition triangle indices
+		const float binScale = NUM_BINS / cExtent[bestAxis];
+		uint32 i = first;
+		uint32 j = first + count - 1;
+		while( i <= j )
 		{
-			Vector3D edgeNormal;
-			edgeNormal.Cross(normal, curr->v[i] - curr->v[prev]);
-			if( (edgeNormal * p) - (edgeNormal * curr->v[i]) < 0 )
+			if( getBinIndex(triCentroid[triIndex[i]], bestAxis, cStart[bestAxis], binScale) <= bestSplit )
+				i++;
+			else
 			{
-				result = false;
-				break;
+				triIndex.swap(i, j);
+				if( j == 0 )
+					break;
+				j--;
 			}
-			prev = i;
 		}
+		const uint32 leftCount = i - first;
+		jassert( leftCount > 0 && leftCount < count );
 
-		if(result)
+		const int leftIndex = outNodes.size();
+		outNodes.add( CollisionBVHNode() );
+		outNodes.add( CollisionBVHNode() );
 		{
-			if(point != NULL)
-				*point = p;
-			if(auxData != NULL)
-				*auxData = curr->auxData;
-			return true;
+			CollisionBVHNode& node = outNodes.getReference(nodeIndex);
+			node.index = (uint32)leftIndex;
+			node.count = 0;
 		}
-		
-		curr = curr->next;
-	}
-	return false;
-}
 
-bool CollNode::pushSphere(Vector3D &pos, const float radius) const 
-{
-	float d = (pos * normal) + offset;
+		buildChild( outNodes, leftIndex, first, leftCount, depth + 1, taskThreshold );
+		buildChild( outNodes, leftIndex + 1, first + leftCount, count - leftCount, depth + 1, taskThreshold );
+	}
 
-	bool pushed = false;
-	if(std::fabs(d) < radius)
+	void buildChild(Array<CollisionBVHNode>& outNodes, int nodeIndex, uint32 first, uint32 count, int depth, uint32 taskThreshold)
 	{
-		CollisionTriangle *above = aboveTriangle(pos);
-
-		if(above != NULL)
+		if( (taskThreshold > 0) && (count <= taskThreshold) )
 		{
-			pos +=  normal * (radius - d); 
-			pushed = true;
+			BuildTask* pTask = new BuildTask();
+			pTask->nodeIndex = nodeIndex;
+			pTask->first = first;
+			pTask->count = count;
+			pTask->depth = depth;
+			tasks.add( pTask );
 		}
+		else
+			buildNode( outNodes, nodeIndex, first, count, depth, taskThreshold );
 	}
 
-	if(front != NULL && d > -radius)
-		pushed |= front->pushSphere(pos, radius);
-	if(back  != NULL && d <  radius)
-		pushed |= back ->pushSphere(pos, radius);
-
-	return pushed;
-}
-
-CollisionTriangle *CollNode::aboveTriangle(const Vector3D &pos) const
-{
-	CollisionTriangle *curr = triangle;
-
-	while(curr != NULL)
+	static int getBinIndex(const Vector3D& vCentroid, int axis, float start, float binScale)
 	{
+		const float c = (axis == 0) ? vCentroid.x : ((axis == 1) ? vCentroid.y : vCentroid.z);
+		return jlimit( 0, NUM_BINS - 1, (int)((c - start) * binScale) );
+	}
 
-		uint32 prev = 2;
-		bool result = true;
-		for(uint32 i = 0; i < 3; i++)
-		{
-			Vector3D edgeNormal;
-			edgeNormal.Cross(normal, curr->v[i] - curr->v[prev]);
-			if( (edgeNormal * pos) - (edgeNormal * curr->v[i]) < 0 )
-			{
-				result = false;
-				break;
-			}
-			prev = i;
-		}
+private:
+	const Array<CollisionTriangle>& triangles;
 
-		if(result)	
-			return curr;
+	Array<Vector3D> triMin, triMax, triCentroid;
+	Array<uint32> triIndex;
 
-		curr = curr->next;
-	}
+	OwnedArray<BuildTask> tasks;
 
-	return NULL;
-}
+	SGP_DECLARE_NON_COPYABLE (CollisionBVHBuilder)
+};
 
+
+//==============================================================================
 CollisionSet::CollisionSet()
 {
-	top = NULL;
 }
 
 
@@ -288,38 +306,189 @@ CollisionSet::~CollisionSet()
 
 void CollisionSet::release()
 {
-	if(top != NULL) 
-		delete top;
-	top = NULL;
+	triangles.clear();
+	nodes.clear();
 }
 
-void CollisionSet::build(const uint32 cutWeight, const uint32 diffWeight, const uint32 coplanarWeight)
+void CollisionSet::build()
 {
-	if(top != NULL) 
-		delete top;
+	nodes.clear();
 
 	if(triangles.size() > 0)
 	{
-		top = new CollNode();
-		top->build(triangles, cutWeight, diffWeight, coplanarWeight);
-
-		triangles.clear();
+		CollisionBVHBuilder builder(triangles);
+		builder.build(nodes);
+
+		// Reorder triangles so that leaves reference contiguous triangles
+		const Array<uint32>& triIndex = builder.getTriangleIndices();
+		Array<CollisionTriangle> sortedTriangles;
+		sortedTriangles.ensureStorageAllocated(triangles.size());
+		for(int i = 0; i < triIndex.size(); i++)
+			sortedTriangles.add(triangles[triIndex[i]]);
+		triangles.swapWithArray(sortedTriangles);
 	}
 }
 
-bool CollisionSet::intersect(const Vector3D &v0, const Vector3D &v1, Vector3D *point, bool solid, void **auxData) const 
+bool CollisionSet::intersect(const Vector3D &v0, const Vector3D &v1, Vector3D *point, bool solid, void **auxData) const
 {
-	if(top != NULL) 
-		return top->intersect(v0, v1, point, solid, auxData);
-	return false;
+	if(nodes.size() == 0)
+		return false;
+
+	const bool anyHit = (point == NULL) && (auxData == NULL);
+	const Vector3D dir = v1 - v0;
+	const float origin[3] = { v0.x, v0.y, v0.z };
+	const float direction[3] = { dir.x, dir.y, dir.z };
+	float invDir[3];
+	for(int a = 0; a < 3; a++)
+		invDir[a] = (direction[a] != 0.0f) ? 1.0f / direction[a] : 0.0f;
+
+	float bestT = 1.0f;
+	const CollisionTriangle *bestTri = NULL;
+
+	// Each level of the tree leaves at most one sibling on the stack
+	uint32 stack[MAX_TREE_DEPTH + 1];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize > 0)
+	{
+		const CollisionBVHNode &node = nodes.getReference(stack[--stackSize]);
+
+		// Segment against node bounding box, clipped by the nearest intersection found
+		const float bMin[3] = { node.vcMin.x, node.vcMin.y, node.vcMin.z };
+		const float bMax[3] = { node.vcMax.x, node.vcMax.y, node.vcMax.z };
+		float tNear = 0.0f;
+		float tFar = bestT;
+		bool bOutside = false;
+		for(int a = 0; a < 3 && !bOutside; a++)
+		{
+			if(direction[a] == 0.0f)
+			{
+				bOutside = (origin[a] < bMin[a]) || (origin[a] > bMax[a]);
+				continue;
+			}
+			float t0 = (bMin[a] - origin[a]) * invDir[a];
+			float t1 = (bMax[a] - origin[a]) * invDir[a];
+			if(t0 > t1)
+				std::swap(t0, t1);
+			tNear = jmax(tNear, t0);
+			tFar = jmin(tFar, t1);
+			bOutside = (tNear > tFar);
+		}
+		if(bOutside)
+			continue;
+
+		if(node.count == 0)
+		{
+			jassert(stackSize + 2 <= MAX_TREE_DEPTH + 1);
+			stack[stackSize++] = node.index + 1;
+			stack[stackSize++] = node.index;
+			continue;
+		}
+
+		for(uint32 i = node.index; i < node.index + node.count; i++)
+		{
+			const CollisionTriangle &tri = triangles.getReference(i);
+
+			float d0 = (tri.normal * v0) + tri.offset;
+			float d1 = (tri.normal * v1) + tri.offset;
+
+			if(d0 > 0)
+			{
+				if(d1 >= 0)
+					continue;
+			}
+			else
+			{
+				if(d1 <= 0 || (solid && !(tri.doubleSided && d0 < 0)))
+					continue;
+			}
+
+			float k = d0 / (d0 - d1);
+			if(k >= bestT)
+				continue;
+
+			Vector3D p = v0 + dir * k;
+			if(!isAboveTriangle(tri, p))
+				continue;
+
+			bestT = k;
+			bestTri = &tri;
+			if(anyHit)
+				return true;
+		}
+	}
+
+	if(bestTri == NULL)
+		return false;
+
+	if(point != NULL)
+		*point = v0 + dir * bestT;
+	if(auxData != NULL)
+		*auxData = bestTri->auxData;
+	return true;
 }
 
 
 
-bool CollisionSet::pushSphere(Vector3D &pos, const float radius) const 
+bool CollisionSet::pushSphere(Vector3D &pos, const float radius) const
 {
-	if(top != NULL)
-		return top->pushSphere(pos, radius);
+	if(nodes.size() == 0)
+		return false;
+
+	bool pushed = false;
+
+	// Each level of the tree leaves at most one sibling on the stack
+	uint32 stack[MAX_TREE_DEPTH + 1];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while(stackSize > 0)
+	{
+		const CollisionBVHNode &node = nodes.getReference(stack[--stackSize]);
+
+		if( pos.x < node.vcMin.x - radius || pos.x > node.vcMax.x + radius ||
+			pos.y < node.vcMin.y - radius || pos.y > node.vcMax.y + radius ||
+			pos.z < node.vcMin.z - radius || pos.z > node.vcMax.z + radius )
+			continue;
 
-	return false;
+		if(node.count == 0)
+		{
+			jassert(stackSize + 2 <= MAX_TREE_DEPTH + 1);
+			stack[stackSize++] = node.index + 1;
+			stack[stackSize++] = node.index;
+			continue;
+		}
+
+		for(uint32 i = node.index; i < node.index + node.count; i++)
+		{
+			const CollisionTriangle &tri = triangles.getReference(i);
+
+			float d = (pos * tri.normal) + tri.offset;
+			if(std::fabs(d) < radius && isAboveTriangle(tri, pos))
+			{
+				// Push out of the face the sphere is on for double sided triangle
+				float target = (tri.doubleSided && d < 0) ? -radius : radius;
+				pos += tri.normal * (target - d);
+				pushed = true;
+			}
+		}
+	}
+
+	return pushed;
+}
+
+bool CollisionSet::isAboveTriangle(const CollisionTriangle &tri, const Vector3D &pos)
+{
+	// Edge normals point out of the triangle with its own plane normal
+	uint32 prev = 2;
+	for(uint32 i = 0; i < 3; i++)
+	{
+		Vector3D edgeNormal;
+		edgeNormal.Cross(tri.normal, tri.v[i] - tri.v[prev]);
+		if( (edgeNormal * pos) - (edgeNormal * tri.v[i]) > 0 )
+			return false;
+		prev = i;
+	}
+	return true;
 }
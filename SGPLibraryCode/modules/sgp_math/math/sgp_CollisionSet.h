@@ -4,45 +4,45 @@
 
 struct CollisionTriangle 
 {
-	CollisionTriangle(const Vector3D &v0, const Vector3D &v1, const Vector3D &v2, void *aData)
+	CollisionTriangle() : auxData(NULL), offset(0), doubleSided(false) {}
+	CollisionTriangle(const Vector3D &v0, const Vector3D &v1, const Vector3D &v2, void *aData, bool bDoubleSided = false)
 	{
 		v[0] = v0;
 		v[1] = v1;
 		v[2] = v2;
 		auxData = aData;
+		doubleSided = bDoubleSided;
+
+		normal.Cross(v2 - v0, v1 - v0);
+		normal.Normalize();
+		offset = -(normal * v0);
 	}
 
 	Vector3D v[3];
-	CollisionTriangle *next;
 	void *auxData;
-};
-
-class CollNode 
-{
-public:
-	CollNode();
-	~CollNode();
-
-	void build(SortedSet <CollisionTriangle *> &triangles, const uint32 cutWeight, const uint32 diffWeight, const uint32 coplanarWeight);
-	bool intersect(const Vector3D &v0, const Vector3D &v1, Vector3D *point = NULL, bool solid = true, void **auxData = NULL) const;
-
-	bool pushSphere(Vector3D &pos, const float radius) const;
 
-	CollisionTriangle *aboveTriangle(const Vector3D &pos) const;
-
-protected:
-	bool isect(const Vector3D &v0, const Vector3D &v1, Vector3D *point, void **auxData) const;
-	
-	Vector3D normal;
+	Vector3D normal;		// Triangle plane, front face is the side normal pointing to
 	float offset;
-
-	CollNode *front;
-	CollNode *back;
-
-	CollisionTriangle *triangle;
+	bool doubleSided;		// Collide with both faces (the same as adding the triangle with both windings)
 };
 
+/**
+	Node of the bounding volume hierarchy in CollisionSet
+	Interior node has two children at nodes[index] and nodes[index+1],
+	leaf node has triangles[index] to triangles[index+count-1].
+*/
+struct CollisionBVHNode
+{
+	Vector3D vcMin, vcMax;	// Bounding box of all triangles in the node
+	uint32 index;
+	uint32 count;			// Triangle number of leaf node, 0 for interior node
+};
 
+/**
+	Triangle collision set for segment intersection and sphere pushing (used by lightmap baking).
+	Triangles are organized in a bounding volume hierarchy built with binned SAH
+	(surface area heuristic), subtrees of the hierarchy are built in parallel.
+*/
 class CollisionSet 
 {
 public:
@@ -50,18 +50,30 @@ public:
 	~CollisionSet();
 
 	void release();
-	void addTriangle(const Vector3D &v0, const Vector3D &v1, const Vector3D &v2, void *auxData = NULL)
+	void addTriangle(const Vector3D &v0, const Vector3D &v1, const Vector3D &v2, void *auxData = NULL, bool doubleSided = false)
 	{
-		triangles.add(new CollisionTriangle(v0, v1, v2, auxData));
+		triangles.add(CollisionTriangle(v0, v1, v2, auxData, doubleSided));
 	}
-	void build(const uint32 cutWeight = 3, const uint32 diffWeight = 1, const uint32 coplanarWeight = 2);
+	void build();
+
+	// Find the intersection of segment v0-v1 nearest to v0.
+	// If solid, segment only collides with triangle front faces (both faces for double sided triangle)
+	// If both point and auxData are NULL, return at the first intersection found.
 	bool intersect(const Vector3D &v0, const Vector3D &v1, Vector3D *point = NULL, bool solid = true, void **auxData = NULL) const;
 	
 	bool pushSphere(Vector3D &pos, const float radius) const;
 
+	int getNumTriangles() const { return triangles.size(); }
+	int getNumNodes() const { return nodes.size(); }
+
+	// Deeper nodes are not split, so traversal stacks of MAX_TREE_DEPTH + 1 entries never overflow
+	static const int MAX_TREE_DEPTH = 48;
+
 protected:
-	SortedSet <CollisionTriangle *> triangles;
-	CollNode *top;
+	static bool isAboveTriangle(const CollisionTriangle &tri, const Vector3D &pos);
+
+	Array<CollisionTriangle> triangles;
+	Array<CollisionBVHNode> nodes;
 };
 
 
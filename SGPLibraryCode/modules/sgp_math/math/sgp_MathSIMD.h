@@ -0,0 +1,110 @@
+#ifndef __SGP_MATHSIMD_HEADER__
+#define __SGP_MATHSIMD_HEADER__
+
+//==============================================================================
+/*
+    SIMD kernels of the core Matrix4x4 / Vector4D operations working on raw floats
+	(a Matrix4x4 is 16 row major floats, a Vector4D is 4 floats).
+	SSE intrinsics are used on x86 / x64, otherwise the Scalar version is used.
+	The Scalar versions are also the reference implementation for the SIMD ones.
+*/
+
+//==============================================================================
+// pM = pA * pB, pM must not be pA or pB
+inline void MatrixMultiplyScalar(const float* pA, const float* pB, float* pM) noexcept
+{
+	for(int i=0; i<4; i++)
+	{
+		for(int j=0; j<4; j++)
+		{
+			pM[4*i+j] = pA[4*i]   * pB[j] +
+						pA[4*i+1] * pB[4+j] +
+						pA[4*i+2] * pB[8+j] +
+						pA[4*i+3] * pB[12+j];
+		}
+	}
+}
+
+// pOut = (x, y, z, 1) * pM, then divided by w
+inline void Vector4TransformCoordScalar(const float* pV, const float* pM, float* pOut) noexcept
+{
+	float x = pV[0]*pM[0] + pV[1]*pM[4] + pV[2]*pM[8]  + pM[12];
+	float y = pV[0]*pM[1] + pV[1]*pM[5] + pV[2]*pM[9]  + pM[13];
+	float z = pV[0]*pM[2] + pV[1]*pM[6] + pV[2]*pM[10] + pM[14];
+	float w = pV[0]*pM[3] + pV[1]*pM[7] + pV[2]*pM[11] + pM[15];
+
+	pOut[0] = x / w;
+	pOut[1] = y / w;
+	pOut[2] = z / w;
+	pOut[3] = 1.0f;
+}
+
+// pA = pA * (1-t) + pB * t
+inline void MatrixLerpScalar(float* pA, const float* pB, float t) noexcept
+{
+	for(int i=0; i<16; i++)
+		pA[i] = pA[i] * (1-t) + pB[i] * t;
+}
+
+
+//==============================================================================
+#if SGP_MATH_USE_SSE
+
+inline void MatrixMultiply(const float* pA, const float* pB, float* pM) noexcept
+{
+	const __m128 b0 = _mm_loadu_ps(pB);
+	const __m128 b1 = _mm_loadu_ps(pB + 4);
+	const __m128 b2 = _mm_loadu_ps(pB + 8);
+	const __m128 b3 = _mm_loadu_ps(pB + 12);
+
+	for(int i=0; i<4; i++)
+	{
+		__m128 r = _mm_mul_ps(_mm_set1_ps(pA[4*i]), b0);
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(pA[4*i+1]), b1));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(pA[4*i+2]), b2));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(pA[4*i+3]), b3));
+		_mm_storeu_ps(pM + 4*i, r);
+	}
+}
+
+inline void Vector4TransformCoord(const float* pV, const float* pM, float* pOut) noexcept
+{
+	__m128 r = _mm_mul_ps(_mm_set1_ps(pV[0]), _mm_loadu_ps(pM));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(pV[1]), _mm_loadu_ps(pM + 4)));
+	r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(pV[2]), _mm_loadu_ps(pM + 8)));
+	r = _mm_add_ps(r, _mm_loadu_ps(pM + 12));
+	r = _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+	_mm_storeu_ps(pOut, r);
+	pOut[3] = 1.0f;
+}
+
+inline void MatrixLerp(float* pA, const float* pB, float t) noexcept
+{
+	const __m128 t0 = _mm_set1_ps(1-t);
+	const __m128 t1 = _mm_set1_ps(t);
+
+	for(int i=0; i<16; i+=4)
+		_mm_storeu_ps(pA + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pA + i), t0), _mm_mul_ps(_mm_loadu_ps(pB + i), t1)));
+}
+
+//==============================================================================
+#else
+
+inline void MatrixMultiply(const float* pA, const float* pB, float* pM) noexcept
+{
+	MatrixMultiplyScalar(pA, pB, pM);
+}
+
+inline void Vector4TransformCoord(const float* pV, const float* pM, float* pOut) noexcept
+{
+	Vector4TransformCoordScalar(pV, pM, pOut);
+}
+
+inline void MatrixLerp(float* pA, const float* pB, float t) noexcept
+{
+	MatrixLerpScalar(pA, pB, t);
+}
+
+#endif
+
+#endif		// __SGP_MATHSIMD_HEADER__
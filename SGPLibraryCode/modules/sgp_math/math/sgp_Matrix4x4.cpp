@@ -112,22 +112,7 @@ Matrix4x4 Matrix4x4::operator * (const Matrix4x4 &m) const
 		MatrixMult((float*)this, (float*)&m, (float*)&mResult);
 	}
 #else
-	float *pA = (float*)this;
-	float *pB = (float*)&m;
-	float *pM = (float*)&mResult;
-
-	memset(pM, 0, sizeof(Matrix4x4));
-
-	for(unsigned char i=0; i<4; i++) 
-	{
-		for(unsigned char j=0; j<4; j++) 
-		{
-			pM[4*i+j] += pA[4*i]   * pB[j];
-			pM[4*i+j] += pA[4*i+1] * pB[4+j];
-			pM[4*i+j] += pA[4*i+2] * pB[8+j];
-			pM[4*i+j] += pA[4*i+3] * pB[12+j];
-		}
-	}
+	MatrixMultiply((const float*)this, (const float*)&m, (float*)&mResult);
 #endif
 	return mResult;
 }
@@ -238,25 +223,7 @@ void Matrix4x4::InverseOf(const Matrix4x4 &m)
 
 Matrix4x4& Matrix4x4::Lerp(const Matrix4x4 &m2, float t)
 {
-	this->_11 = this->_11 * (1-t) + m2._11 * t; 
-	this->_12 = this->_12 * (1-t) + m2._12 * t; 
-	this->_13 = this->_13 * (1-t) + m2._13 * t; 
-	this->_14 = this->_14 * (1-t) + m2._14 * t;
-
-	this->_21 = this->_21 * (1-t) + m2._21 * t; 
-	this->_22 = this->_22 * (1-t) + m2._22 * t; 
-	this->_23 = this->_23 * (1-t) + m2._23 * t; 
-	this->_24 = this->_24 * (1-t) + m2._24 * t;
-
-	this->_31 = this->_31 * (1-t) + m2._31 * t; 
-	this->_32 = this->_32 * (1-t) + m2._32 * t; 
-	this->_33 = this->_33 * (1-t) + m2._33 * t; 
-	this->_34 = this->_34 * (1-t) + m2._34 * t;
-
-	this->_41 = this->_41 * (1-t) + m2._41 * t; 
-	this->_42 = this->_42 * (1-t) + m2._42 * t; 
-	this->_43 = this->_43 * (1-t) + m2._43 * t; 
-	this->_44 = this->_44 * (1-t) + m2._44 * t;
+	MatrixLerp((float*)this, (const float*)&m2, t);
 
 	return *this;
 }
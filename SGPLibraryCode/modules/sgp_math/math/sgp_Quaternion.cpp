@@ -85,8 +85,9 @@ void Quaternion::GetMatrix(Matrix4x4 *pMat)
 {
 	float wx, wy, wz, xx, yy, yz, xy, xz, zz, x2, y2, z2;
 
-	// set matrix to identity
-	memset(pMat, 0, sizeof(Matrix4x4));
+	// last row and column of identity, the rest is all written below
+	pMat->_14 = pMat->_24 = pMat->_34 = 0.0f;
+	pMat->_41 = pMat->_42 = pMat->_43 = 0.0f;
 	pMat->_44 = 1.0f;
 
 	x2 = x + x; 
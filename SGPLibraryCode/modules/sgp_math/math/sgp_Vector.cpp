@@ -90,15 +90,7 @@ Vector4D Vector4D::operator * (const Matrix4x4 &m) const
 		}
 	}
 #else
-	vcResult.x = x*m._11 + y*m._21 + z*m._31 + m._41;
-	vcResult.y = x*m._12 + y*m._22 + z*m._32 + m._42;
-	vcResult.z = x*m._13 + y*m._23 + z*m._33 + m._43;
-	vcResult.w = x*m._14 + y*m._24 + z*m._34 + m._44;
-   
-	vcResult.x = vcResult.x/vcResult.w;
-	vcResult.y = vcResult.y/vcResult.w;
-	vcResult.z = vcResult.z/vcResult.w;
-	vcResult.w = 1.0f;
+	Vector4TransformCoord((const float*)this, (const float*)&m, (float*)&vcResult);
 #endif
 	return vcResult;
 }
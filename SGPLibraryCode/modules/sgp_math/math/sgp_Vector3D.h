@@ -16,9 +16,8 @@ public:
 	Vector3D() noexcept : x(0), y(0), z(0) {}
 	//! Constructor with two different values
 	Vector3D(float nx, float ny, float nz) noexcept : x(nx), y(ny), z(nz) {}
-	//! Copy constructor
-	Vector3D(const Vector3D& other) noexcept : x(other.x), y(other.y), z(other.z) {}
-    Vector3D& operator = (const Vector3D& other) noexcept { x = other.x; y = other.y; z = other.z; return *this; }
+	// The compiler generated copy constructor and assignment keep the class trivially copyable,
+	// so arrays of Vector3D (and of structs holding them) can be moved with realloc / memmove
 
 	inline void Set(float _x, float _y, float _z) noexcept { x=_x; y=_y; z=_z; }
 	inline void Set(const Vector3D &v) noexcept { x=v.x; y=v.y; z=v.z; }
@@ -18,6 +18,7 @@ namespace sgp
 #include "math/sgp_Plane.cpp"
 #include "math/sgp_Quaternion.cpp"
 #include "math/sgp_Frustum.cpp"
+#include "math/sgp_AABBoxArray.cpp"
 #include "math/sgp_Uuid.cpp"
 #include "math/sgp_CollisionSet.cpp"
 }
@@ -3,11 +3,25 @@
 
 #include "../sgp_core/sgp_core.h"
 
+//==============================================================================
+// SIMD intrinsics used by math/sgp_MathSIMD.h
+// MSVC Win32 builds keep their inline assembly and do not use these kernels,
+// builds without SSE (e.g. ARM) use the Scalar versions.
+#if ! (SGP_MSVC && SGP_WIN32)
+ #if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SGP_MATH_USE_SSE 1
+  #include <xmmintrin.h>
+ #endif
+#endif
+
 namespace sgp
 {
 #ifndef __SPG_MATHHELPER_HEADER__
  #include "math/sgp_MathHelper.h"
 #endif
+#ifndef __SGP_MATHSIMD_HEADER__
+ #include "math/sgp_MathSIMD.h"
+#endif
 #ifndef __SGP_VECTOR2D_HEADER__
  #include "math/sgp_Vector2D.h"
 #endif
@@ -41,6 +55,9 @@ namespace sgp
 #ifndef __SGP_FRUSTUM_HEADER__
  #include "math/sgp_Frustum.h"
 #endif
+#ifndef __SGP_AABBOXARRAY_HEADER__
+ #include "math/sgp_AABBoxArray.h"
+#endif
 #ifndef __SGP_UUID_HEADER__
  #include "math/sgp_Uuid.h"
 #endif
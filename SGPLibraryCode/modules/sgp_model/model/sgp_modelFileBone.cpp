@@ -0,0 +1,124 @@
+Vector3D CalculateTranslationAtTime( const KeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame )
+{
+	Vector3D vTrans;
+	float fInterp = 0.0f;
+
+	//if there are one keyframes, don't do any transformations
+	if( pKeyFrames && (pKeyFrames->m_nextBlock == NULL) && (pKeyFrames->m_iNumber == 1) )
+	{
+		vTrans.Set( pKeyFrames->m_KeyFrames[0].m_fParam[0],
+					pKeyFrames->m_KeyFrames[0].m_fParam[1],
+					pKeyFrames->m_KeyFrames[0].m_fParam[2] );
+	}
+	else if( pKeyFrames && (pKeyFrames->m_iNumber > 1) )
+	{
+		//Calculate the current Translation frame
+		const SGPMF1KeyFrame *pLastKeyFrame = NULL;
+		const SGPMF1KeyFrame *pCurKeyFrame = FindKeyFrameAtTime( pKeyFrames, fTime, fSecondsPerFrame, pLastKeyFrame );
+		if( pCurKeyFrame )
+		{
+			if( pCurKeyFrame->m_iFrameID == pLastKeyFrame->m_iFrameID )
+				fInterp = 0;
+			else
+				fInterp = (fTime / fSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
+					float(pCurKeyFrame->m_iFrameID - pLastKeyFrame->m_iFrameID);
+
+			vTrans.Set( pLastKeyFrame->m_fParam[0] + (pCurKeyFrame->m_fParam[0] - pLastKeyFrame->m_fParam[0]) * fInterp,
+						pLastKeyFrame->m_fParam[1] + (pCurKeyFrame->m_fParam[1] - pLastKeyFrame->m_fParam[1]) * fInterp,
+						pLastKeyFrame->m_fParam[2] + (pCurKeyFrame->m_fParam[2] - pLastKeyFrame->m_fParam[2]) * fInterp );
+		}
+	}
+	return vTrans;
+}
+
+Quaternion CalculateRotationAtTime( const KeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame )
+{
+	Quaternion vRots;
+	float fInterp = 0.0f;
+
+	//if there are one keyframes, don't do any transformations
+	if( pKeyFrames && (pKeyFrames->m_nextBlock == NULL) && (pKeyFrames->m_iNumber == 1) )
+	{
+		return Quaternion(  pKeyFrames->m_KeyFrames[0].m_fParam[0],
+							pKeyFrames->m_KeyFrames[0].m_fParam[1],
+							pKeyFrames->m_KeyFrames[0].m_fParam[2],
+							pKeyFrames->m_KeyFrames[0].m_fParam[3] );
+	}
+	else if( pKeyFrames && (pKeyFrames->m_iNumber > 1) )
+	{
+		//Calculate the current Rotation frame
+		const SGPMF1KeyFrame *pLastKeyFrame = NULL;
+		const SGPMF1KeyFrame *pCurKeyFrame = FindKeyFrameAtTime( pKeyFrames, fTime, fSecondsPerFrame, pLastKeyFrame );
+		if( pCurKeyFrame )
+		{
+			if( pCurKeyFrame->m_iFrameID == pLastKeyFrame->m_iFrameID )
+				fInterp = 0;
+			else
+				fInterp = (fTime / fSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
+					float(pCurKeyFrame->m_iFrameID - pLastKeyFrame->m_iFrameID);
+
+			Quaternion vCurRots( pCurKeyFrame->m_fParam[0], 
+				pCurKeyFrame->m_fParam[1], 
+				pCurKeyFrame->m_fParam[2], 
+				pCurKeyFrame->m_fParam[3] );
+			vRots.x = pLastKeyFrame->m_fParam[0];
+			vRots.y = pLastKeyFrame->m_fParam[1];
+			vRots.z = pLastKeyFrame->m_fParam[2];
+			vRots.w = pLastKeyFrame->m_fParam[3];
+
+			vRots.Slerp(vCurRots, fInterp);
+		}
+	}
+	return vRots;
+}
+
+float CalculateScaleAtTime( const ScaleKeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame )
+{
+	float scale = 1.0f;
+	float fInterp = 0.0f;
+
+	//if there are one keyframes, don't do any transformations
+	if( pKeyFrames && (pKeyFrames->m_nextBlock == NULL) && (pKeyFrames->m_iNumber == 1) )
+	{
+		return pKeyFrames->m_KeyFrames[0].m_scale;
+	}
+	else if( pKeyFrames && (pKeyFrames->m_iNumber > 1) )
+	{
+		//Calculate the current scale frame
+		const SGPMF1ScaleKeyFrame *pLastKeyFrame = NULL;
+		const SGPMF1ScaleKeyFrame *pCurKeyFrame = FindKeyFrameAtTime( pKeyFrames, fTime, fSecondsPerFrame, pLastKeyFrame );
+		if( pCurKeyFrame )
+		{
+			if( pCurKeyFrame->m_iFrameID == pLastKeyFrame->m_iFrameID )
+				fInterp = 0;
+			else
+				fInterp = (fTime / fSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
+					float(pCurKeyFrame->m_iFrameID - pLastKeyFrame->m_iFrameID);
+
+			scale = pLastKeyFrame->m_scale + (pCurKeyFrame->m_scale - pLastKeyFrame->m_scale) * fInterp;
+		}
+	}
+	return scale;
+}
+
+bool CalculateVisibleAtTime( const VisibleKeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame )
+{
+	bool bVisible = true;
+
+	//if there are one keyframes, don't do anything
+	if( pKeyFrames && (pKeyFrames->m_nextBlock == NULL) && (pKeyFrames->m_iNumber == 1) )
+	{
+		return pKeyFrames->m_KeyFrames[0].m_Visible;
+	}
+	else if( pKeyFrames && (pKeyFrames->m_iNumber > 1) )
+	{
+		//Calculate the current visible frame
+		const SGPMF1VisibleKeyFrame *pLastKeyFrame = NULL;
+		const SGPMF1VisibleKeyFrame *pCurKeyFrame = FindKeyFrameAtTime( pKeyFrames, fTime, fSecondsPerFrame, pLastKeyFrame );
+		if( pCurKeyFrame && (pCurKeyFrame->m_iFrameID * fSecondsPerFrame == fTime) )
+			bVisible = pCurKeyFrame->m_Visible;
+		else
+			bVisible = pLastKeyFrame->m_Visible;
+	}
+	return bVisible;
+}
@@ -182,6 +182,58 @@ struct VisibleKeyFrameBlock
 	VisibleKeyFrameBlock() : m_iNumber(0), m_BoneFileID(0), m_KeyFrames(NULL), m_nextBlock(NULL) {}
 };
 
+//-------------------------------------------------------------
+//- FindKeyFrameAtTime
+//- Find the first key frame whose time is not earlier than fTime in a chain of key frame blocks,
+//- pLastKeyFrame returns the key frame before it (or the first key frame of the chain).
+//- Return NULL if all key frames are earlier than fTime, pLastKeyFrame is the last one then.
+//- Key frames in a block are sorted by frame ID, so only the last key of each block is tested
+//- and the block holding the result is binary searched.
+template <typename KeyFrameBlockType, typename KeyFrameType>
+inline const KeyFrameType* FindKeyFrameAtTime( const KeyFrameBlockType* pFirstBlock, float fTime, float fSecondsPerFrame, const KeyFrameType* &pLastKeyFrame )
+{
+	pLastKeyFrame = pFirstBlock->m_KeyFrames;
+
+	for( const KeyFrameBlockType* pBlock = pFirstBlock; pBlock != NULL; pBlock = pBlock->m_nextBlock )
+	{
+		if( pBlock->m_iNumber == 0 )
+			continue;
+
+		const KeyFrameType* pKeyFrames = pBlock->m_KeyFrames;
+		if( pKeyFrames[pBlock->m_iNumber - 1].m_iFrameID * fSecondsPerFrame < fTime )
+		{
+			pLastKeyFrame = &pKeyFrames[pBlock->m_iNumber - 1];
+			continue;
+		}
+
+		int Low = 0;
+		int High = pBlock->m_iNumber - 1;
+		while( Low < High )
+		{
+			int Mid = (Low + High) / 2;
+			if( pKeyFrames[Mid].m_iFrameID * fSecondsPerFrame >= fTime )
+				High = Mid;
+			else
+				Low = Mid + 1;
+		}
+		if( Low > 0 )
+			pLastKeyFrame = &pKeyFrames[Low - 1];
+		return &pKeyFrames[Low];
+	}
+	return NULL;
+}
+
+
+//-------------------------------------------------------------
+//- Key frame samplers of a bone track at fTime (in seconds), used by the skeleton instances.
+//- Translation / rotation / scale are interpolated between the key frames around fTime,
+//- visibility is the one of the last key frame not later than fTime.
+//- A NULL or empty track gives zero translation, identity rotation, scale 1 and visible.
+Vector3D CalculateTranslationAtTime( const KeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame );
+Quaternion CalculateRotationAtTime( const KeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame );
+float CalculateScaleAtTime( const ScaleKeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame );
+bool CalculateVisibleAtTime( const VisibleKeyFrameBlock* pKeyFrames, float fTime, float fSecondsPerFrame );
+
 
 //-------------------------------------------------------------
 //- SGPMF1Bone
@@ -1,7 +1,417 @@
 
-static Array<PtrOffset> s_CollectPtrs;
-static uint32 s_CurFileOffset = 0;
+//-------------------------------------------------------------
+//	Collects the data blocks of a MF1 / BF1 file when saving.
+//  Every saving has its own writer, and the model being saved is not modified,
+//  pointers in the blocks are replaced by file offsets only in the written file.
+//-------------------------------------------------------------
+class SGPModelFileWriter
+{
+public:
+	SGPModelFileWriter( uint32 Alignment ) : m_iAlignment(Alignment), m_iFileSize(0) {}
+
+	//Add a block of data at the end of file, return its index (-1 if no data)
+	int addBlock( const void* pDataBuffer, uint32 DataSize )
+	{
+		if( !pDataBuffer || DataSize == 0 )
+			return -1;
+
+		Block NewBlock;
+		NewBlock.pData = (const uint8*)pDataBuffer;
+		NewBlock.DataSize = DataSize;
+		NewBlock.FileOffset = (m_iFileSize + m_iAlignment - 1) & ~(m_iAlignment - 1);
+		m_Blocks.add(NewBlock);
+
+		m_iFileSize = NewBlock.FileOffset + DataSize;
+		return m_Blocks.size() - 1;
+	}
+
+	//File offset of the block, 0 if BlockIndex is -1
+	uint32 getBlockOffset( int BlockIndex ) const
+	{
+		return (BlockIndex >= 0) ? m_Blocks.getReference(BlockIndex).FileOffset : 0;
+	}
+
+	//pPointerField is a pointer inside an added block (BF1 file),
+	//it will be saved as the file offset of the block BlockIndex (NULL if BlockIndex is -1)
+	void addPointer( const void* pPointerField, int BlockIndex )
+	{
+		addPatch( getFieldOffset( pPointerField, sizeof(void*) ), sizeof(void*), getBlockOffset(BlockIndex) );
+	}
+
+	//pPointerField is a SGPMF1Pointer inside an added block (version 2 MF1 file),
+	//it will be saved as the offset from the field to the block BlockIndex (NULL if BlockIndex is -1)
+	template <typename Type>
+	void addFilePointer( const SGPMF1Pointer<Type>* pPointerField, int BlockIndex )
+	{
+		uint32 FieldOffset = getFieldOffset( pPointerField, sizeof(SGPMF1Pointer<Type>) );
+
+		SGPMF1Pointer<Type> FilePointer;
+		FilePointer.set( NULL );
+		if( BlockIndex >= 0 )
+		{
+			// The data is always added after the block holding its pointer
+			jassert( getBlockOffset(BlockIndex) > FieldOffset );
+			FilePointer.setFileOffset( getBlockOffset(BlockIndex) - FieldOffset );
+		}
+
+		uint64 Value;
+		memcpy( &Value, &FilePointer, sizeof(uint64) );
+		addPatch( FieldOffset, sizeof(uint64), Value );
+	}
+
+	//uint32 field inside an added block will be saved as Value
+	void setUInt32( const uint32* pField, uint32 Value )
+	{
+		addPatch( getFieldOffset( pField, sizeof(uint32) ), sizeof(uint32), Value );
+	}
+
+	bool writeToFile( const File& DestFile ) const
+	{
+		HeapBlock<uint8> FileData( m_iFileSize, true );
+
+		for( int i=0; i<m_Blocks.size(); i++ )
+			memcpy( FileData + m_Blocks.getReference(i).FileOffset, m_Blocks.getReference(i).pData, m_Blocks.getReference(i).DataSize );
+		for( int i=0; i<m_Patches.size(); i++ )
+		{
+			const Patch& FieldPatch = m_Patches.getReference(i);
+			if( FieldPatch.Size == sizeof(uint64) )
+				memcpy( FileData + FieldPatch.FileOffset, &FieldPatch.Value, sizeof(uint64) );
+			else
+			{
+				uint32 Value32 = (uint32)FieldPatch.Value;
+				memcpy( FileData + FieldPatch.FileOffset, &Value32, sizeof(uint32) );
+			}
+		}
+
+		// The old file may still be memory mapped by the loader (even to the data being saved),
+		// so write a new file next to it and only replace the old one when it is complete
+		File TempFile( DestFile.getNonexistentSibling() );
+
+		bool Result = false;
+		{
+			ScopedPointer<FileOutputStream> fileStream( TempFile.createOutputStream() );
+			if( fileStream != nullptr && fileStream->openedOk() )
+			{
+				Result = fileStream->write( FileData, (int)m_iFileSize );
+				fileStream->flush();
+				Result = Result && !fileStream->getStatus().failed();
+			}
+		}
+
+		if( Result )
+			Result = TempFile.moveFileTo( DestFile );
+		if( !Result )
+			TempFile.deleteFile();
+		return Result;
+	}
+
+private:
+	struct Block
+	{
+		const uint8* pData;
+		uint32 DataSize;
+		uint32 FileOffset;
+	};
+	struct Patch
+	{
+		uint32 FileOffset;
+		uint32 Size;
+		uint64 Value;
+	};
+
+	//File offset of a field inside an added block
+	uint32 getFieldOffset( const void* pField, uint32 FieldSize ) const
+	{
+		for( int i=m_Blocks.size()-1; i>=0; i-- )
+		{
+			const Block& CurBlock = m_Blocks.getReference(i);
+			if( (const uint8*)pField >= CurBlock.pData && (const uint8*)pField + FieldSize <= CurBlock.pData + CurBlock.DataSize )
+				return CurBlock.FileOffset + (uint32)((const uint8*)pField - CurBlock.pData);
+		}
+		jassertfalse;		// the block holding this field must be added first
+		return 0;
+	}
+
+	void addPatch( uint32 FileOffset, uint32 Size, uint64 Value )
+	{
+		Patch NewPatch;
+		NewPatch.FileOffset = FileOffset;
+		NewPatch.Size = Size;
+		NewPatch.Value = Value;
+		m_Patches.add(NewPatch);
+	}
+
+	uint32 m_iAlignment;
+	uint32 m_iFileSize;
+	Array<Block> m_Blocks;
+	Array<Patch> m_Patches;
+};
+
+//-------------------------------------------------------------
+//	Add a top-level data array of MF1 file, and record it in section table
+//-------------------------------------------------------------
+static int AddMF1Section( SGPModelFileWriter& Writer, Array<SGPMF1Section>& Sections, uint32 SectionType, const void* pDataBuffer, uint32 ElementSize, uint32 Count )
+{
+	int BlockIndex = Writer.addBlock( pDataBuffer, ElementSize * Count );
+	if( BlockIndex >= 0 )
+	{
+		SGPMF1Section Section;
+		Section.m_iType = SectionType;
+		Section.m_iCount = Count;
+		Section.m_iOffset = Writer.getBlockOffset(BlockIndex);
+		Section.m_iSize = ElementSize * Count;
+		Sections.add(Section);
+	}
+	return BlockIndex;
+}
+
+//-------------------------------------------------------------
+//	Reads a version 1 MF1 file into a model, which is then saved as version 2.
+//  Pointers of version 1 file hold file offsets, and have the size of the application
+//  which saved it (4 bytes for Win32 build). The structures holding pointers are copied
+//  with their pointers widened to SGPMF1Pointer, the other data arrays are used in the
+//  file data. Every array must be inside the file, and the first one must be right after
+//  CSGPModelMF1, otherwise the file has not been saved with this pointer size.
+//-------------------------------------------------------------
+class SGPModelFileLegacyReader
+{
+public:
+	SGPModelFileLegacyReader( uint8* pFileData, uint32 FileSize, uint32 PointerSize )
+		: m_pFileData(pFileData), m_iFileSize(FileSize), m_iPointerSize(PointerSize),
+		  m_iFirstDataOffset(0xFFFFFFFF), m_bValid(true)
+	{
+		// CSGPModelMF1 has 14 pointers
+		m_iModelSize = sizeof(CSGPModelMF1) - 14 * (sizeof(SGPMF1Pointer<void>) - PointerSize);
+	}
+
+	bool readModel( CSGPModelMF1& Model )
+	{
+		if( m_iFileSize < m_iModelSize )
+			return false;
+
+		const CSGPModelMF1* pFileModel = (const CSGPModelMF1*)m_pFileData;
+		const SGPMF1Header& Header = pFileModel->m_Header;
+		Model.m_Header = Header;
+		Model.m_MeshAABBox = pFileModel->m_MeshAABBox;
+
+		// Skin
+		static const uint32 SkinPointers[] = { offsetof(SGPMF1Skin, m_pMatKeyFrame) };
+		Model.m_pSkins = copyRecords<SGPMF1Skin>( Header.m_iSkinOffset, Header.m_iNumSkins, SkinPointers, 1 );
+		for( uint32 i=0; i<Header.m_iNumSkins && m_bValid; i++ )
+		{
+			SGPMF1Skin& Skin = Model.m_pSkins[i];
+			Skin.m_pMatKeyFrame = getData<SGPMF1MatKeyFrame>( Skin.m_pMatKeyFrame.m_iLow, Skin.m_iNumMatKeyFrame );
+		}
+
+		// LOD0 Mesh
+		static const uint32 MeshPointers[] = { offsetof(SGPMF1Mesh, m_pVertex), offsetof(SGPMF1Mesh, m_pIndices),
+			offsetof(SGPMF1Mesh, m_pVertexBoneGroupID), offsetof(SGPMF1Mesh, m_pTexCoords0),
+			offsetof(SGPMF1Mesh, m_pTexCoords1), offsetof(SGPMF1Mesh, m_pVertexColor) };
+		uint32 NumMeshes = (Header.m_iNumLods >= 1) ? Header.m_iNumMeshes : 0;
+		Model.m_pLOD0Meshes = copyRecords<SGPMF1Mesh>( Header.m_iLod0MeshOffset, NumMeshes, MeshPointers, 6 );
+		for( uint32 i=0; i<NumMeshes && m_bValid; i++ )
+		{
+			SGPMF1Mesh& Mesh = Model.m_pLOD0Meshes[i];
+			Mesh.m_pVertex = getData<SGPMF1Vertex>( Mesh.m_pVertex.m_iLow, Mesh.m_iNumVerts );
+			Mesh.m_pIndices = getData<uint16>( Mesh.m_pIndices.m_iLow, Mesh.m_iNumIndices );
+			Mesh.m_pVertexBoneGroupID = getData<uint16>( Mesh.m_pVertexBoneGroupID.m_iLow, Mesh.m_iNumVerts );
+			Mesh.m_pTexCoords0 = getData<SGPMF1TexCoord>( Mesh.m_pTexCoords0.m_iLow, Mesh.m_iNumUV0 );
+			Mesh.m_pTexCoords1 = getData<SGPMF1TexCoord>( Mesh.m_pTexCoords1.m_iLow, Mesh.m_iNumUV1 );
+			Mesh.m_pVertexColor = getData<SGPMF1VertexColor>( Mesh.m_pVertexColor.m_iLow, Mesh.m_iNumVertexColor );
+		}
+
+		Model.m_pBoneFileNames = getData<SGPMF1BoneFileName>( Header.m_iBoneAnimFileOffset, Header.m_iNumBoneAnimFile );
+		Model.m_pActionLists = getData<SGPMF1ActionList>( Header.m_iActionListOffset, Header.m_iNumActionList );
+		Model.m_pAttachTags = getData<SGPMF1AttachmentTag>( Header.m_iAttachOffset, Header.m_iNumAttc );
+		Model.m_pEffectTags = getData<SGPMF1AttachmentTag>( Header.m_iEttachOffset, Header.m_iNumEttc );
+
+		// Particle
+		static const uint32 ParticlePointers[] = { offsetof(SGPMF1ParticleTag, m_SystemParam) + offsetof(ParticleSystemParam, m_pGroupParam) };
+		static const uint32 GroupPointers[] = {
+			offsetof(ParticleGroupParam, m_ModelParam) + offsetof(ParticleModelParam, m_pRegularParam),
+			offsetof(ParticleGroupParam, m_ModelParam) + offsetof(ParticleModelParam, m_pInterpolatorParam),
+			offsetof(ParticleGroupParam, m_pEmitterParam), offsetof(ParticleGroupParam, m_pModifierParam) };
+		Model.m_pParticleEmitter = copyRecords<SGPMF1ParticleTag>( Header.m_iParticleOffset, Header.m_iNumParticles, ParticlePointers, 1 );
+		for( uint32 i=0; i<Header.m_iNumParticles && m_bValid; ++i )
+		{
+			ParticleSystemParam& systemParam = Model.m_pParticleEmitter[i].m_SystemParam;
+			systemParam.m_pGroupParam = copyRecords<ParticleGroupParam>( systemParam.m_pGroupParam.m_iLow, systemParam.m_groupCount, GroupPointers, 4 );
+			for( uint32 j=0; j<systemParam.m_groupCount && m_bValid; ++j )
+			{
+				ParticleGroupParam& groupParam = systemParam.m_pGroupParam[j];
+				ParticleModelParam& modelParam = groupParam.m_ModelParam;
+
+				modelParam.m_pRegularParam = getData<ParticleRegularParam>( modelParam.m_pRegularParam.m_iLow, modelParam.m_ParamCount );
+
+				// The union holding the pointer is larger than it, so the structure has the same size,
+				// and m_iLow of the copied pointer is the file offset with both pointer sizes
+				modelParam.m_pInterpolatorParam = copyRecords<ParticleInterpolatorParam>( modelParam.m_pInterpolatorParam.m_iLow, modelParam.m_InterpolatorCount, NULL, 0 );
+				for( uint32 k=0; k<modelParam.m_InterpolatorCount && m_bValid; ++k )
+				{
+					ParticleInterpolatorParam& interpolatorParam = modelParam.m_pInterpolatorParam[k];
+					if( interpolatorParam.m_InterpolatorType == Interpolator_SelfDefine )
+					{
+						ParticleSelfDefInterpolatorData& selfDefData = interpolatorParam.m_SelfDefData;
+						selfDefData.m_pEntry = getData<ParticleEntryParam>( selfDefData.m_pEntry.m_iLow, selfDefData.m_count );
+					}
+				}
+
+				groupParam.m_pEmitterParam = getData<ParticleEmitterParam>( groupParam.m_pEmitterParam.m_iLow, groupParam.m_nEmitterCount );
+				groupParam.m_pModifierParam = getData<ParticleModifierParam>( groupParam.m_pModifierParam.m_iLow, groupParam.m_nModifierCount );
+			}
+		}
+
+		// Config Setting
+		static const uint32 ConfigPointers[] = { offsetof(SGPMF1ConfigSetting, pMeshConfigList),
+			offsetof(SGPMF1ConfigSetting, pReplaceTextureConfigList), offsetof(SGPMF1ConfigSetting, pParticleConfigList),
+			offsetof(SGPMF1ConfigSetting, pRibbonConfigList) };
+		Model.m_pConfigSetting = copyRecords<SGPMF1ConfigSetting>( Header.m_iConfigsOffset, Header.m_iNumConfigs, ConfigPointers, 4 );
+		for( uint32 i=0; i<Header.m_iNumConfigs && m_bValid; i++ )
+		{
+			SGPMF1ConfigSetting& Config = Model.m_pConfigSetting[i];
+			Config.pMeshConfigList = getData<SGPMF1ConfigSetting::MeshConfig>( Config.pMeshConfigList.m_iLow, Config.MeshConfigNum );
+			Config.pReplaceTextureConfigList = getData<SGPMF1ConfigSetting::ReplaceTextureConfig>( Config.pReplaceTextureConfigList.m_iLow, Config.ReplaceTextureConfigNum );
+			Config.pParticleConfigList = getData<SGPMF1ConfigSetting::ParticleConfig>( Config.pParticleConfigList.m_iLow, Config.ParticleConfigNum );
+			Config.pRibbonConfigList = getData<SGPMF1ConfigSetting::RibbonConfig>( Config.pRibbonConfigList.m_iLow, Config.RibbonConfigNum );
+		}
+
+		return m_bValid && (m_iFirstDataOffset == 0xFFFFFFFF || m_iFirstDataOffset == m_iModelSize);
+	}
+
+	//The arrays of Model are owned by the reader or the file, ~CSGPModelMF1() must not delete them
+	static void detachModel( CSGPModelMF1& Model )
+	{
+		Model.m_pSkins = NULL;
+		Model.m_pLOD0Meshes = NULL;
+		Model.m_pBoneFileNames = NULL;
+		Model.m_pActionLists = NULL;
+		Model.m_pAttachTags = Model.m_pEffectTags = NULL;
+		Model.m_pParticleEmitter = NULL;
+		Model.m_pConfigSetting = NULL;
+	}
+
+private:
+	uint8* m_pFileData;
+	uint32 m_iFileSize;
+	uint32 m_iPointerSize;
+	uint32 m_iModelSize;
+	uint32 m_iFirstDataOffset;
+	bool m_bValid;
+	OwnedArray<MemoryBlock> m_Copies;
+
+	//Array of Count elements of ElementSize bytes in file, NULL if Count is 0
+	uint8* getArray( uint32 FileOffset, uint32 Count, uint32 ElementSize )
+	{
+		if( Count == 0 || !m_bValid )
+			return NULL;
+
+		if( FileOffset < m_iModelSize || FileOffset > m_iFileSize ||
+			(uint64)Count * ElementSize > (uint64)(m_iFileSize - FileOffset) )
+		{
+			m_bValid = false;
+			return NULL;
+		}
+
+		m_iFirstDataOffset = jmin( m_iFirstDataOffset, FileOffset );
+		return m_pFileData + FileOffset;
+	}
+
+	template <typename Type>
+	Type* getData( uint32 FileOffset, uint32 Count )
+	{
+		return (Type*)getArray( FileOffset, Count, sizeof(Type) );
+	}
+
+	//Copy Count structures from file, their pointers are at PointerOffsets (ascending offsets in Type).
+	//The pointers of the copies hold the file offsets in m_iLow.
+	template <typename Type>
+	Type* copyRecords( uint32 FileOffset, uint32 Count, const uint32* PointerOffsets, int NumPointers )
+	{
+		const uint32 FileRecordSize = sizeof(Type) - NumPointers * (sizeof(SGPMF1Pointer<void>) - m_iPointerSize);
+		const uint8* pFileRecords = getArray( FileOffset, Count, FileRecordSize );
+		if( pFileRecords == NULL )
+			return NULL;
+
+		MemoryBlock* pCopy = new MemoryBlock( sizeof(Type) * Count, true );
+		m_Copies.add( pCopy );
+		uint8* pRecords = (uint8*)pCopy->getData();
+
+		for( uint32 i=0; i<Count; i++ )
+		{
+			const uint8* pSrc = pFileRecords + i * FileRecordSize;
+			uint8* pDest = pRecords + i * sizeof(Type);
+			uint32 DestOffset = 0;
+
+			for( int j=0; j<NumPointers; j++ )
+			{
+				memcpy( pDest + DestOffset, pSrc, PointerOffsets[j] - DestOffset );
+				pSrc += PointerOffsets[j] - DestOffset;
+
+				uint64 Offset = 0;
+				memcpy( &Offset, pSrc, m_iPointerSize );		// little endian
+				if( Offset > 0xFFFFFFFF )
+					m_bValid = false;
+
+				SGPMF1Pointer<void> Pointer;
+				Pointer.m_iLow = (uint32)Offset;
+				Pointer.m_iHigh = 0;
+				memcpy( pDest + PointerOffsets[j], &Pointer, sizeof(Pointer) );
+
+				pSrc += m_iPointerSize;
+				DestOffset = PointerOffsets[j] + sizeof(Pointer);
+			}
+			memcpy( pDest + DestOffset, pSrc, sizeof(Type) - DestOffset );
+		}
 
+		return (Type*)pRecords;
+	}
+
+	SGP_DECLARE_NON_COPYABLE( SGPModelFileLegacyReader )
+};
+
+//-------------------------------------------------------------
+//	Load version 1 MF1 file, it is read with the pointer size of 64-bit and 32-bit builds
+//  and saved as version 2 to a temporary file, which is mapped instead of it
+//-------------------------------------------------------------
+static MemoryMappedFile* ConvertLegacyMF1( MemoryMappedFile* pLegacyFile, const String& Filename )
+{
+	const uint32 PointerSizes[2] = { 8, 4 };
+	MemoryMappedFile* pMappedFile = NULL;
+
+	for( int i=0; i<2; i++ )
+	{
+		SGPModelFileLegacyReader Reader( (uint8*)pLegacyFile->getData(), (uint32)pLegacyFile->getSize(), PointerSizes[i] );
+		CSGPModelMF1 LegacyModel;
+
+		bool bRead = Reader.readModel( LegacyModel );
+
+		if( bRead )
+		{
+			File TempFile( File::getSpecialLocation( File::tempDirectory ).getNonexistentChildFile( "SGPModelMF1", ".mf1", false ) );
+
+			if( LegacyModel.SaveMF1( String::empty, TempFile.getFullPathName() ) )
+			{
+				// The mapping is private, the file isn't needed any more
+				pMappedFile = new MemoryMappedFile( TempFile, MemoryMappedFile::copyOnWrite );
+				if( pMappedFile->getData() == nullptr )
+					deleteAndZero( pMappedFile );
+			}
+			TempFile.deleteFile();
+		}
+
+		SGPModelFileLegacyReader::detachModel( LegacyModel );
+		if( bRead )
+			break;
+	}
+
+	delete pLegacyFile;
+
+	if( pMappedFile == NULL )
+		Logger::getCurrentLogger()->writeToLog(String("Could not load version 1 MF1 File:") + Filename, ELL_ERROR);
+	else
+		Logger::getCurrentLogger()->writeToLog(Filename + String(" is a version 1 MF1 File, save it again to load it faster"), ELL_WARNING);
+	return pMappedFile;
+}
 
 CSGPModelMF1::CSGPModelMF1()
 {
@@ -104,10 +514,10 @@ CSGPModelMF1::~CSGPModelMF1()
 //- Load
 //- Loads an MF1 model from a file
 //-------------------------------------------------------------
-uint8* CSGPModelMF1::LoadMF1(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& Filename)
+MemoryMappedFile* CSGPModelMF1::LoadMF1(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& Filename)
 {
+	MemoryMappedFile* pMappedFile = NULL;
 	uint8 * ucpBuffer = 0;	
-	uint32 iFileSize = 0;
 
 	String AbsolutePath(Filename);
 	// Identify by their absolute filenames if possible.
@@ -116,191 +526,54 @@ uint8* CSGPModelMF1::LoadMF1(CSGPModelMF1* &pOutModelMF1, const String& WorkingD
 		AbsolutePath = WorkingDir +	File::separatorString + String(Filename);
 	}
 
+	// Map the file copy-on-write, version 2 file is used as it is, only the pages of
+	// pointers set later (bones) will be copied, the others are read from disk when
+	// they are first used
+	pMappedFile = new MemoryMappedFile( File(AbsolutePath), MemoryMappedFile::copyOnWrite );
+	if( (pMappedFile->getData() == nullptr) || (pMappedFile->getSize() < sizeof(SGPMF1Header)) )
 	{
-		ScopedPointer<FileInputStream> MF1FileStream( File(AbsolutePath).createInputStream() );
-		if( MF1FileStream == nullptr )
-		{
-			Logger::getCurrentLogger()->writeToLog(String("Could not open MF1 File:") + Filename, ELL_ERROR);
-			return NULL;
-		}
-		iFileSize = (uint32)MF1FileStream->getTotalLength();
-
-		ucpBuffer = new uint8 [iFileSize];
-
-		MF1FileStream->read(ucpBuffer, iFileSize);
+		Logger::getCurrentLogger()->writeToLog(String("Could not open MF1 File:") + Filename, ELL_ERROR);
+		delete pMappedFile;
+		return NULL;
 	}
+	ucpBuffer = (uint8 *)pMappedFile->getData();
 
 	//Make sure header is valid
 	pOutModelMF1 = (CSGPModelMF1 *)ucpBuffer;
 
-	if(pOutModelMF1->m_Header.m_iId != 0xCAFE2BEE || pOutModelMF1->m_Header.m_iVersion != 1)
+	if( pOutModelMF1->m_Header.m_iId != 0xCAFE2BEE ||
+		(pOutModelMF1->m_Header.m_iVersion != 1 && pOutModelMF1->m_Header.m_iVersion != SGPMF1_VERSION) )
 	{
 		Logger::getCurrentLogger()->writeToLog(Filename + String(" is not a valid MF1 File!"), ELL_ERROR);
-		delete [] ucpBuffer;
-		ucpBuffer = NULL;
+		delete pMappedFile;
 		return NULL;
 	}
 
-	// Skin
-	{
-		if( pOutModelMF1->m_Header.m_iSkinOffset )
-		{
-			pOutModelMF1->m_pSkins = (SGPMF1Skin *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iSkinOffset);
-			for( uint32 i=0; i<pOutModelMF1->m_Header.m_iNumSkins; i++ )
-			{
-				if( pOutModelMF1->m_pSkins[i].m_pMatKeyFrame )
-					pOutModelMF1->m_pSkins[i].m_pMatKeyFrame = (SGPMF1MatKeyFrame *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pSkins[i].m_pMatKeyFrame);
-			}
-		}
-		else
-			pOutModelMF1->m_pSkins = NULL;
-	}
-
-	//Mesh
-	{
-		if( pOutModelMF1->m_Header.m_iLod0MeshOffset )
-		{
-			pOutModelMF1->m_pLOD0Meshes = (SGPMF1Mesh *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iLod0MeshOffset);
-			for( uint32 i=0; i<pOutModelMF1->m_Header.m_iNumMeshes; i++ )
-			{
-				if( pOutModelMF1->m_pLOD0Meshes[i].m_pVertex )
-					pOutModelMF1->m_pLOD0Meshes[i].m_pVertex = (SGPMF1Vertex *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pLOD0Meshes[i].m_pVertex);
-				if( pOutModelMF1->m_pLOD0Meshes[i].m_pIndices )
-					pOutModelMF1->m_pLOD0Meshes[i].m_pIndices = (uint16 *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pLOD0Meshes[i].m_pIndices);
-				if( pOutModelMF1->m_pLOD0Meshes[i].m_pVertexBoneGroupID )
-					pOutModelMF1->m_pLOD0Meshes[i].m_pVertexBoneGroupID = (uint16 *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pLOD0Meshes[i].m_pVertexBoneGroupID);
-				if( pOutModelMF1->m_pLOD0Meshes[i].m_pTexCoords0 )
-					pOutModelMF1->m_pLOD0Meshes[i].m_pTexCoords0 = (SGPMF1TexCoord *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pLOD0Meshes[i].m_pTexCoords0);
-				if( pOutModelMF1->m_pLOD0Meshes[i].m_pTexCoords1 )
-					pOutModelMF1->m_pLOD0Meshes[i].m_pTexCoords1 = (SGPMF1TexCoord *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pLOD0Meshes[i].m_pTexCoords1);
-				if( pOutModelMF1->m_pLOD0Meshes[i].m_pVertexColor )
-					pOutModelMF1->m_pLOD0Meshes[i].m_pVertexColor = (SGPMF1VertexColor *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pLOD0Meshes[i].m_pVertexColor);
-			}
-		}
-		else
-			pOutModelMF1->m_pLOD0Meshes = NULL;
-
-		if( pOutModelMF1->m_Header.m_iLod1MeshOffset )
-		{}
-		else
-			pOutModelMF1->m_pLOD1Meshes = NULL;
-
-		if( pOutModelMF1->m_Header.m_iLod2MeshOffset )
-		{}
-		else
-			pOutModelMF1->m_pLOD2Meshes = NULL;
-	}
-
-	// Bone File name
-	{
-		if( pOutModelMF1->m_Header.m_iBoneAnimFileOffset )
-			pOutModelMF1->m_pBoneFileNames = (SGPMF1BoneFileName *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iBoneAnimFileOffset);
-		else
-			pOutModelMF1->m_pBoneFileNames = NULL;
-	}
-
-	// ActionList
-	{
-		if( pOutModelMF1->m_Header.m_iActionListOffset )
-			pOutModelMF1->m_pActionLists = (SGPMF1ActionList *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iActionListOffset);
-		else
-			pOutModelMF1->m_pActionLists = NULL;
-	}
-
-	//Attachment
-	{
-		if( pOutModelMF1->m_Header.m_iAttachOffset )
-			pOutModelMF1->m_pAttachTags = (SGPMF1AttachmentTag *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iAttachOffset);
-		else
-			pOutModelMF1->m_pAttachTags = NULL;
-
-		if( pOutModelMF1->m_Header.m_iEttachOffset )
-			pOutModelMF1->m_pEffectTags = (SGPMF1AttachmentTag *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iEttachOffset);
-		else
-			pOutModelMF1->m_pEffectTags = NULL;
-	}
-
-	// Particle
-	{
-		if( pOutModelMF1->m_Header.m_iParticleOffset )
-		{
-			pOutModelMF1->m_pParticleEmitter = (SGPMF1ParticleTag *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iParticleOffset);
-
-			for( uint32 i=0; i < pOutModelMF1->m_Header.m_iNumParticles; ++i )
-			{
-				// Particle System
-				ParticleSystemParam& systemParam = pOutModelMF1->m_pParticleEmitter[i].m_SystemParam;
-				systemParam.m_pGroupParam = (ParticleGroupParam *)(ucpBuffer + (intptr_t)systemParam.m_pGroupParam);
-				for( uint32 j=0; j < systemParam.m_groupCount; ++j )
-				{
-					// Particle Group
-					ParticleGroupParam& groupParam = systemParam.m_pGroupParam[j];
-					// Particle Model
-					ParticleModelParam& modelParam = groupParam.m_ModelParam;
-
-					modelParam.m_pRegularParam = (ParticleRegularParam *)(ucpBuffer + (intptr_t)modelParam.m_pRegularParam);
-					modelParam.m_pInterpolatorParam = (ParticleInterpolatorParam *)(ucpBuffer + (intptr_t)modelParam.m_pInterpolatorParam);
-					
-					// interpolator
-					for(uint32 k=0; k < modelParam.m_InterpolatorCount; ++k)
-					{
-						ParticleInterpolatorParam& interpolatorParam = modelParam.m_pInterpolatorParam[k];
-						if(interpolatorParam.m_InterpolatorType == Interpolator_SelfDefine)
-						{
-							ParticleSelfDefInterpolatorData& selfDefData = interpolatorParam.m_SelfDefData;
-							selfDefData.m_pEntry = (ParticleEntryParam *)(ucpBuffer + (intptr_t)selfDefData.m_pEntry);
-						}
-					}
-
-					// Particle Emitter
-					groupParam.m_pEmitterParam = (ParticleEmitterParam *)(ucpBuffer + (intptr_t)groupParam.m_pEmitterParam);
-					// Particle Modifier
-					groupParam.m_pModifierParam = (ParticleModifierParam *)(ucpBuffer + (intptr_t)groupParam.m_pModifierParam);
-				}
-			}
-		}
-	}
-	//Ribbon
-	{
-	}
-
-	//Config Setting
+	// Version 2, pointers hold offsets which SGPMF1Pointer resolves, nothing need to be changed
+	if( pOutModelMF1->m_Header.m_iVersion == SGPMF1_VERSION )
 	{
-		if( pOutModelMF1->m_Header.m_iConfigsOffset )
+		if( pMappedFile->getSize() < SGPMF1_LAYOUT_OFFSET + sizeof(SGPMF1FileLayout) )
 		{
-			pOutModelMF1->m_pConfigSetting = (SGPMF1ConfigSetting *)(ucpBuffer + (intptr_t)pOutModelMF1->m_Header.m_iConfigsOffset);
-			for( uint32 i=0; i<pOutModelMF1->m_Header.m_iNumConfigs; i++ )
-			{
-				if( pOutModelMF1->m_pConfigSetting[i].pMeshConfigList )
-					pOutModelMF1->m_pConfigSetting[i].pMeshConfigList = (SGPMF1ConfigSetting::MeshConfig *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pConfigSetting[i].pMeshConfigList);
-				if( pOutModelMF1->m_pConfigSetting[i].pReplaceTextureConfigList )
-					pOutModelMF1->m_pConfigSetting[i].pReplaceTextureConfigList = (SGPMF1ConfigSetting::ReplaceTextureConfig *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pConfigSetting[i].pReplaceTextureConfigList);
-				if( pOutModelMF1->m_pConfigSetting[i].pParticleConfigList )
-					pOutModelMF1->m_pConfigSetting[i].pParticleConfigList = (SGPMF1ConfigSetting::ParticleConfig *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pConfigSetting[i].pParticleConfigList);
-				if( pOutModelMF1->m_pConfigSetting[i].pRibbonConfigList )
-					pOutModelMF1->m_pConfigSetting[i].pRibbonConfigList = (SGPMF1ConfigSetting::RibbonConfig *)(ucpBuffer + (intptr_t)pOutModelMF1->m_pConfigSetting[i].pRibbonConfigList);
-			}
+			Logger::getCurrentLogger()->writeToLog(Filename + String(" is not a valid MF1 File!"), ELL_ERROR);
+			delete pMappedFile;
+			return NULL;
 		}
-		else
-			pOutModelMF1->m_pConfigSetting = NULL;
+		return pMappedFile;
 	}
 
-	pOutModelMF1->m_iNumBones = 0;
-	pOutModelMF1->m_iNumBoneGroup = 0;
-
-	pOutModelMF1->m_pBones = NULL;
-	pOutModelMF1->m_pBoneGroup = NULL;
-
-
-	return ucpBuffer;
+	// Version 1, pointers hold file offsets and have the size of the application which saved it,
+	// the file is converted to version 2
+	pMappedFile = ConvertLegacyMF1( pMappedFile, Filename );
+	pOutModelMF1 = pMappedFile ? (CSGPModelMF1 *)pMappedFile->getData() : NULL;
+	return pMappedFile;
 }
 
 
 //Load an MF1 bone animation file
-uint8* CSGPModelMF1::LoadBone(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& BoneFilename, uint16 BoneFileIndex)
+MemoryMappedFile* CSGPModelMF1::LoadBone(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& BoneFilename, uint16 BoneFileIndex)
 {
+	MemoryMappedFile* pMappedFile = NULL;
 	uint8 * ucpBuffer = 0;	
-	uint32 iFileSize = 0;
 
 	String AbsolutePath(BoneFilename);
 	// Identify by their absolute filenames if possible.
@@ -311,26 +584,22 @@ uint8* CSGPModelMF1::LoadBone(CSGPModelMF1* &pOutModelMF1, const String& Working
 	if( BoneFileIndex > 0 )
 		AbsolutePath = AbsolutePath + String(BoneFileIndex);
 
+	// Map the file copy-on-write, only the pages of pointers relocated below will be copied,
+	// the others are read from disk when they are first used
+	pMappedFile = new MemoryMappedFile( File(AbsolutePath), MemoryMappedFile::copyOnWrite );
+	if( (pMappedFile->getData() == nullptr) || (pMappedFile->getSize() < sizeof(SGPMF1BoneHeader)) )
 	{
-		ScopedPointer<FileInputStream> BF1FileStream( File(AbsolutePath).createInputStream() );
-		if( BF1FileStream == nullptr )
-		{
-			Logger::getCurrentLogger()->writeToLog(String("Could not open BF1 File:") + BoneFilename, ELL_ERROR);
-			return NULL;
-		}
-		iFileSize = (uint32)BF1FileStream->getTotalLength();
-
-		ucpBuffer = new uint8 [iFileSize];
-
-		BF1FileStream->read(ucpBuffer, iFileSize);
+		Logger::getCurrentLogger()->writeToLog(String("Could not open BF1 File:") + BoneFilename, ELL_ERROR);
+		delete pMappedFile;
+		return NULL;
 	}
+	ucpBuffer = (uint8 *)pMappedFile->getData();
 
 	SGPMF1BoneHeader *pBoneHeader = (SGPMF1BoneHeader *)ucpBuffer;
 	if(pBoneHeader->m_iId != 0xCAFEBBEE || pBoneHeader->m_iVersion != 1)
 	{
 		Logger::getCurrentLogger()->writeToLog(BoneFilename + String(" is not a valid BF1 File!"), ELL_ERROR);
-		delete [] ucpBuffer;
-		ucpBuffer = NULL;
+		delete pMappedFile;
 		return NULL;
 	}
 
@@ -406,7 +675,7 @@ uint8* CSGPModelMF1::LoadBone(CSGPModelMF1* &pOutModelMF1, const String& Working
 		}
 	}
 
-	return ucpBuffer;
+	return pMappedFile;
 }
 
 
@@ -418,167 +687,169 @@ uint8* CSGPModelMF1::LoadBone(CSGPModelMF1* &pOutModelMF1, const String& Working
 //-------------------------------------------------------------
 bool CSGPModelMF1::SaveMF1(const String& WorkingDir, const String& Filename)
 {
-	bool SaveResult = true;
-	s_CurFileOffset = 0;
-	s_CollectPtrs.clear();
-
-	
-	CollectPointers( &m_Header, sizeof(SGPMF1Header) );
-	CollectPointers( &m_MeshAABBox, sizeof(AABBox) );
-
-	CollectPointers( &m_pSkins, sizeof(SGPMF1Skin *) );
-
-	CollectPointers( &m_pLOD0Meshes, sizeof(SGPMF1Mesh *) );
-	CollectPointers( &m_pLOD1Meshes, sizeof(SGPMF1Mesh *) );
-	CollectPointers( &m_pLOD2Meshes, sizeof(SGPMF1Mesh *) );
+	SGPModelFileWriter Writer( SGPMF1_BLOCK_ALIGNMENT );
+	SGPMF1FileLayout FileLayout;
+	Array<SGPMF1Section> Sections;
 
-	CollectPointers( &m_pBoneFileNames, sizeof(SGPMF1BoneFileName *) );
-	CollectPointers( &m_pActionLists, sizeof(SGPMF1ActionList *) );
+	Writer.addBlock( this, sizeof(CSGPModelMF1) );
+	Writer.addBlock( &FileLayout, sizeof(SGPMF1FileLayout) );
+	jassert( Writer.getBlockOffset(1) == SGPMF1_LAYOUT_OFFSET );
 
-	CollectPointers( &m_pAttachTags, sizeof(SGPMF1AttachmentTag *) );
-	CollectPointers( &m_pEffectTags, sizeof(SGPMF1AttachmentTag *) );
-
-	CollectPointers( &m_pBones, sizeof(SGPMF1Bone *) );
-	CollectPointers( &m_pBoneGroup, sizeof(SGPMF1BoneGroup *) );
-
-	CollectPointers( &m_pParticleEmitter, sizeof(SGPMF1ParticleTag *) );// Particle
-	CollectPointers( &m_pRibbonEmitter, sizeof(void *) );				// Ribbon
-
-	CollectPointers( &m_pConfigSetting, sizeof(SGPMF1ConfigSetting *) );// Config setting
-
-	CollectPointers( &m_iNumBones, sizeof(uint32) );
-	CollectPointers( &m_iNumBoneGroup, sizeof(uint32) );
+	Writer.setUInt32( &m_Header.m_iVersion, SGPMF1_VERSION );
 
+	// Bones are saved in BF1 files
+	Writer.addFilePointer( &m_pBones, -1 );
+	Writer.addFilePointer( &m_pBoneGroup, -1 );
+	Writer.setUInt32( &m_iNumBones, 0 );
+	Writer.setUInt32( &m_iNumBoneGroup, 0 );
 
 	// Skin
 	{
-		m_Header.m_iSkinOffset = CollectPointers( m_pSkins, sizeof(SGPMF1Skin) * m_Header.m_iNumSkins );
+		int SkinBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_SKIN, m_pSkins, sizeof(SGPMF1Skin), m_Header.m_iNumSkins );
+		Writer.addFilePointer( &m_pSkins, SkinBlock );
+		Writer.setUInt32( &m_Header.m_iSkinOffset, Writer.getBlockOffset(SkinBlock) );
 		for( uint32 i=0; i<m_Header.m_iNumSkins; i++ )
 		{
-			if( m_pSkins[i].m_iNumMatKeyFrame > 0 )
-				m_pSkins[i].m_pMatKeyFrame = (SGPMF1MatKeyFrame *)CollectPointers( m_pSkins[i].m_pMatKeyFrame, sizeof(SGPMF1MatKeyFrame) * m_pSkins[i].m_iNumMatKeyFrame );
+			Writer.addFilePointer( &m_pSkins[i].m_pMatKeyFrame,
+				Writer.addBlock( m_pSkins[i].m_pMatKeyFrame, sizeof(SGPMF1MatKeyFrame) * m_pSkins[i].m_iNumMatKeyFrame ) );
 		}
 	}
 
 	// LOD Mesh
 	{
+		int MeshBlock = -1;
 		if( m_Header.m_iNumLods >= 1 )
 		{
+			MeshBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_LOD0MESH, m_pLOD0Meshes, sizeof(SGPMF1Mesh), m_Header.m_iNumMeshes );
 			for( uint32 i = 0; i < m_Header.m_iNumMeshes; i++ )
 			{
-				m_pLOD0Meshes[i].m_pVertex = (SGPMF1Vertex *)CollectPointers(m_pLOD0Meshes[i].m_pVertex, sizeof(SGPMF1Vertex) * m_pLOD0Meshes[i].m_iNumVerts );
-				m_pLOD0Meshes[i].m_pIndices = (uint16 *)CollectPointers(m_pLOD0Meshes[i].m_pIndices, sizeof(uint16) * m_pLOD0Meshes[i].m_iNumIndices);
-				m_pLOD0Meshes[i].m_pVertexBoneGroupID = (uint16 *)CollectPointers(m_pLOD0Meshes[i].m_pVertexBoneGroupID, sizeof(uint16) * m_pLOD0Meshes[i].m_iNumVerts);
-				if( m_pLOD0Meshes[i].m_iNumUV0 > 0 )
-					m_pLOD0Meshes[i].m_pTexCoords0 = (SGPMF1TexCoord *)CollectPointers(m_pLOD0Meshes[i].m_pTexCoords0, sizeof(SGPMF1TexCoord) * m_pLOD0Meshes[i].m_iNumUV0);
-				if( m_pLOD0Meshes[i].m_iNumUV1 > 0 )
-					m_pLOD0Meshes[i].m_pTexCoords1 = (SGPMF1TexCoord *)CollectPointers(m_pLOD0Meshes[i].m_pTexCoords1, sizeof(SGPMF1TexCoord) * m_pLOD0Meshes[i].m_iNumUV1);
-				if( m_pLOD0Meshes[i].m_iNumVertexColor > 0 )
-					m_pLOD0Meshes[i].m_pVertexColor = (SGPMF1VertexColor *)CollectPointers(m_pLOD0Meshes[i].m_pVertexColor, sizeof(SGPMF1VertexColor) * m_pLOD0Meshes[i].m_iNumVertexColor);
+				SGPMF1Mesh& Mesh = m_pLOD0Meshes[i];
+				Writer.addFilePointer( &Mesh.m_pVertex, Writer.addBlock( Mesh.m_pVertex, sizeof(SGPMF1Vertex) * Mesh.m_iNumVerts ) );
+				Writer.addFilePointer( &Mesh.m_pIndices, Writer.addBlock( Mesh.m_pIndices, sizeof(uint16) * Mesh.m_iNumIndices ) );
+				Writer.addFilePointer( &Mesh.m_pVertexBoneGroupID, Writer.addBlock( Mesh.m_pVertexBoneGroupID, sizeof(uint16) * Mesh.m_iNumVerts ) );
+				Writer.addFilePointer( &Mesh.m_pTexCoords0, Writer.addBlock( Mesh.m_pTexCoords0, sizeof(SGPMF1TexCoord) * Mesh.m_iNumUV0 ) );
+				Writer.addFilePointer( &Mesh.m_pTexCoords1, Writer.addBlock( Mesh.m_pTexCoords1, sizeof(SGPMF1TexCoord) * Mesh.m_iNumUV1 ) );
+				Writer.addFilePointer( &Mesh.m_pVertexColor, Writer.addBlock( Mesh.m_pVertexColor, sizeof(SGPMF1VertexColor) * Mesh.m_iNumVertexColor ) );
 			}
-			m_Header.m_iLod0MeshOffset = CollectPointers( m_pLOD0Meshes, sizeof(SGPMF1Mesh) * m_Header.m_iNumMeshes );
-		}
-		if( m_Header.m_iNumLods >= 2 )
-		{
-		}
-		if( m_Header.m_iNumLods >= 3 )
-		{
 		}
+		Writer.addFilePointer( &m_pLOD0Meshes, MeshBlock );
+		Writer.setUInt32( &m_Header.m_iLod0MeshOffset, Writer.getBlockOffset(MeshBlock) );
+
+		// LOD1 and LOD2 meshes are not supported yet
 		if( m_Header.m_iNumLods >= 4 )
 			jassertfalse;
+		Writer.addFilePointer( &m_pLOD1Meshes, -1 );
+		Writer.addFilePointer( &m_pLOD2Meshes, -1 );
+		Writer.setUInt32( &m_Header.m_iLod1MeshOffset, 0 );
+		Writer.setUInt32( &m_Header.m_iLod2MeshOffset, 0 );
 	}
 
 	// Bone File name
-	if( m_Header.m_iNumBoneAnimFile > 0 )
 	{
-		m_Header.m_iBoneAnimFileOffset = CollectPointers(m_pBoneFileNames, sizeof(SGPMF1BoneFileName) * m_Header.m_iNumBoneAnimFile);
+		int BoneFileNameBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_BONEFILENAME, m_pBoneFileNames, sizeof(SGPMF1BoneFileName), m_Header.m_iNumBoneAnimFile );
+		Writer.addFilePointer( &m_pBoneFileNames, BoneFileNameBlock );
+		Writer.setUInt32( &m_Header.m_iBoneAnimFileOffset, Writer.getBlockOffset(BoneFileNameBlock) );
 	}
 
 	// ActionList
-	if( m_Header.m_iNumActionList > 0 )
 	{
-		m_Header.m_iActionListOffset = CollectPointers(m_pActionLists, sizeof(SGPMF1ActionList) * m_Header.m_iNumActionList);
+		int ActionListBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_ACTIONLIST, m_pActionLists, sizeof(SGPMF1ActionList), m_Header.m_iNumActionList );
+		Writer.addFilePointer( &m_pActionLists, ActionListBlock );
+		Writer.setUInt32( &m_Header.m_iActionListOffset, Writer.getBlockOffset(ActionListBlock) );
 	}
 
 	//ATTACHMENT
-	if( m_Header.m_iNumAttc > 0 )
-		m_Header.m_iAttachOffset = CollectPointers(m_pAttachTags, sizeof(SGPMF1AttachmentTag) * m_Header.m_iNumAttc);
-	if( m_Header.m_iNumEttc > 0 )
-		m_Header.m_iEttachOffset = CollectPointers(m_pEffectTags, sizeof(SGPMF1AttachmentTag) * m_Header.m_iNumEttc);
+	{
+		int AttachBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_ATTACHMENT, m_pAttachTags, sizeof(SGPMF1AttachmentTag), m_Header.m_iNumAttc );
+		Writer.addFilePointer( &m_pAttachTags, AttachBlock );
+		Writer.setUInt32( &m_Header.m_iAttachOffset, Writer.getBlockOffset(AttachBlock) );
+
+		int EffectAttachBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_EFFECTATTACHMENT, m_pEffectTags, sizeof(SGPMF1AttachmentTag), m_Header.m_iNumEttc );
+		Writer.addFilePointer( &m_pEffectTags, EffectAttachBlock );
+		Writer.setUInt32( &m_Header.m_iEttachOffset, Writer.getBlockOffset(EffectAttachBlock) );
+	}
 
 	// Particle
-	if( m_Header.m_iNumParticles > 0 )
 	{
-		m_Header.m_iParticleOffset = CollectPointers(m_pParticleEmitter, sizeof(SGPMF1ParticleTag) * m_Header.m_iNumParticles);
+		int ParticleBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_PARTICLE, m_pParticleEmitter, sizeof(SGPMF1ParticleTag), m_Header.m_iNumParticles );
+		Writer.addFilePointer( &m_pParticleEmitter, ParticleBlock );
+		Writer.setUInt32( &m_Header.m_iParticleOffset, Writer.getBlockOffset(ParticleBlock) );
 
 		for( uint32 i=0; i<m_Header.m_iNumParticles; ++i )
 		{
 			// Particle System
 			ParticleSystemParam& systemParam = m_pParticleEmitter[i].m_SystemParam;
-			ParticleGroupParam* pGroupParam = systemParam.m_pGroupParam;
-			if(systemParam.m_groupCount > 0)
-				systemParam.m_pGroupParam = (ParticleGroupParam*)CollectPointers(systemParam.m_pGroupParam, sizeof(ParticleGroupParam) * systemParam.m_groupCount);
+			Writer.addFilePointer( &systemParam.m_pGroupParam,
+				Writer.addBlock( systemParam.m_pGroupParam, sizeof(ParticleGroupParam) * systemParam.m_groupCount ) );
 
 			for( uint32 j=0; j<systemParam.m_groupCount; ++j )
 			{
 				// Particle Group
-				ParticleGroupParam& groupParam = pGroupParam[j];
+				ParticleGroupParam& groupParam = systemParam.m_pGroupParam[j];
 
 				// Particle Model
 				ParticleModelParam& modelParam = groupParam.m_ModelParam;
 
 				// Model Normal Param
-				if(modelParam.m_ParamCount > 0)
-					modelParam.m_pRegularParam = (ParticleRegularParam*)CollectPointers(modelParam.m_pRegularParam, sizeof(ParticleRegularParam) * modelParam.m_ParamCount);
-				
+				Writer.addFilePointer( &modelParam.m_pRegularParam,
+					Writer.addBlock( modelParam.m_pRegularParam, sizeof(ParticleRegularParam) * modelParam.m_ParamCount ) );
+
 				// Model Interpolator Param
-				if(modelParam.m_InterpolatorCount > 0)
+				Writer.addFilePointer( &modelParam.m_pInterpolatorParam,
+					Writer.addBlock( modelParam.m_pInterpolatorParam, sizeof(ParticleInterpolatorParam) * modelParam.m_InterpolatorCount ) );
+				for( uint32 k=0; k<modelParam.m_InterpolatorCount; ++k )
 				{
-					ParticleInterpolatorParam* pInterpolatorParam = modelParam.m_pInterpolatorParam;
-					modelParam.m_pInterpolatorParam = (ParticleInterpolatorParam*)CollectPointers(modelParam.m_pInterpolatorParam, sizeof(ParticleInterpolatorParam) * modelParam.m_InterpolatorCount);
-					for(uint32 k=0; k<modelParam.m_InterpolatorCount; ++k)
+					ParticleInterpolatorParam& interpolatorParam = modelParam.m_pInterpolatorParam[k];
+					if(interpolatorParam.m_InterpolatorType == Interpolator_SelfDefine)
 					{
-						ParticleInterpolatorParam& interpolatorParam = pInterpolatorParam[k];
-						if(interpolatorParam.m_InterpolatorType == Interpolator_SelfDefine)
-						{
-							ParticleSelfDefInterpolatorData& selfDefData = interpolatorParam.m_SelfDefData;
-							if(selfDefData.m_count > 0)
-								selfDefData.m_pEntry = (ParticleEntryParam*)CollectPointers(selfDefData.m_pEntry, sizeof(ParticleEntryParam) * selfDefData.m_count);
-						}
+						ParticleSelfDefInterpolatorData& selfDefData = interpolatorParam.m_SelfDefData;
+						Writer.addFilePointer( &selfDefData.m_pEntry,
+							Writer.addBlock( selfDefData.m_pEntry, sizeof(ParticleEntryParam) * selfDefData.m_count ) );
 					}
 				}
 
 				// Particle Emitter
-				if( groupParam.m_nEmitterCount > 0 )
-					groupParam.m_pEmitterParam = (ParticleEmitterParam*)CollectPointers(groupParam.m_pEmitterParam, sizeof(ParticleEmitterParam) * groupParam.m_nEmitterCount);
+				Writer.addFilePointer( &groupParam.m_pEmitterParam,
+					Writer.addBlock( groupParam.m_pEmitterParam, sizeof(ParticleEmitterParam) * groupParam.m_nEmitterCount ) );
 
 				// Particle Modifier
-				if( groupParam.m_nModifierCount > 0 )
-					groupParam.m_pModifierParam = (ParticleModifierParam*)CollectPointers(groupParam.m_pModifierParam, sizeof(ParticleModifierParam) * groupParam.m_nModifierCount);
+				Writer.addFilePointer( &groupParam.m_pModifierParam,
+					Writer.addBlock( groupParam.m_pModifierParam, sizeof(ParticleModifierParam) * groupParam.m_nModifierCount ) );
 			}
 		}
 	}
 	// RIBBON
 	{
+		Writer.addFilePointer( &m_pRibbonEmitter, -1 );
 	}
 
 	// Config Setting
-	if( m_Header.m_iNumConfigs > 0 )
 	{
+		int ConfigBlock = AddMF1Section( Writer, Sections, SGPMF1_SECTION_CONFIGSETTING, m_pConfigSetting, sizeof(SGPMF1ConfigSetting), m_Header.m_iNumConfigs );
+		Writer.addFilePointer( &m_pConfigSetting, ConfigBlock );
+		Writer.setUInt32( &m_Header.m_iConfigsOffset, Writer.getBlockOffset(ConfigBlock) );
+
 		for( uint32 i = 0; i < m_Header.m_iNumConfigs; i++ )
 		{
-			if( m_pConfigSetting[i].MeshConfigNum > 0 )
-				m_pConfigSetting[i].pMeshConfigList = (SGPMF1ConfigSetting::MeshConfig *)CollectPointers( m_pConfigSetting[i].pMeshConfigList, sizeof(SGPMF1ConfigSetting::MeshConfig) * m_pConfigSetting[i].MeshConfigNum );
-			if( m_pConfigSetting[i].ReplaceTextureConfigNum > 0 )
-				m_pConfigSetting[i].pReplaceTextureConfigList = (SGPMF1ConfigSetting::ReplaceTextureConfig *)CollectPointers( m_pConfigSetting[i].pReplaceTextureConfigList, sizeof(SGPMF1ConfigSetting::ReplaceTextureConfig) * m_pConfigSetting[i].ReplaceTextureConfigNum );
-			if( m_pConfigSetting[i].ParticleConfigNum > 0 )
-				m_pConfigSetting[i].pParticleConfigList = (SGPMF1ConfigSetting::ParticleConfig *)CollectPointers( m_pConfigSetting[i].pParticleConfigList, sizeof(SGPMF1ConfigSetting::ParticleConfig) * m_pConfigSetting[i].ParticleConfigNum );
-			if( m_pConfigSetting[i].RibbonConfigNum > 0 )
-				m_pConfigSetting[i].pRibbonConfigList = (SGPMF1ConfigSetting::RibbonConfig *)CollectPointers( m_pConfigSetting[i].pRibbonConfigList, sizeof(SGPMF1ConfigSetting::RibbonConfig) * m_pConfigSetting[i].RibbonConfigNum );
+			SGPMF1ConfigSetting& Config = m_pConfigSetting[i];
+			Writer.addFilePointer( &Config.pMeshConfigList,
+				Writer.addBlock( Config.pMeshConfigList, sizeof(SGPMF1ConfigSetting::MeshConfig) * Config.MeshConfigNum ) );
+			Writer.addFilePointer( &Config.pReplaceTextureConfigList,
+				Writer.addBlock( Config.pReplaceTextureConfigList, sizeof(SGPMF1ConfigSetting::ReplaceTextureConfig) * Config.ReplaceTextureConfigNum ) );
+			Writer.addFilePointer( &Config.pParticleConfigList,
+				Writer.addBlock( Config.pParticleConfigList, sizeof(SGPMF1ConfigSetting::ParticleConfig) * Config.ParticleConfigNum ) );
+			Writer.addFilePointer( &Config.pRibbonConfigList,
+				Writer.addBlock( Config.pRibbonConfigList, sizeof(SGPMF1ConfigSetting::RibbonConfig) * Config.RibbonConfigNum ) );
 		}
-		m_Header.m_iConfigsOffset = CollectPointers(m_pConfigSetting, sizeof(SGPMF1ConfigSetting) * m_Header.m_iNumConfigs);
 	}
 
+	// Section table
+	int SectionTableBlock = Writer.addBlock( Sections.getRawDataPointer(), sizeof(SGPMF1Section) * Sections.size() );
+
+	FileLayout.m_iAlignment = SGPMF1_BLOCK_ALIGNMENT;
+	FileLayout.m_iNumSections = Sections.size();
+	FileLayout.m_iSectionOffset = Writer.getBlockOffset(SectionTableBlock);
+
 
 	//-------------------------------------------------------------
 	// Identify it by the absolute filenames if possible.
@@ -588,162 +859,7 @@ bool CSGPModelMF1::SaveMF1(const String& WorkingDir, const String& Filename)
 		AbsolutePath = WorkingDir +	File::separatorString + Filename;
 	}
 
-	ScopedPointer<FileOutputStream> fileStream( File(AbsolutePath).createOutputStream() );
-	if (fileStream != nullptr && fileStream->openedOk() )
-    {
-		fileStream->setPosition(0);
-		fileStream->truncate();
-
-		for( int i=0; i<s_CollectPtrs.size(); i++ )
-		{
-			fileStream->write( (const uint8*)s_CollectPtrs[i].pDataPointer, s_CollectPtrs[i].DataSize );
-		}
-
-		fileStream->flush();
-	}
-	else
-		SaveResult = false;
-	//-------------------------------------------------------------
-
-	// Reset Pointers - For release memory correctly
-	RelocateFirstPointers();							//SGPMF1Header
-	RelocateFirstPointers();							//AABBox
-
-	(SGPMF1Skin *)RelocateFirstPointers();				//SGPMF1Skin*
-
-	(SGPMF1Mesh *)RelocateFirstPointers();
-	(SGPMF1Mesh *)RelocateFirstPointers();
-	(SGPMF1Mesh *)RelocateFirstPointers();
-
-	(SGPMF1BoneFileName *)RelocateFirstPointers();
-	(SGPMF1ActionList *)RelocateFirstPointers();
-	(SGPMF1AttachmentTag *)RelocateFirstPointers();
-	(SGPMF1AttachmentTag *)RelocateFirstPointers();
-
-	(SGPMF1Bone *)RelocateFirstPointers();
-	(SGPMF1BoneGroup *)RelocateFirstPointers();
-	(SGPMF1ParticleTag *)RelocateFirstPointers();		//Particle
-	(void *)RelocateFirstPointers();					//Ribbon
-	(SGPMF1ConfigSetting *)RelocateFirstPointers();		//ConfigSetting
-
-	RelocateFirstPointers();
-	RelocateFirstPointers();
-
-
-
-	(SGPMF1Skin *)RelocateFirstPointers();
-	for( uint32 i=0; i<m_Header.m_iNumSkins; i++ )
-	{
-		if( m_pSkins[i].m_iNumMatKeyFrame > 0 )
-			m_pSkins[i].m_pMatKeyFrame = (SGPMF1MatKeyFrame *)RelocateFirstPointers();
-	}
-
-	if( m_Header.m_iNumLods >= 1 )
-	{
-		for( uint32 i = 0; i < m_Header.m_iNumMeshes; i++ )
-		{
-			m_pLOD0Meshes[i].m_pVertex = (SGPMF1Vertex *)RelocateFirstPointers();
-			m_pLOD0Meshes[i].m_pIndices = (uint16 *)RelocateFirstPointers();
-			m_pLOD0Meshes[i].m_pVertexBoneGroupID = (uint16 *)RelocateFirstPointers();
-			if( m_pLOD0Meshes[i].m_iNumUV0 > 0 )
-				m_pLOD0Meshes[i].m_pTexCoords0 = (SGPMF1TexCoord *)RelocateFirstPointers();
-			if( m_pLOD0Meshes[i].m_iNumUV1 > 0 )
-				m_pLOD0Meshes[i].m_pTexCoords1 = (SGPMF1TexCoord *)RelocateFirstPointers();
-			if( m_pLOD0Meshes[i].m_iNumVertexColor > 0 )
-				m_pLOD0Meshes[i].m_pVertexColor = (SGPMF1VertexColor *)RelocateFirstPointers();
-		}
-		(SGPMF1Mesh*)RelocateFirstPointers();
-	}
-	if( m_Header.m_iNumLods >= 2 )
-	{
-	}
-	if( m_Header.m_iNumLods >= 3 )
-	{
-	}
-
-
-	if( m_Header.m_iNumBoneAnimFile > 0 )
-		(SGPMF1BoneFileName*)RelocateFirstPointers();
-	if( m_Header.m_iNumActionList > 0 )
-		(SGPMF1ActionList*)RelocateFirstPointers();
-
-	if( m_Header.m_iNumAttc > 0 )
-		(SGPMF1AttachmentTag*)RelocateFirstPointers();
-	if( m_Header.m_iNumEttc > 0 )
-		(SGPMF1AttachmentTag*)RelocateFirstPointers();
-
-	// Particle
-	if( m_Header.m_iNumParticles > 0 )
-	{
-		(SGPMF1ParticleTag*)RelocateFirstPointers();
-
-		for( uint32 i=0; i < m_Header.m_iNumParticles; ++i )
-		{
-			// Particle System
-			ParticleSystemParam& systemParam = m_pParticleEmitter[i].m_SystemParam;
-			if( systemParam.m_groupCount > 0 )
-				systemParam.m_pGroupParam = (ParticleGroupParam *)RelocateFirstPointers();
-			for( uint32 j=0; j<systemParam.m_groupCount; ++j )
-			{
-				// Particle Group
-				ParticleGroupParam& groupParam = systemParam.m_pGroupParam[j];
-
-				// Particle Model
-				ParticleModelParam& modelParam = groupParam.m_ModelParam;
-
-				// Model Normal Param
-				if( modelParam.m_ParamCount > 0 )
-					modelParam.m_pRegularParam = (ParticleRegularParam *)RelocateFirstPointers();
-				
-				// Model Interpolator Param
-				if( modelParam.m_InterpolatorCount > 0 )
-				{
-					modelParam.m_pInterpolatorParam = (ParticleInterpolatorParam *)RelocateFirstPointers();
-					for(uint32 k=0; k<modelParam.m_InterpolatorCount; ++k)
-					{
-						ParticleInterpolatorParam& interpolatorParam = modelParam.m_pInterpolatorParam[k];
-						if(interpolatorParam.m_InterpolatorType == Interpolator_SelfDefine)
-						{
-							ParticleSelfDefInterpolatorData& selfDefData = interpolatorParam.m_SelfDefData;
-							if( selfDefData.m_count > 0 )
-								selfDefData.m_pEntry = (ParticleEntryParam *)RelocateFirstPointers();
-
-						}
-					}
-				}
-
-				// Particle Emitter
-				if( groupParam.m_nEmitterCount > 0 )
-					groupParam.m_pEmitterParam = (ParticleEmitterParam *)RelocateFirstPointers();
-
-				// Particle Modifier
-				if( groupParam.m_nModifierCount > 0 )
-					groupParam.m_pModifierParam = (ParticleModifierParam *)RelocateFirstPointers();
-			}
-		}
-
-	}
-	// RIBBON
-	{
-	}
-	// Config Setting
-	if( m_Header.m_iNumConfigs > 0 )
-	{
-		for( uint32 i = 0; i < m_Header.m_iNumConfigs; i++ )
-		{
-			if( m_pConfigSetting[i].MeshConfigNum > 0 )
-				m_pConfigSetting[i].pMeshConfigList = (SGPMF1ConfigSetting::MeshConfig *)RelocateFirstPointers();
-			if( m_pConfigSetting[i].ReplaceTextureConfigNum > 0 )
-				m_pConfigSetting[i].pReplaceTextureConfigList = (SGPMF1ConfigSetting::ReplaceTextureConfig *)RelocateFirstPointers();
-			if( m_pConfigSetting[i].ParticleConfigNum > 0 )
-				m_pConfigSetting[i].pParticleConfigList = (SGPMF1ConfigSetting::ParticleConfig *)RelocateFirstPointers();
-			if( m_pConfigSetting[i].RibbonConfigNum > 0 )
-				m_pConfigSetting[i].pRibbonConfigList = (SGPMF1ConfigSetting::RibbonConfig *)RelocateFirstPointers();
-		}
-		(SGPMF1ConfigSetting*)RelocateFirstPointers();
-	}
-
-	return SaveResult;
+	return Writer.writeToFile( File(AbsolutePath) );
 }
 
 //-------------------------------------------------------------
@@ -756,9 +872,7 @@ bool CSGPModelMF1::SaveMF1(const String& WorkingDir, const String& Filename)
 //-------------------------------------------------------------
 bool CSGPModelMF1::SaveBone(const String& WorkingDir, const String& BoneFilename, uint16 BoneFileIndex)
 {
-	bool SaveResult = true;
-	s_CurFileOffset = 0;
-	s_CollectPtrs.clear();
+	SGPModelFileWriter Writer( 1 );
 
 	Array<uint16> BackupTransFrameNum;
 	Array<uint16> BackupRotsFrameNum;
@@ -791,13 +905,12 @@ bool CSGPModelMF1::SaveBone(const String& WorkingDir, const String& BoneFilename
 	BF1Header.m_iNumBones = m_iNumBones;
 	BF1Header.m_iNumBoneGroup = m_iNumBoneGroup;
 
-	CollectPointers(&BF1Header, sizeof(SGPMF1BoneHeader));
+	Writer.addBlock(&BF1Header, sizeof(SGPMF1BoneHeader));
 
-	BF1Header.m_iBonesOffset = CollectPointers(m_pBones, sizeof(SGPMF1Bone) * m_iNumBones);
+	BF1Header.m_iBonesOffset = Writer.getBlockOffset( Writer.addBlock(m_pBones, sizeof(SGPMF1Bone) * m_iNumBones) );
 	for(uint32 i=0; i<m_iNumBones; i++)
 	{
-		if( m_pBones[i].m_iNumChildId > 0 )
-			m_pBones[i].m_ChildIds = (uint16*)CollectPointers( m_pBones[i].m_ChildIds, sizeof(uint16) * m_pBones[i].m_iNumChildId );
+		Writer.addPointer( &m_pBones[i].m_ChildIds, Writer.addBlock( m_pBones[i].m_ChildIds, sizeof(uint16) * m_pBones[i].m_iNumChildId ) );
 
 		BackupTransFrameNum.add(m_pBones[i].m_TransKeyFrames->m_iNumber);
 		BackupRotsFrameNum.add(m_pBones[i].m_RotsKeyFrames->m_iNumber);
@@ -881,19 +994,25 @@ bool CSGPModelMF1::SaveBone(const String& WorkingDir, const String& BoneFilename
 		pScaleKeyFrames->m_iNumber = ScaleKFNum;
 		pVisibleKeyFrames->m_iNumber = VisibleKFNum;
 
-		m_pBones[i].m_TransKeyFrames = (KeyFrameBlock*)CollectPointers( m_pBones[i].m_TransKeyFrames, sizeof(KeyFrameBlock) );
-		m_pBones[i].m_RotsKeyFrames = (KeyFrameBlock*)CollectPointers( m_pBones[i].m_RotsKeyFrames, sizeof(KeyFrameBlock) );
-		m_pBones[i].m_ScaleKeyFrames = (ScaleKeyFrameBlock*)CollectPointers( m_pBones[i].m_ScaleKeyFrames, sizeof(ScaleKeyFrameBlock) );
-		m_pBones[i].m_VisibleKeyFrames = (VisibleKeyFrameBlock*)CollectPointers( m_pBones[i].m_VisibleKeyFrames, sizeof(VisibleKeyFrameBlock) );
-
-		pTransKeyFrames->m_KeyFrames = (SGPMF1KeyFrame *)CollectPointers( pTransKeyFrames->m_KeyFrames + TransKFStartOffset, sizeof(SGPMF1KeyFrame) * TransKFNum, TransKFStartOffset * sizeof(SGPMF1KeyFrame));
-		pRotsKeyFrames->m_KeyFrames = (SGPMF1KeyFrame *)CollectPointers( pRotsKeyFrames->m_KeyFrames + RotsKFStartOffset, sizeof(SGPMF1KeyFrame) * RotsKFNum, RotsKFStartOffset * sizeof(SGPMF1KeyFrame));
-		pScaleKeyFrames->m_KeyFrames = (SGPMF1ScaleKeyFrame *)CollectPointers( pScaleKeyFrames->m_KeyFrames + ScaleKFStartOffset, sizeof(SGPMF1ScaleKeyFrame) * ScaleKFNum, ScaleKFStartOffset * sizeof(SGPMF1ScaleKeyFrame));
-		pVisibleKeyFrames->m_KeyFrames = (SGPMF1VisibleKeyFrame *)CollectPointers( pVisibleKeyFrames->m_KeyFrames + VisibleKFStartOffset, sizeof(SGPMF1VisibleKeyFrame) * VisibleKFNum, VisibleKFStartOffset * sizeof(SGPMF1VisibleKeyFrame));
+		Writer.addPointer( &m_pBones[i].m_TransKeyFrames, Writer.addBlock( pTransKeyFrames, sizeof(KeyFrameBlock) ) );
+		Writer.addPointer( &m_pBones[i].m_RotsKeyFrames, Writer.addBlock( pRotsKeyFrames, sizeof(KeyFrameBlock) ) );
+		Writer.addPointer( &m_pBones[i].m_ScaleKeyFrames, Writer.addBlock( pScaleKeyFrames, sizeof(ScaleKeyFrameBlock) ) );
+		Writer.addPointer( &m_pBones[i].m_VisibleKeyFrames, Writer.addBlock( pVisibleKeyFrames, sizeof(VisibleKeyFrameBlock) ) );
+
+		// Blocks of other bone files are linked when loading
+		Writer.addPointer( &pTransKeyFrames->m_nextBlock, -1 );
+		Writer.addPointer( &pRotsKeyFrames->m_nextBlock, -1 );
+		Writer.addPointer( &pScaleKeyFrames->m_nextBlock, -1 );
+		Writer.addPointer( &pVisibleKeyFrames->m_nextBlock, -1 );
+
+		Writer.addPointer( &pTransKeyFrames->m_KeyFrames, Writer.addBlock( pTransKeyFrames->m_KeyFrames + TransKFStartOffset, sizeof(SGPMF1KeyFrame) * TransKFNum ) );
+		Writer.addPointer( &pRotsKeyFrames->m_KeyFrames, Writer.addBlock( pRotsKeyFrames->m_KeyFrames + RotsKFStartOffset, sizeof(SGPMF1KeyFrame) * RotsKFNum ) );
+		Writer.addPointer( &pScaleKeyFrames->m_KeyFrames, Writer.addBlock( pScaleKeyFrames->m_KeyFrames + ScaleKFStartOffset, sizeof(SGPMF1ScaleKeyFrame) * ScaleKFNum ) );
+		Writer.addPointer( &pVisibleKeyFrames->m_KeyFrames, Writer.addBlock( pVisibleKeyFrames->m_KeyFrames + VisibleKFStartOffset, sizeof(SGPMF1VisibleKeyFrame) * VisibleKFNum ) );
 	}
 	
 
-	BF1Header.m_iBoneGroupOffset = CollectPointers( m_pBoneGroup, sizeof(SGPMF1BoneGroup) * m_iNumBoneGroup );
+	BF1Header.m_iBoneGroupOffset = Writer.getBlockOffset( Writer.addBlock( m_pBoneGroup, sizeof(SGPMF1BoneGroup) * m_iNumBoneGroup ) );
 
 
 
@@ -907,48 +1026,17 @@ bool CSGPModelMF1::SaveBone(const String& WorkingDir, const String& BoneFilename
 	if( BoneFileIndex > 0 )
 		AbsolutePath = AbsolutePath + String(BoneFileIndex);
 
-
-	ScopedPointer<FileOutputStream> fileStream( File(AbsolutePath).createOutputStream() );
-	if (fileStream != nullptr && fileStream->openedOk() )
-    {
-		fileStream->setPosition(0);
-		fileStream->truncate();
-
-		for( int i=0; i<s_CollectPtrs.size(); i++ )
-		{
-			fileStream->write( (const uint8*)s_CollectPtrs[i].pDataPointer, s_CollectPtrs[i].DataSize );
-		}
-
-		fileStream->flush();
-	}
-	else
-		SaveResult = false;
+	bool SaveResult = Writer.writeToFile( File(AbsolutePath) );
 	//-------------------------------------------------------------
 
-	// Reset Pointers - For release memory correctly
-	RelocateFirstPointers();							//SGPMF1BoneHeader
-	(SGPMF1Bone*)RelocateFirstPointers();
+	// Restore key frame number of every bone
 	for(uint32 i=0; i<m_iNumBones; i++)
 	{
-		if( m_pBones[i].m_iNumChildId > 0 )
-			m_pBones[i].m_ChildIds = (uint16*)RelocateFirstPointers();
-
-		m_pBones[i].m_TransKeyFrames = (KeyFrameBlock*)RelocateFirstPointers();
-		m_pBones[i].m_RotsKeyFrames = (KeyFrameBlock*)RelocateFirstPointers();
-		m_pBones[i].m_ScaleKeyFrames = (ScaleKeyFrameBlock*)RelocateFirstPointers();
-		m_pBones[i].m_VisibleKeyFrames = (VisibleKeyFrameBlock*)RelocateFirstPointers();
-
-		m_pBones[i].m_TransKeyFrames->m_KeyFrames = (SGPMF1KeyFrame*)RelocateFirstPointers();
-		m_pBones[i].m_RotsKeyFrames->m_KeyFrames = (SGPMF1KeyFrame*)RelocateFirstPointers();
-		m_pBones[i].m_ScaleKeyFrames->m_KeyFrames = (SGPMF1ScaleKeyFrame*)RelocateFirstPointers();
-		m_pBones[i].m_VisibleKeyFrames->m_KeyFrames = (SGPMF1VisibleKeyFrame*)RelocateFirstPointers();
-	
 		m_pBones[i].m_TransKeyFrames->m_iNumber = BackupTransFrameNum[i];
 		m_pBones[i].m_RotsKeyFrames->m_iNumber = BackupRotsFrameNum[i];
 		m_pBones[i].m_ScaleKeyFrames->m_iNumber = BackupScaleFrameNum[i];
 		m_pBones[i].m_VisibleKeyFrames->m_iNumber = BackupVisibleFrameNum[i];		
 	}
-	(SGPMF1BoneGroup *)RelocateFirstPointers();
 
 	return SaveResult;
 }
@@ -1037,40 +1125,24 @@ bool CSGPModelMF1::GetMeshPointFromSecondTexCoord( Vector3D& position, Vector3D&
 	return false;
 }
 
-
-
-
-
-
-
-
-
-
-
-
 //-------------------------------------------------------------
-//	In this function you transfer the pDataBuffer pointers to file offset according to DataSize.
-//  the pointers are adjusted to become an offset from the beginning of the block.
+//- FindSection
+//- Find a top-level section in a version 2 MF1 file data,
+//- the data can be used before or after LoadMF1()
 //-------------------------------------------------------------
-uint32 CSGPModelMF1::CollectPointers( void* pDataBuffer, uint32 DataSize, uint32 RawOffset )
+const SGPMF1Section* CSGPModelMF1::FindSection( const void* pMF1FileData, uint32 SectionType )
 {
-	if( !pDataBuffer || DataSize == 0 )
-		return 0;
-
-	PtrOffset DataOffset;
-	DataOffset.pDataPointer = pDataBuffer;
-	DataOffset.DataSize = DataSize;
-	DataOffset.RawOffset = RawOffset;
-	s_CollectPtrs.add(DataOffset);
-
-	s_CurFileOffset += DataSize;
+	const uint8* ucpBuffer = (const uint8*)pMF1FileData;
+	const CSGPModelMF1* pModelMF1 = (const CSGPModelMF1*)ucpBuffer;
+	if( pModelMF1->m_Header.m_iId != 0xCAFE2BEE || pModelMF1->m_Header.m_iVersion != SGPMF1_VERSION )
+		return NULL;
 
-	return s_CurFileOffset - DataSize;
+	const SGPMF1FileLayout* pLayout = (const SGPMF1FileLayout*)(ucpBuffer + SGPMF1_LAYOUT_OFFSET);
+	const SGPMF1Section* pSections = (const SGPMF1Section*)(ucpBuffer + pLayout->m_iSectionOffset);
+	for( uint32 i=0; i<pLayout->m_iNumSections; i++ )
+	{
+		if( pSections[i].m_iType == SectionType )
+			return &pSections[i];
+	}
+	return NULL;
 }
-
-//Return recorded original pointer from Array
-void* CSGPModelMF1::RelocateFirstPointers()
-{
-	PtrOffset DataOffset = s_CollectPtrs.remove(0);
-	return (void*)((intptr_t)DataOffset.pDataPointer - DataOffset.RawOffset);
-}
\ No newline at end of file
@@ -184,7 +184,32 @@ Effect Attachment	|      AttachBoneID         uint16				|
 					|-----------------------------------------------|
 */
 //------------------------------------------------------------------
+/*
+	MF1 Version 2
+	Same data as version 1 above, but every block starts at 16 bytes aligned
+	file offset, and two more blocks are added:
+
+	Layout			|  SGPMF1FileLayout, right after CSGPModelMF1   |
+					|  (at file offset of SGPMF1_LAYOUT_OFFSET)		|
+					|-----------------------------------------------|
+	Sections		|  SGPMF1Section * m_iNumSections				|
+					|-----------------------------------------------|
+
+	Every pointer is a SGPMF1Pointer (8 bytes in all applications), which holds
+	uint32 offset from the pointer itself to the data, so 32-bit and 64-bit
+	applications load the same file, and use it in place without changing it.
+	Sections can be read in place before (or without) loading, see
+	CSGPModelMF1::GetSectionData().
+
+	Pointers of version 1 file have the size of the application which saved it
+	(4 bytes in 32-bit build), LoadMF1() reads it with either size and converts it
+	to version 2 in a temporary file.
+*/
+//------------------------------------------------------------------
 
+#define SGPMF1_VERSION				2
+#define SGPMF1_BLOCK_ALIGNMENT		16
+#define SGPMF1_LAYOUT_OFFSET		((sizeof(CSGPModelMF1) + SGPMF1_BLOCK_ALIGNMENT - 1) & ~(SGPMF1_BLOCK_ALIGNMENT - 1))
 
 
 
@@ -199,7 +224,7 @@ Effect Attachment	|      AttachBoneID         uint16				|
 struct SGPMF1Header
 {
 	uint32 m_iId;				//Must be 0xCAFE2BEE (magic number)
-	uint32 m_iVersion;			//Must be 1
+	uint32 m_iVersion;			//Must be 1 or 2 (SGPMF1_VERSION)
 	char m_cFilename[64];		//Full filename (Relative Path to application's executable file, usually in Bin Floder)
 
 	uint32 m_iUVAnim;			//Have texture coord anim in this MF1?
@@ -237,7 +262,7 @@ struct SGPMF1Header
 	uint32 m_iHeaderSize;		//Size of this header
 
 
-	SGPMF1Header() : m_iId(0xCAFE2BEE), m_iVersion(1), m_iNumLods(1), m_iUVAnim(0),
+	SGPMF1Header() : m_iId(0xCAFE2BEE), m_iVersion(SGPMF1_VERSION), m_iNumLods(1), m_iUVAnim(0),
 		m_iBipBoneID(-1), m_iNumSkins(0), m_iNumBoneAnimFile(0), m_iNumActionList(0),
 		m_iNumMeshes(0), m_iNumParticles(0), m_iNumRibbons(0), m_iNumConfigs(0),
 		m_iNumAttc(0), m_iNumEttc(0), m_iLod1MeshOffset(0), m_iLod2MeshOffset(0)
@@ -247,6 +272,42 @@ struct SGPMF1Header
 };
 
 
+//-------------------------------------------------------------
+//- SGPMF1FileLayout
+//- Version 2 file, where to find sections and relocations
+struct SGPMF1FileLayout
+{
+	uint32 m_iAlignment;			//Alignment of every block in file
+
+	uint32 m_iNumSections;			//Number of SGPMF1Section
+	uint32 m_iSectionOffset;		//File offset of SGPMF1Section table
+
+	SGPMF1FileLayout() : m_iAlignment(16), m_iNumSections(0), m_iSectionOffset(0) {}
+};
+
+//-------------------------------------------------------------
+//- SGPMF1Section
+//- Version 2 file, A top-level data array in the file
+enum SGPMF1SectionType
+{
+	SGPMF1_SECTION_SKIN = 1,
+	SGPMF1_SECTION_LOD0MESH,
+	SGPMF1_SECTION_BONEFILENAME,
+	SGPMF1_SECTION_ACTIONLIST,
+	SGPMF1_SECTION_ATTACHMENT,
+	SGPMF1_SECTION_EFFECTATTACHMENT,
+	SGPMF1_SECTION_PARTICLE,
+	SGPMF1_SECTION_CONFIGSETTING
+};
+
+struct SGPMF1Section
+{
+	uint32 m_iType;				//SGPMF1SectionType
+	uint32 m_iCount;			//Number of elements
+	uint32 m_iOffset;			//File offset of first element
+	uint32 m_iSize;				//Size in bytes of all elements
+};
+
 //-------------------------------------------------------------
 //- SGPMF1Vertex
 //- A single vertex in the MF1 file
@@ -311,7 +372,7 @@ struct SGPMF1Skin
 
 
 	uint32 m_iNumMatKeyFrame;	// Material Key Frame count
-	SGPMF1MatKeyFrame * m_pMatKeyFrame;
+	SGPMF1Pointer<SGPMF1MatKeyFrame> m_pMatKeyFrame;
 
 	SGPMF1Skin()
 	{
@@ -364,16 +425,16 @@ struct SGPMF1Mesh
 	char m_cName[64];					//Mesh name
 
 	uint32 m_iNumVerts;					//Number of vertices
-	SGPMF1Vertex * m_pVertex;			//vertices data
+	SGPMF1Pointer<SGPMF1Vertex> m_pVertex;			//vertices data
 	uint32 m_iNumIndices;				//Number of indices
-	uint16 * m_pIndices;				//index data
-	uint16 * m_pVertexBoneGroupID;		//Vertex Bone Group ID (num is m_iNumVerts)
+	SGPMF1Pointer<uint16> m_pIndices;				//index data
+	SGPMF1Pointer<uint16> m_pVertexBoneGroupID;		//Vertex Bone Group ID (num is m_iNumVerts)
 	uint32 m_iNumUV0;					//Number of UV0
-	SGPMF1TexCoord * m_pTexCoords0;		//Texture coordinate set 0
+	SGPMF1Pointer<SGPMF1TexCoord> m_pTexCoords0;		//Texture coordinate set 0
 	uint32 m_iNumUV1;					//Number of UV1
-	SGPMF1TexCoord * m_pTexCoords1;		//Texture coordinate set 1
+	SGPMF1Pointer<SGPMF1TexCoord> m_pTexCoords1;		//Texture coordinate set 1
 	uint32 m_iNumVertexColor;			//Number of Vertex color
-	SGPMF1VertexColor * m_pVertexColor; //Data for vertex color
+	SGPMF1Pointer<SGPMF1VertexColor> m_pVertexColor; //Data for vertex color
 
 	uint32 m_SkinIndex;
 	uint32 m_nType;
@@ -471,11 +532,11 @@ public:
 	~CSGPModelMF1();
 
 	//Load an MF1 mesh model
-	//Return the raw memory allocated from file
-	static uint8* LoadMF1(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& Filename);
+	//Return the memory mapped file which holds the loaded data, delete it when no longer used
+	static MemoryMappedFile* LoadMF1(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& Filename);
 	//Load an MF1 bone animation file
-	//Return the raw memory allocated from file
-	static uint8* LoadBone(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& BoneFilename, uint16 BoneFileIndex = 0);
+	//Return the memory mapped file which holds the loaded data, delete it when no longer used
+	static MemoryMappedFile* LoadBone(CSGPModelMF1* &pOutModelMF1, const String& WorkingDir, const String& BoneFilename, uint16 BoneFileIndex = 0);
 
 	//Save an MF1 mesh model
 	bool SaveMF1(const String& WorkingDir, const String& szFilename);
@@ -486,16 +547,18 @@ public:
 	bool GetMeshPointFromSecondTexCoord( Vector3D& position, Vector3D& normal, const Vector2D& uv, const Matrix4x4& modelMatrix );
 
 
-	//This function is used when saving. 
-	//In this function you transfer the pDataBuffer pointers to file offset according to DataSize.
-	//the pointers are adjusted to become an offset from the beginning of the block.
-	uint32 CollectPointers( void* pDataBuffer, uint32 DataSize, uint32 RawOffset = 0 );
-	
-	//Return recorded original pointer from Array
-	//Because CollectPointers() function will adjust pointer to offset
-	//Alloced memory in this pointer will miss when deleted
-	//After save function, those pointers should be relocated 
-	void * RelocateFirstPointers();
+	//Find a top-level section in a version 2 MF1 file data (loaded or not),
+	//Return NULL if not found or the data is a version 1 file.
+	static const SGPMF1Section* FindSection( const void* pMF1FileData, uint32 SectionType );
+
+	//Return the section data of a version 2 MF1 file, as an array of T
+	template <typename T>
+	static const T* GetSectionData( const void* pMF1FileData, uint32 SectionType, uint32& Count )
+	{
+		const SGPMF1Section* pSection = FindSection( pMF1FileData, SectionType );
+		Count = pSection ? pSection->m_iCount : 0;
+		return pSection ? (const T*)((const uint8*)pMF1FileData + pSection->m_iOffset) : NULL;
+	}
 
 public:
 	//File header
@@ -505,40 +568,40 @@ public:
 	AABBox m_MeshAABBox;
 
 	//Skins
-	SGPMF1Skin * m_pSkins;
+	SGPMF1Pointer<SGPMF1Skin> m_pSkins;
 
 	//Meshes
-	SGPMF1Mesh * m_pLOD0Meshes;
-	SGPMF1Mesh * m_pLOD1Meshes;
-	SGPMF1Mesh * m_pLOD2Meshes;
+	SGPMF1Pointer<SGPMF1Mesh> m_pLOD0Meshes;
+	SGPMF1Pointer<SGPMF1Mesh> m_pLOD1Meshes;
+	SGPMF1Pointer<SGPMF1Mesh> m_pLOD2Meshes;
 
 
 	//Bone & Skeleton Anim filename
-	SGPMF1BoneFileName * m_pBoneFileNames;
+	SGPMF1Pointer<SGPMF1BoneFileName> m_pBoneFileNames;
 
 	//Action List
-	SGPMF1ActionList * m_pActionLists;
+	SGPMF1Pointer<SGPMF1ActionList> m_pActionLists;
 
 	//Attachment helper Tags
-	SGPMF1AttachmentTag * m_pAttachTags;
-	SGPMF1AttachmentTag * m_pEffectTags;	
+	SGPMF1Pointer<SGPMF1AttachmentTag> m_pAttachTags;
+	SGPMF1Pointer<SGPMF1AttachmentTag> m_pEffectTags;	
 
 
 
 	//Bone Info
-	SGPMF1Bone * m_pBones;					// every bone data
+	SGPMF1Pointer<SGPMF1Bone> m_pBones;					// every bone data
 
 	//Bone Group Info
-	SGPMF1BoneGroup * m_pBoneGroup;			// BoneGroup data
+	SGPMF1Pointer<SGPMF1BoneGroup> m_pBoneGroup;			// BoneGroup data
 
 	//Particle Info
-	SGPMF1ParticleTag * m_pParticleEmitter;	// Particles data
+	SGPMF1Pointer<SGPMF1ParticleTag> m_pParticleEmitter;	// Particles data
 
 	//Ribbon Reserved
-	void * m_pRibbonEmitter;
+	SGPMF1Pointer<void> m_pRibbonEmitter;
 
 	//Config Setting
-	SGPMF1ConfigSetting * m_pConfigSetting;	// Config data
+	SGPMF1Pointer<SGPMF1ConfigSetting> m_pConfigSetting;	// Config data
 
 
 	uint32		 m_iNumBones;
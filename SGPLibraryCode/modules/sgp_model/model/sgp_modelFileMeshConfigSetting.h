@@ -36,10 +36,10 @@ struct SGPMF1ConfigSetting
 	uint32 ParticleConfigNum;			// Number of particle setting for this MF1 config
 	uint32 RibbonConfigNum;				// Number of ribbon setting for this MF1 config
 
-	MeshConfig *pMeshConfigList;						// Mesh Config List
-	ReplaceTextureConfig *pReplaceTextureConfigList;	// ReplaceTexture Config List
-	ParticleConfig *pParticleConfigList;				// Particle Config List
-	RibbonConfig *pRibbonConfigList;					// Ribbon Config List
+	SGPMF1Pointer<MeshConfig> pMeshConfigList;						// Mesh Config List
+	SGPMF1Pointer<ReplaceTextureConfig> pReplaceTextureConfigList;	// ReplaceTexture Config List
+	SGPMF1Pointer<ParticleConfig> pParticleConfigList;				// Particle Config List
+	SGPMF1Pointer<RibbonConfig> pRibbonConfigList;					// Ribbon Config List
 
 	SGPMF1ConfigSetting() : MeshConfigNum(0), ReplaceTextureConfigNum(0), ParticleConfigNum(0), RibbonConfigNum(0)
 	{
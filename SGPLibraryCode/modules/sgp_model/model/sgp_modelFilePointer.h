@@ -0,0 +1,55 @@
+#ifndef __SGP_MODELFILEPOINTER_HEADER__
+#define __SGP_MODELFILEPOINTER_HEADER__
+
+//High 32 bits of a pointer field saved in a version 2 MF1 file.
+//Never the high bits of an address, no application has its data there.
+#define SGPMF1_FILE_OFFSET_TAG		0xFFFFFFFF
+
+#pragma pack(push, packing)
+#pragma pack(1)
+
+//-------------------------------------------------------------
+//- SGPMF1Pointer
+//- A pointer field of the structures saved in MF1 file.
+//- It is 8 bytes in both 32-bit and 64-bit applications, so the structures
+//- (and the files) have the same layout for all of them.
+//- At runtime it holds an address. In a version 2 MF1 file it holds a uint32
+//- offset from the field itself to the data, which get() resolves,
+//- so the file is used in place without changing it.
+//- A field read from file must not be copied to another address with memcpy,
+//- assign get() to the new field instead.
+template <typename Type>
+struct SGPMF1Pointer
+{
+	uint32 m_iLow;				//Low 32 bits of address, or offset from this field in file
+	uint32 m_iHigh;				//High 32 bits of address, or SGPMF1_FILE_OFFSET_TAG in file
+
+	Type* get() const
+	{
+		if( m_iHigh == SGPMF1_FILE_OFFSET_TAG )
+			return (Type*)((uint8*)this + m_iLow);
+		return (Type*)(pointer_sized_uint)(((uint64)m_iHigh << 32) | m_iLow);
+	}
+
+	void set( Type* pAddress )
+	{
+		uint64 Address = (uint64)(pointer_sized_uint)pAddress;
+		m_iLow = (uint32)Address;
+		m_iHigh = (uint32)(Address >> 32);
+	}
+
+	//Field offset of version 2 MF1 file, Offset is from this field to the data
+	void setFileOffset( uint32 Offset )
+	{
+		m_iLow = Offset;
+		m_iHigh = SGPMF1_FILE_OFFSET_TAG;
+	}
+
+	operator Type*() const						{ return get(); }
+	Type* operator->() const					{ return get(); }
+	SGPMF1Pointer& operator=( Type* pAddress )	{ set(pAddress); return *this; }
+};
+
+#pragma pack(pop, packing)
+
+#endif		// __SGP_MODELFILEPOINTER_HEADER__
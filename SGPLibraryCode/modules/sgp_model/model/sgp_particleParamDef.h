@@ -34,7 +34,7 @@ struct ParticleEntryParam
 struct ParticleSelfDefInterpolatorData
 {
 	uint32 m_count;
-	ParticleEntryParam* m_pEntry;
+	SGPMF1Pointer<ParticleEntryParam> m_pEntry;
 };
 
 // Sinusoidal Interpolator
@@ -108,9 +108,9 @@ struct ParticleModelParam
 	uint32 m_InterpolatedFlag;
 	
 	uint32 m_ParamCount;
-	ParticleRegularParam *m_pRegularParam;
+	SGPMF1Pointer<ParticleRegularParam> m_pRegularParam;
 	uint32 m_InterpolatorCount;
-	ParticleInterpolatorParam* m_pInterpolatorParam;
+	SGPMF1Pointer<ParticleInterpolatorParam> m_pInterpolatorParam;
 
 	ParticleModelParam()
 	{
@@ -476,9 +476,9 @@ struct ParticleGroupParam
 	ParticleModelParam m_ModelParam;
 	ParticleRenderParam m_RenderParam;
 	uint32 m_nEmitterCount;
-	ParticleEmitterParam *m_pEmitterParam;
+	SGPMF1Pointer<ParticleEmitterParam> m_pEmitterParam;
 	uint32 m_nModifierCount;
-	ParticleModifierParam *m_pModifierParam;
+	SGPMF1Pointer<ParticleModifierParam> m_pModifierParam;
 
 	ParticleGroupParam()
 	{
@@ -510,7 +510,7 @@ struct ParticleSystemParam
 {
 	bool m_bEnableAABBCompute;
 	uint32 m_groupCount;
-	ParticleGroupParam* m_pGroupParam;
+	SGPMF1Pointer<ParticleGroupParam> m_pGroupParam;
 
 	ParticleSystemParam()
 	{
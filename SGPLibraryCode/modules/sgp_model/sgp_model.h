@@ -6,6 +6,9 @@
 
 namespace sgp
 {
+#ifndef	__SGP_MODELFILEPOINTER_HEADER__
+ #include "model/sgp_modelFilePointer.h"
+#endif
 #ifndef	__SGP_MODELFILESETTINGFLAG_HEADER__
  #include "model/sgp_modelFileSettingFlag.h"
 #endif
@@ -79,7 +79,7 @@ void CEffectInstance::destroyEffect()
 	}
 }
 
-bool CEffectInstance::update( float deltaTimeinSeconds )
+bool CEffectInstance::update( float deltaTimeinSeconds, Array<CSkeletonMeshInstance*>* pSkeletonInstances )
 {
 	if( !m_bVisible || (m_fEffectAlpha < 0.01f) )
 		return false;
@@ -106,7 +106,13 @@ bool CEffectInstance::update( float deltaTimeinSeconds )
 			}
 		}
 
-		bResult = m_pSkeletonMeshInstance->update( deltaTimeinSeconds );
+		if( pSkeletonInstances )
+		{
+			pSkeletonInstances->add( m_pSkeletonMeshInstance );
+			bResult = true;
+		}
+		else
+			bResult = m_pSkeletonMeshInstance->update( deltaTimeinSeconds );
 	}
 	else if( m_pStaticMeshInstance )
 	{
@@ -12,7 +12,9 @@ public:
 	void		destroyEffect( void );
 
 	// Update and Render
-	bool		update( float deltaTimeinSeconds );
+	// If pSkeletonInstances is not NULL, the skeleton mesh instance is added to it instead of
+	// being updated, the caller updates them together with ISGPInstanceManager::updateSkeletonInstances()
+	bool		update( float deltaTimeinSeconds, Array<CSkeletonMeshInstance*>* pSkeletonInstances = NULL );
 	void		render();
 
 	// Setting Interface
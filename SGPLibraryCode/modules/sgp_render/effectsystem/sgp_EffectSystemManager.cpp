@@ -62,14 +62,19 @@ void ISGPEffectSystemManager::renderAllEffectInstance()
 
 
 
-void ISGPEffectSystemManager::updateAllEffectInstance( float deltaTimeinSeconds )
+void ISGPEffectSystemManager::updateAllEffectInstance( float deltaTimeinSeconds, uint32 nFrameIndex )
 {
+	m_SkeletonInstances.clearQuick();
+
 	CEffectInstance** pEnd = m_EffectInstanceArray.end();
 	for( CEffectInstance** pbegin = m_EffectInstanceArray.begin(); pbegin < pEnd; pbegin++ )
 	{
 		if( (*pbegin) )
-			(*pbegin)->update(deltaTimeinSeconds);
+			(*pbegin)->update(deltaTimeinSeconds, &m_SkeletonInstances);
 	}
+
+	// Bone evaluation of all effects in parallel
+	m_pRenderDevice->GetInstanceManager()->updateSkeletonInstances( m_SkeletonInstances, deltaTimeinSeconds, nFrameIndex );
 }
 
 void ISGPEffectSystemManager::clearAllEffectInstance()
@@ -25,7 +25,8 @@ public:
 	void renderAllEffectInstance();
 
 	//! Update all effect instance in the manager
-	void updateAllEffectInstance( float deltaTimeinSeconds );
+	// nFrameIndex is the frame counter of the render loop (see ISGPInstanceManager::updateSkeletonInstances())
+	void updateAllEffectInstance( float deltaTimeinSeconds, uint32 nFrameIndex );
 
 	//! Removes all effect instance from the manager and deletes them.
 	void clearAllEffectInstance();
@@ -53,6 +54,8 @@ private:
 	String							m_WorkingDir;
 
 	OwnedArray< CEffectInstance >	m_EffectInstanceArray;	// EffectInstance array
+
+	Array< CSkeletonMeshInstance* >	m_SkeletonInstances;	// Skeleton instances of effects updated this frame
 };
 
 #endif		// __SGP_EFFECTSYSTEMMANAGER_HEADER__
\ No newline at end of file
@@ -1,16 +1,134 @@
 
-
 uint8 ISGPInstanceManager::DefaultSkeletonFPS = 30;
 float ISGPInstanceManager::DefaultSecondsPerFrame = 1.0f / ISGPInstanceManager::DefaultSkeletonFPS;
 float ISGPInstanceManager::DefaultSecondsActionBlend = 0.3f;
+float ISGPInstanceManager::UpdateLODLowRateDistance = 60.0f;
+float ISGPInstanceManager::UpdateLODPauseDistance = 150.0f;
+float ISGPInstanceManager::UpdateLODLowRateStep = 0.1f;
+float ISGPInstanceManager::UpdateLODMaxCatchUpTime = 2.0f;
+bool ISGPInstanceManager::AnimLODEnabled = false;
+float ISGPInstanceManager::AnimLODFullDistance = 15.0f;
+float ISGPInstanceManager::AnimLODIntervalDistance = 40.0f;
+float ISGPInstanceManager::AnimLODReducedDistance = 80.0f;
+uint32 ISGPInstanceManager::AnimLODUpdateInterval = 3;
+uint32 ISGPInstanceManager::AnimLODMaxBoneEvaluations = 0;
+
+
+ISGPInstanceManager::ISGPInstanceManager(ISGPRenderDevice *pdevice)
+	: m_pRenderDevice(pdevice), m_nBudgetFrame(0), m_nBonesEvaluatedInFrame(0)
+{
+}
+
+ISGPInstanceManager::~ISGPInstanceManager()
+{
+}
 
+void ISGPInstanceManager::addSkeletonInstance( CSkeletonMeshInstance* pInstance )
+{
+	m_SkeletonInstance.addIfNotAlreadyThere(pInstance);
+}
 
-void ISGPInstanceManager::updateAllSkeletonInstance( float deltaTimeinSeconds )
+void ISGPInstanceManager::removeSkeletonInstance( CSkeletonMeshInstance* pInstance )
 {
-	for( int i=0; i<m_SkeletonInstance.size(); i++ )
+	m_SkeletonInstance.removeFirstMatchingValue(pInstance);
+}
+
+void ISGPInstanceManager::updateAllSkeletonInstance( float deltaTimeinSeconds, uint32 nFrameIndex )
+{
+	updateSkeletonInstances( m_SkeletonInstance, deltaTimeinSeconds, nFrameIndex );
+}
+
+void ISGPInstanceManager::updateSkeletonInstances( const Array<CSkeletonMeshInstance*>& Instances, float deltaTimeinSeconds, uint32 nFrameIndex )
+{
+	m_BoneJobs.clearQuick();
+
+	for( int i=0; i<Instances.size(); i++ )
 	{
-		m_SkeletonInstance[i]->update(deltaTimeinSeconds);
+		if( Instances[i]->updateBegin(deltaTimeinSeconds) )
+			m_BoneJobs.add( Instances[i] );
 	}
+
+	if( AnimLODMaxBoneEvaluations > 0 )
+		applyBoneEvaluationBudget( m_BoneJobs, nFrameIndex );
+
+	// One instance per job, the cost of an instance depends on its LOD and bone count
+	BoneJobRunner Runner = { &m_BoneJobs };
+	JobScheduler::getSharedScheduler().parallelFor( 0, m_BoneJobs.size(), Runner, 1 );
+
+	for( int i=0; i<m_BoneJobs.size(); i++ )
+		m_BoneJobs[i]->updateEnd();
+}
+
+void ISGPInstanceManager::BoneJobRunner::operator() (int begin, int end) const
+{
+	for( int i=begin; i<end; i++ )
+		pBoneJobs->getUnchecked(i)->updateBones();
+}
+
+void ISGPInstanceManager::applyBoneEvaluationBudget( const Array<CSkeletonMeshInstance*>& BoneJobs, uint32 nFrameIndex )
+{
+	// A new frame index starts a new budget
+	if( nFrameIndex != m_nBudgetFrame )
+	{
+		m_nBudgetFrame = nFrameIndex;
+		m_nBonesEvaluatedInFrame = 0;
+	}
+
+	uint32 nTotalCost = 0;
+	for( int i=0; i<BoneJobs.size(); i++ )
+		nTotalCost += BoneJobs[i]->getBoneEvaluationCost();
+	if( m_nBonesEvaluatedInFrame + nTotalCost <= AnimLODMaxBoneEvaluations )
+	{
+		m_nBonesEvaluatedInFrame += nTotalCost;
+		return;
+	}
+
+	// Nearest instances are evaluated first (each deferred frame makes an instance nearer),
+	// the others keep their pose and try again next frame
+	Array<CSkeletonMeshInstance*> SortedJobs( BoneJobs );
+	AnimLODDistanceSorter Sorter;
+	SortedJobs.sort( Sorter );
+
+	for( int i=0; i<SortedJobs.size(); i++ )
+	{
+		const uint32 nJobCost = SortedJobs[i]->getBoneEvaluationCost();
+		if( nJobCost == 0 )
+			continue;
+		if( (m_nBonesEvaluatedInFrame + nJobCost > AnimLODMaxBoneEvaluations) && SortedJobs[i]->deferBoneEvaluation() )
+			continue;
+		m_nBonesEvaluatedInFrame += nJobCost;
+	}
+}
+
+int ISGPInstanceManager::AnimLODDistanceSorter::compareElements( CSkeletonMeshInstance* first, CSkeletonMeshInstance* second )
+{
+	const float fFirst = first->getBoneEvaluationPriority();
+	const float fSecond = second->getBoneEvaluationPriority();
+	if( fFirst < fSecond )
+		return -1;
+	if( fFirst > fSecond )
+		return 1;
+	return 0;
+}
+
+SGP_ANIM_LOD ISGPInstanceManager::getAnimLOD( float fDistance )
+{
+	if( !AnimLODEnabled || (fDistance < AnimLODFullDistance) )
+		return SGPAL_FULL;
+	if( fDistance < AnimLODIntervalDistance )
+		return SGPAL_INTERVAL;
+	if( fDistance < AnimLODReducedDistance )
+		return SGPAL_REDUCED;
+	return SGPAL_FROZEN;
+}
+
+float ISGPInstanceManager::getParticleUpdateStep( float fDistanceSquared )
+{
+	if( fDistanceSquared > UpdateLODPauseDistance * UpdateLODPauseDistance )
+		return -1.0f;
+	if( fDistanceSquared > UpdateLODLowRateDistance * UpdateLODLowRateDistance )
+		return UpdateLODLowRateStep;
+	return 0;
 }
 
 void ISGPInstanceManager::updateAllStaticInstance( float deltaTimeinSeconds )
@@ -19,4 +137,4 @@ void ISGPInstanceManager::updateAllStaticInstance( float deltaTimeinSeconds )
 	{
 		m_StaticInstance[i]->update(deltaTimeinSeconds);
 	}
-}
\ No newline at end of file
+}
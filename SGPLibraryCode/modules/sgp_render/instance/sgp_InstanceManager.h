@@ -4,30 +4,107 @@
 class CSkeletonMeshInstance;
 class CStaticMeshInstance;
 
+//! Animation LOD tiers of skeleton instances
+enum SGP_ANIM_LOD
+{
+	SGPAL_FULL = 0,			// all bones evaluated every frame
+	SGPAL_INTERVAL,			// all bones evaluated every AnimLODUpdateInterval frames, interpolated in between
+	SGPAL_REDUCED,			// as SGPAL_INTERVAL, finger and facial bones inherit the matrix of their parent
+	SGPAL_FROZEN			// no bone evaluation, current pose is kept
+};
+
+/*
+	updateAllSkeletonInstance() updates registered skeleton instances in three phases:
+	updateBegin() of every instance in render thread, then bone palette evaluation
+	(updateBones()) of the instances as parallel jobs of the shared JobScheduler, the render
+	thread runs jobs too while it waits for them, at last updateEnd() (TBO uploading, particles and attachments) in render thread.
+	When AnimLODEnabled is set, each instance picks an animation LOD (SGP_ANIM_LOD) in updateBegin(),
+	otherwise every instance is SGPAL_FULL. When the bones to evaluate in a frame exceed
+	AnimLODMaxBoneEvaluations (0 by default, no limit), the farthest instances keep their pose
+	this frame. The budget is shared by all updateSkeletonInstances() calls with the same frame index
+	(passed by the render loop), and instances deferred in earlier frames are treated as nearer,
+	so they are not deferred forever.
+	Registered skeleton instances are NOT owned by the manager.
+*/
 class SGP_API ISGPInstanceManager
 {
 public:
-	ISGPInstanceManager(ISGPRenderDevice *pdevice) : m_pRenderDevice(pdevice)
-	{}
-	~ISGPInstanceManager() 
-	{}
+	ISGPInstanceManager(ISGPRenderDevice *pdevice);
+	~ISGPInstanceManager();
 
-	void updateAllSkeletonInstance( float deltaTimeinSeconds );
+	void addSkeletonInstance( CSkeletonMeshInstance* pInstance );
+	void removeSkeletonInstance( CSkeletonMeshInstance* pInstance );
+
+	// nFrameIndex is the frame counter of the render loop, it only has to change every frame
+	void updateAllSkeletonInstance( float deltaTimeinSeconds, uint32 nFrameIndex );
 	void updateAllStaticInstance( float deltaTimeinSeconds );
 
+	// Updates skeleton instances which are not registered (e.g. the ones of effect instances)
+	// the same way as updateAllSkeletonInstance()
+	void updateSkeletonInstances( const Array<CSkeletonMeshInstance*>& Instances, float deltaTimeinSeconds, uint32 nFrameIndex );
+
+	int getNumWorkerThreads() const { return JobScheduler::getSharedScheduler().getNumWorkers(); }
+
 public:
 	static uint8 DefaultSkeletonFPS;
 	static float DefaultSecondsPerFrame;		// Default Animation delta seconds per frame
 	static float DefaultSecondsActionBlend;		// Default Animation blend time when Action Blending
 
+	// Update LOD: invisible instances do no per-frame work, their skipped time is applied
+	// when they are visible again. Particles of visible instances are updated less often with distance.
+	static float UpdateLODLowRateDistance;		// particles farther than this are updated at low rate
+	static float UpdateLODPauseDistance;		// particles farther than this are paused
+	static float UpdateLODLowRateStep;			// seconds between two low rate particle updates
+	static float UpdateLODMaxCatchUpTime;		// most seconds simulated when paused particles resume
+
+	// Seconds of pending time needed before attached particles are updated again, -1 if paused
+	static float getParticleUpdateStep( float fDistanceSquared );
+
+	// Animation LOD of skeleton instances, from camera distance divided by instance scale
+	static bool AnimLODEnabled;					// false (default): all instances are SGPAL_FULL
+	static float AnimLODFullDistance;			// nearer instances are SGPAL_FULL
+	static float AnimLODIntervalDistance;		// nearer instances are SGPAL_INTERVAL
+	static float AnimLODReducedDistance;		// nearer instances are SGPAL_REDUCED, farther are SGPAL_FROZEN
+	static uint32 AnimLODUpdateInterval;		// frames between two bone evaluations of SGPAL_INTERVAL and SGPAL_REDUCED
+	static uint32 AnimLODMaxBoneEvaluations;	// bones evaluated per frame at most, 0 is no limit
+
+	static SGP_ANIM_LOD getAnimLOD( float fDistance );
+
+
+private:
+	//==============================================================================
+	// Runs updateBones() of m_BoneJobs [begin, end), called by JobScheduler::parallelFor()
+	struct BoneJobRunner
+	{
+		void operator() (int begin, int end) const;
+
+		const Array<CSkeletonMeshInstance*>* pBoneJobs;
+	};
+
+	// Defers bone evaluation of farthest instances when AnimLODMaxBoneEvaluations is exceeded
+	void applyBoneEvaluationBudget( const Array<CSkeletonMeshInstance*>& BoneJobs, uint32 nFrameIndex );
+
+	struct AnimLODDistanceSorter
+	{
+		static int compareElements( CSkeletonMeshInstance* first, CSkeletonMeshInstance* second );
+	};
 
 private:
 	ISGPRenderDevice*			m_pRenderDevice;
 
-	// Created Skeleton Instance Array
-	OwnedArray<CSkeletonMeshInstance> m_SkeletonInstance;
+	// Registered Skeleton Instance Array
+	Array<CSkeletonMeshInstance*> m_SkeletonInstance;
 	OwnedArray<CStaticMeshInstance> m_StaticInstance;
+
+	// Bone jobs of current frame, kept to reuse the storage
+	Array<CSkeletonMeshInstance*> m_BoneJobs;
+
+	// Bones evaluated in the frame whose index is m_nBudgetFrame
+	uint32 m_nBudgetFrame;
+	uint32 m_nBonesEvaluatedInFrame;
+
+	SGP_DECLARE_NON_COPYABLE (ISGPInstanceManager)
 };
 
 
-#endif		// __SGP_INSTANCEMANAGER_HEADER__
\ No newline at end of file
+#endif		// __SGP_INSTANCEMANAGER_HEADER__
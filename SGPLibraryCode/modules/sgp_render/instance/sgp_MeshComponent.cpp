@@ -524,180 +524,22 @@ uint32 CMeshComponent::getBoneNum()
 
 Vector3D CMeshComponent::calculateCurrentTranslation(const SGPMF1Bone *pBone, float fTime)
 {
-	Vector3D vTrans;
-	float fInterp = 0.0f;
-
-	//if there are one keyframes, don't do any transformations
-	if( pBone->m_TransKeyFrames && (pBone->m_TransKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_TransKeyFrames->m_iNumber == 1) )
-	{
-		vTrans.Set( pBone->m_TransKeyFrames->m_KeyFrames[0].m_fParam[0],
-					pBone->m_TransKeyFrames->m_KeyFrames[0].m_fParam[1],
-					pBone->m_TransKeyFrames->m_KeyFrames[0].m_fParam[2] );
-	}
-	else if( pBone->m_TransKeyFrames && (pBone->m_TransKeyFrames->m_iNumber > 1) )
-	{
-		SGPMF1KeyFrame *pLastKeyFrame = pBone->m_TransKeyFrames->m_KeyFrames;
-
-
-		//Calculate the current Translation frame
-		KeyFrameBlock *pCurTransBlock = pBone->m_TransKeyFrames;
-		while( pCurTransBlock != NULL )
-		{
-			for( int i=0; i<pCurTransBlock->m_iNumber; i++ )
-			{
-				if( pCurTransBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame >= fTime )
-				{
-					if( pCurTransBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
-						fInterp = 0;
-					else
-						fInterp = (fTime / ISGPInstanceManager::DefaultSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
-							float(pCurTransBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
-
-					vTrans.Set( pLastKeyFrame->m_fParam[0] + (pCurTransBlock->m_KeyFrames[i].m_fParam[0] - pLastKeyFrame->m_fParam[0]) * fInterp,
-								pLastKeyFrame->m_fParam[1] + (pCurTransBlock->m_KeyFrames[i].m_fParam[1] - pLastKeyFrame->m_fParam[1]) * fInterp,
-								pLastKeyFrame->m_fParam[2] + (pCurTransBlock->m_KeyFrames[i].m_fParam[2] - pLastKeyFrame->m_fParam[2]) * fInterp );
-
-					return vTrans;
-				}
-				pLastKeyFrame = &pCurTransBlock->m_KeyFrames[i];
-			}
-			pCurTransBlock = pCurTransBlock->m_nextBlock;
-		}
-	}
-	return vTrans;
+	return CalculateTranslationAtTime( pBone->m_TransKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 Quaternion CMeshComponent::calculateCurrentRotation(const SGPMF1Bone *pBone, float fTime)
 {
-	Quaternion vRots;
-	float fInterp = 0.0f;
-
-	//if there are one keyframes, don't do any transformations
-	if( pBone->m_RotsKeyFrames && (pBone->m_RotsKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_RotsKeyFrames->m_iNumber == 1) )
-	{
-		return Quaternion(  pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[0],
-							pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[1],
-							pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[2],
-							pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[3] );
-	}
-	else if( pBone->m_RotsKeyFrames && (pBone->m_RotsKeyFrames->m_iNumber > 1) )
-	{
-		SGPMF1KeyFrame *pLastKeyFrame = pBone->m_RotsKeyFrames->m_KeyFrames;
-
-
-		//Calculate the current Rotation frame
-		KeyFrameBlock *pCurRotsBlock = pBone->m_RotsKeyFrames;
-		while( pCurRotsBlock != NULL )
-		{
-			for( int i=0; i<pCurRotsBlock->m_iNumber; i++ )
-			{
-				if( pCurRotsBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame >= fTime )
-				{
-					if( pCurRotsBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
-						fInterp = 0;
-					else
-						fInterp = (fTime / ISGPInstanceManager::DefaultSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
-							float(pCurRotsBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
-
-					Quaternion vCurRots( pCurRotsBlock->m_KeyFrames[i].m_fParam[0], 
-						pCurRotsBlock->m_KeyFrames[i].m_fParam[1], 
-						pCurRotsBlock->m_KeyFrames[i].m_fParam[2], 
-						pCurRotsBlock->m_KeyFrames[i].m_fParam[3] );
-					vRots.x = pLastKeyFrame->m_fParam[0];
-					vRots.y = pLastKeyFrame->m_fParam[1];
-					vRots.z = pLastKeyFrame->m_fParam[2];
-					vRots.w = pLastKeyFrame->m_fParam[3];
-
-					vRots.Slerp(vCurRots, fInterp);
-
-					return vRots;
-				}
-				pLastKeyFrame = &pCurRotsBlock->m_KeyFrames[i];
-			}
-			pCurRotsBlock = pCurRotsBlock->m_nextBlock;
-		}
-	}
-	return vRots;
+	return CalculateRotationAtTime( pBone->m_RotsKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 float CMeshComponent::calculateCurrentScale(const SGPMF1Bone *pBone, float fTime)
 {
-	float scale = 1.0f;
-	float fInterp = 0.0f;
-
-	//if there are one keyframes, don't do any transformations
-	if( pBone->m_ScaleKeyFrames && (pBone->m_ScaleKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_ScaleKeyFrames->m_iNumber == 1) )
-	{
-		return pBone->m_ScaleKeyFrames->m_KeyFrames[0].m_scale;
-	}
-	else if( pBone->m_ScaleKeyFrames && (pBone->m_ScaleKeyFrames->m_iNumber > 1) )
-	{
-		SGPMF1ScaleKeyFrame *pLastKeyFrame = pBone->m_ScaleKeyFrames->m_KeyFrames;
-
-
-		//Calculate the current scale frame
-		ScaleKeyFrameBlock *pCurScaleBlock = pBone->m_ScaleKeyFrames;
-		while( pCurScaleBlock != NULL )
-		{
-			for( int i=0; i<pCurScaleBlock->m_iNumber; i++ )
-			{
-				if( pCurScaleBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame >= fTime )
-				{
-					if( pCurScaleBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
-						fInterp = 0;
-					else
-						fInterp = (fTime / ISGPInstanceManager::DefaultSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
-							float(pCurScaleBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
-
-					scale = pLastKeyFrame->m_scale + (pCurScaleBlock->m_KeyFrames[i].m_scale - pLastKeyFrame->m_scale) * fInterp;
-
-					return scale;
-				}
-				pLastKeyFrame = &pCurScaleBlock->m_KeyFrames[i];
-			}
-			pCurScaleBlock = pCurScaleBlock->m_nextBlock;
-		}
-
-	}
-	return scale;
+	return CalculateScaleAtTime( pBone->m_ScaleKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 bool CMeshComponent::calculateCurrentVisible(const SGPMF1Bone *pBone, float fTime)
 {
-	bool bVisible = true;
-
-	//if there are one keyframes, don't do anything
-	if( pBone->m_VisibleKeyFrames && (pBone->m_VisibleKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_VisibleKeyFrames->m_iNumber == 1) )
-	{
-		return pBone->m_VisibleKeyFrames->m_KeyFrames[0].m_Visible;
-	}
-	else if( pBone->m_VisibleKeyFrames && (pBone->m_VisibleKeyFrames->m_iNumber > 1) )
-	{
-		bVisible = pBone->m_VisibleKeyFrames->m_KeyFrames[0].m_Visible;
-
-		//Calculate the current visible frame
-		VisibleKeyFrameBlock *pCurVisibleBlock = pBone->m_VisibleKeyFrames;
-		while( pCurVisibleBlock != NULL )
-		{
-			for( int i=0; i<pCurVisibleBlock->m_iNumber; i++ )
-			{
-				if( pCurVisibleBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame == fTime )
-					return pCurVisibleBlock->m_KeyFrames[i].m_Visible;
-
-				if( pCurVisibleBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame > fTime )
-					return bVisible;
-
-				bVisible = pCurVisibleBlock->m_KeyFrames[i].m_Visible;
-			}
-			pCurVisibleBlock = pCurVisibleBlock->m_nextBlock;
-		}
-
-	}
-	return bVisible;
+	return CalculateVisibleAtTime( pBone->m_VisibleKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 
@@ -70,7 +70,7 @@ private:
 
 	// Resource
 	uint32					m_MF1ModelResourceID;		// MF1 File Resource ID in SGPModelManager Models Array
-	uint32					m_TBOID;					// index of TBO Array in VertexCacheManager
+	uint32					m_TBOID;					// bone palette slot in VertexCacheManager
 	
 	// Render
 	RenderBatchConfig		m_InstanceBatchConfig;		// used for Instance render batch setting
@@ -4,10 +4,15 @@ CSkeletonMeshInstance::CSkeletonMeshInstance(ISGPRenderDevice *pdevice) :
 	m_fScale(1.0f),
 	m_MF1ModelResourceID(0xFFFFFFFF),
 	m_BoneMatrixBuffer(NULL),
+	m_pAnimLODBoneMatrix(NULL),
+	m_pReducedBoneSource(NULL),
+	m_pUpdatingModel(NULL),
+	m_bBoneUpdatePending(false),
 	m_pBlendFrameMatrix(NULL),
 	m_pUpperBodyBlendFrameMatrix(NULL),
 	m_pCurrentConfig(NULL),
 	m_bVisible(false),
+	m_fSkippedTime(0), m_fParticlePendingTime(0),
 	m_fInstanceRenderAlpha(1.0f),
 	m_fOldInstanceRenderAlpha(1.0f),
 	m_fInstanceRenderScale(1.0f),
@@ -23,6 +28,13 @@ CSkeletonMeshInstance::~CSkeletonMeshInstance()
 		delete [] m_BoneMatrixBuffer;
 	m_BoneMatrixBuffer = NULL;
 
+	if( m_pAnimLODBoneMatrix )
+		delete [] m_pAnimLODBoneMatrix;
+	m_pAnimLODBoneMatrix = NULL;
+	if( m_pReducedBoneSource )
+		delete [] m_pReducedBoneSource;
+	m_pReducedBoneSource = NULL;
+
 	if( m_pBlendFrameMatrix )
 		delete [] m_pBlendFrameMatrix;
 	m_pBlendFrameMatrix = NULL;
@@ -45,6 +57,21 @@ void CSkeletonMeshInstance::resetModel()
 		delete [] m_BoneMatrixBuffer;
 	m_BoneMatrixBuffer = NULL;
 
+	if( m_pAnimLODBoneMatrix )
+		delete [] m_pAnimLODBoneMatrix;
+	m_pAnimLODBoneMatrix = NULL;
+	if( m_pReducedBoneSource )
+		delete [] m_pReducedBoneSource;
+	m_pReducedBoneSource = NULL;
+	m_nReducedBoneNum = 0;
+
+	m_AnimLOD = SGPAL_FULL;
+	m_BoneUpdateMode = eBoneEvaluate;
+	m_nAnimLODFrame = 0;
+	m_fAnimLODDistance = 0;
+	m_nDeferredFrames = 0;
+	m_bBonePoseValid = false;
+
 	if( m_pBlendFrameMatrix )
 		delete [] m_pBlendFrameMatrix;
 	m_pBlendFrameMatrix = NULL;
@@ -64,6 +91,12 @@ void CSkeletonMeshInstance::resetModel()
 	m_fLastTime = 0;
 	m_fUpperLastTime = 0;
 
+	m_pUpdatingModel = NULL;
+	m_fUpdateDeltaTime = 0;
+	m_fUpdateTime = 0;
+	m_fUpdateUpperTime = 0;
+	m_bBoneUpdatePending = false;
+
 	m_nStartFrameTime = 0;
 	m_nEndFrameTime = 0;
 	m_fAnimPlayedTime = 0;
@@ -83,6 +116,8 @@ void CSkeletonMeshInstance::resetModel()
 	m_RenderFlagEx = 0;
 
 	m_bVisible = false;
+	m_fSkippedTime = 0;
+	m_fParticlePendingTime = 0;
 	m_fInstanceRenderAlpha = 1.0f;
 	m_fOldInstanceRenderAlpha = 1.0f;
 	m_fInstanceRenderScale = 1.0f;	
@@ -145,6 +180,7 @@ void CSkeletonMeshInstance::changeModel( const String& MF1ModelFileName, uint32
 		{
 			m_BoneMatrixBuffer = new float [pMF1Res->pModelMF1->m_iNumBones * 12];
 			memset(m_BoneMatrixBuffer, 0, sizeof(float)*12*pMF1Res->pModelMF1->m_iNumBones);
+			buildAnimLODData(pMF1Res->pModelMF1);
 		}
 
 		// Setting Config
@@ -220,6 +256,19 @@ void CSkeletonMeshInstance::render()
 
 bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 {
+	if( !updateBegin(deltaTimeinSeconds) )
+		return false;
+
+	updateBones();
+	updateEnd();
+
+	return true;
+}
+
+bool CSkeletonMeshInstance::updateBegin( float deltaTimeinSeconds )
+{
+	m_bBoneUpdatePending = false;
+
 	if( m_pRenderDevice->isResLoadingMultiThread() && (m_MF1ModelResourceID == 0xFFFFFFFF) )
 	{
 		m_MF1ModelResourceID = m_pRenderDevice->GetModelManager()->getModelIDByName(m_ModelFileName);
@@ -231,6 +280,7 @@ bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 			{
 				m_BoneMatrixBuffer = new float [pMF1Res->pModelMF1->m_iNumBones * 12];
 				memset(m_BoneMatrixBuffer, 0, sizeof(float)*12*pMF1Res->pModelMF1->m_iNumBones);
+				buildAnimLODData(pMF1Res->pModelMF1);
 			}
 
 			// Setting Config
@@ -265,14 +315,22 @@ bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 	// Update Instance OOBB boundingbox
 	updateOBB(m_matModel);
 
+	// Invisible instance does no per-frame work, the skipped time is applied when it is visible again
 	if( !m_bVisible )
-		return true;
+	{
+		m_fSkippedTime += deltaTimeinSeconds;
+		return false;
+	}
+	// Skipped time may be several loops long, it is wrapped with fmodf below
+	const bool bCatchUp = (m_fSkippedTime > 0);
+	deltaTimeinSeconds += m_fSkippedTime;
+	m_fSkippedTime = 0;
 
 	///////////////////////////////////////////////////////////////////////
 	CMF1FileResource* pMF1Res = m_pRenderDevice->GetModelManager()->getModelByID(m_MF1ModelResourceID);
 
 	if (!pMF1Res || !pMF1Res->pModelMF1)
-		return true;
+		return false;
 
 	// If UV Anim, Update StaticBuffer Skin Time 
 	if( pMF1Res->pModelMF1->m_Header.m_iUVAnim > 0 )
@@ -315,8 +373,11 @@ bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 	{
 		if(m_bLoopPlaying)
 		{
-			m_fLastTime = m_nStartFrameTime;
-			fTime = m_nStartFrameTime;
+			if( bCatchUp )
+				fTime = m_nStartFrameTime + fmodf(fTime - m_nStartFrameTime, m_nEndFrameTime - m_nStartFrameTime);
+			else
+				fTime = m_nStartFrameTime;
+			m_fLastTime = fTime;
 		}
 		else
 			fTime = m_nEndFrameTime;
@@ -338,8 +399,11 @@ bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 	{
 		if(m_bUpperLoopPlaying)
 		{
-			m_fUpperLastTime = m_nUpperStartFrameTime;
-			fUpperTime = m_nUpperStartFrameTime;
+			if( bCatchUp )
+				fUpperTime = m_nUpperStartFrameTime + fmodf(fUpperTime - m_nUpperStartFrameTime, m_nUpperEndFrameTime - m_nUpperStartFrameTime);
+			else
+				fUpperTime = m_nUpperStartFrameTime;
+			m_fUpperLastTime = fUpperTime;
 		}
 		else
 			fUpperTime = m_nUpperEndFrameTime;
@@ -349,127 +413,326 @@ bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 
 	m_bPlayingUpperBodyAnim = m_bEnableUpperBodyAnim && (pMF1Res->pModelMF1->m_Header.m_iBipBoneID != -1);
 
+	// Remember the state of this frame for updateBones() and updateEnd()
+	m_pUpdatingModel = pMF1Res->pModelMF1;
+	m_fUpdateDeltaTime = deltaTimeinSeconds;
+	m_fUpdateTime = fTime;
+	m_fUpdateUpperTime = fUpperTime;
+	m_bBoneUpdatePending = true;
+
+	// Animation LOD from camera distance, bigger instances keep their detail farther
+	Vector4D CamPos;
+	m_pRenderDevice->getCamreaPosition( &CamPos );
+	m_fAnimLODDistance = (Vector3D(CamPos.x, CamPos.y, CamPos.z) - m_vPosition).GetLength() / jmax(getScale(), 0.01f);
+
+	const SGP_ANIM_LOD LastAnimLOD = m_AnimLOD;
+	m_AnimLOD = ISGPInstanceManager::getAnimLOD( m_fAnimLODDistance );
+	if( !m_pAnimLODBoneMatrix && (m_AnimLOD != SGPAL_FROZEN) )
+		m_AnimLOD = SGPAL_FULL;
+
+	m_nAnimLODFrame++;
+	if( (m_AnimLOD == SGPAL_FULL) || !m_bBonePoseValid )
+		m_BoneUpdateMode = eBoneEvaluate;
+	else if( m_AnimLOD == SGPAL_FROZEN )
+		m_BoneUpdateMode = eBoneHold;
+	else if( (m_AnimLOD != LastAnimLOD) || (m_nAnimLODFrame >= ISGPInstanceManager::AnimLODUpdateInterval) )
+		m_BoneUpdateMode = eBoneEvaluate;
+	else
+		m_BoneUpdateMode = eBoneInterpolate;
+
+	return true;
+}
+
+void CSkeletonMeshInstance::updateBones()
+{
+	if( !m_bBoneUpdatePending || (m_pUpdatingModel->m_iNumBones == 0) )
+		return;
+
+	const uint32 nNumBones = m_pUpdatingModel->m_iNumBones;
+	const uint32 nInterval = jmax(ISGPInstanceManager::AnimLODUpdateInterval, (uint32)1);
+
+	switch( m_BoneUpdateMode )
+	{
+	case eBoneEvaluate:
+		m_nAnimLODFrame = 0;
+		m_nDeferredFrames = 0;
+		// The first evaluation is a full one, there is no pose to interpolate from yet
+		if( (m_AnimLOD == SGPAL_FULL) || !m_bBonePoseValid )
+		{
+			evaluateBones(m_BoneMatrixBuffer, false);
+			m_bBonePoseValid = true;
+			break;
+		}
+		// Interpolate from the pose shown now to the new pose over the next AnimLODUpdateInterval frames
+		memcpy(m_pAnimLODBoneMatrix, m_BoneMatrixBuffer, sizeof(float)*12*nNumBones);
+		evaluateBones(m_pAnimLODBoneMatrix + 12*nNumBones, m_AnimLOD == SGPAL_REDUCED);
+		interpolateBones(1.0f / nInterval);
+		break;
+	case eBoneInterpolate:
+		interpolateBones(jmin((float)(m_nAnimLODFrame + 1) / nInterval, 1.0f));
+		break;
+	default:
+		break;
+	}
+}
+
+void CSkeletonMeshInstance::interpolateBones(float t)
+{
+	const uint32 nNum = 12 * m_pUpdatingModel->m_iNumBones;
+	const float* pFrom = m_pAnimLODBoneMatrix;
+	const float* pTo = m_pAnimLODBoneMatrix + nNum;
+
+	for( uint32 i = 0; i < nNum; i++ )
+		m_BoneMatrixBuffer[i] = pFrom[i] + (pTo[i] - pFrom[i]) * t;
+}
+
+void CSkeletonMeshInstance::evaluateBones(float* pBoneMatrix, bool bReducedBones)
+{
+	const CSGPModelMF1* pModelMF1 = m_pUpdatingModel;
+	const float fTime = m_fUpdateTime;
+	const float fUpperTime = m_fUpdateUpperTime;
 
 	Vector3D vUpperBodyOffset;
 	Vector3D vTranslation;
 	Quaternion vRotationQuat;
 	float fScale = 1.0f;
+	Matrix4x4 matTemp;
 
-	if( pMF1Res && pMF1Res->pModelMF1 && (pMF1Res->pModelMF1->m_iNumBones > 0) )
+	// If having upper anim, first calculate Upper Body Offset vector from Lower Body
+	if( m_bPlayingUpperBodyAnim )
 	{
-		// If having upper anim, first calculate Upper Body Offset vector from Lower Body
-		if( m_bPlayingUpperBodyAnim )
-		{
-			const SGPMF1Bone *pBone = &pMF1Res->pModelMF1->m_pBones[pMF1Res->pModelMF1->m_Header.m_iBipBoneID];
-			Vector3D vUpperTranslation = calculateCurrentTranslation(pBone, fUpperTime);
-			Vector3D vLowerTranslation = calculateCurrentTranslation(pBone, fTime);
-			vUpperBodyOffset = vLowerTranslation - vUpperTranslation;
-		}
-		else
-			vUpperBodyOffset.Set(0, 0, 0);
+		const SGPMF1Bone *pBone = &pModelMF1->m_pBones[pModelMF1->m_Header.m_iBipBoneID];
+		Vector3D vUpperTranslation = calculateCurrentTranslation(pBone, fUpperTime);
+		Vector3D vLowerTranslation = calculateCurrentTranslation(pBone, fTime);
+		vUpperBodyOffset = vLowerTranslation - vUpperTranslation;
+	}
+	else
+		vUpperBodyOffset.Set(0, 0, 0);
 
 
-		for(uint32 x = 0; x < pMF1Res->pModelMF1->m_iNumBones; x++)
-		{
-			const SGPMF1Bone *pBone = &pMF1Res->pModelMF1->m_pBones[x];
+	for(uint32 x = 0; x < pModelMF1->m_iNumBones; x++)
+	{
+		if( bReducedBones && (m_pReducedBoneSource[x] != x) )
+			continue;
 
-			if( m_bPlayingUpperBodyAnim && ( pBone->m_bUpperBone == 1 ) )
+		const SGPMF1Bone *pBone = &pModelMF1->m_pBones[x];
+
+		if( m_bPlayingUpperBodyAnim && ( pBone->m_bUpperBone == 1 ) )
+		{
+			// Upper Body Animation update
+			vTranslation = calculateCurrentTranslation(pBone, fUpperTime);
+			vRotationQuat = calculateCurrentRotation(pBone, fUpperTime);
+			fScale = calculateCurrentScale(pBone, fUpperTime);
+
+			Matrix4x4 BoneTransMat;
+			BoneTransMat.Identity();
+			BoneTransMat._11 = BoneTransMat._22 = BoneTransMat._33 = fScale;
+			Matrix4x4 matRot;
+			//Convert the quaternion to a rotation matrix
+			vRotationQuat.GetMatrix( &matRot );
+			BoneTransMat = BoneTransMat * matRot;
+			BoneTransMat.SetTranslation( vTranslation );
+
+			matTemp = pBone->m_matFrame0Inv * BoneTransMat;
+
+			// In local space, upper body roattion from lower body
+			//matTemp = matTemp * m_matUpperBodyRotYFromLowerBody;
+
+			matTemp._41 += vUpperBodyOffset.x;
+			matTemp._42 += vUpperBodyOffset.y;
+			matTemp._43 += vUpperBodyOffset.z;
+
+			// Action Blending
+			if( m_fUpperBodyActionBlendAbsoluteTime > 0.0f )
 			{
-				// Upper Body Animation update
-				vTranslation = calculateCurrentTranslation(pBone, fUpperTime);
-				vRotationQuat = calculateCurrentRotation(pBone, fUpperTime);
-				fScale = calculateCurrentScale(pBone, fUpperTime);
-
-				Matrix4x4 BoneTransMat;
-				BoneTransMat.Identity();
-				BoneTransMat._11 = BoneTransMat._22 = BoneTransMat._33 = fScale;
-				Matrix4x4 matRot;
-				//Convert the quaternion to a rotation matrix
-				vRotationQuat.GetMatrix( &matRot );
-				BoneTransMat = BoneTransMat * matRot;
-				BoneTransMat.SetTranslation( vTranslation );
-
-				matTemp = pBone->m_matFrame0Inv * BoneTransMat;
-
-				// In local space, upper body roattion from lower body
-				//matTemp = matTemp * m_matUpperBodyRotYFromLowerBody;
-
-				matTemp._41 += vUpperBodyOffset.x;
-				matTemp._42 += vUpperBodyOffset.y;
-				matTemp._43 += vUpperBodyOffset.z;
-
-				// Action Blending
-				if( m_fUpperBodyActionBlendAbsoluteTime > 0.0f )
-				{
-					float t = 1.0f - m_fUpperBodyActionBlendPassageTime / m_fUpperBodyActionBlendAbsoluteTime;
-					if( t < 0.0f )
-						m_fUpperBodyActionBlendAbsoluteTime = 0;			// Finish Blend action
-					else
-						matTemp.Lerp(m_pUpperBodyBlendFrameMatrix[x], t);	// linear Lerp bone matrix
-				}
+				float t = 1.0f - m_fUpperBodyActionBlendPassageTime / m_fUpperBodyActionBlendAbsoluteTime;
+				if( t < 0.0f )
+					m_fUpperBodyActionBlendAbsoluteTime = 0;			// Finish Blend action
+				else
+					matTemp.Lerp(m_pUpperBodyBlendFrameMatrix[x], t);	// linear Lerp bone matrix
 			}
-			else
+		}
+		else
+		{
+			// Lower Body Animation update
+			vTranslation = calculateCurrentTranslation(pBone, fTime);
+			vRotationQuat = calculateCurrentRotation(pBone, fTime);
+			fScale = calculateCurrentScale(pBone, fTime);
+
+			Matrix4x4 BoneTransMat;
+			BoneTransMat.Identity();
+			BoneTransMat._11 = BoneTransMat._22 = BoneTransMat._33 = fScale;
+			Matrix4x4 matRot;
+			//Convert the quaternion to a rotation matrix
+			vRotationQuat.GetMatrix( &matRot );
+			BoneTransMat = BoneTransMat * matRot;
+			BoneTransMat.SetTranslation( vTranslation );
+
+			matTemp = pBone->m_matFrame0Inv * BoneTransMat;
+
+			// Action Blending
+			if( m_fActionBlendAbsoluteTime > 0.0f )
 			{
-				// Lower Body Animation update
-				vTranslation = calculateCurrentTranslation(pBone, fTime);
-				vRotationQuat = calculateCurrentRotation(pBone, fTime);
-				fScale = calculateCurrentScale(pBone, fTime);
-
-				Matrix4x4 BoneTransMat;
-				BoneTransMat.Identity();
-				BoneTransMat._11 = BoneTransMat._22 = BoneTransMat._33 = fScale;
-				Matrix4x4 matRot;
-				//Convert the quaternion to a rotation matrix
-				vRotationQuat.GetMatrix( &matRot );
-				BoneTransMat = BoneTransMat * matRot;
-				BoneTransMat.SetTranslation( vTranslation );
-
-				matTemp = pBone->m_matFrame0Inv * BoneTransMat;
-
-				// Action Blending
-				if( m_fActionBlendAbsoluteTime > 0.0f )
-				{
-					float t = 1.0f - m_fActionBlendPassageTime / m_fActionBlendAbsoluteTime;
-					if( t < 0.0f )
-						m_fActionBlendAbsoluteTime = 0;				// Finish Blend action
-					else
-						matTemp.Lerp(m_pBlendFrameMatrix[x], t);	// linear Lerp bone matrix
-				}
+				float t = 1.0f - m_fActionBlendPassageTime / m_fActionBlendAbsoluteTime;
+				if( t < 0.0f )
+					m_fActionBlendAbsoluteTime = 0;				// Finish Blend action
+				else
+					matTemp.Lerp(m_pBlendFrameMatrix[x], t);	// linear Lerp bone matrix
 			}
+		}
 
-			m_BoneMatrixBuffer[12 * x     ] = matTemp._11;  
-            m_BoneMatrixBuffer[12 * x +  1] = matTemp._21;  
-            m_BoneMatrixBuffer[12 * x +  2] = matTemp._31;  
-            m_BoneMatrixBuffer[12 * x +  3] = matTemp._41;  
-            m_BoneMatrixBuffer[12 * x +  4] = matTemp._12;  
-            m_BoneMatrixBuffer[12 * x +  5] = matTemp._22;  
-            m_BoneMatrixBuffer[12 * x +  6] = matTemp._32;  
-            m_BoneMatrixBuffer[12 * x +  7] = matTemp._42;  
-            m_BoneMatrixBuffer[12 * x +  8] = matTemp._13;  
-            m_BoneMatrixBuffer[12 * x +  9] = matTemp._23;  
-            m_BoneMatrixBuffer[12 * x + 10] = matTemp._33;  
-            m_BoneMatrixBuffer[12 * x + 11] = matTemp._43;
+		pBoneMatrix[12 * x     ] = matTemp._11;  
+		pBoneMatrix[12 * x +  1] = matTemp._21;  
+		pBoneMatrix[12 * x +  2] = matTemp._31;  
+		pBoneMatrix[12 * x +  3] = matTemp._41;  
+		pBoneMatrix[12 * x +  4] = matTemp._12;  
+		pBoneMatrix[12 * x +  5] = matTemp._22;  
+		pBoneMatrix[12 * x +  6] = matTemp._32;  
+		pBoneMatrix[12 * x +  7] = matTemp._42;  
+		pBoneMatrix[12 * x +  8] = matTemp._13;  
+		pBoneMatrix[12 * x +  9] = matTemp._23;  
+		pBoneMatrix[12 * x + 10] = matTemp._33;  
+		pBoneMatrix[12 * x + 11] = matTemp._43;
+	}
 
+	// Skipped bones follow the bone they inherit from
+	if( bReducedBones )
+	{
+		for(uint32 x = 0; x < pModelMF1->m_iNumBones; x++)
+		{
+			if( m_pReducedBoneSource[x] != x )
+				memcpy(pBoneMatrix + 12 * x, pBoneMatrix + 12 * m_pReducedBoneSource[x], sizeof(float) * 12);
+		}
+	}
+}
 
+uint32 CSkeletonMeshInstance::getBoneEvaluationCost() const
+{
+	if( !m_bBoneUpdatePending || (m_BoneUpdateMode != eBoneEvaluate) )
+		return 0;
+	return ((m_AnimLOD == SGPAL_REDUCED) && m_bBonePoseValid) ? m_nReducedBoneNum : m_pUpdatingModel->m_iNumBones;
+}
 
-			for(uint32 w = 0; w < pMF1Res->pModelMF1->m_Header.m_iNumParticles; w++)
-			{
-				if( pMF1Res->pModelMF1->m_pParticleEmitter[w].m_iAttachBoneID == x )
-				{
-					m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[w])->
-						updateAbsolutePosition(pMF1Res->pModelMF1->m_pParticleEmitter[w].m_AbsoluteMatrix * matTemp * m_matModel);
-				}
-			}
+bool CSkeletonMeshInstance::deferBoneEvaluation()
+{
+	if( !m_bBonePoseValid )
+		return false;
+
+	// m_nAnimLODFrame is not reset, so evaluation is due again next frame
+	if( m_BoneUpdateMode == eBoneEvaluate )
+	{
+		m_BoneUpdateMode = eBoneHold;
+		m_nDeferredFrames++;
+	}
+	return true;
+}
+
+// Finger and facial bones are skipped by SGPAL_REDUCED
+static bool isDetailBoneName( const char* BoneName )
+{
+	static const char* DetailBoneNames[] = { "Finger", "Thumb", "Face", "Facial", "Eye", "Brow", "Lip", "Jaw", "Mouth", "Tongue", "Cheek" };
+
+	const String Name( BoneName );
+	for( int i=0; i<(int)(sizeof(DetailBoneNames) / sizeof(DetailBoneNames[0])); i++ )
+	{
+		if( Name.containsIgnoreCase(DetailBoneNames[i]) )
+			return true;
+	}
+	return false;
+}
 
+void CSkeletonMeshInstance::buildAnimLODData(const CSGPModelMF1* pModelMF1)
+{
+	const uint32 nNumBones = pModelMF1->m_iNumBones;
+
+	m_pAnimLODBoneMatrix = new float [nNumBones * 12 * 2];
+	memset(m_pAnimLODBoneMatrix, 0, sizeof(float)*12*2*nNumBones);
+	m_bBonePoseValid = false;
+
+	// Every skipped bone inherits the matrix of its nearest ancestor which is not skipped
+	m_pReducedBoneSource = new uint16 [nNumBones];
+	m_nReducedBoneNum = 0;
+	for( uint32 x = 0; x < nNumBones; x++ )
+	{
+		uint32 nSource = x;
+		for( uint32 nDepth = 0; nDepth < nNumBones; nDepth++ )
+		{
+			if( !isDetailBoneName(pModelMF1->m_pBones[nSource].m_cName) )
+				break;
+			const uint32 nParent = pModelMF1->m_pBones[nSource].m_sParentID;
+			if( nParent >= nNumBones )
+				break;
+			nSource = nParent;
+		}
+		if( isDetailBoneName(pModelMF1->m_pBones[nSource].m_cName) )
+			nSource = x;
+
+		m_pReducedBoneSource[x] = (uint16)nSource;
+		if( nSource == x )
+			m_nReducedBoneNum++;
+	}
+
+	m_nAnimLODFrame = (uint32)Random::getSystemRandom().nextInt( jmax((int)ISGPInstanceManager::AnimLODUpdateInterval, 1) );
+}
+
+void CSkeletonMeshInstance::updateEnd()
+{
+	if( !m_bBoneUpdatePending )
+		return;
+	m_bBoneUpdatePending = false;
+
+	CMF1FileResource* pMF1Res = m_pRenderDevice->GetModelManager()->getModelByID(m_MF1ModelResourceID);
+
+	if( pMF1Res->pModelMF1->m_iNumBones > 0 )
+	{
+		// Particles attached to bones
+		for(uint32 w = 0; w < pMF1Res->pModelMF1->m_Header.m_iNumParticles; w++)
+		{
+			uint32 x = pMF1Res->pModelMF1->m_pParticleEmitter[w].m_iAttachBoneID;
+			if( x >= pMF1Res->pModelMF1->m_iNumBones )
+				continue;
+
+			// Bone matrix rebuilt from m_BoneMatrixBuffer
+			Matrix4x4 matTemp;
+			matTemp._11 = m_BoneMatrixBuffer[12 * x     ];
+			matTemp._21 = m_BoneMatrixBuffer[12 * x +  1];
+			matTemp._31 = m_BoneMatrixBuffer[12 * x +  2];
+			matTemp._41 = m_BoneMatrixBuffer[12 * x +  3];
+			matTemp._12 = m_BoneMatrixBuffer[12 * x +  4];
+			matTemp._22 = m_BoneMatrixBuffer[12 * x +  5];
+			matTemp._32 = m_BoneMatrixBuffer[12 * x +  6];
+			matTemp._42 = m_BoneMatrixBuffer[12 * x +  7];
+			matTemp._13 = m_BoneMatrixBuffer[12 * x +  8];
+			matTemp._23 = m_BoneMatrixBuffer[12 * x +  9];
+			matTemp._33 = m_BoneMatrixBuffer[12 * x + 10];
+			matTemp._43 = m_BoneMatrixBuffer[12 * x + 11];
+			matTemp._14 = matTemp._24 = matTemp._34 = 0.0f;
+			matTemp._44 = 1.0f;
+
+			m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[w])->
+				updateAbsolutePosition(pMF1Res->pModelMF1->m_pParticleEmitter[w].m_AbsoluteMatrix * matTemp * m_matModel);
 		}
 
 		m_pRenderDevice->GetVertexCacheManager()->UpdateTextureBufferObjectByID(m_BoneMatrixBuffer, pMF1Res->pModelMF1->m_iNumBones, m_TBOID);
 	
-		//Update Particle
-		for( int i=0; i<pMF1Res->ParticleSystemIDArray.size(); i++ )
+		//Update Particle, far particles are updated at low rate or paused (update LOD)
+		if( pMF1Res->ParticleSystemIDArray.size() > 0 )
 		{
-			if( isParticleVisible(i) )
-				m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[i])->update(deltaTimeinSeconds);
+			m_fParticlePendingTime = jmin(m_fParticlePendingTime + m_fUpdateDeltaTime, ISGPInstanceManager::UpdateLODMaxCatchUpTime);
+
+			Vector4D CamPos;
+			m_pRenderDevice->getCamreaPosition( &CamPos );
+			const float fParticleStep = ISGPInstanceManager::getParticleUpdateStep( (Vector3D(CamPos.x, CamPos.y, CamPos.z) - m_vPosition).GetLengthSquared() );
+			if( (fParticleStep >= 0) && (m_fParticlePendingTime >= fParticleStep) )
+			{
+				for( int i=0; i<pMF1Res->ParticleSystemIDArray.size(); i++ )
+				{
+					if( isParticleVisible(i) )
+						m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[i])->
+							grow(m_fParticlePendingTime, ISGPInstanceManager::DefaultSecondsPerFrame);
+				}
+				m_fParticlePendingTime = 0;
+			}
 		}
 	}
 
@@ -477,10 +740,8 @@ bool CSkeletonMeshInstance::update( float deltaTimeinSeconds )
 	for( int i=0; i<SGPATTDEF_MAXATTACHMENT; i++ )
 	{
 		if( m_pAttachedComponents[i] )
-			m_pAttachedComponents[i]->update(deltaTimeinSeconds);
+			m_pAttachedComponents[i]->update(m_fUpdateDeltaTime);
 	}
-
-	return true;
 }
 
 void CSkeletonMeshInstance::playAnim(float fSpeed, uint32 StartFrameID, uint32 EndFrameID, bool bLoop, bool bNewAnim)
@@ -819,180 +1080,22 @@ void CSkeletonMeshInstance::playAttachmentAnim(float fSpeed, bool bLoop)
 
 Vector3D CSkeletonMeshInstance::calculateCurrentTranslation(const SGPMF1Bone *pBone, float fTime)
 {
-	Vector3D vTrans;
-	float fInterp = 0.0f;
-
-	//if there are one keyframes, don't do any transformations
-	if( pBone->m_TransKeyFrames && (pBone->m_TransKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_TransKeyFrames->m_iNumber == 1) )
-	{
-		vTrans.Set( pBone->m_TransKeyFrames->m_KeyFrames[0].m_fParam[0],
-					pBone->m_TransKeyFrames->m_KeyFrames[0].m_fParam[1],
-					pBone->m_TransKeyFrames->m_KeyFrames[0].m_fParam[2] );
-	}
-	else if( pBone->m_TransKeyFrames && (pBone->m_TransKeyFrames->m_iNumber > 1) )
-	{
-		SGPMF1KeyFrame *pLastKeyFrame = pBone->m_TransKeyFrames->m_KeyFrames;
-
-
-		//Calculate the current Translation frame
-		KeyFrameBlock *pCurTransBlock = pBone->m_TransKeyFrames;
-		while( pCurTransBlock != NULL )
-		{
-			for( int i=0; i<pCurTransBlock->m_iNumber; i++ )
-			{
-				if( pCurTransBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame >= fTime )
-				{
-					if( pCurTransBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
-						fInterp = 0;
-					else
-						fInterp = (fTime / ISGPInstanceManager::DefaultSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
-							float(pCurTransBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
-
-					vTrans.Set( pLastKeyFrame->m_fParam[0] + (pCurTransBlock->m_KeyFrames[i].m_fParam[0] - pLastKeyFrame->m_fParam[0]) * fInterp,
-								pLastKeyFrame->m_fParam[1] + (pCurTransBlock->m_KeyFrames[i].m_fParam[1] - pLastKeyFrame->m_fParam[1]) * fInterp,
-								pLastKeyFrame->m_fParam[2] + (pCurTransBlock->m_KeyFrames[i].m_fParam[2] - pLastKeyFrame->m_fParam[2]) * fInterp );
-
-					return vTrans;
-				}
-				pLastKeyFrame = &pCurTransBlock->m_KeyFrames[i];
-			}
-			pCurTransBlock = pCurTransBlock->m_nextBlock;
-		}
-	}
-	return vTrans;
+	return CalculateTranslationAtTime( pBone->m_TransKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 Quaternion CSkeletonMeshInstance::calculateCurrentRotation(const SGPMF1Bone *pBone, float fTime)
 {
-	Quaternion vRots;
-	float fInterp = 0.0f;
-
-	//if there are one keyframes, don't do any transformations
-	if( pBone->m_RotsKeyFrames && (pBone->m_RotsKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_RotsKeyFrames->m_iNumber == 1) )
-	{
-		return Quaternion(  pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[0],
-							pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[1],
-							pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[2],
-							pBone->m_RotsKeyFrames->m_KeyFrames[0].m_fParam[3] );
-	}
-	else if( pBone->m_RotsKeyFrames && (pBone->m_RotsKeyFrames->m_iNumber > 1) )
-	{
-		SGPMF1KeyFrame *pLastKeyFrame = pBone->m_RotsKeyFrames->m_KeyFrames;
-
-
-		//Calculate the current Rotation frame
-		KeyFrameBlock *pCurRotsBlock = pBone->m_RotsKeyFrames;
-		while( pCurRotsBlock != NULL )
-		{
-			for( int i=0; i<pCurRotsBlock->m_iNumber; i++ )
-			{
-				if( pCurRotsBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame >= fTime )
-				{
-					if( pCurRotsBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
-						fInterp = 0;
-					else
-						fInterp = (fTime / ISGPInstanceManager::DefaultSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
-							float(pCurRotsBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
-
-					Quaternion vCurRots( pCurRotsBlock->m_KeyFrames[i].m_fParam[0], 
-						pCurRotsBlock->m_KeyFrames[i].m_fParam[1], 
-						pCurRotsBlock->m_KeyFrames[i].m_fParam[2], 
-						pCurRotsBlock->m_KeyFrames[i].m_fParam[3] );
-					vRots.x = pLastKeyFrame->m_fParam[0];
-					vRots.y = pLastKeyFrame->m_fParam[1];
-					vRots.z = pLastKeyFrame->m_fParam[2];
-					vRots.w = pLastKeyFrame->m_fParam[3];
-
-					vRots.Slerp(vCurRots, fInterp);
-
-					return vRots;
-				}
-				pLastKeyFrame = &pCurRotsBlock->m_KeyFrames[i];
-			}
-			pCurRotsBlock = pCurRotsBlock->m_nextBlock;
-		}
-	}
-	return vRots;
+	return CalculateRotationAtTime( pBone->m_RotsKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 float CSkeletonMeshInstance::calculateCurrentScale(const SGPMF1Bone *pBone, float fTime)
 {
-	float scale = 1.0f;
-	float fInterp = 0.0f;
-
-	//if there are one keyframes, don't do any transformations
-	if( pBone->m_ScaleKeyFrames && (pBone->m_ScaleKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_ScaleKeyFrames->m_iNumber == 1) )
-	{
-		return pBone->m_ScaleKeyFrames->m_KeyFrames[0].m_scale;
-	}
-	else if( pBone->m_ScaleKeyFrames && (pBone->m_ScaleKeyFrames->m_iNumber > 1) )
-	{
-		SGPMF1ScaleKeyFrame *pLastKeyFrame = pBone->m_ScaleKeyFrames->m_KeyFrames;
-
-
-		//Calculate the current scale frame
-		ScaleKeyFrameBlock *pCurScaleBlock = pBone->m_ScaleKeyFrames;
-		while( pCurScaleBlock != NULL )
-		{
-			for( int i=0; i<pCurScaleBlock->m_iNumber; i++ )
-			{
-				if( pCurScaleBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame >= fTime )
-				{
-					if( pCurScaleBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
-						fInterp = 0;
-					else
-						fInterp = (fTime / ISGPInstanceManager::DefaultSecondsPerFrame - pLastKeyFrame->m_iFrameID) /
-							float(pCurScaleBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
-
-					scale = pLastKeyFrame->m_scale + (pCurScaleBlock->m_KeyFrames[i].m_scale - pLastKeyFrame->m_scale) * fInterp;
-
-					return scale;
-				}
-				pLastKeyFrame = &pCurScaleBlock->m_KeyFrames[i];
-			}
-			pCurScaleBlock = pCurScaleBlock->m_nextBlock;
-		}
-
-	}
-	return scale;
+	return CalculateScaleAtTime( pBone->m_ScaleKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 bool CSkeletonMeshInstance::calculateCurrentVisible(const SGPMF1Bone *pBone, float fTime)
 {
-	bool bVisible = true;
-
-	//if there are one keyframes, don't do anything
-	if( pBone->m_VisibleKeyFrames && (pBone->m_VisibleKeyFrames->m_nextBlock == NULL) &&
-		(pBone->m_VisibleKeyFrames->m_iNumber == 1) )
-	{
-		return pBone->m_VisibleKeyFrames->m_KeyFrames[0].m_Visible;
-	}
-	else if( pBone->m_VisibleKeyFrames && (pBone->m_VisibleKeyFrames->m_iNumber > 1) )
-	{
-		bVisible = pBone->m_VisibleKeyFrames->m_KeyFrames[0].m_Visible;
-
-		//Calculate the current visible frame
-		VisibleKeyFrameBlock *pCurVisibleBlock = pBone->m_VisibleKeyFrames;
-		while( pCurVisibleBlock != NULL )
-		{
-			for( int i=0; i<pCurVisibleBlock->m_iNumber; i++ )
-			{
-				if( pCurVisibleBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame == fTime )
-					return pCurVisibleBlock->m_KeyFrames[i].m_Visible;
-
-				if( pCurVisibleBlock->m_KeyFrames[i].m_iFrameID * ISGPInstanceManager::DefaultSecondsPerFrame > fTime )
-					return bVisible;
-
-				bVisible = pCurVisibleBlock->m_KeyFrames[i].m_Visible;
-			}
-			pCurVisibleBlock = pCurVisibleBlock->m_nextBlock;
-		}
-
-	}
-	return bVisible;
+	return CalculateVisibleAtTime( pBone->m_VisibleKeyFrames, fTime, ISGPInstanceManager::DefaultSecondsPerFrame );
 }
 
 void CSkeletonMeshInstance::buildOBB()
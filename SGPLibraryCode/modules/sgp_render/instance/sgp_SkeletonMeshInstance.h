@@ -16,6 +16,26 @@ public:
 	bool		update( float deltaTimeinSeconds );
 	void		render();
 
+	// update() split into three phases, used by ISGPInstanceManager::updateAllSkeletonInstance()
+	// updateBegin() and updateEnd() must be called in render thread,
+	// updateBones() only writes this instance and reads model data, so it can run in worker threads
+	// updateBegin() returns false if there is nothing more to do this frame (no model, or invisible)
+	bool		updateBegin( float deltaTimeinSeconds );
+	void		updateBones();
+	void		updateEnd();
+
+	// Animation LOD, chosen by updateBegin()
+	SGP_ANIM_LOD getAnimLOD() const { return m_AnimLOD; }
+	float		getAnimLODDistance() const { return m_fAnimLODDistance; }
+	// Number of bones updateBones() evaluates this frame, 0 if pose is interpolated or kept
+	uint32		getBoneEvaluationCost() const;
+	// Keeps the current pose this frame, used when bone evaluation budget is exceeded
+	// return false if the evaluation can not be deferred (no pose has been evaluated yet)
+	bool		deferBoneEvaluation();
+	// Order of bone evaluation under the budget, smaller first: the distance shrinks
+	// with each deferred frame, so far instances are not deferred forever
+	float		getBoneEvaluationPriority() const { return m_fAnimLODDistance / (1.0f + m_nDeferredFrames); }
+
 
 	// Setting Interface
 	void		setPosition(float x, float y, float z) { m_vPosition.Set(x, y, z); }
@@ -99,6 +119,11 @@ private:
 	bool		isRibbonVisible(int ) { return false; }
 	bool		isBoneVisible(uint16 nBoneID);
 
+	// Animation LOD
+	void		buildAnimLODData(const CSGPModelMF1* pModelMF1);
+	void		evaluateBones(float* pBoneMatrix, bool bReducedBones);
+	void		interpolateBones(float t);
+
 	Matrix4x4   getBBRDMeshMatrix(int meshIndex);
 
 private:
@@ -144,6 +169,30 @@ private:
 	// These data are transformed Bone Matrix, Multiplied by Frame0Inv matrix
 	float*				m_BoneMatrixBuffer;			
 
+	// Animation LOD
+	enum BoneUpdateMode
+	{
+		eBoneEvaluate = 0,		// evaluate bones from key frames
+		eBoneInterpolate,		// interpolate between last two evaluated poses
+		eBoneHold				// keep current pose
+	};
+	SGP_ANIM_LOD		m_AnimLOD;
+	BoneUpdateMode		m_BoneUpdateMode;
+	uint32				m_nAnimLODFrame;			// frames since last bone evaluation
+	float				m_fAnimLODDistance;			// camera distance divided by instance scale
+	uint32				m_nDeferredFrames;			// frames the bone evaluation has been deferred in a row
+	bool				m_bBonePoseValid;			// m_BoneMatrixBuffer holds an evaluated pose
+	float*				m_pAnimLODBoneMatrix;		// pose shown at last evaluation, followed by evaluated pose
+	uint16*				m_pReducedBoneSource;		// bone whose matrix each bone uses in SGPAL_REDUCED
+	uint32				m_nReducedBoneNum;			// bones evaluated in SGPAL_REDUCED
+
+	// Per-frame state passed from updateBegin() to updateBones() and updateEnd()
+	const CSGPModelMF1*	m_pUpdatingModel;
+	float				m_fUpdateDeltaTime;
+	float				m_fUpdateTime;
+	float				m_fUpdateUpperTime;
+	bool				m_bBoneUpdatePending;
+
 	// Render
 	uint32				m_RenderFlagEx;				// render flag
 	float				m_fInstanceRenderAlpha;		// Instance Alpha
@@ -151,12 +200,14 @@ private:
 	float				m_fInstanceRenderScale;		// Instance scale
 	float				m_fOldInstanceRenderScale;	// backup Instance scale
 	bool				m_bVisible;					// is this instance visible
+	float				m_fSkippedTime;				// update time skipped while invisible
+	float				m_fParticlePendingTime;		// time attached particles are behind (update LOD)
 
 	RenderBatchConfig	m_InstanceBatchConfig;		// used for Instance render batch setting
 
 	// Resource
 	uint32				m_MF1ModelResourceID;		// MF1 File Resource ID in SGPModelManager Models Array
-	uint32				m_TBOID;					// index of TBO Array in VertexCacheManager
+	uint32				m_TBOID;					// bone palette slot in VertexCacheManager
 
 	// Particle scale and alpha
 	float				m_fEffectChangedScale;
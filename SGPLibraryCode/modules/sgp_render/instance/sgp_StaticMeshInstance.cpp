@@ -5,6 +5,7 @@ CStaticMeshInstance::CStaticMeshInstance(ISGPRenderDevice *pdevice) :
 	m_fScale(1.0f),
 	m_bNeedUpdate(true),
 	m_bVisible(false),
+	m_fSkippedTime(0), m_fParticlePendingTime(0),
 	m_fInstanceRenderAlpha(1.0f),
 	m_fOldInstanceRenderAlpha(1.0f),
 	m_fInstanceRenderScale(1.0f),
@@ -31,6 +32,8 @@ void CStaticMeshInstance::resetModel()
 	m_MF1ConfigIndex = 0;
 	m_RenderFlagEx = 0;
 	m_bVisible = false;
+	m_fSkippedTime = 0;
+	m_fParticlePendingTime = 0;
 
 	m_fInstanceRenderAlpha = 1.0f;
 	m_fOldInstanceRenderAlpha = 1.0f;
@@ -60,7 +63,7 @@ void CStaticMeshInstance::destroyModel()
 	resetModel();
 }
 
-void CStaticMeshInstance::changeModel( const String& MF1ModelFileName, uint32 ConfigIndex )
+void CStaticMeshInstance::changeModel( const String& MF1ModelFileName, uint32 ConfigIndex, float fLoadingPriority )
 {
 	// If currently have resource in this Instance, first unregister
 	if( m_MF1ModelResourceID != 0xFFFFFFFF )
@@ -72,7 +75,7 @@ void CStaticMeshInstance::changeModel( const String& MF1ModelFileName, uint32 Co
 	m_MF1ConfigIndex = ConfigIndex;
 
 	if( m_pRenderDevice->isResLoadingMultiThread() )
-		m_MF1ModelResourceID = m_pRenderDevice->GetModelManager()->registerModelMT(MF1ModelFileName, false);
+		m_MF1ModelResourceID = m_pRenderDevice->GetModelManager()->registerModelMT(MF1ModelFileName, false, fLoadingPriority);
 	else
 		m_MF1ModelResourceID = m_pRenderDevice->GetModelManager()->registerModel(MF1ModelFileName, false);
 	
@@ -165,8 +168,14 @@ bool CStaticMeshInstance::update( float deltaTimeinSeconds )
 		m_bNeedUpdate = false;
 	}
 
+	// Invisible instance does no per-frame work, the skipped time is applied when it is visible again
 	if( !m_bVisible )
+	{
+		m_fSkippedTime += deltaTimeinSeconds;
 		return true;
+	}
+	const float fElapsedTime = deltaTimeinSeconds + m_fSkippedTime;
+	m_fSkippedTime = 0;
 
 	///////////////////////////////////////////////////////////////////////
 	CMF1FileResource* pMF1Res = m_pRenderDevice->GetModelManager()->getModelByID(m_MF1ModelResourceID);
@@ -177,7 +186,7 @@ bool CStaticMeshInstance::update( float deltaTimeinSeconds )
 
 	// If UV Anim, Update StaticBuffer Skin Time
 	if( pMF1Res->pModelMF1->m_Header.m_iUVAnim > 0 )
-		m_InstanceBatchConfig.m_fTimePassedFromCreated += deltaTimeinSeconds;
+		m_InstanceBatchConfig.m_fTimePassedFromCreated += fElapsedTime;
 
 	// If Instance Alpha changed, Update StaticBuffer Skin Instance alpha
 	if( (m_fInstanceRenderAlpha >= 0.0f) && (m_fInstanceRenderAlpha <= 1.0f) && (m_fOldInstanceRenderAlpha != m_fInstanceRenderAlpha) )
@@ -199,6 +208,19 @@ bool CStaticMeshInstance::update( float deltaTimeinSeconds )
 		m_fOldInstanceRenderScale = m_fInstanceRenderScale;
 	}
 
+	if( pMF1Res->ParticleSystemIDArray.size() == 0 )
+		return true;
+
+	// Particle update LOD, far particles are updated at low rate or paused.
+	// Pending time is simulated in fixed steps when they run again.
+	m_fParticlePendingTime = jmin(m_fParticlePendingTime + fElapsedTime, ISGPInstanceManager::UpdateLODMaxCatchUpTime);
+
+	Vector4D CamPos;
+	m_pRenderDevice->getCamreaPosition( &CamPos );
+	const float fParticleStep = ISGPInstanceManager::getParticleUpdateStep( (Vector3D(CamPos.x, CamPos.y, CamPos.z) - m_vPosition).GetLengthSquared() );
+	if( (fParticleStep < 0) || (m_fParticlePendingTime < fParticleStep) )
+		return true;
+
 	for( int i=0; i<pMF1Res->ParticleSystemIDArray.size(); i++ )
 	{
 		if( isParticleVisible(i) )
@@ -206,9 +228,11 @@ bool CStaticMeshInstance::update( float deltaTimeinSeconds )
 			m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[i])->
 				updateAbsolutePosition(pMF1Res->pModelMF1->m_pParticleEmitter[i].m_AbsoluteMatrix * m_matModel);
 
-			m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[i])->update(deltaTimeinSeconds);
+			m_pRenderDevice->GetParticleManager()->getParticleSystemByID(pMF1Res->ParticleSystemIDArray[i])->
+				grow(m_fParticlePendingTime, ISGPInstanceManager::DefaultSecondsPerFrame);
 		}
 	}
+	m_fParticlePendingTime = 0;
 
 	return true;
 }
@@ -9,7 +9,8 @@ public:
 	~CStaticMeshInstance();
 
 	// Create and Destroy
-	void		changeModel( const String& MF1ModelFileName, uint32 ConfigIndex = 0 );
+	//\param fLoadingPriority	only used when loading in multi-thread, smaller value will be loaded earlier
+	void		changeModel( const String& MF1ModelFileName, uint32 ConfigIndex = 0, float fLoadingPriority = 0 );
 	void		destroyModel( void );
 
 	// Update and Render
@@ -40,6 +41,7 @@ public:
 	Matrix4x4&		getModelMatrix() { return m_matModel; }
 	const OBBox&	getInstanceOBBox() { return m_InstanceOBBox; }
 	uint32			getMF1ModelResourceID() { return m_MF1ModelResourceID; }
+	const String&	getModelFileName() { return m_ModelFileName; }
 	const uint32	getMeshTriangleCount();
 	const uint32	getMeshVertexCount();
 
@@ -81,6 +83,8 @@ private:
 
 	bool				m_bNeedUpdate;				// is this instance need update
 	bool				m_bVisible;					// is this instance visible
+	float				m_fSkippedTime;				// update time skipped while invisible
+	float				m_fParticlePendingTime;		// time attached particles are behind (update LOD)
 
 	// Render
 	uint32				m_RenderFlagEx;				// render flag
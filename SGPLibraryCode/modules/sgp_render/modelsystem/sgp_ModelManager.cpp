@@ -20,7 +20,7 @@ ISGPModelManager::~ISGPModelManager()
 	m_MF1Models.clear(true);
 
 
-	HashMap<uint64, uint32>::Iterator i (m_StringToModelIDMap);
+	FlatHashMap<uint64, uint32>::Iterator i (m_StringToModelIDMap);
 	while( i.next() )
 	{
 		uint32 ModelID = i.getValue();
@@ -69,11 +69,11 @@ uint32 ISGPModelManager::registerModel(const String& modelfilename, bool bLoadBo
 	// try to load MF1 file
 	CMF1FileResource *pMF1ModelRes = new CMF1FileResource();	
 	pMF1ModelRes->incReferenceCount();
-	pMF1ModelRes->pMF1RawMemoryAddress = CSGPModelMF1::LoadMF1(pMF1ModelRes->pModelMF1, m_WorkingDir, modelfilename);
+	pMF1ModelRes->pMF1MappedFile = CSGPModelMF1::LoadMF1(pMF1ModelRes->pModelMF1, m_WorkingDir, modelfilename);
 	if( bLoadBoneAnim )
 	{
 		String BoneAnimFileName = modelfilename.dropLastCharacters(3) + String( "bf1" );		
-		pMF1ModelRes->pBF1RawMemoryAddress.add( CSGPModelMF1::LoadBone(pMF1ModelRes->pModelMF1, m_WorkingDir, BoneAnimFileName, 0) );
+		pMF1ModelRes->pBF1MappedFiles.add( CSGPModelMF1::LoadBone(pMF1ModelRes->pModelMF1, m_WorkingDir, BoneAnimFileName, 0) );
 	}
 
 	// Create render resource
@@ -89,7 +89,7 @@ uint32 ISGPModelManager::registerModel(const String& modelfilename, bool bLoadBo
 	return ModelID;
 }
 
-uint32 ISGPModelManager::registerModelMT(const String& modelfilename, bool bLoadBoneAnim)
+uint32 ISGPModelManager::registerModelMT(const String& modelfilename, bool bLoadBoneAnim, float fPriority)
 {
 	uint32 ModelID = getModelIDByName(modelfilename);
 	if( ModelID != 0xFFFFFFFF )
@@ -98,7 +98,7 @@ uint32 ISGPModelManager::registerModelMT(const String& modelfilename, bool bLoad
 		return ModelID;
 	}
 
-	m_pRenderDevice->GetMTResourceLoader()->addLoadingModel(modelfilename, bLoadBoneAnim ? 0 : 0xFFFF);		
+	m_pRenderDevice->GetMTResourceLoader()->addLoadingModel(modelfilename, bLoadBoneAnim ? 0 : 0xFFFF, fPriority);		
 	return 0xFFFFFFFF;
 }
 
@@ -112,7 +112,7 @@ uint32 ISGPModelManager::attachActionInfoByName(const String& modelfilename, uin
 		if( pMF1ModelRes )
 		{
 			String BoneAnimFileName = modelfilename.dropLastCharacters(3) + String( "bf1" );		
-			pMF1ModelRes->pBF1RawMemoryAddress.add( CSGPModelMF1::LoadBone(pMF1ModelRes->pModelMF1, m_WorkingDir, BoneAnimFileName, boneAnimFileIndex) );
+			pMF1ModelRes->pBF1MappedFiles.add( CSGPModelMF1::LoadBone(pMF1ModelRes->pModelMF1, m_WorkingDir, BoneAnimFileName, boneAnimFileIndex) );
 		}
 	}
 	return ModelID;
@@ -125,7 +125,7 @@ uint32 ISGPModelManager::attachActionInfoByID(uint32 id, uint16 boneAnimFileInde
 	if( pMF1ModelRes )
 	{		
 		String BoneAnimFileName = String(pMF1ModelRes->pModelMF1->m_Header.m_cFilename).dropLastCharacters(3) + String( "bf1" );		
-		pMF1ModelRes->pBF1RawMemoryAddress.add( CSGPModelMF1::LoadBone(pMF1ModelRes->pModelMF1, m_WorkingDir, BoneAnimFileName, boneAnimFileIndex) );
+		pMF1ModelRes->pBF1MappedFiles.add( CSGPModelMF1::LoadBone(pMF1ModelRes->pModelMF1, m_WorkingDir, BoneAnimFileName, boneAnimFileIndex) );
 	}
 	
 	return id;
@@ -221,7 +221,7 @@ void ISGPModelManager::removeAllModels()
 	m_MF1Models.clear(true);
 }
 
-void ISGPModelManager::registerSkinTexturesMT(CMF1FileResource* pMF1FileRes)
+void ISGPModelManager::registerSkinTexturesMT(CMF1FileResource* pMF1FileRes, float fPriority)
 {
 	CSGPModelMF1* pMF1Model = pMF1FileRes->pModelMF1;
 	if( !pMF1Model )
@@ -230,7 +230,7 @@ void ISGPModelManager::registerSkinTexturesMT(CMF1FileResource* pMF1FileRes)
 	// Register Used skin Textures
 	for( uint32 i=0; i<pMF1Model->m_Header.m_iNumSkins; i++ )
 	{
-		m_pRenderDevice->GetTextureManager()->registerTextureMT( String(pMF1Model->m_pSkins[i].m_cName) );
+		m_pRenderDevice->GetTextureManager()->registerTextureMT( String(pMF1Model->m_pSkins[i].m_cName), false, fPriority );
 	}
 	// Register Particle system Used Textures
 	for( uint32 i=0; i<pMF1Model->m_Header.m_iNumParticles; i++ )
@@ -243,10 +243,10 @@ void ISGPModelManager::registerSkinTexturesMT(CMF1FileResource* pMF1FileRes)
 			switch(renderParam.m_type)
 			{
 			case Render_Point:				
-				m_pRenderDevice->GetTextureManager()->registerTextureMT( String(renderParam.m_pointData.m_texPath) );
+				m_pRenderDevice->GetTextureManager()->registerTextureMT( String(renderParam.m_pointData.m_texPath), false, fPriority );
 				break;
 			case Render_Quad:
-				m_pRenderDevice->GetTextureManager()->registerTextureMT( String(renderParam.m_quadData.m_texPath) );
+				m_pRenderDevice->GetTextureManager()->registerTextureMT( String(renderParam.m_quadData.m_texPath), false, fPriority );
 				break;
             default:
                 break;
@@ -406,6 +406,12 @@ void ISGPModelManager::createRenderResourceMT(SGPModelRecord Record)
 		Record.pMF1Resource->ParticleSystemIDArray.add(
 			m_pRenderDevice->createOpenGLParticleSystem( pMF1Model->m_pParticleEmitter[i]) );
 	}
+}
+
+void ISGPModelManager::registerRenderResourceMT(SGPModelRecord Record)
+{
+	if( !Record.pMF1Resource->pModelMF1 )
+		return;
 
 	Record.pMF1Resource->incReferenceCount();
 	for( uint32 i=0; i<Record.nRefCount; i++ )
@@ -90,15 +90,20 @@ public:
 	//! Create used textures in Skins, multi-thread version, called by resource Loading Thread
 	// immediately called after Load Raw MF1 Model file and before Render Resource be created
 	//\param pMF1FileRes Pointer to CMF1FileResource.
-	void registerSkinTexturesMT(CMF1FileResource* pMF1FileRes);
+	//\param fPriority Loading priority of the textures, smaller value will be loaded earlier
+	void registerSkinTexturesMT(CMF1FileResource* pMF1FileRes, float fPriority = 0);
 	void unRegisterSkinTexturesMT(CMF1FileResource* pMF1FileRes);
 
 	// Multi-Thread version of Function createRenderResource and releaseRenderResource
+	// createRenderResourceMT() only creates static meshes and particle systems, it is called without
+	// the lock of resource loader, registerRenderResourceMT() then adds the model with the lock
 	void createRenderResourceMT(SGPModelRecord Record);
+	void registerRenderResourceMT(SGPModelRecord Record);
 	void releaseRenderResourceMT(SGPModelRecord Record);
 
 	// Multi-Thread version of Function registerModel
-	uint32 registerModelMT(const String& modelfilename, bool bLoadBoneAnim);
+	//\param fPriority Loading priority, smaller value will be loaded earlier (usually squared distance to camera)
+	uint32 registerModelMT(const String& modelfilename, bool bLoadBoneAnim, float fPriority = 0);
 
 	// Multi-Thread version of unRegister
 	void unRegisterModelByNameMT( const String& modelfilename );
@@ -124,7 +129,7 @@ private:
 
 
 	// Hashmap of model file path string to Index of Model Array
-	HashMap<uint64, uint32>		m_StringToModelIDMap;
+	FlatHashMap<uint64, uint32>		m_StringToModelIDMap;
 };
 
 #endif		// __SGP_MODELMANAGER_HEADER__
\ No newline at end of file
@@ -5,22 +5,22 @@
 class CMF1FileResource
 {
 public:
-	CMF1FileResource() : pModelMF1(NULL), pMF1RawMemoryAddress(0), deleteTimeStamp(0) {}
+	CMF1FileResource() : pModelMF1(NULL), pMF1MappedFile(NULL), deleteTimeStamp(0) {}
 	~CMF1FileResource()
 	{
         // it's dangerous to delete an object that's still referenced by something else!
         jassert (getReferenceCount() == 0);
 
-		if( pMF1RawMemoryAddress )
-			delete [] pMF1RawMemoryAddress;
-		pMF1RawMemoryAddress = NULL;
+		if( pMF1MappedFile )
+			delete pMF1MappedFile;
+		pMF1MappedFile = NULL;
 
-		for(int j=0; j<pBF1RawMemoryAddress.size(); j++)
+		for(int j=0; j<pBF1MappedFiles.size(); j++)
 		{
-			uint8* pBF1Address = pBF1RawMemoryAddress.getReference(j);
-			if( pBF1Address )
-				delete [] pBF1Address;
-			pBF1Address = NULL;
+			MemoryMappedFile* pBF1MappedFile = pBF1MappedFiles.getReference(j);
+			if( pBF1MappedFile )
+				delete pBF1MappedFile;
+			pBF1MappedFile = NULL;
 		}
 
 		pModelMF1 = NULL;
@@ -49,8 +49,8 @@ public:
 
 public:
 	CSGPModelMF1 * pModelMF1;
-	uint8* pMF1RawMemoryAddress;
-	Array<uint8*> pBF1RawMemoryAddress;
+	MemoryMappedFile* pMF1MappedFile;				// MF1 file data, pModelMF1 points into it
+	Array<MemoryMappedFile*> pBF1MappedFiles;		// BF1 bone animation file data
 
 	Array<uint32> StaticMeshIDArray;		// Staticmesh chunk ID Array of this Model file
 	Array<uint32> ParticleSystemIDArray;	// particle system ID Array of this Model file
@@ -4,6 +4,5 @@
 //==============================================================================
 bool OpenGLHelpers::isContextActive()
 {
-    ScopedXLock xlock;
     return glXGetCurrentContext() != 0;
 }
@@ -0,0 +1,88 @@
+
+CSGPNullCommandLog::CSGPNullCommandLog() : m_FrameIndex(0), m_bRecording(true)
+{
+	memset(m_CommandCount, 0, sizeof(m_CommandCount));
+}
+
+void CSGPNullCommandLog::record(SGP_NULL_COMMAND Type, uint32 ObjectID, uint32 Count, uint32 Param)
+{
+	jassert( Type < SGPNC_COUNT );
+
+	m_CommandCount[Type]++;
+
+	if( !m_bRecording )
+		return;
+
+	SGPNullCommand Command;
+	Command.Type = Type;
+	Command.Frame = m_FrameIndex;
+	Command.ObjectID = ObjectID;
+	Command.Count = Count;
+	Command.Param = Param;
+	m_Commands.add(Command);
+}
+
+void CSGPNullCommandLog::clear()
+{
+	m_Commands.clearQuick();
+	memset(m_CommandCount, 0, sizeof(m_CommandCount));
+}
+
+const char* CSGPNullCommandLog::getCommandName(SGP_NULL_COMMAND Type)
+{
+	static const char* CommandNames[SGPNC_COUNT] =
+	{
+		"BeginScene",
+		"EndScene",
+		"FlushRenderBatch",
+		"FlushEditorLines",
+		"ClearZBuffer",
+
+		"SetClearColor",
+		"SetViewPort",
+		"SetCamera",
+		"SetDriverFeature",
+		"SetRenderTarget",
+		"ResetRenderTarget",
+		"BindTexture",
+		"BindBoneBuffer",
+
+		"CreateTexture",
+		"UpdateTexture",
+		"DeleteTexture",
+		"CreateStaticBuffer",
+		"DeleteStaticBuffer",
+		"CreateBoneBuffer",
+		"UpdateBoneBuffer",
+		"DeleteBoneBuffer",
+
+		"DrawStaticBuffer",
+		"DrawInstanced",
+		"DrawSkeletonMesh",
+		"DrawDynamicBuffer",
+		"DrawDebug",
+		"DrawFullScreenQuad",
+		"DrawParticles",
+		"DrawText"
+	};
+
+	if( Type >= SGPNC_COUNT )
+		return "Unknown";
+	return CommandNames[Type];
+}
+
+void CSGPNullCommandLog::writeToLog(Logger* pLogger) const
+{
+	if( !pLogger )
+		return;
+
+	for( int i=0; i<m_Commands.size(); i++ )
+	{
+		const SGPNullCommand& Command = m_Commands.getReference(i);
+		pLogger->writeToLog( String("Frame ") + String(Command.Frame) + String(" ") +
+			String(getCommandName(Command.Type)) +
+			String(" ID=") + String(Command.ObjectID) +
+			String(" Count=") + String(Command.Count) +
+			String(" Param=") + String(Command.Param), ELL_INFORMATION );
+	}
+}
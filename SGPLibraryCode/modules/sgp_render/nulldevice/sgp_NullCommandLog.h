@@ -0,0 +1,100 @@
+#ifndef __SGP_NULLCOMMANDLOG_HEADER__
+#define __SGP_NULLCOMMANDLOG_HEADER__
+
+//! Commands recorded by the null render device
+enum SGP_NULL_COMMAND
+{
+	// Frame
+	SGPNC_BEGIN_SCENE = 0,
+	SGPNC_END_SCENE,
+	SGPNC_FLUSH_RENDERBATCH,
+	SGPNC_FLUSH_EDITORLINES,
+	SGPNC_CLEAR_ZBUFFER,
+
+	// State changes
+	SGPNC_SET_CLEARCOLOR,
+	SGPNC_SET_VIEWPORT,
+	SGPNC_SET_CAMERA,
+	SGPNC_SET_DRIVERFEATURE,
+	SGPNC_SET_RENDERTARGET,
+	SGPNC_RESET_RENDERTARGET,
+	SGPNC_BIND_TEXTURE,
+	SGPNC_BIND_BONEBUFFER,
+
+	// Resources and uploads
+	SGPNC_CREATE_TEXTURE,
+	SGPNC_UPDATE_TEXTURE,
+	SGPNC_DELETE_TEXTURE,
+	SGPNC_CREATE_STATICBUFFER,
+	SGPNC_DELETE_STATICBUFFER,
+	SGPNC_CREATE_BONEBUFFER,
+	SGPNC_UPDATE_BONEBUFFER,
+	SGPNC_DELETE_BONEBUFFER,
+
+	// Submitted batches
+	SGPNC_DRAW_STATICBUFFER,
+	SGPNC_DRAW_INSTANCED,			// One instanced draw call of opaque static buffer batches when flushing (Count is instance number)
+	SGPNC_DRAW_SKELETONMESH,
+	SGPNC_DRAW_DYNAMICBUFFER,
+	SGPNC_DRAW_DEBUG,
+	SGPNC_DRAW_FULLSCREENQUAD,
+	SGPNC_DRAW_PARTICLES,
+	SGPNC_DRAW_TEXT,
+
+	//! Only used for counting the elements of this enum
+	SGPNC_COUNT
+};
+
+//! One recorded command (20 bytes)
+struct SGPNullCommand
+{
+	SGP_NULL_COMMAND	Type;
+	uint32				Frame;		// Number of beginScene() calls when recorded
+	uint32				ObjectID;	// Fake texture / buffer ID, 0 if none
+	uint32				Count;		// Vertices, bones, particles or bytes (command dependent)
+	uint32				Param;		// Indices, texture unit, feature... (command dependent)
+};
+
+/**
+	Inspectable log of everything submitted to the null render device.
+	Per-type counters are always updated, the command list is only filled when
+	recording is enabled, so benchmarks can run without growing memory.
+	The log is not thread safe, the device only writes to it from the render thread.
+*/
+class CSGPNullCommandLog
+{
+public:
+	CSGPNullCommandLog();
+
+	void record(SGP_NULL_COMMAND Type, uint32 ObjectID = 0, uint32 Count = 0, uint32 Param = 0);
+
+	//! Start a new frame, called by beginScene()
+	void nextFrame() { m_FrameIndex++; }
+
+	//! Remove all commands and reset counters (the frame index is kept)
+	void clear();
+
+	inline void setRecording(bool bRecording)	{ m_bRecording = bRecording; }
+	inline bool isRecording() const				{ return m_bRecording; }
+
+	inline int getNumCommands() const							{ return m_Commands.size(); }
+	inline const SGPNullCommand& getCommand(int index) const	{ return m_Commands.getReference(index); }
+	inline uint32 getCommandCount(SGP_NULL_COMMAND Type) const	{ return m_CommandCount[Type]; }
+	inline uint32 getFrameIndex() const							{ return m_FrameIndex; }
+
+	//! Readable name of a command type
+	static const char* getCommandName(SGP_NULL_COMMAND Type);
+
+	//! Write all recorded commands to logger
+	void writeToLog(Logger* pLogger) const;
+
+private:
+	Array<SGPNullCommand>	m_Commands;
+	uint32					m_CommandCount[SGPNC_COUNT];
+	uint32					m_FrameIndex;
+	bool					m_bRecording;
+
+	SGP_DECLARE_NON_COPYABLE (CSGPNullCommandLog)
+};
+
+#endif		// __SGP_NULLCOMMANDLOG_HEADER__
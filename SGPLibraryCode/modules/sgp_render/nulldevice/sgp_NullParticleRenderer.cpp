@@ -0,0 +1,10 @@
+
+SPARKNullRenderer::SPARKNullRenderer(CNullRenderDevice* device, uint32 RenderType)
+	: ISGPParticleRenderer(device), m_pNullDevice(device), m_RenderType(RenderType)
+{
+}
+
+void SPARKNullRenderer::render(const SPARK::Group& group)
+{
+	m_pNullDevice->getCommandLog().record(SGPNC_DRAW_PARTICLES, group.getSPARKID(), group.getNumberOfParticles(), m_RenderType);
+}
@@ -0,0 +1,36 @@
+#ifndef __SGP_NULLPARTICLERENDERER_HEADER__
+#define __SGP_NULLPARTICLERENDERER_HEADER__
+
+class CNullRenderDevice;
+
+/**
+* Particle renderer of the null render device.
+* Creates no particle buffer, rendering a group only writes the number of
+* particles and the render type (ParticleRenderType) to the command log.
+*/
+class SGP_API SPARKNullRenderer : public ISGPParticleRenderer
+{
+	SPARK_IMPLEMENT_REGISTERABLE(SPARKNullRenderer)
+
+public:
+	SPARKNullRenderer(CNullRenderDevice* device, uint32 RenderType);
+	static SPARKNullRenderer* create(CNullRenderDevice* device, uint32 RenderType);
+
+	virtual void render(const SPARK::Group& group);
+
+private:
+	CNullRenderDevice*		m_pNullDevice;
+	uint32					m_RenderType;
+
+	virtual const uint32 getBufferID() const { return 0; }
+};
+
+
+inline SPARKNullRenderer* SPARKNullRenderer::create(CNullRenderDevice* device, uint32 RenderType)
+{
+	SPARKNullRenderer* obj = new SPARKNullRenderer(device, RenderType);
+	registerObject(obj);
+	return obj;
+}
+
+#endif		// __SGP_NULLPARTICLERENDERER_HEADER__
@@ -0,0 +1,493 @@
+
+CNullRenderDevice::CNullRenderDevice(const SGPCreationParameters& params)
+	: m_LastObjectID(0),
+	m_pCurrentCamera(NULL),
+	m_pLogger(params.plog),
+	m_RenderDeviceTime(0), m_RenderDeviceDelta(0),
+	m_Params(params),
+	m_pTextureManager(NULL), m_pShaderManager(NULL), m_pMaterialSystem(NULL),
+	m_pVertexCacheManager(NULL), m_pModelManager(NULL), m_pParticleManager(NULL),
+	m_pEffectSystemManager(NULL), m_pFontManager(NULL), m_pInstanceManager(NULL),
+	m_pMTResourceLoader(NULL)
+{
+	jassert(m_pLogger);
+
+	m_ScreenSize.Width = params.WindowWidth;
+	m_ScreenSize.Height = params.WindowHeight;
+
+	// Null device behaves like a driver supporting everything
+	for( int i=0; i<SGPVDF_COUNT; i++ )
+		m_bFeatureEnabled[i] = true;
+}
+
+CNullRenderDevice::~CNullRenderDevice()
+{
+	if( m_pMTResourceLoader )
+	{
+		delete m_pMTResourceLoader;
+		m_pMTResourceLoader = NULL;
+	}
+	if( m_pInstanceManager )
+	{
+		delete m_pInstanceManager;
+		m_pInstanceManager = NULL;
+	}
+	if( m_pShaderManager )
+	{
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+	}
+	if( m_pMaterialSystem )
+	{
+		delete m_pMaterialSystem;
+		m_pMaterialSystem = NULL;
+	}
+	if( m_pVertexCacheManager )
+	{
+		delete m_pVertexCacheManager;
+		m_pVertexCacheManager = NULL;
+	}
+	if( m_pModelManager )
+	{
+		delete m_pModelManager;
+		m_pModelManager = NULL;
+	}
+	if( m_pParticleManager )
+	{
+		delete m_pParticleManager;
+		m_pParticleManager = NULL;
+	}
+	if( m_pEffectSystemManager )
+	{
+		delete m_pEffectSystemManager;
+		m_pEffectSystemManager = NULL;
+	}
+	if( m_pCurrentCamera )
+	{
+		delete m_pCurrentCamera;
+		m_pCurrentCamera = NULL;
+	}
+	if( m_pFontManager )
+	{
+		delete m_pFontManager;
+		m_pFontManager = NULL;
+	}
+
+	// Texture manager should release last
+	if( m_pTextureManager )
+	{
+		delete m_pTextureManager;
+		m_pTextureManager = NULL;
+	}
+}
+
+bool CNullRenderDevice::initDriver()
+{
+	m_pLogger->writeToLog(String("Using renderer: Null Render Device"), ELL_INFORMATION);
+
+	// Manager System Init, same order as OpenGL device
+	// Texture System
+	m_pTextureManager = new CSGPTextureManager(this,m_pLogger);
+	m_pTextureManager->createDefaultTexture();
+	m_pTextureManager->createWhiteTexture();
+	m_pTextureManager->createBlackTexture();
+
+	// Shader System
+	m_pShaderManager = new CNullShaderManager();
+
+	// Camera System
+	m_pCurrentCamera = new CNullCamera(this);
+
+	// Material System
+	m_pMaterialSystem = new ISGPMaterialSystem(this);
+	m_pMaterialSystem->LoadGameMaterials();
+
+	// VertexCache System
+	m_pVertexCacheManager = new CNullVertexCacheManager(this);
+
+	// Model System
+	m_pModelManager = new ISGPModelManager(this,m_pLogger);
+
+	// Particle System
+	m_pParticleManager = new ISGPParticleManager(this,m_pLogger);
+
+	// Effect Instance System
+	m_pEffectSystemManager = new ISGPEffectSystemManager(this,m_pLogger);
+
+	// Font System
+	m_pFontManager = new ISGPFontManager(this);
+
+	// Multi-Thread Resource Loader
+	m_pMTResourceLoader = new CSGPResourceLoaderMuitiThread(this);
+
+	// Instance Manager
+	m_pInstanceManager = new ISGPInstanceManager(this);
+
+	setViewPort( SViewPort(0, 0, m_ScreenSize.Width, m_ScreenSize.Height) );
+
+	return true;
+}
+
+bool CNullRenderDevice::beginScene( bool bClearColorBuffer, bool bClearDepthBuffer, bool bClearStencilBuffer )
+{
+	m_CommandLog.nextFrame();
+
+	uint32 ClearMask = (bClearColorBuffer ? 1 : 0) | (bClearDepthBuffer ? 2 : 0) | (bClearStencilBuffer ? 4 : 0);
+	m_CommandLog.record(SGPNC_BEGIN_SCENE, 0, 0, ClearMask);
+	return true;
+}
+
+bool CNullRenderDevice::endScene()
+{
+	m_CommandLog.record(SGPNC_END_SCENE);
+	return true;
+}
+
+void CNullRenderDevice::FlushRenderBatch()
+{
+	m_CommandLog.record(SGPNC_FLUSH_RENDERBATCH);
+
+	static_cast<CNullVertexCacheManager*>(m_pVertexCacheManager)->FlushStaticInstanceRuns();
+	static_cast<CNullVertexCacheManager*>(m_pVertexCacheManager)->FlushBonePalette();
+}
+
+void CNullRenderDevice::FlushEditorLinesRenderBatch(bool bNoDepthLine, float )
+{
+	m_CommandLog.record(SGPNC_FLUSH_EDITORLINES, 0, 0, bNoDepthLine ? 1 : 0);
+}
+
+void CNullRenderDevice::createRenderToFrameBuffer(uint32 Width, uint32 Height, bool )
+{
+	m_CurrentRTSize.Width = Width;
+	m_CurrentRTSize.Height = Height;
+}
+
+void CNullRenderDevice::recreateRenderToFrameBuffer(uint32 Width, uint32 Height, bool stencilbuffer)
+{
+	createRenderToFrameBuffer(Width, Height, stencilbuffer);
+}
+
+void CNullRenderDevice::deleteRenderToFrameBuffer()
+{
+	m_CurrentRTSize.Width = m_CurrentRTSize.Height = 0;
+}
+
+void CNullRenderDevice::setRenderToFrameBuffer()
+{
+	m_CommandLog.record(SGPNC_SET_RENDERTARGET, 0, m_CurrentRTSize.Width, m_CurrentRTSize.Height);
+}
+
+void CNullRenderDevice::renderBackToMainBuffer()
+{
+	m_CommandLog.record(SGPNC_RESET_RENDERTARGET);
+}
+
+void CNullRenderDevice::clearZBuffer()
+{
+	m_CommandLog.record(SGPNC_CLEAR_ZBUFFER);
+}
+
+void CNullRenderDevice::setClearColor(float fRed, float fGreen, float fBlue, float fAlpha)
+{
+	m_CommandLog.record(SGPNC_SET_CLEARCOLOR, 0, 0, Colour::fromFloatRGBA(fRed, fGreen, fBlue, fAlpha).getARGB());
+}
+
+void CNullRenderDevice::setDriverFeature(SGP_DRIVER_FEATURE feature, bool flag)
+{
+	m_bFeatureEnabled[feature] = flag;
+	m_CommandLog.record(SGPNC_SET_DRIVERFEATURE, 0, flag ? 1 : 0, (uint32)feature);
+}
+
+void CNullRenderDevice::onResize(const uint32 width, const uint32 height)
+{
+	if( m_ViewPort.Width == m_ScreenSize.Width &&
+		m_ViewPort.Height == m_ScreenSize.Height )
+	{
+		m_ViewPort.X = m_ViewPort.Y = 0;
+		m_ViewPort.Width = width;
+		m_ViewPort.Height = height;
+	}
+	m_ScreenSize.Width = width;
+	m_ScreenSize.Height = height;
+
+	setViewPort(m_ViewPort);
+}
+
+const SDimension2D& CNullRenderDevice::getCurrentRenderTargetSize() const
+{
+	if (m_CurrentRTSize.Width == 0)
+		return m_ScreenSize;
+	else
+		return m_CurrentRTSize;
+}
+
+ISGPTexture* CNullRenderDevice::createTexture( ISGPImage* pImage, const String& AbsolutePath, bool bGenMipMap )
+{
+	return new CNullTexture(pImage, AbsolutePath, this, bGenMipMap);
+}
+
+// Creates one new ISGPParticleSystem from Particle setting
+uint32 CNullRenderDevice::createOpenGLParticleSystem(const SGPMF1ParticleTag& PartSetting)
+{
+	Matrix4x4 ParticleWorldMatrix;
+	ParticleWorldMatrix.Identity();
+	uint32 ParticleID = GetParticleManager()->createParticleSystem(ParticleWorldMatrix);
+	ISGPParticleSystem* pSystem = GetParticleManager()->getParticleSystemByID( ParticleID );
+
+	SPARK::Group** pParticleGroups = pSystem->createParticleGroups(PartSetting);
+	if( pParticleGroups )
+	{
+		for(uint32 i=0; i<PartSetting.m_SystemParam.m_groupCount; ++i)
+			pSystem->addGroup( pParticleGroups[i] );
+
+		delete [] pParticleGroups;
+		pParticleGroups = NULL;
+	}
+	pSystem->enableAABBComputing(PartSetting.m_SystemParam.m_bEnableAABBCompute);
+
+	return ParticleID;
+}
+
+// Particles are simulated as usual, render calls are only recorded
+SPARK::Renderer* CNullRenderDevice::createOpenGLParticleRenderer( const ParticleRenderParam& renderParam )
+{
+	return SPARKNullRenderer::create( this, (uint32)renderParam.m_type );
+}
+
+
+void CNullRenderDevice::setCameraMode(SGP_CAMERAMODE_TYPE Mode)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->setCameraMode(Mode);
+}
+
+void CNullRenderDevice::setFov(float fov)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->m_fFov = fov;
+}
+
+void CNullRenderDevice::setViewPort(const SViewPort& area)
+{
+	m_ViewPort = area;
+
+	if( m_ViewPort.Height > 0 )
+		setProjMatrixParams((float)m_ViewPort.Width/(float)m_ViewPort.Height);
+
+	m_CommandLog.record(SGPNC_SET_VIEWPORT, 0, m_ViewPort.Width, m_ViewPort.Height);
+}
+
+void CNullRenderDevice::setNearFarClipPlane(float fNear, float fFar)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->SetClippingPlanes( fNear, fFar );
+}
+
+void CNullRenderDevice::setProjMatrixParams(float fAspect)
+{
+	if(!m_pCurrentCamera)
+		return;
+
+	if( m_pCurrentCamera->m_Mode == SGPCT_PERSPECTIVE )
+	{
+		m_pCurrentCamera->CalcPerspProjMatrix(fAspect);
+	}
+	else if( m_pCurrentCamera->m_Mode == SGPCT_ORTHOGONAL )
+	{
+		m_pCurrentCamera->CalcOrthoProjMatrix(
+			(float)m_ViewPort.X, (float)m_ViewPort.X+m_ViewPort.Width,
+			(float)m_ViewPort.Y, (float)m_ViewPort.Y+m_ViewPort.Height,
+			m_pCurrentCamera->m_fNear,
+			m_pCurrentCamera->m_fFar );
+	}
+	else if( m_pCurrentCamera->m_Mode == SGPCT_TWOD )
+	{
+		m_pCurrentCamera->Prepare2DMode();
+	}
+}
+
+void CNullRenderDevice::setViewMatrix3D(
+	const Vector4D& vcRight, const Vector4D& vcUp, const Vector4D& vcDir, const Vector4D& vcEyePos )
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->SetViewMatrix3D(vcRight, vcUp, vcDir, vcEyePos);
+
+	m_CommandLog.record(SGPNC_SET_CAMERA);
+}
+
+void CNullRenderDevice::setViewMatrixLookAt(
+	const Vector4D& vcPos, const Vector4D& vcPoint, const Vector4D& vcWorldUp)
+{
+	Vector4D vcDir, vcTemp, vcUp;
+
+	vcDir = vcPoint - vcPos;
+	vcDir.Normalize();
+
+	// calculate up vector
+	float fDot = vcWorldUp * vcDir;
+	vcTemp = vcDir * fDot;
+	vcUp = vcWorldUp - vcTemp;
+	float fL = vcUp.GetLength();
+
+	// if length too small take normal y axis as up vector
+	if(fL < 1e-6f)
+	{
+		Vector4D vcY;
+		vcY.Set(0.0f, 1.0f, 0.0f);
+
+		vcTemp = vcDir * vcDir.y;
+		vcUp = vcY - vcTemp;
+
+		fL = vcUp.GetLength();
+
+		// if still too small take z axis as up vector
+		if (fL < 1e-6f)
+		{
+			vcY.Set(0.0f, 0.0f, 1.0f);
+
+			vcTemp = vcDir * vcDir.z;
+			vcUp = vcY - vcTemp;
+
+			// if still too small we are lost
+			fL = vcUp.GetLength();
+			if(fL < 1e-6f)
+				return;
+		}
+	}
+
+	vcUp /= fL;
+
+	// build right vector using cross product
+	Vector4D vcRight;
+	vcRight.Cross(vcUp, vcDir);
+	vcRight.Normalize();
+
+	vcUp.Cross(vcDir, vcRight);
+
+	return setViewMatrix3D(vcRight, vcUp, vcDir, vcPos);
+}
+
+void CNullRenderDevice::getCamreaPosition(Vector4D* pCameraPos)
+{
+	if( m_pCurrentCamera && pCameraPos )
+		pCameraPos->Set(m_pCurrentCamera->GetPos());
+}
+
+void CNullRenderDevice::getCamreaViewDirection(Vector3D* pViewDir)
+{
+	if( m_pCurrentCamera && pViewDir )
+		pViewDir->Set(m_pCurrentCamera->m_mViewMatrix._13, m_pCurrentCamera->m_mViewMatrix._23, m_pCurrentCamera->m_mViewMatrix._33);
+}
+
+void CNullRenderDevice::getViewFrustrum(Plane *pPlane)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->GetFrustrum(pPlane);
+}
+
+void CNullRenderDevice::getViewMatrix(Matrix4x4& mat)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->GetViewMatrix(mat);
+}
+
+void CNullRenderDevice::getProjMatrix(Matrix4x4& mat)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->GetProjMatrix(mat);
+}
+
+void CNullRenderDevice::getViewProjMatrix(Matrix4x4& mat)
+{
+	if( m_pCurrentCamera )
+		m_pCurrentCamera->GetViewProjMatrix(mat);
+}
+
+void CNullRenderDevice::Transform2Dto3D(const SDimension2D &pt, Vector4D *vcOrig, Vector4D *vcDir)
+{
+	if( !m_pCurrentCamera || (m_ViewPort.Width == 0) || (m_ViewPort.Height == 0) )
+		return;
+
+	const Matrix4x4& mView = m_pCurrentCamera->m_mViewMatrix;
+	const Matrix4x4& mProj = m_pCurrentCamera->m_mProjMatrix;
+	Matrix4x4 mInvView;
+	Vector4D vcS;
+
+	// resize to viewportspace [-1,1] -> projection
+	vcS.x =  ( ((pt.Width*2.0f) / m_ViewPort.Width) -1.0f) / mProj._11;
+	vcS.y = -( ((pt.Height*2.0f) / m_ViewPort.Height)-1.0f) / mProj._22;
+	vcS.z = 1.0f;
+
+	// invert view matrix
+	mInvView.InverseOf(mView);
+
+	// ray from screen to worldspace
+	(*vcDir).x = (vcS.x * mInvView._11)	+ (vcS.y * mInvView._21) + (vcS.z * mInvView._31);
+	(*vcDir).y = (vcS.x * mInvView._12)	+ (vcS.y * mInvView._22) + (vcS.z * mInvView._32);
+	(*vcDir).z = (vcS.x * mInvView._13)	+ (vcS.y * mInvView._23) + (vcS.z * mInvView._33);
+
+	// inverse translation.
+	(*vcOrig).x = mInvView._41;
+	(*vcOrig).y = mInvView._42;
+	(*vcOrig).z = mInvView._43;
+
+	// normalize
+	(*vcDir).Normalize();
+}
+
+SDimension2D CNullRenderDevice::Transform3Dto2D(const Vector4D &vcPoint)
+{
+	SDimension2D pt;
+	pt.Width = pt.Height = 0;
+
+	if( !m_pCurrentCamera )
+		return pt;
+
+	const Matrix4x4& mViewProj = m_pCurrentCamera->m_mViewProjMatrix;
+
+	float fClip_x = (float)(m_ViewPort.Width  >> 1);
+	float fClip_y = (float)(m_ViewPort.Height >> 1);
+
+	float fXp = (mViewProj._11*vcPoint.x) + (mViewProj._21*vcPoint.y) + (mViewProj._31*vcPoint.z) + mViewProj._41;
+	float fYp = (mViewProj._12*vcPoint.x) + (mViewProj._22*vcPoint.y) + (mViewProj._32*vcPoint.z) + mViewProj._42;
+	float fWp = (mViewProj._14*vcPoint.x) + (mViewProj._24*vcPoint.y) + (mViewProj._34*vcPoint.z) + mViewProj._44;
+
+	float fWpInv = 1.0f / fWp;
+
+	// transform from [-1,1] to actual viewport dimensions
+	pt.Width = (uint32)( (1.0f + (fXp * fWpInv)) * fClip_x );
+	pt.Height = (uint32)( (1.0f + (fYp * fWpInv)) * fClip_y );
+
+	return pt;
+}
+
+void CNullRenderDevice::setWorkingDirection(const String& workingDir)
+{
+	m_WorkingDir = workingDir;
+	if( m_pTextureManager )
+		m_pTextureManager->setWorkingDirection(m_WorkingDir);
+	if( m_pModelManager )
+		m_pModelManager->setWorkingDirection(m_WorkingDir);
+	if( m_pParticleManager )
+		m_pParticleManager->setWorkingDirection(m_WorkingDir);
+	if( m_pEffectSystemManager )
+		m_pEffectSystemManager->setWorkingDirection(m_WorkingDir);
+}
+
+// Text is not formatted, length of format string and flag are recorded
+void CNullRenderDevice::DrawTextInPos(int , int , uint32 flag, float , uint8 , uint8 , uint8 , wchar_t* format, ...)
+{
+	m_CommandLog.record(SGPNC_DRAW_TEXT, 0, format ? (uint32)wcslen(format) : 0, flag);
+}
+
+//==============================================================================
+CNullRenderDevice* createNullDriver(const SGPCreationParameters& params)
+{
+	CNullRenderDevice* pNull = new CNullRenderDevice(params);
+	if( !pNull->initDriver() )
+	{
+		delete pNull;
+		pNull = NULL;
+	}
+	return pNull;
+}
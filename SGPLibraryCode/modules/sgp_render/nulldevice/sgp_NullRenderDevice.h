@@ -0,0 +1,217 @@
+#ifndef __SGP_NULLRENDERDEVICE_HEADER__
+#define __SGP_NULLRENDERDEVICE_HEADER__
+
+#include "../../sgp_enginedevice/enginedevice/sgp_CreationParameter.h"
+
+// Camera of the null device, the OpenGL cameras do not use any OpenGL calls
+#if defined (BUILD_OGLES2)
+	typedef COpenGLES2Camera	CNullCamera;
+#else
+	typedef COpenGLCamera		CNullCamera;
+#endif
+
+//! Material of the null render device, material string is ignored and there is no pass
+class CNullMaterial : public AbstractMaterial
+{
+public:
+	CNullMaterial() {}
+	virtual ~CNullMaterial() {}
+
+	virtual void Clear() {}
+	virtual void Update( float ) {}
+	virtual void Clone( AbstractMaterial * ) {}
+};
+
+//! Shader manager of the null render device, there is no shader to load
+class CNullShaderManager : public ISGPShaderManager
+{
+public:
+	virtual void onDeviceLost(void) {}
+	virtual void onDeviceReset(void) {}
+	virtual void preCacheShaders(void) {}
+	virtual void loadAllShaders(void) {}
+	virtual void unloadAllShaders(void) {}
+};
+
+//==============================================================================
+/**
+	Render device which creates no window, context or API objects.
+
+	Textures, static buffers and bone buffers get fake IDs, and every submitted batch,
+	state change and upload is written to an inspectable command log (getCommandLog()).
+	Camera, viewport and frustum math is the same as the OpenGL device,
+	so culling and instance / particle / effect updates run unmodified on headless machines
+	(benchmarks and tests).
+
+	There is no world system manager: COpenGLWorldSystemManager needs the OpenGL
+	terrain, water and grass renderers, GetWorldSystemManager() returns NULL.
+*/
+class SGP_API CNullRenderDevice : public ISGPRenderDevice
+{
+public:
+	CNullRenderDevice(const SGPCreationParameters& params);
+	virtual ~CNullRenderDevice();
+
+	//! inits managers of the null driver
+	bool initDriver();
+
+	// Manager
+	virtual CSGPResourceLoaderMuitiThread* GetMTResourceLoader() { return m_pMTResourceLoader; }
+	virtual CSGPTextureManager* GetTextureManager()	{ return m_pTextureManager; }
+	virtual ISGPShaderManager* GetShaderManager() { return m_pShaderManager; }
+	virtual ISGPMaterialSystem* GetMaterialSystem() { return m_pMaterialSystem; }
+	virtual ISGPVertexCacheManager* GetVertexCacheManager() { return m_pVertexCacheManager; }
+	virtual ISGPModelManager* GetModelManager() { return m_pModelManager; }
+	virtual ISGPParticleManager* GetParticleManager() { return m_pParticleManager; }
+	virtual ISGPEffectSystemManager* GetEffectInstanceManager() { return m_pEffectSystemManager; }
+	virtual ISGPWorldSystemManager* GetWorldSystemManager() { return NULL; }
+	virtual ISGPFontManager* GetFontManager() { return m_pFontManager; }
+	virtual ISGPInstanceManager* GetInstanceManager() { return m_pInstanceManager; }
+
+	virtual bool beginScene(	bool bClearColorBuffer = true,
+								bool bClearDepthBuffer = true,
+								bool bClearStencilBuffer = true );
+	virtual bool endScene();
+	virtual void FlushRenderBatch();
+
+	virtual void createRenderToFrameBuffer(uint32 Width, uint32 Height, bool stencilbuffer=false);
+	virtual void recreateRenderToFrameBuffer(uint32 Width, uint32 Height, bool stencilbuffer=false);
+	virtual void deleteRenderToFrameBuffer();
+	virtual void setRenderToFrameBuffer();
+	virtual void renderBackToMainBuffer();
+
+	virtual void clearZBuffer();
+	virtual void setClearColor(float fRed, float fGreen, float fBlue, float fAlpha);
+
+	virtual bool queryDriverFeature(SGP_DRIVER_FEATURE feature) const
+	{
+		return m_bFeatureEnabled[feature];
+	}
+	virtual void setDriverFeature(SGP_DRIVER_FEATURE feature, bool flag);
+
+	virtual bool checkDriverReset() { return false; }
+	virtual bool isResLoadingMultiThread() { return m_Params.MultiThreadResLoading; }
+	virtual bool isViewportRotated() { return false; }
+
+	virtual void onResize(const uint32 width, const uint32 height);
+
+	virtual SGP_PIXEL_FORMAT getPixelFormat() const { return SGPPF_A8R8G8B8; }
+	virtual SGP_RENDER_STAGE getCurrentRenderStage() const { return SGPRS_NORMAL; }
+	virtual const SDimension2D& getScreenSize() const { return m_ScreenSize; }
+	virtual const SDimension2D& getCurrentRenderTargetSize() const;
+
+	//! There is no frame buffer to read back
+	virtual ISGPImage* createScreenShot(SGP_PIXEL_FORMAT ) { return NULL; }
+
+	virtual ISGPTexture* createTexture( ISGPImage* pImage,
+			const String& AbsolutePath,
+			bool bGenMipMap = false );
+
+	virtual AbstractMaterial* createMaterial() { return new CNullMaterial(); }
+	virtual AbstractMaterial* createMaterial(char* ) { return new CNullMaterial(); }
+
+	virtual uint32 createOpenGLParticleSystem(const SGPMF1ParticleTag& PartSetting);
+	virtual SPARK::Renderer* createOpenGLParticleRenderer( const ParticleRenderParam& renderParam );
+
+
+	// CAMERA param
+	virtual void setCameraMode(SGP_CAMERAMODE_TYPE Mode);
+	virtual void setFov(float fov);
+	virtual void setViewPort(const SViewPort& area);
+	virtual const SViewPort& getViewPort() const { return m_ViewPort; }
+	virtual void setNearFarClipPlane(float fNear, float fFar);
+	virtual void setProjMatrixParams(float fAspect);
+	virtual void setViewMatrix3D( const Vector4D& vcRight, const Vector4D& vcUp,
+								  const Vector4D& vcDir, const Vector4D& vcEyePos );
+	virtual void setViewMatrixLookAt( const Vector4D& vcPos, const Vector4D& vcPoint,
+									  const Vector4D& vcWorldUp);
+
+	virtual void getCamreaPosition(Vector4D* pCameraPos);
+	virtual void getCamreaViewDirection(Vector3D* pViewDir);
+	virtual void getViewFrustrum(Plane *pPlane);
+	virtual void getViewMatrix(Matrix4x4& mat);
+	virtual void getProjMatrix(Matrix4x4& mat);
+	virtual void getViewProjMatrix(Matrix4x4& mat);
+
+	virtual void Transform2Dto3D(const SDimension2D &pt, Vector4D *vcOrig, Vector4D *vcDir);
+	virtual SDimension2D Transform3Dto2D(const Vector4D &vcPoint);
+
+
+	virtual SGP_DRIVER_TYPE getVideoDriverType() const { return SGPDT_NULL; }
+	virtual const String getVideoDriverName() const { return String("Null Render Device"); }
+	virtual String getVendorName() { return String("SGP Engine"); }
+
+	virtual void setAmbientLight(const Colour& ) {}
+	virtual void setWorkingDirection(const String& workingDir);
+
+	virtual void setRenderDeviceTime(uint32 devicetime, double deltatime)
+	{
+		m_RenderDeviceTime = devicetime;
+		m_RenderDeviceDelta = deltatime;
+	}
+	virtual uint32 getRenderDeviceTime() { return m_RenderDeviceTime; }
+	virtual double getDeltaTime() { return m_RenderDeviceDelta; }
+
+
+	virtual void FlushEditorLinesRenderBatch(bool bNoDepthLine = false, float LineWidth = 1.0f );
+
+	// No font is created, text drawing is only recorded
+	virtual SGP_TTFFont* CreateTTFFont(FT_Library& ) { return NULL; }
+	virtual void BeginRenderText() {}
+	virtual void EndRenderText() {}
+	virtual void SetActiveFont(const char* ) {}
+	virtual bool CreateFontInManager(const char* , const String& , bool , bool , uint16 ) { return false; }
+	virtual void DrawTextInPos(int xPos, int yPos, uint32 flag, float RealFontSize, uint8 r, uint8 g, uint8 b, wchar_t* format, ...);
+	virtual void PreCacheChar(const String& ) {}
+
+public:
+	//! Command log of all submitted work
+	CSGPNullCommandLog& getCommandLog() { return m_CommandLog; }
+
+	//! Hands out an unique fake texture ID
+	uint32 createNullObjectID() { return ++m_LastObjectID; }
+
+	CNullCamera* getNullCamera() { return m_pCurrentCamera; }
+
+private:
+	CNullRenderDevice();
+
+	SGP_DECLARE_NON_COPYABLE (CNullRenderDevice)
+
+private:
+	CSGPNullCommandLog		m_CommandLog;
+	uint32					m_LastObjectID;
+
+	CNullCamera*			m_pCurrentCamera;
+	Logger*					m_pLogger;
+	SDimension2D			m_ScreenSize;
+	SDimension2D			m_CurrentRTSize;
+	SViewPort				m_ViewPort;
+	bool					m_bFeatureEnabled[SGPVDF_COUNT];
+
+	String					m_WorkingDir;
+
+	uint32					m_RenderDeviceTime;		// in milliseconds
+	double					m_RenderDeviceDelta;	// in milliseconds
+
+	SGPCreationParameters	m_Params;
+
+	// Manager
+	CSGPTextureManager*		m_pTextureManager;
+	ISGPShaderManager*		m_pShaderManager;
+	ISGPMaterialSystem*		m_pMaterialSystem;
+	ISGPVertexCacheManager* m_pVertexCacheManager;
+	ISGPModelManager*		m_pModelManager;
+	ISGPParticleManager*	m_pParticleManager;
+	ISGPEffectSystemManager*m_pEffectSystemManager;
+	ISGPFontManager*		m_pFontManager;
+	ISGPInstanceManager*	m_pInstanceManager;
+
+	// MultiThread Loader
+	CSGPResourceLoaderMuitiThread*	m_pMTResourceLoader;
+};
+
+//! Creates the null render device, returns NULL if failed
+CNullRenderDevice* createNullDriver(const SGPCreationParameters& params);
+
+#endif   // __SGP_NULLRENDERDEVICE_HEADER__
@@ -0,0 +1,76 @@
+
+CNullTexture::CNullTexture(ISGPImage* surface, const String& name, CNullRenderDevice* renderdevice, bool bHasMipmaps)
+	: ISGPTexture(name), m_pRenderDevice(renderdevice), m_NullTextureID(0),
+	m_ColorFormat(SGPPF_A8R8G8B8), m_Pitch(0), m_MipMapLevels(bHasMipmaps ? 1 : 0),
+	m_bCubeMap(false), m_bVolume(false)
+{
+	m_NullTextureID = m_pRenderDevice->createNullObjectID();
+
+	// DDS data is recorded as an update of the new texture
+	if( surface && surface->IsDDSImage() )
+	{
+		m_pRenderDevice->getCommandLog().record(SGPNC_CREATE_TEXTURE, m_NullTextureID);
+		updateDDSTexture(surface);
+		return;
+	}
+
+	getImageValues(surface);
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_CREATE_TEXTURE, m_NullTextureID,
+		surface ? surface->getImageDataSizeInBytes() : 0, m_ImageSize.Width);
+}
+
+CNullTexture::~CNullTexture()
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_DELETE_TEXTURE, m_NullTextureID);
+}
+
+void CNullTexture::updateDDSTexture(ISGPImage* surface)
+{
+	SGPImageDDS *pSurface = static_cast<SGPImageDDS*>(surface);
+
+	m_ImageSize = surface->getDimension();
+	m_bCubeMap = pSurface->isCubemap();
+	m_bVolume = pSurface->isVolume();
+	m_MipMapLevels = (pSurface->getNumberOfMipmaps() > 1) ? pSurface->getNumberOfMipmaps() : 0;
+
+	// Bytes which would be uploaded to video memory
+	uint32 nBytes = 0;
+	for( int i=0; i<pSurface->getNumberOfMipmaps(); i++ )
+		nBytes += pSurface->getMipmapDataBytes(i);
+	if( m_bCubeMap )
+		nBytes *= 6;
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_UPDATE_TEXTURE, m_NullTextureID, nBytes, m_ImageSize.Width);
+}
+
+bool CNullTexture::BindTexture2D(int iTextureUnit)
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_BIND_TEXTURE, m_NullTextureID, 0, (uint32)iTextureUnit);
+	return true;
+}
+
+bool CNullTexture::BindTexture3D(int iTextureUnit)
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_BIND_TEXTURE, m_NullTextureID, 0, (uint32)iTextureUnit);
+	return true;
+}
+
+bool CNullTexture::BindTextureCubeMap(int iTextureUnit)
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_BIND_TEXTURE, m_NullTextureID, 0, (uint32)iTextureUnit);
+	return true;
+}
+
+void CNullTexture::getImageValues(ISGPImage* image)
+{
+	if( !image )
+	{
+		Logger::getCurrentLogger()->writeToLog(String("No image for Null texture."), ELL_ERROR);
+		return;
+	}
+
+	m_ImageSize = image->getDimension();
+	m_ColorFormat = image->getColorFormat();
+	m_Pitch = image->getPitch();
+}
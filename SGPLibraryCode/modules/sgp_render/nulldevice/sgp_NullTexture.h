@@ -0,0 +1,70 @@
+#ifndef __SGP_NULLTEXTURE_HEADER__
+#define __SGP_NULLTEXTURE_HEADER__
+
+class CNullRenderDevice;
+
+/**
+	Texture of the null render device.
+	Only the image description is kept, no pixel data is stored and no API texture is created.
+	Every texture gets an unique fake ID, uploads and binds are written to the command log.
+*/
+class CNullTexture : public ISGPTexture
+{
+public:
+	CNullTexture(ISGPImage* surface, const String& name, CNullRenderDevice* renderdevice, bool bHasMipmaps=false);
+	virtual ~CNullTexture();
+
+	virtual void updateDDSTexture(ISGPImage* surface);
+
+	//! No pixel data is kept, so texture can not be locked
+	virtual void* lock(SGP_TEXTURE_LOCK_MODE , uint32 ) { return NULL; }
+	virtual void unlock() {}
+
+	virtual const SDimension2D& getOriginalSize() const		{ return m_ImageSize; }
+	virtual const SDimension2D& getSize() const				{ return m_ImageSize; }
+	virtual SGP_DRIVER_TYPE getDriverType() const			{ return SGPDT_NULL; }
+	virtual SGP_PIXEL_FORMAT getColorFormat() const			{ return m_ColorFormat; }
+	virtual uint32 getPitch() const							{ return m_Pitch; }
+	virtual bool hasMipMaps() const							{ return m_MipMapLevels > 0; }
+	virtual uint32 getMipMapLevels() const					{ return m_MipMapLevels; }
+	virtual void regenerateMipMapLevels() {}
+
+	virtual bool isTexture2D() const	{ return !m_bCubeMap && !m_bVolume; }
+	virtual bool isTexture3D() const	{ return m_bVolume; }
+	virtual bool isCubeMap() const		{ return m_bCubeMap; }
+
+	virtual bool getMipmapData(void* , uint32 , SGP_TEXTURE_TARGET ) { return false; }
+
+	virtual void setFiltering(SGP_TEXTURE_FILTERING , SGP_TEXTURE_FILTERING ) {}
+	virtual void setWrapMode(SGP_TEXTURE_ADDRESSING , SGP_TEXTURE_ADDRESSING , SGP_TEXTURE_ADDRESSING ) {}
+	virtual void setBorderColor(const Colour ) {}
+	virtual void setAnisotropicFilter(int ) {}
+	virtual void setLODBias(float ) {}
+	virtual void setMaxMipLevel(int ) {}
+
+	virtual bool BindTexture2D(int iTextureUnit = 0);
+	virtual bool BindTexture3D(int iTextureUnit = 0);
+	virtual bool BindTextureCubeMap(int iTextureUnit = 0);
+	virtual bool unBindTexture2D(int ) { return true; }
+	virtual bool unBindTexture3D(int ) { return true; }
+	virtual bool unBindTextureCubeMap(int ) { return true; }
+
+	//! Fake API texture ID
+	inline uint32 getNullTextureID() const { return m_NullTextureID; }
+
+private:
+	void getImageValues(ISGPImage* image);
+
+	CNullRenderDevice*	m_pRenderDevice;
+	uint32				m_NullTextureID;
+	SDimension2D		m_ImageSize;
+	SGP_PIXEL_FORMAT	m_ColorFormat;
+	uint32				m_Pitch;
+	uint32				m_MipMapLevels;
+	bool				m_bCubeMap;
+	bool				m_bVolume;
+
+	SGP_DECLARE_NON_COPYABLE (CNullTexture)
+};
+
+#endif		// __SGP_NULLTEXTURE_HEADER__
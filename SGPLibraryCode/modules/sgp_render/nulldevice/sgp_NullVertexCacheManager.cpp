@@ -0,0 +1,322 @@
+
+CNullVertexCacheManager::CNullVertexCacheManager(CNullRenderDevice* pRenderDevice)
+	: m_pRenderDevice(pRenderDevice), m_BonePaletteBoneNum(0), m_NumBonePaletteFlush(0)
+{
+}
+
+CNullVertexCacheManager::~CNullVertexCacheManager()
+{
+	ClearAllTextureBufferObject();
+	ClearAllStaticBuffer();
+}
+
+uint32 CNullVertexCacheManager::addStaticBuffer(SNullStaticBuffer* pNewSB)
+{
+	m_StaticBuffers.add(pNewSB);
+	pNewSB->nSBID = (uint32)m_StaticBuffers.size();
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_CREATE_STATICBUFFER, pNewSB->nSBID, pNewSB->nNumVerts, pNewSB->nNumIndis);
+	return pNewSB->nSBID;
+}
+
+uint32 CNullVertexCacheManager::CreateStaticBuffer(
+	SGP_VERTEX_TYPE VertexType,
+	const SGPSkin& skin,
+	const AABBox& boundingbox,
+	uint32  nVertexNum,
+	uint32  nIndexNum,
+	const void   *pVerts,
+	const uint16 *pIndis )
+{
+	jassert((nVertexNum>0) && (nIndexNum>0) && (pVerts) && (pIndis));
+
+	SNullStaticBuffer* pNewSB = new SNullStaticBuffer();
+	pNewSB->VertexType = VertexType;
+	pNewSB->nNumVerts = nVertexNum;
+	pNewSB->nNumIndis = nIndexNum;
+	pNewSB->MaterialSkin = skin;
+	pNewSB->BoundingBox = boundingbox;
+
+	return addStaticBuffer(pNewSB);
+}
+
+// Alphatest variant of a static mesh shader type, OpenGL ES 2.0 has no alphatest shaders
+static SGP_SHADER_TYPE getNullShaderType(SGP_SHADER_TYPE nShaderType, bool bAlphaTest)
+{
+#if !defined(BUILD_OGLES2)
+	if( bAlphaTest )
+	{
+		switch( nShaderType )
+		{
+		case SGPST_TEXTURE:					return SGPST_TEXTURE_ALPHATEST;
+		case SGPST_VERTEXCOLOR_TEXTURE:		return SGPST_VERTEXCOLOR_TEXTURE_ALPHATEST;
+		case SGPST_LIGHTMAP:				return SGPST_LIGHTMAP_ALPHATEST;
+		case SGPST_VERTEXCOLOR_LIGHTMAP:	return SGPST_VERTEXCOLOR_LIGHTMAP_ALPHATEST;
+		case SGPST_SKELETONANIM:			return SGPST_SKELETONANIM_ALPHATEST;
+		default:							break;
+		}
+	}
+#else
+	(void)bAlphaTest;
+#endif
+	return nShaderType;
+}
+
+uint32 CNullVertexCacheManager::CreateMF1MeshStaticBuffer(
+	const SGPMF1Skin& MeshSkin,
+	const SGPMF1Mesh& MF1Mesh,
+	const SGPMF1BoneGroup* pBoneGroup,
+	uint32 NumBoneGroup )
+{
+	jassert( (MF1Mesh.m_iNumVerts>0) && (MF1Mesh.m_iNumIndices>0) &&
+			 (MF1Mesh.m_pVertex) && (MF1Mesh.m_pIndices) );
+
+	SNullStaticBuffer* pNewSB = new SNullStaticBuffer();
+	pNewSB->nNumVerts = MF1Mesh.m_iNumVerts;
+	pNewSB->nNumIndis = MF1Mesh.m_iNumIndices;
+	pNewSB->BoundingBox = MF1Mesh.m_bbox;
+	pNewSB->MaterialSkin.bAlpha = ((MeshSkin.m_iMtlFlag & SGPMESHRF_ALPHABLEND) > 0) ? true : false;
+	pNewSB->MaterialSkin.bAlpha |= ( MF1Mesh.m_nType == static_cast<uint32>(SGPMESHCF_AVMESH) );
+	pNewSB->MaterialSkin.bAlphaTest = ((MeshSkin.m_iMtlFlag & SGPMESHRF_ALPHATEST) > 0) ? true : false;
+	pNewSB->MaterialSkin.nTextureNum = 1;
+	pNewSB->MaterialSkin.nTextureID[0] = m_pRenderDevice->GetTextureManager()->getTextureIDByName(String(MeshSkin.m_cName));
+
+	// Same vertex type and shader selection as the OpenGL vertex cache manager
+	const bool bAlphaTest = pNewSB->MaterialSkin.bAlphaTest;
+	const bool bVertexColor = (MF1Mesh.m_iNumVertexColor > 0) && MF1Mesh.m_pVertexColor;
+	pNewSB->VertexType = SGPVT_UPOS_TEXTURE;
+	pNewSB->MaterialSkin.nShaderType = getNullShaderType(SGPST_TEXTURE, bAlphaTest);
+	if( ( MF1Mesh.m_nType < static_cast<uint32>(SGPMESHCF_BBRD) ||
+		  MF1Mesh.m_nType > static_cast<uint32>(SGPMESHCF_BBRD_VERTICALGROUND) ) &&
+		(NumBoneGroup > 0) &&
+		pBoneGroup )
+	{
+		pNewSB->VertexType = SGPVT_ANIM;
+		pNewSB->MaterialSkin.nShaderType = getNullShaderType(SGPST_SKELETONANIM, bAlphaTest);
+	}
+	else if( (MF1Mesh.m_iNumUV1 > 0) && MF1Mesh.m_pTexCoords1 &&
+			 (MF1Mesh.m_iNumUV0 > 0) && MF1Mesh.m_pTexCoords0 )
+	{
+		pNewSB->MaterialSkin.nTextureNum = 2;
+		pNewSB->MaterialSkin.nTextureID[1] = 1;		// Default White Texture as lightmap texture
+		pNewSB->MaterialSkin.bLightMap = true;
+		if( bVertexColor )
+		{
+			pNewSB->VertexType = SGPVT_UPOS_TEXTURETWO_VERTEXCOLOR;
+			pNewSB->MaterialSkin.nShaderType = getNullShaderType(SGPST_VERTEXCOLOR_LIGHTMAP, bAlphaTest);
+		}
+		else
+		{
+			pNewSB->VertexType = SGPVT_UPOS_TEXTURETWO;
+			pNewSB->MaterialSkin.nShaderType = getNullShaderType(SGPST_LIGHTMAP, bAlphaTest);
+		}
+	}
+	else if( bVertexColor )
+	{
+		pNewSB->VertexType = SGPVT_UPOS_TEXTURE_VERTEXCOLOR;
+		pNewSB->MaterialSkin.nShaderType = getNullShaderType(SGPST_VERTEXCOLOR_TEXTURE, bAlphaTest);
+	}
+
+	return addStaticBuffer(pNewSB);
+}
+
+void* CNullVertexCacheManager::GetStaticBufferByID(uint32 nSBufferID)
+{
+	return (void*)getStaticBuffer(nSBufferID);
+}
+
+uint32 CNullVertexCacheManager::CreateTextureBufferObjectByID(uint32 ModelResourceID)
+{
+	CMF1FileResource* pMF1Res =	m_pRenderDevice->GetModelManager()->getModelByID(ModelResourceID);
+	if( pMF1Res && pMF1Res->pModelMF1 && (pMF1Res->pModelMF1->m_iNumBones > 0) )
+	{
+		uint32 TBOID = m_TBOBoneNum.size();
+		m_TBOBoneNum.add( pMF1Res->pModelMF1->m_iNumBones );
+		m_TBOPaletteFlush.add( m_NumBonePaletteFlush - 1 );
+
+		m_pRenderDevice->getCommandLog().record(SGPNC_CREATE_BONEBUFFER, TBOID, pMF1Res->pModelMF1->m_iNumBones);
+		return TBOID;
+	}
+
+	return 0xFFFFFFFF;
+}
+
+void CNullVertexCacheManager::UpdateTextureBufferObjectByID(float* pBoneMatrixBuffer, uint32 nBoneCount, uint32 TBOID)
+{
+	if( TBOID >= (uint32)m_TBOBoneNum.size() || (m_TBOBoneNum[TBOID] == 0) || !pBoneMatrixBuffer )
+		return;
+
+	// Uploaded with the bone palette
+	m_TBOBoneNum.set(TBOID, nBoneCount);
+}
+
+bool CNullVertexCacheManager::BindTextureBufferObjectByID(uint32 TBOID, int iTextureUnit)
+{
+	if( TBOID >= (uint32)m_TBOBoneNum.size() || (m_TBOBoneNum[TBOID] == 0) )
+		return false;
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_BIND_BONEBUFFER, TBOID, 0, (uint32)iTextureUnit);
+	return true;
+}
+
+void CNullVertexCacheManager::ClearAllTextureBufferObject()
+{
+	for( int i=0; i<m_TBOBoneNum.size(); i++ )
+		ClearTextureBufferObject( (uint32)i );
+	m_TBOBoneNum.clear();
+	m_TBOPaletteFlush.clear();
+}
+
+void CNullVertexCacheManager::ClearTextureBufferObject( uint32 nTBOID )
+{
+	if( nTBOID >= (uint32)m_TBOBoneNum.size() || (m_TBOBoneNum[nTBOID] == 0) )
+		return;
+
+	// Slot is kept, IDs of other TBOs should not change
+	m_TBOBoneNum.set(nTBOID, 0);
+	m_pRenderDevice->getCommandLog().record(SGPNC_DELETE_BONEBUFFER, nTBOID);
+}
+
+void CNullVertexCacheManager::ClearAllStaticBuffer()
+{
+	for( int i=0; i<m_StaticBuffers.size(); i++ )
+		ClearStaticBuffer( (uint32)i + 1 );
+	m_StaticBuffers.clear();
+}
+
+void CNullVertexCacheManager::ClearStaticBuffer( uint32 nSBufferID )
+{
+	SNullStaticBuffer* pSB = getStaticBuffer(nSBufferID);
+	if( !pSB )
+		return;
+
+	// Slot is kept, IDs of other static buffers should not change
+	pSB->nSBID = 0;
+	m_pRenderDevice->getCommandLog().record(SGPNC_DELETE_STATICBUFFER, nSBufferID);
+}
+
+void CNullVertexCacheManager::RenderStaticBuffer( uint32 nSBufferID, const Matrix4x4& , const RenderBatchConfig& config )
+{
+	SNullStaticBuffer* pSB = getStaticBuffer(nSBufferID);
+	if( !pSB )
+		return;
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_STATICBUFFER, nSBufferID, pSB->nNumVerts, pSB->nNumIndis);
+
+	// Same rule as OpenGL device: opaque batches with a geometry instancing shader
+	const SGPSkin& skin = pSB->MaterialSkin;
+	if( (skin.nPrimitiveType == SGPPT_POINTS) || (skin.nPrimitiveType == SGPPT_LINE_STRIP) ||
+		(skin.nPrimitiveType == SGPPT_LINE_LOOP) || (skin.nPrimitiveType == SGPPT_LINES) ||
+		skin.bAlpha || (config.m_fBatchAlpha < 1.0f) ||
+		(getInstancingShaderType(skin.nShaderType) == SGPST_SHADER_NUM) )
+		return;
+
+	SNullStaticInstance Instance;
+	Instance.nSBID = nSBufferID;
+	Instance.nReplacedTextureID = config.m_nReplacedTextureID;
+	Instance.nLightMapTextureID = skin.bLightMap ? config.m_nLightMapTextureID : 0;
+	m_StaticInstances.add(Instance);
+}
+
+int CNullVertexCacheManager::StaticInstanceSorter::compareElements(const SNullStaticInstance& first, const SNullStaticInstance& second)
+{
+	if( first.nSBID != second.nSBID )
+		return (first.nSBID < second.nSBID) ? -1 : 1;
+	if( first.nReplacedTextureID != second.nReplacedTextureID )
+		return (first.nReplacedTextureID < second.nReplacedTextureID) ? -1 : 1;
+	if( first.nLightMapTextureID != second.nLightMapTextureID )
+		return (first.nLightMapTextureID < second.nLightMapTextureID) ? -1 : 1;
+	return 0;
+}
+
+void CNullVertexCacheManager::FlushStaticInstanceRuns()
+{
+	StaticInstanceSorter Sorter;
+	m_StaticInstances.sort(Sorter);
+
+	int i = 0;
+	while( i < m_StaticInstances.size() )
+	{
+		int iRunEnd = i + 1;
+		while( (iRunEnd < m_StaticInstances.size()) &&
+			(StaticInstanceSorter::compareElements(m_StaticInstances.getReference(i), m_StaticInstances.getReference(iRunEnd)) == 0) )
+			iRunEnd++;
+
+		// Single batch is drawn without instancing
+		if( iRunEnd - i > 1 )
+		{
+			const uint32 nSBID = m_StaticInstances.getReference(i).nSBID;
+			m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_INSTANCED, nSBID, (uint32)(iRunEnd - i), getStaticBuffer(nSBID) ? getStaticBuffer(nSBID)->nNumIndis : 0);
+		}
+		i = iRunEnd;
+	}
+
+	m_StaticInstances.clearQuick();
+}
+
+void CNullVertexCacheManager::FlushBonePalette()
+{
+	// 3x4 matrix per bone
+	if( m_BonePaletteBoneNum > 0 )
+		m_pRenderDevice->getCommandLog().record(SGPNC_UPDATE_BONEBUFFER, 0, m_BonePaletteBoneNum, sizeof(float)*12*m_BonePaletteBoneNum);
+
+	m_BonePaletteBoneNum = 0;
+	m_NumBonePaletteFlush++;
+}
+
+void CNullVertexCacheManager::RenderSkeletonMesh( uint32 nSBufferID, const Matrix4x4& , uint32 nTBOID, const RenderBatchConfig& )
+{
+	SNullStaticBuffer* pSB = getStaticBuffer(nSBufferID);
+	if( !pSB )
+		return;
+
+	uint32 nBoneNum = (nTBOID < (uint32)m_TBOBoneNum.size()) ? m_TBOBoneNum[nTBOID] : 0;
+	if( nBoneNum == 0 )
+		return;
+
+	// Meshes of one instance share its bones
+	if( m_TBOPaletteFlush[nTBOID] != m_NumBonePaletteFlush )
+	{
+		m_TBOPaletteFlush.set(nTBOID, m_NumBonePaletteFlush);
+		m_BonePaletteBoneNum += nBoneNum;
+	}
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_SKELETONMESH, nSBufferID, nBoneNum, pSB->nNumIndis);
+}
+
+void CNullVertexCacheManager::RenderSkeletonMesh( uint32 nSBufferID, const Matrix4x4& , float* , uint32 nBoneNum, const RenderBatchConfig& )
+{
+	SNullStaticBuffer* pSB = getStaticBuffer(nSBufferID);
+	if( !pSB )
+		return;
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_SKELETONMESH, nSBufferID, nBoneNum, pSB->nNumIndis);
+}
+
+void CNullVertexCacheManager::RenderDynamicBuffer(
+	SGP_VERTEX_TYPE ,
+	const SGPSkin& ,
+	uint32 nVertexNum,
+	uint32 nIndexNum,
+	const void   *pVerts,
+	const uint16 * )
+{
+	if( (nVertexNum == 0) || !pVerts )
+		return;
+
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_DYNAMICBUFFER, 0, nVertexNum, nIndexNum);
+}
+
+void CNullVertexCacheManager::RenderFullScreenQuad()
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_FULLSCREENQUAD, 0, 4, 6);
+}
+
+void CNullVertexCacheManager::RenderFullScreenQuadWithoutMaterial()
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_FULLSCREENQUAD, 0, 4, 6);
+}
+
+void CNullVertexCacheManager::recordDebug(uint32 nVertexNum)
+{
+	m_pRenderDevice->getCommandLog().record(SGPNC_DRAW_DEBUG, 0, nVertexNum);
+}
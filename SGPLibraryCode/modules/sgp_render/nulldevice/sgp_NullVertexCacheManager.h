@@ -0,0 +1,153 @@
+#ifndef __SGP_NULLVERTEXCACHEMANAGER_HEADER__
+#define __SGP_NULLVERTEXCACHEMANAGER_HEADER__
+
+class CNullRenderDevice;
+
+//! Static buffer description of the null render device (no vertex data is kept)
+struct SNullStaticBuffer
+{
+	uint32			nSBID;			// 0 if the slot is free
+	SGP_VERTEX_TYPE	VertexType;
+	uint32			nNumVerts;
+	uint32			nNumIndis;
+	SGPSkin			MaterialSkin;
+	AABBox			BoundingBox;
+};
+
+/**
+	Vertex cache manager of the null render device.
+	Buffers are only described, every creation, upload and render call is written
+	to the command log of the device. Static buffer ID is slot index + 1,
+	bone buffer (TBO) ID is slot index, so lookups are O(1).
+	Like the OpenGL device, bones of rendered skeleton instances go into one bone palette
+	which is uploaded once per flush.
+*/
+class CNullVertexCacheManager : public ISGPVertexCacheManager
+{
+public:
+	CNullVertexCacheManager(CNullRenderDevice* pRenderDevice);
+	virtual ~CNullVertexCacheManager();
+
+	virtual uint32		CreateStaticBuffer(
+											SGP_VERTEX_TYPE VertexType,
+											const SGPSkin& skin,
+											const AABBox& boundingbox,
+											uint32  nVertexNum,
+											uint32  nIndexNum,
+											const void   *pVerts,
+											const uint16 *pIndis );
+
+	virtual uint32		CreateMF1MeshStaticBuffer(
+											const SGPMF1Skin& MeshSkin,
+											const SGPMF1Mesh& MF1Mesh,
+											const SGPMF1BoneGroup* pBoneGroup,
+											uint32 NumBoneGroup );
+
+	virtual void*		GetStaticBufferByID(uint32 nSBufferID);
+
+	virtual uint32		CreateTextureBufferObjectByID(uint32 ModelResourceID);
+	virtual void		UpdateTextureBufferObjectByID(float* pBoneMatrixBuffer, uint32 nBoneCount, uint32 TBOID);
+	virtual bool		BindTextureBufferObjectByID(uint32 TBOID, int iTextureUnit);
+
+	virtual void		ClearAllTextureBufferObject();
+	virtual void		ClearTextureBufferObject( uint32 nTBOID );
+
+	virtual void		ClearAllStaticBuffer();
+	virtual void		ClearStaticBuffer( uint32 nSBufferID );
+
+	virtual void		RenderStaticBuffer( uint32 nSBufferID, const Matrix4x4& matWorld, const RenderBatchConfig& config );
+
+	virtual void		RenderSkeletonMesh( uint32 nSBufferID, const Matrix4x4& matWorld, uint32 nTBOID, const RenderBatchConfig& config );
+	virtual void		RenderSkeletonMesh( uint32 nSBufferID, const Matrix4x4& matWorld, float* pBoneMatrixBuffer, uint32 nBoneNum, const RenderBatchConfig& config );
+
+	virtual void		RenderDynamicBuffer(SGP_VERTEX_TYPE VertexType,
+											const SGPSkin& skin,
+											uint32 nVertexNum,
+											uint32 nIndexNum,
+											const void   *pVerts,
+											const uint16 *pIndis );
+
+	virtual void		ForcedCommitAll(void) {}
+	virtual void		ForcedClearAll(void) {}
+
+
+	// Debug rendering, only the number of vertices (if known) is recorded
+	virtual void		RenderPoints( uint32 nVertexNum, const SGPVertex_UPOS_VERTEXCOLOR * )					{ recordDebug(nVertexNum); }
+	virtual void		RenderLines( uint32 nVertexNum, const SGPVertex_UPOS_VERTEXCOLOR *, bool )				{ recordDebug(nVertexNum); }
+	virtual void		RenderLine( const float *, const float *, const Colour * )								{ recordDebug(2); }
+	virtual void		RenderTriangles( uint32 nVertexNum, uint32 , const void *, const uint16 *, bool )		{ recordDebug(nVertexNum); }
+
+	virtual void		RenderBox( const AABBox& , const Colour& )												{ recordDebug(24); }
+	virtual void		RenderBox( const OBBox& , const Colour& )												{ recordDebug(24); }
+	virtual void		RenderBox( const Vector3D& , const Vector3D& , const Colour& )							{ recordDebug(24); }
+	virtual void		FillBox( const AABBox& , const Colour& )												{ recordDebug(8); }
+	virtual void		FillBox( const OBBox& , const Colour& )													{ recordDebug(8); }
+	virtual void		FillBox( const Vector3D& , const Vector3D& , const Colour& )							{ recordDebug(8); }
+	virtual void		RenderCircle( const Vector3D& , float , int , const Colour& )							{ recordDebug(0); }
+	virtual void		RenderCircle( const Vector3D& , float , const Vector3D& , const Colour& )				{ recordDebug(0); }
+	virtual void		RenderEllipse( const Vector3D& , const Vector3D& , int , const Colour& )				{ recordDebug(0); }
+	virtual void		RenderEllipse( const Vector3D& , const Vector3D& , float , const Vector3D& , float , const Colour& ) { recordDebug(0); }
+
+	virtual void		RenderSphere( const Vector3D& , float , const Colour& )									{ recordDebug(0); }
+	virtual void		RenderSphere( const Matrix4x4& , float , const Colour& )								{ recordDebug(0); }
+	virtual void		FillSphere( const Vector3D& , float , const Colour& )									{ recordDebug(0); }
+	virtual void		RenderDetailSphere( const Vector3D& , float , int , int , const Colour& )				{ recordDebug(0); }
+
+	virtual void		RenderCylinder( const Vector3D& , float , float , int , const Colour& )					{ recordDebug(0); }
+	virtual void		RenderCylinder( const Matrix4x4& , float , float , int , const Colour& )				{ recordDebug(0); }
+	virtual void		RenderCone( const Vector3D& , float , float , int , const Colour& )						{ recordDebug(0); }
+	virtual void		RenderCone( const Matrix4x4& , float , float , int , const Colour& )					{ recordDebug(0); }
+	virtual void		RenderEllipsoid( const Vector3D& , const Vector3D& , const Colour& )					{ recordDebug(0); }
+	virtual void		RenderEllipsoid( const Matrix4x4& , const Vector3D& , const Colour& )					{ recordDebug(0); }
+	virtual void		RenderCapsule( const Vector3D& , const Vector3D& , float , const Colour& )				{ recordDebug(0); }
+	virtual void		RenderFrustum( const Frustum& , const Colour& )											{ recordDebug(24); }
+
+	virtual void		FillTriangles( SGP_VERTEX_TYPE , uint32 nVertexNum, uint32 , const void *, const uint16 *, const SGPSkin& ) { recordDebug(nVertexNum); }
+
+	virtual void		RenderFullScreenQuad();
+	virtual void		RenderFullScreenQuadWithoutMaterial();
+
+	//! Records one SGPNC_DRAW_INSTANCED for each run of opaque static buffer batches
+	//! since last flush, runs are grouped like the OpenGL material renderer does
+	void				FlushStaticInstanceRuns();
+
+	//! Records one SGPNC_UPDATE_BONEBUFFER for the bone palette of all skeleton batches since last flush
+	void				FlushBonePalette();
+
+private:
+	// Opaque static buffer batch which could be drawn instanced
+	struct SNullStaticInstance
+	{
+		uint32			nSBID;
+		uint32			nReplacedTextureID;
+		uint32			nLightMapTextureID;		// 0 if the mesh has no lightmap
+	};
+	class StaticInstanceSorter
+	{
+	public:
+		static int compareElements(const SNullStaticInstance& first, const SNullStaticInstance& second);
+	};
+
+	inline SNullStaticBuffer* getStaticBuffer(uint32 nSBufferID) const
+	{
+		if( (nSBufferID == 0) || (nSBufferID > (uint32)m_StaticBuffers.size()) )
+			return NULL;
+		SNullStaticBuffer* pSB = m_StaticBuffers[nSBufferID-1];
+		return (pSB->nSBID != 0) ? pSB : NULL;
+	}
+
+	uint32 addStaticBuffer(SNullStaticBuffer* pNewSB);
+	void recordDebug(uint32 nVertexNum);
+
+	CNullRenderDevice*				m_pRenderDevice;
+	OwnedArray<SNullStaticBuffer>	m_StaticBuffers;
+	Array<uint32>					m_TBOBoneNum;		// bone number of each TBO, 0 if the slot is free
+	Array<uint32>					m_TBOPaletteFlush;	// m_NumBonePaletteFlush when the TBO was added to the palette
+	uint32							m_BonePaletteBoneNum;
+	uint32							m_NumBonePaletteFlush;
+	Array<SNullStaticInstance>		m_StaticInstances;	// batches submitted since last flush
+
+	SGP_DECLARE_NON_COPYABLE (CNullVertexCacheManager)
+};
+
+#endif		// __SGP_NULLVERTEXCACHEMANAGER_HEADER__
@@ -0,0 +1,87 @@
+
+
+char Shader_lightmap_alphatest_instance_VS_String[] = 
+	"#version 330																\n"\
+	"																			\n"\
+	"layout (location = 0) in vec3 inPosition;									\n"\
+	"layout (location = 1) in vec2 inCoord0;									\n"\
+	"layout (location = 2) in vec2 inCoord1;									\n"\
+	"// per-instance world matrix columns, color and texture anim				\n"\
+	"layout (location = 8) in vec4 inWorld0;									\n"\
+	"layout (location = 9) in vec4 inWorld1;									\n"\
+	"layout (location = 10) in vec4 inWorld2;									\n"\
+	"layout (location = 11) in vec4 inWorld3;									\n"\
+	"// inMaterialColor.a is batch alpha										\n"\
+	"layout (location = 12) in vec4 inMaterialColor;							\n"\
+	"// x is texture index; y,z is uv offset									\n"\
+	"layout (location = 13) in vec3 inTexIndexUVOffset;							\n"\
+	"																			\n"\
+	"uniform mat4 ViewProjMatrix;												\n"\
+	"uniform float fFarPlane;													\n"\
+
+	"// TextureAtlas how many parts texture be divided in X and Y				\n"\
+	"// TextureAtlas.xy = AtlasNbX, AtlasNbY									\n"\
+	"// TextureAtlas.zw = 1.0f/AtlasNbX, 1.0f/AtlasNbY							\n"\
+	"uniform vec4 TextureAtlas;													\n"\
+	"																			\n"\
+	"out vec2 vTexCoordPass0;													\n"\
+	"out vec2 vTexCoordPass1;													\n"\
+	"out vec4 vMaterialColorPass;												\n"\
+	"out float fVertexDepth;													\n"\
+	"																			\n"\
+	" void main()																\n"\
+	" {																			\n"\
+	" 	mat4 WorldMatrix = mat4(inWorld0, inWorld1, inWorld2, inWorld3);		\n"\
+	" 	gl_Position = ViewProjMatrix * (WorldMatrix * vec4(inPosition, 1.0));	\n"\
+
+	"	vTexCoordPass0 = vec2(													\n"\
+	"		float( int(inTexIndexUVOffset.x) % int(TextureAtlas.x) ) / TextureAtlas.x,	\n"\
+	"		float( int(inTexIndexUVOffset.x) / int(TextureAtlas.x) ) / TextureAtlas.y ) +	\n"\
+	"			inCoord0.xy * TextureAtlas.zw + inTexIndexUVOffset.yz;			\n"\
+
+	"	vTexCoordPass1 = inCoord1;												\n"\
+	"	vMaterialColorPass = inMaterialColor;									\n"\
+	"	// store Depth as current w / farplane									\n"\
+	"	fVertexDepth = gl_Position.w / fFarPlane;								\n"\
+	" }																			\n"\
+	"";
+
+char Shader_lightmap_alphatest_instance_PS_String[] = 
+	"#version 330																\n"\
+	"																			\n"\
+
+	"in vec2 vTexCoordPass0;													\n"\
+	"in vec2 vTexCoordPass1;													\n"\
+	"in vec4 vMaterialColorPass;												\n"\
+	"in float fVertexDepth;														\n"\
+
+	"layout (location = 0) out vec4 outputColor;								\n"\
+	"layout (location = 1) out vec4 outputColor1;								\n"\
+
+	"uniform sampler2D gSampler0;			// Diffuse							\n"\
+	"uniform sampler2D gSampler1;			// Lightmap							\n"\
+	"uniform vec4 SunColor;					// ambient color and Intensity		\n"\
+
+	"void main()																\n"\
+	"{																			\n"\
+	"	outputColor = texture2D(gSampler0, vTexCoordPass0);						\n"\
+	"	// Alpha-test															\n"\
+	"	if( outputColor.a < 0.5 )												\n"\
+	"	{																		\n"\
+	"		discard;															\n"\
+	"	}																		\n"\
+
+	"	vec4 lightmap = texture2D(gSampler1, vTexCoordPass1);					\n"\
+	"	outputColor.rgb *= lightmap.rgb * vMaterialColorPass.rgb;				\n"\
+	"	outputColor.rgb += SunColor.rgb * SunColor.a * lightmap.a;	//Ambient	\n"\
+	"	outputColor.a *= vMaterialColorPass.a;									\n"\
+
+	"	// Packing a [0-1] float depth value into a 4D vector					\n"\
+	"	//	where each component will be 8-bits color value						\n"\
+	"	const vec4 bitSh = vec4(16777216.0, 65536.0, 256.0, 1.0);				\n"\
+	"	const vec4 bitMsk = vec4(0.0, 1.0/256.0, 1.0/256.0, 1.0/256.0);			\n"\
+	"	outputColor1 = fract(fVertexDepth * bitSh);								\n"\
+	"	outputColor1 -= outputColor1.xxyz * bitMsk;								\n"\
+
+	"}																			\n"\
+	"";
@@ -22,6 +22,7 @@ char Shader_anim_alphatest_VS_String[] =
 	"uniform vec3 SunDirection;			// Sun Direction 										\n"\
 
 	"uniform samplerBuffer jointTex;															\n"\
+	"uniform int BoneOffset;			// first texel of this instance in bone palette			\n"\
 
 	"out float fVertexAlphaPass;																\n"\
 	"out vec2 vTexCoordPass;																	\n"\
@@ -32,9 +33,9 @@ char Shader_anim_alphatest_VS_String[] =
 	"	 mat4 matBone = mat4(0.0);																\n"\
 	"    for(int i = 0; i < 4; ++i)																\n"\
     "    {																						\n"\
-	"		 matBone[0] += texelFetch(jointTex, int(3*inBoneIndex[i]  )  ) * inBoneWeight[i];	\n"\
-    "		 matBone[1] += texelFetch(jointTex, int(3*inBoneIndex[i]+1)  ) * inBoneWeight[i];	\n"\
-    "		 matBone[2] += texelFetch(jointTex, int(3*inBoneIndex[i]+2)  ) * inBoneWeight[i];	\n"\
+	"		 matBone[0] += texelFetch(jointTex, BoneOffset + int(3*inBoneIndex[i]  )  ) * inBoneWeight[i];	\n"\
+    "		 matBone[1] += texelFetch(jointTex, BoneOffset + int(3*inBoneIndex[i]+1)  ) * inBoneWeight[i];	\n"\
+    "		 matBone[2] += texelFetch(jointTex, BoneOffset + int(3*inBoneIndex[i]+2)  ) * inBoneWeight[i];	\n"\
 	"    }																						\n"\
 	"	 matBone[3] = vec4(0.0, 0.0, 0.0, 1.0);													\n"\
 
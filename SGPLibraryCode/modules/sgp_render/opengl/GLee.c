@@ -40,6 +40,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <assert.h>
 #include "GLee.h"
 
 #if defined(__APPLE__) || defined(__APPLE_CC__)
@@ -52,6 +53,8 @@ GLboolean __GLeeInited=GL_FALSE;
 
 #ifndef _WIN32
 	#define __stdcall  /* nothing */
+	#define _strdup strdup
+	#define sprintf_s snprintf
 #endif 
 
 GLEE_FUNC __GLeeGetProcAddress(const char *extname)
@@ -20321,7 +20324,7 @@ GLEE_EXTERN void GLeeGetExtStrGL( char * glExtStr, int strlength )
 	glGetIntegerv(GL_NUM_EXTENSIONS, &n);
 
 	GLEEPFNGLGETSTRINGIPROC glGetStringi = 0;
-	glGetStringi = (GLEEPFNGLGETSTRINGIPROC)wglGetProcAddress("glGetStringi");
+	glGetStringi = (GLEEPFNGLGETSTRINGIPROC)__GLeeGetProcAddress("glGetStringi");
 
 	char * pStartPos = glExtStr;
 	for (GLint i=0; i<n; i++) 
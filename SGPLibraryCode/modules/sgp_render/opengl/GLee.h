@@ -64,6 +64,8 @@
 #else // GLX
 	#define __glext_h_  /* prevent glext.h from being included  */
 	#define __glxext_h_ /* prevent glxext.h from being included */
+	#define GL_GLEXT_LEGACY   /* newer Mesa headers use other include guards, */
+	#define GLX_GLXEXT_LEGACY /* these keep gl.h and glx.h from including them */
 	#define GLX_GLXEXT_PROTOTYPES
 	#include <GL/gl.h>
 	#include <GL/glx.h>
@@ -1082,6 +1084,10 @@ GLEE_EXTERN GLboolean _GLEE_SGIX_texture_range;
 	#ifndef GLX_NV_video_output
     typedef unsigned int GLXVideoDeviceNV;
     #endif // GLX_NV_video_output
+
+	#ifndef GLX_NV_video_capture
+    typedef XID GLXVideoCaptureDeviceNV;
+    #endif // GLX_NV_video_capture
     	
 #endif /* end platform specific */
 
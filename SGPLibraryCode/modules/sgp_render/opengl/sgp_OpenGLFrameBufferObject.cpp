@@ -263,6 +263,9 @@ void COpenGLFrameBufferObject::clearOneDrawBuffers(int nColorAttachment, float f
 	static GLenum Firstbuffers[] = {GL_COLOR_ATTACHMENT0};
 	static GLenum Secondbuffers[] = {GL_COLOR_ATTACHMENT1};
 
+	// glClear uses color / depth write masks
+	m_pRenderDevice->getRenderStateCache()->apply();
+
 	switch( nColorAttachment )
 	{
 	case 0:
@@ -138,55 +138,67 @@ void COpenGLGrassRenderer::update(float fDeltaTimeInSecond, const Vector4D& camP
 
 	SGPVertex_GRASS_Cluster tempData;
 
+	// Collect bounding box of grass clusters in visible chunks, they are culled in one batch
+	m_GrassClusterBounds.clear();
+	m_GrassClusterCandidates.clearQuick();
+
 	CSGPTerrainChunk** pChunkEnd = pGrass->m_TerrainGrassChunks.end();
 	for( CSGPTerrainChunk** pChunkStart = pGrass->m_TerrainGrassChunks.begin(); pChunkStart < pChunkEnd; pChunkStart++ )
 	{
 		if( !m_pRenderDevice->GetWorldSystemManager()->isTerrainChunkVisible( *pChunkStart ) )
 			continue;
 
+		const SGPGrassCluster* pClusterData = (*pChunkStart)->GetGrassClusterData();
 		for(uint32 i=0; i<(*pChunkStart)->GetGrassClusterDataCount(); i++ )
 		{
 			// None Flag, skip this Cluster
-			uint32 nGrassSetFlag = (*pChunkStart)->GetGrassClusterData()[i].nData;
-			if( nGrassSetFlag == 0 )
+			if( pClusterData[i].nData == 0 )
 				continue;
 
-			tempData.vPosition[0] = (*pChunkStart)->GetGrassClusterData()[i].fPositionX;
-			tempData.vPosition[1] = (*pChunkStart)->GetGrassClusterData()[i].fPositionY;
-			tempData.vPosition[2] = (*pChunkStart)->GetGrassClusterData()[i].fPositionZ;
-			tempData.vPosition[3] = float( (nGrassSetFlag & 0x00FF0000) >> 16 );
+			m_GrassClusterBounds.add(
+				Vector3D(pClusterData[i].fPositionX - m_vDefaultGrassSize.x, pClusterData[i].fPositionY, pClusterData[i].fPositionZ - m_vDefaultGrassSize.x),
+				Vector3D(pClusterData[i].fPositionX + m_vDefaultGrassSize.x, pClusterData[i].fPositionY + m_vDefaultGrassSize.y, pClusterData[i].fPositionZ + m_vDefaultGrassSize.x) );
+			m_GrassClusterCandidates.add( &pClusterData[i] );
+		}
+	}
 
-			// GrassCluster is not inside the camera Frustum, skip this Cluster
-			AABBox GrassClusterAABB;
-			GrassClusterAABB += Vector3D(tempData.vPosition[0] - m_vDefaultGrassSize.x, tempData.vPosition[1], tempData.vPosition[2] - m_vDefaultGrassSize.x);
-			GrassClusterAABB += Vector3D(tempData.vPosition[0] + m_vDefaultGrassSize.x, tempData.vPosition[1] + m_vDefaultGrassSize.y, tempData.vPosition[2] + m_vDefaultGrassSize.x);
-			if( !GrassClusterAABB.Intersects(viewFrustum) )
-				continue;
+	// GrassCluster which is not inside the camera Frustum is skipped
+	m_GrassClusterVisibleIndex.resize( m_GrassClusterBounds.size() );
+	const int nNumVisible = m_GrassClusterBounds.cullToIndices( viewFrustum, m_GrassClusterVisibleIndex.getRawDataPointer() );
 
-			// GrassCluster is too far from the Grass Far Fading distance, skip this Cluster
-			float fGrassDis = (m_vCameraPos - Vector4D(tempData.vPosition[0], tempData.vPosition[1], tempData.vPosition[2])).GetLength();
-			if( fGrassDis > CSGPWorldConfig::getInstance()->m_fGrassFarFadingEnd )
-				continue;
+	for( int v=0; v<nNumVisible; v++ )
+	{
+		const SGPGrassCluster& ClusterData = *m_GrassClusterCandidates[m_GrassClusterVisibleIndex[v]];
+		uint32 nGrassSetFlag = ClusterData.nData;
 
-			// Too many grass Cluster
-			if( m_GrassClusterInstanceArray.size() + 1 > INIT_GRASSCLUSTERINSTANCE_NUM )
-				continue;
+		tempData.vPosition[0] = ClusterData.fPositionX;
+		tempData.vPosition[1] = ClusterData.fPositionY;
+		tempData.vPosition[2] = ClusterData.fPositionZ;
+		tempData.vPosition[3] = float( (nGrassSetFlag & 0x00FF0000) >> 16 );
+
+		// GrassCluster is too far from the Grass Far Fading distance, skip this Cluster
+		float fGrassDis = (m_vCameraPos - Vector4D(tempData.vPosition[0], tempData.vPosition[1], tempData.vPosition[2])).GetLength();
+		if( fGrassDis > CSGPWorldConfig::getInstance()->m_fGrassFarFadingEnd )
+			continue;
 
-			tempData.vPackedNormal[0] = (uint8)(((*pChunkStart)->GetGrassClusterData()[i].nPackedNormal & 0xFF000000) >> 24);
-			tempData.vPackedNormal[1] = (uint8)(((*pChunkStart)->GetGrassClusterData()[i].nPackedNormal & 0x00FF0000) >> 16);
-			tempData.vPackedNormal[2] = (uint8)(((*pChunkStart)->GetGrassClusterData()[i].nPackedNormal & 0x0000FF00) >> 8);
-			tempData.vPackedNormal[3] = (uint8)((nGrassSetFlag & 0xFF000000) >> 24);
+		// Too many grass Cluster
+		if( m_GrassClusterInstanceArray.size() + 1 > INIT_GRASSCLUSTERINSTANCE_NUM )
+			continue;
 
-			tempData.vColor[0] = tempData.vColor[1] = tempData.vColor[2] = 1.0f;
-			tempData.vColor[3] = 1.0f - jlimit(0.0f, 1.0f, (fGrassDis - CSGPWorldConfig::getInstance()->m_fGrassFarFadingStart) / (CSGPWorldConfig::getInstance()->m_fGrassFarFadingEnd - CSGPWorldConfig::getInstance()->m_fGrassFarFadingStart));
-			
-			tempData.vWindParams[0] = ((nGrassSetFlag & 0x0000FF00) >> 8) / 255.0f;
-			tempData.vWindParams[1] = 0.0f;
-			tempData.vWindParams[2] = (nGrassSetFlag & 0x000000FF) / 255.0f;
-			tempData.vWindParams[3] = 0.0f;
+		tempData.vPackedNormal[0] = (uint8)((ClusterData.nPackedNormal & 0xFF000000) >> 24);
+		tempData.vPackedNormal[1] = (uint8)((ClusterData.nPackedNormal & 0x00FF0000) >> 16);
+		tempData.vPackedNormal[2] = (uint8)((ClusterData.nPackedNormal & 0x0000FF00) >> 8);
+		tempData.vPackedNormal[3] = (uint8)((nGrassSetFlag & 0xFF000000) >> 24);
 
-			m_GrassClusterInstanceArray.add( tempData );
-		}
+		tempData.vColor[0] = tempData.vColor[1] = tempData.vColor[2] = 1.0f;
+		tempData.vColor[3] = 1.0f - jlimit(0.0f, 1.0f, (fGrassDis - CSGPWorldConfig::getInstance()->m_fGrassFarFadingStart) / (CSGPWorldConfig::getInstance()->m_fGrassFarFadingEnd - CSGPWorldConfig::getInstance()->m_fGrassFarFadingStart));
+		
+		tempData.vWindParams[0] = ((nGrassSetFlag & 0x0000FF00) >> 8) / 255.0f;
+		tempData.vWindParams[1] = 0.0f;
+		tempData.vWindParams[2] = (nGrassSetFlag & 0x000000FF) / 255.0f;
+		tempData.vWindParams[3] = 0.0f;
+
+		m_GrassClusterInstanceArray.add( tempData );
 	}
 
 	// update grass rendering params
@@ -551,12 +551,17 @@ void OpenGLMaterial::Pass::PreRender()
 {
 	for( int i = 0; i < begin_.size(); ++i )
 		begin_[i]->Begin();
+
+	// Only the state which differs from the last pass reaches OpenGL
+	static_cast<COpenGLRenderDevice*>(ISGPMaterialProperty::m_pRenderDevice)->getRenderStateCache()->apply();
 }
 
 
 // PostRender()
 void OpenGLMaterial::Pass::PostRender()
 {
+	// Restored defaults stay pending in the render state cache,
+	// they are not sent if the next pass sets the same state again
 	for( int i = 0; i < end_.size(); ++i )
 		end_[i]->End();
 }
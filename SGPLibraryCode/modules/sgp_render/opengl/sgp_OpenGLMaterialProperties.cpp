@@ -19,63 +19,71 @@ GLenum getGLBlend(SGP_BLEND_FACTOR factor)
 	return r;
 }
 
+// State of fixed function properties goes through the render state cache of the device
+inline COpenGLRenderStateCache* getGLRenderState()
+{
+	return static_cast<COpenGLRenderDevice*>(ISGPMaterialProperty::m_pRenderDevice)->getRenderStateCache();
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // DepthWriteEnableProperty
 void DepthWriteEnableProperty::Begin() const
 {
-	glDepthMask(flag_);
+	getGLRenderState()->setDepthMask(flag_);
 }
 
 void DepthWriteEnableProperty::End() const
 {
 	// Initially, depth buffer writing is enabled.
-	glDepthMask(GL_TRUE);
+	getGLRenderState()->setDepthMask(GL_TRUE);
 }
 
 // DepthFuncProperty
 void DepthFuncProperty::Begin() const
 {
+	COpenGLRenderStateCache* pState = getGLRenderState();
 	switch(func_)
 	{
 		case SGPCFN_NEVER:
-			glDisable(GL_DEPTH_TEST);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, false);
 			break;
 		case SGPCFN_LESSEQUAL:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LEQUAL);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_LEQUAL);
 			break;
 		case SGPCFN_EQUAL:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_EQUAL);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_EQUAL);
 			break;
 		case SGPCFN_LESS:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LESS);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_LESS);
 			break;
 		case SGPCFN_NOTEQUAL:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_NOTEQUAL);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_NOTEQUAL);
 			break;
 		case SGPCFN_GREATEREQUAL:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_GEQUAL);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_GEQUAL);
 			break;
 		case SGPCFN_GREATER:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_GREATER);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_GREATER);
 			break;
 		case SGPCFN_ALWAYS:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_ALWAYS);
+			pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
+			pState->setDepthFunc(GL_ALWAYS);
 			break;
 	}
 }
 void DepthFuncProperty::End() const
 {
+	COpenGLRenderStateCache* pState = getGLRenderState();
 	if( func_ == SGPCFN_NEVER )
-		glEnable(GL_DEPTH_TEST);
+		pState->enable(COpenGLRenderStateCache::eCapDepthTest, true);
 	// The initial value is SGPCFN_LESS	
-	glDepthFunc(GL_LESS);
+	pState->setDepthFunc(GL_LESS);
 }
 
 // TextureProperty
@@ -205,24 +213,25 @@ void AlphaBlendOpProperty::Begin() const
 	COpenGLRenderDevice *RI = static_cast<COpenGLRenderDevice*>(m_pRenderDevice);
 	if(RI->queryDriverFeature(SGPVDF_BLEND_OPERATIONS))
 	{
-		glEnable(GL_BLEND);
+		COpenGLRenderStateCache* pState = RI->getRenderStateCache();
+		pState->enable(COpenGLRenderStateCache::eCapBlend, true);
 		switch(op_)
 		{
 		case SGPBO_SUBTRACT:
-			glBlendEquation(GL_FUNC_SUBTRACT);
+			pState->setBlendEquation(GL_FUNC_SUBTRACT);
 			break;
 		case SGPBO_REVSUBTRACT:
-			glBlendEquation(GL_FUNC_REVERSE_SUBTRACT);
+			pState->setBlendEquation(GL_FUNC_REVERSE_SUBTRACT);
 			break;
 		case SGPBO_MIN:
-			glBlendEquation(GL_MIN);
+			pState->setBlendEquation(GL_MIN);
 			break;
 		case SGPBO_MAX:
-			glBlendEquation(GL_MAX);
+			pState->setBlendEquation(GL_MAX);
 			break;
 
 		default:
-			glBlendEquation(GL_FUNC_ADD);
+			pState->setBlendEquation(GL_FUNC_ADD);
 			break;
 		}
 	}
@@ -230,32 +239,33 @@ void AlphaBlendOpProperty::Begin() const
 
 void AlphaBlendOpProperty::End() const
 {
-	glDisable(GL_BLEND);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapBlend, false);
 	if( op_ != SGPBO_ADD )
-		glBlendEquation(GL_FUNC_ADD);
+		pState->setBlendEquation(GL_FUNC_ADD);
 }
 
 // AlphaBlendProperty
 void AlphaBlendProperty::Begin() const
 {
-	glBlendFunc( getGLBlend(src_), getGLBlend(dst_) );
+	getGLRenderState()->setBlendFunc( getGLBlend(src_), getGLBlend(dst_) );
 }
 
 void AlphaBlendProperty::End() const
 {
-	glBlendFunc(GL_ONE, GL_ZERO);
+	getGLRenderState()->setBlendFunc(GL_ONE, GL_ZERO);
 }
 
 
 // AlphaBlendFuncSeparateProperty
 void AlphaBlendFuncSeparateProperty::Begin() const
 {
-	glBlendFuncSeparate( getGLBlend(srcRGB_), getGLBlend(dstRGB_), getGLBlend(srcAlpha_), getGLBlend(dstAlpha_) );
+	getGLRenderState()->setBlendFuncSeparate( getGLBlend(srcRGB_), getGLBlend(dstRGB_), getGLBlend(srcAlpha_), getGLBlend(dstAlpha_) );
 }
 
 void AlphaBlendFuncSeparateProperty::End() const
 {
-	glBlendFuncSeparate(GL_ONE, GL_ZERO, GL_ONE, GL_ZERO);
+	getGLRenderState()->setBlendFuncSeparate(GL_ONE, GL_ZERO, GL_ONE, GL_ZERO);
 }
 
 
@@ -295,94 +305,98 @@ void StencilProperty::Begin() const
 	default:
 		break;
 	}
-	glEnable(GL_STENCIL_TEST);
-	glStencilFunc( func, ref_, mask_ );
-	glStencilOp( fail_, zfail_, pass_ );
-	glStencilMask( writemask_ );
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapStencilTest, true);
+	pState->setStencilFunc( func, ref_, mask_ );
+	pState->setStencilOp( fail_, zfail_, pass_ );
+	pState->setStencilWriteMask( writemask_ );
 }
 
 void StencilProperty::End() const
 {
-	glStencilFunc( GL_ALWAYS, 0, 0xFFFFFFFF );	
-	glStencilOp( GL_KEEP, GL_KEEP, GL_KEEP );
-	glStencilMask( 0xFFFFFFFF );
-	glDisable(GL_STENCIL_TEST);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->setStencilFunc( GL_ALWAYS, 0, 0xFFFFFFFF );	
+	pState->setStencilOp( GL_KEEP, GL_KEEP, GL_KEEP );
+	pState->setStencilWriteMask( 0xFFFFFFFF );
+	pState->enable(COpenGLRenderStateCache::eCapStencilTest, false);
 }
 
 // FillModeProperty
 void FillModeProperty::Begin() const
 {
-	glPolygonMode(GL_FRONT_AND_BACK, mode_);
+	getGLRenderState()->setPolygonMode(mode_);
 }
 
 void FillModeProperty::End() const
 {
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	getGLRenderState()->setPolygonMode(GL_FILL);
 }
 
 // CullingModeProperty
 void CullingModeProperty::Begin() const
 {
-	if( bculling_ )
-		glEnable(GL_CULL_FACE);
-	else
-		glDisable(GL_CULL_FACE);
-	glCullFace(mode_);
-	glFrontFace(frontface_);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapCullFace, bculling_);
+	pState->setCullFace(mode_);
+	pState->setFrontFace(frontface_);
 }
 
 void CullingModeProperty::End() const
 {
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_BACK);
-	glFrontFace(GL_CCW);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapCullFace, true);
+	pState->setCullFace(GL_BACK);
+	pState->setFrontFace(GL_CCW);
 }
 
 // ColorMaskProperty
 void ColorMaskProperty::Begin() const
 {
-	glColorMask(red_, green_, blue_, alpha_);
+	getGLRenderState()->setColorMask(red_, green_, blue_, alpha_);
 }
 
 void ColorMaskProperty::End() const
 {
-	glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
+	getGLRenderState()->setColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
 }
 
 // ThicknessProperty
 void ThicknessProperty::Begin() const
 {
 	COpenGLRenderDevice *RI = static_cast<COpenGLRenderDevice*>(m_pRenderDevice);
+	COpenGLRenderStateCache* pState = RI->getRenderStateCache();
 
 	if(COpenGLConfig::getInstance()->FullScreenAntiAlias)
 	{
 		// we don't use point smoothing
-		glPointSize(jlimit(RI->DimAliasedPoint[0], RI->DimAliasedPoint[1], size_));
-		glLineWidth(jlimit(RI->DimSmoothedLine[0], RI->DimSmoothedLine[1], size_));
+		pState->setPointSize(jlimit(RI->DimAliasedPoint[0], RI->DimAliasedPoint[1], size_));
+		pState->setLineWidth(jlimit(RI->DimSmoothedLine[0], RI->DimSmoothedLine[1], size_));
 	}
 	else
 	{
-		glPointSize(jlimit(RI->DimAliasedPoint[0], RI->DimAliasedPoint[1], size_));
-		glLineWidth(jlimit(RI->DimAliasedLine[0], RI->DimAliasedLine[1], size_));
+		pState->setPointSize(jlimit(RI->DimAliasedPoint[0], RI->DimAliasedPoint[1], size_));
+		pState->setLineWidth(jlimit(RI->DimAliasedLine[0], RI->DimAliasedLine[1], size_));
 	}
 }
 void ThicknessProperty::End() const
 {
-	glPointSize(1);
-	glLineWidth(1);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->setPointSize(1);
+	pState->setLineWidth(1);
 }
 
 // AntiAliasingProperty
 void AntiAliasingProperty::Begin() const
 {
+	COpenGLRenderStateCache* pState = getGLRenderState();
 	if(GLEE_ARB_multisample)
 	{
 		if( mode_ & SGPAAM_ALPHA_TO_COVERAGE )
-			glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
+			pState->enable(COpenGLRenderStateCache::eCapSampleAlphaToCoverage, true);
 
 		if( (COpenGLConfig::getInstance()->FullScreenAntiAlias >= 2) && (mode_ & (SGPAAM_SIMPLE|SGPAAM_QUALITY)) )
 		{
-			glEnable(GL_MULTISAMPLE_ARB);
+			pState->enable(COpenGLRenderStateCache::eCapMultisample, true);
 #ifdef GL_NV_multisample_filter_hint
 			if (GLEE_NV_multisample_filter_hint)
 			{
@@ -392,53 +406,58 @@ void AntiAliasingProperty::Begin() const
 #endif
 		}
 		else
-			glDisable(GL_MULTISAMPLE_ARB);
+			pState->enable(COpenGLRenderStateCache::eCapMultisample, false);
 	}
 	if( mode_ & SGPAAM_LINE_SMOOTH )
 	{
-		glEnable(GL_LINE_SMOOTH);
+		pState->enable(COpenGLRenderStateCache::eCapLineSmooth, true);
 	}
 	if( mode_ & SGPAAM_POINT_SMOOTH )
 	{
 		// often in software, and thus very slow
-		glEnable(GL_POINT_SMOOTH);
+		pState->enable(COpenGLRenderStateCache::eCapPointSmooth, true);
 	}
 }
 
 void AntiAliasingProperty::End() const
 {
+	COpenGLRenderStateCache* pState = getGLRenderState();
 	if( mode_ & SGPAAM_ALPHA_TO_COVERAGE )
-		glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE_ARB);
+		pState->enable(COpenGLRenderStateCache::eCapSampleAlphaToCoverage, false);
 	if( mode_ & SGPAAM_POINT_SMOOTH )
-		glDisable(GL_POINT_SMOOTH);
+		pState->enable(COpenGLRenderStateCache::eCapPointSmooth, false);
 	if( mode_ & SGPAAM_LINE_SMOOTH )
-		glDisable(GL_LINE_SMOOTH);
+		pState->enable(COpenGLRenderStateCache::eCapLineSmooth, false);
 	if( (COpenGLConfig::getInstance()->FullScreenAntiAlias >= 2) && (mode_ & (SGPAAM_SIMPLE|SGPAAM_QUALITY)) )
-		glDisable(GL_MULTISAMPLE_ARB);
+		pState->enable(COpenGLRenderStateCache::eCapMultisample, false);
 }
 
 //PolygonOffsetProperty
 void PolygonOffsetProperty::Begin() const
 {
-	glEnable(GL_POLYGON_OFFSET_FILL);
-	glPolygonOffset(factor_, units_);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapPolygonOffsetFill, true);
+	pState->setPolygonOffset(factor_, units_);
 }
 
 void PolygonOffsetProperty::End() const
 {
-	glDisable(GL_POLYGON_OFFSET_FILL);
-	glPolygonOffset(0, 0);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapPolygonOffsetFill, false);
+	pState->setPolygonOffset(0, 0);
 }
 
 //PolygonFillLineOffsetProperty
 void PolygonFillLineOffsetProperty::Begin() const
 {
-	glEnable(GL_POLYGON_OFFSET_LINE);
-	glPolygonOffset(factor_, units_);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapPolygonOffsetLine, true);
+	pState->setPolygonOffset(factor_, units_);
 }
 
 void PolygonFillLineOffsetProperty::End() const
 {
-	glDisable(GL_POLYGON_OFFSET_LINE);
-	glPolygonOffset(0, 0);
+	COpenGLRenderStateCache* pState = getGLRenderState();
+	pState->enable(COpenGLRenderStateCache::eCapPolygonOffsetLine, false);
+	pState->setPolygonOffset(0, 0);
 }
\ No newline at end of file
@@ -8,30 +8,28 @@ int COpenGLMaterialRenderer::m_SkinAnimRenderBatchPoolUsed = 0;
 
 
 COpenGLMaterialRenderer::COpenGLMaterialRenderer(COpenGLRenderDevice *pRenderDevice)
-	: m_pRenderDevice(pRenderDevice), m_FirstMaterial(0)
+	: m_pRenderDevice(pRenderDevice), m_FirstMaterial(0),
+	  m_RenderQueue(eListNumMax, INIT_LARGE_RENDERBATCH_ARRAY_NUM * 2),
+	  m_StaticInstanceVBID(0), m_StaticInstanceVBSize(INIT_LARGE_RENDERBATCH_ARRAY_NUM)
 {
 	materialStack_.ensureStorageAllocated(INIT_MATERIALINFO_ARRAY_NUM);
 
-	m_opaqueBatch.ensureStorageAllocated(INIT_LARGE_RENDERBATCH_ARRAY_NUM);
-	m_opaqueLightMapBatch.ensureStorageAllocated(INIT_LARGE_RENDERBATCH_ARRAY_NUM);
-	m_transparentBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_transparentLightMapBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_particlePSBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_particleLineBatch.ensureStorageAllocated(INIT_FEW_RENDERBATCH_ARRAY_NUM);
-	m_particleQuadBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_lineBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_skinanimBatch.ensureStorageAllocated(INIT_LARGE_RENDERBATCH_ARRAY_NUM);
-	m_skinanimAlphaBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-
-	m_alphaTestBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_alphaTestLightMapBatch.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
-	m_skinanimAlphaTestBatch.ensureStorageAllocated(INIT_LARGE_RENDERBATCH_ARRAY_NUM);
-
 	ReAllocRenderBatchPool();
+
+	m_StaticInstanceRuns.ensureStorageAllocated(INIT_SMALL_RENDERBATCH_ARRAY_NUM);
+	m_StaticInstanceArray.ensureStorageAllocated(INIT_LARGE_RENDERBATCH_ARRAY_NUM);
+	memset(m_StaticInstanceRunStart, 0, sizeof(m_StaticInstanceRunStart));
+
+	// Static mesh instance VertexBuffer
+	m_pRenderDevice->extGlGenBuffers(1, &m_StaticInstanceVBID);
+	m_pRenderDevice->extGlBindBuffer(GL_ARRAY_BUFFER, m_StaticInstanceVBID);
+	m_pRenderDevice->extGlBufferData(GL_ARRAY_BUFFER, m_StaticInstanceVBSize * sizeof(SGPVertex_STATIC_Instance), NULL, GL_STREAM_DRAW);
+	m_pRenderDevice->extGlBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 COpenGLMaterialRenderer::~COpenGLMaterialRenderer()
 {
+	m_pRenderDevice->extGlDeleteBuffers(1, &m_StaticInstanceVBID);
 }
 
 int	COpenGLMaterialRenderer::ComputeMaterialPass()
@@ -197,154 +195,149 @@ void COpenGLMaterialRenderer::RenderBatchDrawCall( ISGPRenderBatch::BatchType BT
 	switch( BTtype )
 	{
 	case ISGPRenderBatch::eBatchOpaque:
-		{
-			for( int i= 0; i<m_opaqueBatch.size(); i++ )
-			{
-				m_opaqueBatch[i]->PreRender();
-				m_opaqueBatch[i]->Render();
-				m_opaqueBatch[i]->PostRender();
-			}
-			for( int i= 0; i<m_alphaTestBatch.size(); i++ )
-			{
-				m_alphaTestBatch[i]->PreRender();
-				m_alphaTestBatch[i]->Render();
-				m_alphaTestBatch[i]->PostRender();
-			}
-			for( int i= 0; i<m_opaqueLightMapBatch.size(); i++ )
-			{
-				m_opaqueLightMapBatch[i]->PreRender();
-				m_opaqueLightMapBatch[i]->Render();
-				m_opaqueLightMapBatch[i]->PostRender();
-			}
-			for( int i= 0; i<m_alphaTestLightMapBatch.size(); i++ )
-			{
-				m_alphaTestLightMapBatch[i]->PreRender();
-				m_alphaTestLightMapBatch[i]->Render();
-				m_alphaTestLightMapBatch[i]->PostRender();
-			}
-		}
+		RenderListDrawCall(eListOpaque);
+		RenderListDrawCall(eListAlphaTest);
+		RenderListDrawCall(eListOpaqueLightMap);
+		RenderListDrawCall(eListAlphaTestLightMap);
 		break;
 	case ISGPRenderBatch::eBatchTransparent:
-		{
-			for( int i= 0; i<m_transparentBatch.size(); i++ )
-			{
-				m_transparentBatch[i]->PreRender();
-				m_transparentBatch[i]->Render();
-				m_transparentBatch[i]->PostRender();
-			}
-			for( int i= 0; i<m_transparentLightMapBatch.size(); i++ )
-			{
-				m_transparentLightMapBatch[i]->PreRender();
-				m_transparentLightMapBatch[i]->Render();
-				m_transparentLightMapBatch[i]->PostRender();
-			}
-		}
+		RenderListDrawCall(eListTransparent);
+		RenderListDrawCall(eListTransparentLightMap);
 		break;
 	case ISGPRenderBatch::eBatchParticlePointSprites:
-		{
-			for( int i= 0; i<m_particlePSBatch.size(); i++ )
-			{
-				m_particlePSBatch[i]->PreRender();
-				m_particlePSBatch[i]->Render();
-				m_particlePSBatch[i]->PostRender();
-			}
-		}
+		RenderListDrawCall(eListParticlePointSprites);
 		break;
 	case ISGPRenderBatch::eBatchParticleLine:
-		{
-			for( int i= 0; i<m_particleLineBatch.size(); i++ )
-			{
-				m_particleLineBatch[i]->PreRender();
-				m_particleLineBatch[i]->Render();
-				m_particleLineBatch[i]->PostRender();
-			}
-		}
+		RenderListDrawCall(eListParticleLine);
 		break;
 	case ISGPRenderBatch::eBatchParticleQuad:
-		{
-			for( int i= 0; i<m_particleQuadBatch.size(); i++ )
-			{
-				m_particleQuadBatch[i]->PreRender();
-				m_particleQuadBatch[i]->Render();
-				m_particleQuadBatch[i]->PostRender();
-			}
-		}
+		RenderListDrawCall(eListParticleQuad);
 		break;
 	case ISGPRenderBatch::eBatchSkinAnim:
-		{
-			ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
-			for( int i= 0; i<m_skinanimBatch.size(); i++ )
-			{
-				m_skinanimBatch[i]->PreRender();
-				m_skinanimBatch[i]->Render();
-				m_skinanimBatch[i]->PostRender();
-			}
-			for( int i= 0; i<m_skinanimAlphaTestBatch.size(); i++ )
-			{
-				m_skinanimAlphaTestBatch[i]->PreRender();
-				m_skinanimAlphaTestBatch[i]->Render();
-				m_skinanimAlphaTestBatch[i]->PostRender();
-			}
-			ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
-		}
+		ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
+		RenderListDrawCall(eListSkinAnim);
+		RenderListDrawCall(eListSkinAnimAlphaTest);
+		ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
 		break;
 	case ISGPRenderBatch::eBatchSkinAnimAlpha:
-		{
-			ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
-			for( int i= 0; i<m_skinanimAlphaBatch.size(); i++ )
-			{
-				m_skinanimAlphaBatch[i]->PreRender();
-				m_skinanimAlphaBatch[i]->Render();
-				m_skinanimAlphaBatch[i]->PostRender();
-			}
-			ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
-		}
+		ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
+		RenderListDrawCall(eListSkinAnimAlpha);
+		ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
 		break;
 	case ISGPRenderBatch::eBatchLine:
-		{
-			for( int i= 0; i<m_lineBatch.size(); i++ )
-			{
-				m_lineBatch[i]->PreRender();
-				m_lineBatch[i]->Render();
-				m_lineBatch[i]->PostRender();
-			}
-		}
+		RenderListDrawCall(eListLine);
 		break;
 	default:
 		break;
 	}
 }
 
+void COpenGLMaterialRenderer::RenderListDrawCall( RenderList ListIndex )
+{
+	const int iEnd = m_RenderQueue.getListEnd(ListIndex);
+	int iRun = m_StaticInstanceRunStart[ListIndex];
+	const int iRunEnd = m_StaticInstanceRunStart[ListIndex+1];
+	for( int i = m_RenderQueue.getListStart(ListIndex); i < iEnd; i++ )
+	{
+		ISGPRenderBatch* pBatch = GetRenderBatchFromPool(ListIndex, m_RenderQueue.getPacket(i).BatchIndex);
+
+		if( (iRun < iRunEnd) && (m_StaticInstanceRuns.getReference(iRun).PacketStart == i) )
+		{
+			const StaticInstanceRun& Run = m_StaticInstanceRuns.getReference(iRun++);
+			pBatch->RenderInstanced(m_StaticInstanceVBID, Run.FirstInstance, Run.NumInstances);
+			i += Run.NumInstances - 1;
+			continue;
+		}
+
+		pBatch->PreRender();
+		pBatch->Render();
+		pBatch->PostRender();
+	}
+}
+
 void COpenGLMaterialRenderer::QueueRenderBatch()
 {
-	COpenGLMaterialRenderer::Sorter CompareRenderBatch;
-
-	if( m_opaqueBatch.size() > 1 )
-		m_opaqueBatch.sort(CompareRenderBatch);
-	if( m_opaqueLightMapBatch.size() > 1 )
-		m_opaqueLightMapBatch.sort(CompareRenderBatch);
-	if( m_transparentBatch.size() > 1 )
-		m_transparentBatch.sort(CompareRenderBatch);
-	if( m_transparentLightMapBatch.size() > 1 )
-		m_transparentLightMapBatch.sort(CompareRenderBatch);
-	if( m_particlePSBatch.size() > 1 )
-		m_particlePSBatch.sort(CompareRenderBatch);
-	if( m_particleLineBatch.size() > 1 )
-		m_particleLineBatch.sort(CompareRenderBatch);
-	if( m_particleQuadBatch.size() > 1 )
-		m_particleQuadBatch.sort(CompareRenderBatch);
-	if( m_skinanimBatch.size() > 1 )
-		m_skinanimBatch.sort(CompareRenderBatch);
-	if( m_skinanimAlphaBatch.size() > 1 )
-		m_skinanimAlphaBatch.sort(CompareRenderBatch);
-
-	if( m_alphaTestBatch.size() > 1 )
-		m_alphaTestBatch.sort(CompareRenderBatch);
-	if( m_alphaTestLightMapBatch.size() > 1 )
-		m_alphaTestLightMapBatch.sort(CompareRenderBatch);
-	if( m_skinanimAlphaTestBatch.size() > 1 )
-		m_skinanimAlphaTestBatch.sort(CompareRenderBatch);
+	m_RenderQueue.sort();
 
+	BuildStaticInstanceRuns();
+}
+
+void COpenGLMaterialRenderer::BuildStaticInstanceRuns()
+{
+	m_StaticInstanceRuns.clearQuick();
+	m_StaticInstanceArray.clearQuick();
+
+	for( int ListIndex = 0; ListIndex < eListNumMax; ListIndex++ )
+	{
+		m_StaticInstanceRunStart[ListIndex] = m_StaticInstanceRuns.size();
+
+		// Only opaque lists, transparent batches must keep back to front order
+		if( (ListIndex != eListOpaque) && (ListIndex != eListAlphaTest) &&
+			(ListIndex != eListOpaqueLightMap) && (ListIndex != eListAlphaTestLightMap) )
+			continue;
+
+		const int iEnd = m_RenderQueue.getListEnd(ListIndex);
+		int i = m_RenderQueue.getListStart(ListIndex);
+		while( i < iEnd )
+		{
+			ISGPRenderBatch* pFirstBatch = GetRenderBatchFromPool((RenderList)ListIndex, m_RenderQueue.getPacket(i).BatchIndex);
+
+			int iRunEnd = i + 1;
+			if( pFirstBatch->CanBeInstanced() )
+			{
+				while( (iRunEnd < iEnd) &&
+					pFirstBatch->CanBeInstancedWith( *GetRenderBatchFromPool((RenderList)ListIndex, m_RenderQueue.getPacket(iRunEnd).BatchIndex) ) )
+					iRunEnd++;
+			}
+
+			if( iRunEnd - i >= MIN_STATIC_INSTANCE_RUN )
+			{
+				StaticInstanceRun Run;
+				Run.PacketStart = i;
+				Run.FirstInstance = m_StaticInstanceArray.size();
+				Run.NumInstances = iRunEnd - i;
+				m_StaticInstanceRuns.add(Run);
+
+				for( int j = i; j < iRunEnd; j++ )
+				{
+					SGPVertex_STATIC_Instance InstanceData;
+					GetRenderBatchFromPool((RenderList)ListIndex, m_RenderQueue.getPacket(j).BatchIndex)->GetInstanceData(InstanceData);
+					m_StaticInstanceArray.add(InstanceData);
+				}
+			}
+			i = iRunEnd;
+		}
+	}
+	m_StaticInstanceRunStart[eListNumMax] = m_StaticInstanceRuns.size();
+
+	UploadStaticInstanceBuffer();
+}
+
+void COpenGLMaterialRenderer::UploadStaticInstanceBuffer()
+{
+	if( m_StaticInstanceArray.size() == 0 )
+		return;
+
+	m_pRenderDevice->extGlBindBuffer(GL_ARRAY_BUFFER, m_StaticInstanceVBID);
+
+	// Grow instance VB
+	if( m_StaticInstanceArray.size() > m_StaticInstanceVBSize )
+	{
+		while( m_StaticInstanceVBSize < m_StaticInstanceArray.size() )
+			m_StaticInstanceVBSize *= 2;
+		m_pRenderDevice->extGlBufferData(GL_ARRAY_BUFFER, m_StaticInstanceVBSize * sizeof(SGPVertex_STATIC_Instance), NULL, GL_STREAM_DRAW);
+	}
+
+	// update Dynamic Instance Buffer
+	uint32 nSizeData = sizeof(SGPVertex_STATIC_Instance) * m_StaticInstanceArray.size();
+	SGPVertex_STATIC_Instance* pData = (SGPVertex_STATIC_Instance*)m_pRenderDevice->extGlMapBufferRange(GL_ARRAY_BUFFER, 0, nSizeData, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if( pData )
+	{
+		memcpy(pData, m_StaticInstanceArray.getRawDataPointer(), nSizeData);
+		m_pRenderDevice->extGlUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+
+	m_pRenderDevice->extGlBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void COpenGLMaterialRenderer::BeforeDrawRenderBatch()
@@ -357,20 +350,9 @@ void COpenGLMaterialRenderer::BeforeDrawRenderBatch()
 	m_LineRenderBatchPoolUsed = 0;
 	m_SkinAnimRenderBatchPoolUsed = 0;
 
-	m_opaqueBatch.clearQuick();
-	m_opaqueLightMapBatch.clearQuick();
-	m_transparentBatch.clearQuick();
-	m_transparentLightMapBatch.clearQuick();
-	m_particlePSBatch.clearQuick();
-	m_particleLineBatch.clearQuick();
-	m_particleQuadBatch.clearQuick();
-	m_lineBatch.clearQuick();
-	m_skinanimBatch.clearQuick();
-	m_skinanimAlphaBatch.clearQuick();
-
-	m_alphaTestBatch.clearQuick();
-	m_alphaTestLightMapBatch.clearQuick();
-	m_skinanimAlphaTestBatch.clearQuick();
+	m_RenderQueue.clear();
+	m_StaticInstanceRuns.clearQuick();
+	memset(m_StaticInstanceRunStart, 0, sizeof(m_StaticInstanceRunStart));
 }
 
 void COpenGLMaterialRenderer::AfterDrawRenderBatch()
@@ -383,20 +365,9 @@ void COpenGLMaterialRenderer::AfterDrawRenderBatch()
 	m_LineRenderBatchPoolUsed = 0;
 	m_SkinAnimRenderBatchPoolUsed = 0;
 
-	m_opaqueBatch.clearQuick();
-	m_opaqueLightMapBatch.clearQuick();
-	m_transparentBatch.clearQuick();
-	m_transparentLightMapBatch.clearQuick();
-	m_particlePSBatch.clearQuick();
-	m_particleLineBatch.clearQuick();
-	m_particleQuadBatch.clearQuick();
-	m_lineBatch.clearQuick();
-	m_skinanimBatch.clearQuick();
-	m_skinanimAlphaBatch.clearQuick();
-
-	m_alphaTestBatch.clearQuick();
-	m_alphaTestLightMapBatch.clearQuick();
-	m_skinanimAlphaTestBatch.clearQuick();
+	m_RenderQueue.clear();
+	m_StaticInstanceRuns.clearQuick();
+	memset(m_StaticInstanceRunStart, 0, sizeof(m_StaticInstanceRunStart));
 }
 
 void COpenGLMaterialRenderer::DoDrawRenderBatch_Opaque()
@@ -404,7 +375,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_Opaque()
 	ISGPMaterialSystem::MaterialList &Mat_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetMaterialList();
 
 	// Normal opaqe RenderBatch
-	if( (m_opaqueBatch.size() > 0) || (m_opaqueLightMapBatch.size() > 0) )
+	if( (m_RenderQueue.getListSize(eListOpaque) > 0) || (m_RenderQueue.getListSize(eListOpaqueLightMap) > 0) )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &OpaqueMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_opaque_base);
 		PushMaterial( OpaqueMaterial_info.m_material, MM_Add );
@@ -418,7 +389,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_Transparent()
 	ISGPMaterialSystem::MaterialList &Mat_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetMaterialList();
 
 	// Normal transparent RenderBatch
-	if( (m_transparentBatch.size() > 0) || (m_transparentLightMapBatch.size() > 0) )
+	if( (m_RenderQueue.getListSize(eListTransparent) > 0) || (m_RenderQueue.getListSize(eListTransparentLightMap) > 0) )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &TransparentMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_transparent);
 		PushMaterial( TransparentMaterial_info.m_material, MM_Add );
@@ -433,7 +404,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_DebugLine()
 	//ISGPMaterialSystem::MaterialList &Mod_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetModifierList();
 
 	// Debug 3D line RenderBatch with depth bias
-	if( m_lineBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListLine) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &LineMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_line);
 		//const ISGPMaterialSystem::SGPMaterialInfo &ZBiasModifier_info = Mod_List.getReference(ISGPMaterialSystem::eModifier_depthbias);
@@ -452,7 +423,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_NoDepthline()
 	ISGPMaterialSystem::MaterialList &Mod_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetModifierList();
 
 	// Debug 3D line RenderBatch without depth test and write
-	if( m_lineBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListLine) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &LineMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_line);
 		const ISGPMaterialSystem::SGPMaterialInfo &NoDepthModifier_info = Mod_List.getReference(ISGPMaterialSystem::eModifier_nodepth);
@@ -470,7 +441,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_Particle()
 	ISGPMaterialSystem::MaterialList &Mat_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetMaterialList();
 
 	// particle point sprites RenderBatch
-	if( m_particlePSBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListParticlePointSprites) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &ParticleMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_particleaddalpha);
 		PushMaterial( ParticleMaterial_info.m_material, MM_Add );
@@ -479,7 +450,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_Particle()
 	}
 
 	// particle Line RenderBatch
-	if( m_particleLineBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListParticleLine) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &ParticleMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_particleaddalpha_line);
 		PushMaterial( ParticleMaterial_info.m_material, MM_Add );
@@ -488,7 +459,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_Particle()
 	}
 
 	// particle Quad RenderBatch
-	if( m_particleQuadBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListParticleQuad) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &ParticleMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_particleaddalpha);
 		PushMaterial( ParticleMaterial_info.m_material, MM_Add );
@@ -502,7 +473,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_SkinAnim()
 	ISGPMaterialSystem::MaterialList &Mat_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetMaterialList();
 
 	// Skin Anim RenderBatch
-	if( m_skinanimBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListSkinAnim) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &SkinAnimMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_opaque_base);
 		PushMaterial( SkinAnimMaterial_info.m_material, MM_Add );
@@ -516,7 +487,7 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_SkinAnimAlpha()
 	ISGPMaterialSystem::MaterialList &Mat_List = GetOpenGLRenderDevice()->GetMaterialSystem()->GetMaterialList();
 
 	// Skin Anim AVMesh RenderBatch
-	if( m_skinanimAlphaBatch.size() > 0 )
+	if( m_RenderQueue.getListSize(eListSkinAnimAlpha) > 0 )
 	{
 		const ISGPMaterialSystem::SGPMaterialInfo &SkinAnimAlphaMaterial_info = Mat_List.getReference(ISGPMaterialSystem::eMaterial_transparent);
 		PushMaterial( SkinAnimAlphaMaterial_info.m_material, MM_Add );
@@ -527,7 +498,8 @@ void COpenGLMaterialRenderer::DoDrawRenderBatch_SkinAnimAlpha()
 
 void COpenGLMaterialRenderer::PushOpaqueRenderBatch(const COpaqueRenderBatch& batch)
 {
-	COpaqueRenderBatch* pNewBatch = (COpaqueRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchOpaque);
+	uint32 BatchIndex = 0;
+	COpaqueRenderBatch* pNewBatch = (COpaqueRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchOpaque, BatchIndex);
 	
 	if( pNewBatch )
 	{
@@ -537,22 +509,26 @@ void COpenGLMaterialRenderer::PushOpaqueRenderBatch(const COpaqueRenderBatch& ba
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
+		pNewBatch->stQueueValue = batch.stQueueValue;
 
+		RenderList ListIndex;
 		if( pNewBatch->m_pSB && pNewBatch->m_pSB->MaterialSkin.bLightMap )
 		{
 			if( pNewBatch->m_pSB->MaterialSkin.bAlphaTest )
-				m_alphaTestLightMapBatch.add(pNewBatch);
+				ListIndex = eListAlphaTestLightMap;
 			else
-				m_opaqueLightMapBatch.add(pNewBatch);
+				ListIndex = eListOpaqueLightMap;
 		}
 		else
 		{
 			if( (pNewBatch->m_pSB && pNewBatch->m_pSB->MaterialSkin.bAlphaTest) ||
 				(pNewBatch->m_pVC && pNewBatch->m_pVC->m_MaterialSkin.bAlphaTest) )
-				m_alphaTestBatch.add(pNewBatch);
+				ListIndex = eListAlphaTest;
 			else
-				m_opaqueBatch.add(pNewBatch);
+				ListIndex = eListOpaque;
 		}
+
+		m_RenderQueue.add(ListIndex, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
@@ -560,7 +536,8 @@ void COpenGLMaterialRenderer::PushOpaqueRenderBatch(const COpaqueRenderBatch& ba
 
 void COpenGLMaterialRenderer::PushTransparentRenderBatch(const CTransparentRenderBatch& batch)
 {
-	CTransparentRenderBatch *pNewBatch = (CTransparentRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchTransparent);
+	uint32 BatchIndex = 0;
+	CTransparentRenderBatch *pNewBatch = (CTransparentRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchTransparent, BatchIndex);
 
 	if( pNewBatch )
 	{
@@ -570,17 +547,22 @@ void COpenGLMaterialRenderer::PushTransparentRenderBatch(const CTransparentRende
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
+		pNewBatch->stQueueValue = batch.stQueueValue;
 
+		RenderList ListIndex;
 		if( pNewBatch->m_pSB && pNewBatch->m_pSB->MaterialSkin.bLightMap )
-			m_transparentLightMapBatch.add(pNewBatch);
+			ListIndex = eListTransparentLightMap;
 		else
-			m_transparentBatch.add(pNewBatch);
+			ListIndex = eListTransparent;
+
+		m_RenderQueue.add(ListIndex, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
 void COpenGLMaterialRenderer::PushLineRenderBatch(const CLineRenderBatch& batch)
 {
-	CLineRenderBatch* pNewBatch = (CLineRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchLine);	
+	uint32 BatchIndex = 0;
+	CLineRenderBatch* pNewBatch = (CLineRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchLine, BatchIndex);
 	if( pNewBatch )
 	{
 		pNewBatch->m_BatchType = batch.m_BatchType;
@@ -589,14 +571,16 @@ void COpenGLMaterialRenderer::PushLineRenderBatch(const CLineRenderBatch& batch)
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
+		pNewBatch->stQueueValue = batch.stQueueValue;
 
-		m_lineBatch.add(pNewBatch);
+		m_RenderQueue.add(eListLine, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
 void COpenGLMaterialRenderer::PushParticlePSRenderBatch(const CParticlePSRenderBatch& batch)
 {
-	CParticlePSRenderBatch* pNewBatch = (CParticlePSRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchParticlePointSprites);	
+	uint32 BatchIndex = 0;
+	CParticlePSRenderBatch* pNewBatch = (CParticlePSRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchParticlePointSprites, BatchIndex);
 	if( pNewBatch )
 	{
 		pNewBatch->m_BatchType = batch.m_BatchType;
@@ -605,15 +589,17 @@ void COpenGLMaterialRenderer::PushParticlePSRenderBatch(const CParticlePSRenderB
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
+		pNewBatch->stQueueValue = batch.stQueueValue;
 		pNewBatch->m_pParticleBuffer = batch.m_pParticleBuffer;
 
-		m_particlePSBatch.add(pNewBatch);
+		m_RenderQueue.add(eListParticlePointSprites, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
 void COpenGLMaterialRenderer::PushParticleLineRenderBatch(const CParticleLineRenderBatch& batch)
 {
-	CParticleLineRenderBatch* pNewBatch = (CParticleLineRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchParticleLine);	
+	uint32 BatchIndex = 0;
+	CParticleLineRenderBatch* pNewBatch = (CParticleLineRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchParticleLine, BatchIndex);
 	if( pNewBatch )
 	{
 		pNewBatch->m_BatchType = batch.m_BatchType;
@@ -622,15 +608,17 @@ void COpenGLMaterialRenderer::PushParticleLineRenderBatch(const CParticleLineRen
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
+		pNewBatch->stQueueValue = batch.stQueueValue;
 		pNewBatch->m_pParticleBuffer = batch.m_pParticleBuffer;
 
-		m_particleLineBatch.add(pNewBatch);
+		m_RenderQueue.add(eListParticleLine, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
 void COpenGLMaterialRenderer::PushParticleQuadRenderBatch(const CParticleQuadRenderBatch& batch)
 {
-	CParticleQuadRenderBatch* pNewBatch = (CParticleQuadRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchParticleQuad);	
+	uint32 BatchIndex = 0;
+	CParticleQuadRenderBatch* pNewBatch = (CParticleQuadRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchParticleQuad, BatchIndex);
 	if( pNewBatch )
 	{
 		pNewBatch->m_BatchType = batch.m_BatchType;
@@ -639,17 +627,19 @@ void COpenGLMaterialRenderer::PushParticleQuadRenderBatch(const CParticleQuadRen
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
+		pNewBatch->stQueueValue = batch.stQueueValue;
 		pNewBatch->m_pParticleBuffer = batch.m_pParticleBuffer;
 		pNewBatch->m_TextureAtlas = batch.m_TextureAtlas;
 
-		m_particleQuadBatch.add(pNewBatch);
+		m_RenderQueue.add(eListParticleQuad, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
 
 void COpenGLMaterialRenderer::PushSkinAnimRenderBatch(const CSkinAnimRenderBatch& batch)
 {
-	CSkinAnimRenderBatch* pNewBatch = (CSkinAnimRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchSkinAnim);	
+	uint32 BatchIndex = 0;
+	CSkinAnimRenderBatch* pNewBatch = (CSkinAnimRenderBatch*)GetOneFreeRenderBatchFromPool(ISGPRenderBatch::eBatchSkinAnim, BatchIndex);
 	if( pNewBatch )
 	{
 		pNewBatch->m_BatchType = batch.m_BatchType;
@@ -658,110 +648,71 @@ void COpenGLMaterialRenderer::PushSkinAnimRenderBatch(const CSkinAnimRenderBatch
 		pNewBatch->m_BatchConfig = batch.m_BatchConfig;
 		pNewBatch->m_pSB = batch.m_pSB;
 		pNewBatch->m_pVC = batch.m_pVC;
-		pNewBatch->m_TBOID = batch.m_TBOID;
+		pNewBatch->stQueueValue = batch.stQueueValue;
+		pNewBatch->m_BoneOffset = batch.m_BoneOffset;
 
+		RenderList ListIndex;
 		if( pNewBatch->m_pSB && pNewBatch->m_pSB->MaterialSkin.bAlphaTest )
-			m_skinanimAlphaTestBatch.add(pNewBatch);
+			ListIndex = eListSkinAnimAlphaTest;
 		else if( pNewBatch->m_pVC && pNewBatch->m_pVC->m_MaterialSkin.bAlphaTest )
-			m_skinanimAlphaTestBatch.add(pNewBatch);
+			ListIndex = eListSkinAnimAlphaTest;
 		else if( pNewBatch->m_pSB && (pNewBatch->m_pSB->MaterialSkin.bAlpha || (pNewBatch->m_BatchConfig.m_fBatchAlpha < 1.0f)) )
-			m_skinanimAlphaBatch.add(pNewBatch);
+			ListIndex = eListSkinAnimAlpha;
 		else if( pNewBatch->m_pVC && (pNewBatch->m_pVC->m_MaterialSkin.bAlpha || (pNewBatch->m_BatchConfig.m_fBatchAlpha < 1.0f)) )
-			m_skinanimAlphaBatch.add(pNewBatch);
+			ListIndex = eListSkinAnimAlpha;
 		else
-			m_skinanimBatch.add(pNewBatch);
+			ListIndex = eListSkinAnim;
+
+		m_RenderQueue.add(ListIndex, pNewBatch->stQueueValue.ulQueueValue, BatchIndex);
 	}
 }
 
-ISGPRenderBatch* COpenGLMaterialRenderer::GetOneFreeRenderBatchFromPool(ISGPRenderBatch::BatchType BTtype)
+ISGPRenderBatch* COpenGLMaterialRenderer::GetOneFreeRenderBatchFromPool(ISGPRenderBatch::BatchType BTtype, uint32& BatchIndex)
 {
 	ISGPRenderBatch* pBatch = NULL;
 	switch(BTtype)
 	{
 	case ISGPRenderBatch::eBatchOpaque:
-		if( m_OpaqueRenderBatchPoolUsed + 1 >= m_OpaqueRenderBatchPool.size() )
-		{
+		if( m_OpaqueRenderBatchPoolUsed >= m_OpaqueRenderBatchPool.size() )
 			m_OpaqueRenderBatchPool.add( new COpaqueRenderBatch(m_pRenderDevice) );
-			pBatch = m_OpaqueRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_OpaqueRenderBatchPool.getUnchecked(m_OpaqueRenderBatchPoolUsed);
-		}	
-		m_OpaqueRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_OpaqueRenderBatchPoolUsed++;
+		pBatch = m_OpaqueRenderBatchPool.getUnchecked(BatchIndex);
 		break;
 	case ISGPRenderBatch::eBatchTransparent:
-		if( m_TransparentRenderBatchPoolUsed + 1 >= m_TransparentRenderBatchPool.size() )
-		{
+		if( m_TransparentRenderBatchPoolUsed >= m_TransparentRenderBatchPool.size() )
 			m_TransparentRenderBatchPool.add( new CTransparentRenderBatch(m_pRenderDevice) );
-			pBatch = m_TransparentRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_TransparentRenderBatchPool.getUnchecked(m_TransparentRenderBatchPoolUsed);
-		}
-		m_TransparentRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_TransparentRenderBatchPoolUsed++;
+		pBatch = m_TransparentRenderBatchPool.getUnchecked(BatchIndex);
 		break;
 	case ISGPRenderBatch::eBatchParticlePointSprites:
-		if( m_ParticlePSRenderBatchPoolUsed + 1 >= m_ParticlePSRenderBatchPool.size() )
-		{
+		if( m_ParticlePSRenderBatchPoolUsed >= m_ParticlePSRenderBatchPool.size() )
 			m_ParticlePSRenderBatchPool.add( new CParticlePSRenderBatch(m_pRenderDevice) );
-			pBatch = m_ParticlePSRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_ParticlePSRenderBatchPool.getUnchecked(m_ParticlePSRenderBatchPoolUsed);
-		}
-		m_ParticlePSRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_ParticlePSRenderBatchPoolUsed++;
+		pBatch = m_ParticlePSRenderBatchPool.getUnchecked(BatchIndex);
 		break;
 	case ISGPRenderBatch::eBatchParticleLine:
-		if( m_ParticleLineRenderBatchPoolUsed + 1 >= m_ParticleLineRenderBatchPool.size() )
-		{
+		if( m_ParticleLineRenderBatchPoolUsed >= m_ParticleLineRenderBatchPool.size() )
 			m_ParticleLineRenderBatchPool.add( new CParticleLineRenderBatch(m_pRenderDevice) );
-			pBatch = m_ParticleLineRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_ParticleLineRenderBatchPool.getUnchecked(m_ParticleLineRenderBatchPoolUsed);
-		}
-		m_ParticleLineRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_ParticleLineRenderBatchPoolUsed++;
+		pBatch = m_ParticleLineRenderBatchPool.getUnchecked(BatchIndex);
 		break;
 	case ISGPRenderBatch::eBatchParticleQuad:
-		if( m_ParticleQuadRenderBatchPoolUsed + 1 >= m_ParticleQuadRenderBatchPool.size() )
-		{
+		if( m_ParticleQuadRenderBatchPoolUsed >= m_ParticleQuadRenderBatchPool.size() )
 			m_ParticleQuadRenderBatchPool.add( new CParticleQuadRenderBatch(m_pRenderDevice) );
-			pBatch = m_ParticleQuadRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_ParticleQuadRenderBatchPool.getUnchecked(m_ParticleQuadRenderBatchPoolUsed);
-		}
-		m_ParticleQuadRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_ParticleQuadRenderBatchPoolUsed++;
+		pBatch = m_ParticleQuadRenderBatchPool.getUnchecked(BatchIndex);
 		break;
 	case ISGPRenderBatch::eBatchSkinAnim:
-		if( m_SkinAnimRenderBatchPoolUsed + 1 >= m_SkinAnimRenderBatchPool.size() )
-		{
+		if( m_SkinAnimRenderBatchPoolUsed >= m_SkinAnimRenderBatchPool.size() )
 			m_SkinAnimRenderBatchPool.add( new CSkinAnimRenderBatch(m_pRenderDevice) );
-			pBatch = m_SkinAnimRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_SkinAnimRenderBatchPool.getUnchecked(m_SkinAnimRenderBatchPoolUsed);
-		}
-		m_SkinAnimRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_SkinAnimRenderBatchPoolUsed++;
+		pBatch = m_SkinAnimRenderBatchPool.getUnchecked(BatchIndex);
 		break;
-
 	case ISGPRenderBatch::eBatchLine:
-		if( m_LineRenderBatchPoolUsed + 1 >= m_LineRenderBatchPool.size() )
-		{
+		if( m_LineRenderBatchPoolUsed >= m_LineRenderBatchPool.size() )
 			m_LineRenderBatchPool.add( new CLineRenderBatch(m_pRenderDevice) );
-			pBatch = m_LineRenderBatchPool.getLast();
-		}
-		else
-		{
-			pBatch = m_LineRenderBatchPool.getUnchecked(m_LineRenderBatchPoolUsed);
-		}
-		m_LineRenderBatchPoolUsed++;
+		BatchIndex = (uint32)m_LineRenderBatchPoolUsed++;
+		pBatch = m_LineRenderBatchPool.getUnchecked(BatchIndex);
 		break;
 	default:
 		break;
@@ -769,6 +720,36 @@ ISGPRenderBatch* COpenGLMaterialRenderer::GetOneFreeRenderBatchFromPool(ISGPRend
 	return pBatch;
 }
 
+ISGPRenderBatch* COpenGLMaterialRenderer::GetRenderBatchFromPool(RenderList ListIndex, uint32 BatchIndex)
+{
+	switch(ListIndex)
+	{
+	case eListOpaque:
+	case eListAlphaTest:
+	case eListOpaqueLightMap:
+	case eListAlphaTestLightMap:
+		return m_OpaqueRenderBatchPool.getUnchecked(BatchIndex);
+	case eListTransparent:
+	case eListTransparentLightMap:
+		return m_TransparentRenderBatchPool.getUnchecked(BatchIndex);
+	case eListParticlePointSprites:
+		return m_ParticlePSRenderBatchPool.getUnchecked(BatchIndex);
+	case eListParticleLine:
+		return m_ParticleLineRenderBatchPool.getUnchecked(BatchIndex);
+	case eListParticleQuad:
+		return m_ParticleQuadRenderBatchPool.getUnchecked(BatchIndex);
+	case eListSkinAnim:
+	case eListSkinAnimAlphaTest:
+	case eListSkinAnimAlpha:
+		return m_SkinAnimRenderBatchPool.getUnchecked(BatchIndex);
+	case eListLine:
+		return m_LineRenderBatchPool.getUnchecked(BatchIndex);
+	default:
+		break;
+	}
+	return NULL;
+}
+
 void COpenGLMaterialRenderer::ReAllocRenderBatchPool()
 {
 	for( int i=0; i<INIT_LARGE_RENDERBATCH_ARRAY_NUM; i++ )
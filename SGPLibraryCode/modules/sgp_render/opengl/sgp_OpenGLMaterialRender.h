@@ -48,30 +48,35 @@ public :
 
 	//void		CommitAdditionalMaterial(const struct ISGPMaterialSystem::SGPMaterialInfo& MT, const struct SGPSkin& Skin );
 
-public:
-	OpaqueRenderBatchVector				m_opaqueBatch;
-	OpaqueRenderBatchVector				m_opaqueLightMapBatch;
-	TransparentRenderBatchVector		m_transparentBatch;
-	TransparentRenderBatchVector		m_transparentLightMapBatch;
-	ParticlePSRenderBatchVector			m_particlePSBatch;
-	ParticleLineRenderBatchVector		m_particleLineBatch;
-	ParticleQuadRenderBatchVector		m_particleQuadBatch;
-	LineRenderBatchVector				m_lineBatch;
-	SkinAnimRenderBatchVector			m_skinanimBatch;
-	SkinAnimRenderBatchVector			m_skinanimAlphaBatch;
-
-	OpaqueRenderBatchVector				m_alphaTestBatch;
-	OpaqueRenderBatchVector				m_alphaTestLightMapBatch;
-	SkinAnimRenderBatchVector			m_skinanimAlphaTestBatch;
-
 private:
 	static const int INIT_MATERIALINFO_ARRAY_NUM = 64;
 	static const int INIT_FEW_RENDERBATCH_ARRAY_NUM = 4;
 	static const int INIT_SMALL_RENDERBATCH_ARRAY_NUM = 256;
 	static const int INIT_LARGE_RENDERBATCH_ARRAY_NUM = 1024;
 
+	// Render lists in render queue, lists of the same batch type are drawn in this order
+	enum RenderList
+	{
+		eListOpaque = 0,
+		eListAlphaTest,
+		eListOpaqueLightMap,
+		eListAlphaTestLightMap,
+		eListTransparent,
+		eListTransparentLightMap,
+		eListParticlePointSprites,
+		eListParticleLine,
+		eListParticleQuad,
+		eListSkinAnim,
+		eListSkinAnimAlphaTest,
+		eListSkinAnimAlpha,
+		eListLine,
+
+		eListNumMax,
+	};
+
 	// ReAlloc RenderBatch Resource
-	ISGPRenderBatch* GetOneFreeRenderBatchFromPool(ISGPRenderBatch::BatchType BTtype);
+	ISGPRenderBatch* GetOneFreeRenderBatchFromPool(ISGPRenderBatch::BatchType BTtype, uint32& BatchIndex);
+	ISGPRenderBatch* GetRenderBatchFromPool(RenderList ListIndex, uint32 BatchIndex);
 	void ReAllocRenderBatchPool();
 
 	// materials & drawing
@@ -81,18 +86,13 @@ private:
 	void FastDraw( ISGPRenderBatch::BatchType BTtype );
 	void SlowDraw( ISGPRenderBatch::BatchType BTtype );
 	void RenderBatchDrawCall( ISGPRenderBatch::BatchType BTtype );
+	void RenderListDrawCall( RenderList ListIndex );
 
-	struct Sorter
-    {
-		static int compareElements( ISGPRenderBatch* first, ISGPRenderBatch* second ) noexcept
-		{
-			if( first->GetQueueValue() < second->GetQueueValue() )
-				return -1;
-			if( first->GetQueueValue() > second->GetQueueValue() )
-				return 1;
-			return 0;
-		}
-	};
+	// Static mesh geometry instancing
+	// After sorting, neighbour opaque batches of the same static buffer and textures are one run,
+	// their instance data is written to one instance buffer per frame and drawn with one draw call
+	void BuildStaticInstanceRuns();
+	void UploadStaticInstanceBuffer();
 
 	// private types
 	struct MaterialInfo
@@ -110,6 +110,22 @@ private:
 	COpenGLRenderDevice*			m_pRenderDevice;
 	int								m_FirstMaterial;
 
+	CSGPRenderQueue					m_RenderQueue;		// Draw packets of all render batches in this frame
+
+	struct StaticInstanceRun
+	{
+		int		PacketStart;		// first packet of the run in render queue
+		int		FirstInstance;		// instance data of first batch in instance buffer
+		int		NumInstances;
+	};
+	static const int MIN_STATIC_INSTANCE_RUN = 2;
+
+	Array<StaticInstanceRun>			m_StaticInstanceRuns;
+	int									m_StaticInstanceRunStart[eListNumMax+1];	// first run of each render list
+	Array<SGPVertex_STATIC_Instance>	m_StaticInstanceArray;
+	GLuint								m_StaticInstanceVBID;		// Dynamic instance VB
+	int									m_StaticInstanceVBSize;		// instance number the VB can hold
+
 	OwnedArrayOpaqueRenderBatch				m_OpaqueRenderBatchPool;
 	OwnedArrayTransparentRenderBatch		m_TransparentRenderBatchPool;
 	OwnedArrayParticlePSRenderBatch			m_ParticlePSRenderBatchPool;
@@ -1,3 +1,5 @@
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
+
 int32 ISGPRenderBatch::m_ShaderProgramIdx = -1;
 bool ISGPRenderBatch::m_SkinAnimShaderLightmapTexSetted = false;
 
@@ -75,43 +77,14 @@ void ISGPRenderBatch::Render()
 		{
 			Vector4D TextureAtlas((float)m_pSB->MaterialSkin.vUVTile[0], (float)m_pSB->MaterialSkin.vUVTile[1], 1.0f/m_pSB->MaterialSkin.vUVTile[0], 1.0f/m_pSB->MaterialSkin.vUVTile[1]);
 			pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("TextureAtlas", TextureAtlas);
-
-			uint32 nTileFrameID = m_pSB->MaterialSkin.vUVTile[2] + uint32( m_BatchConfig.m_fTimePassedFromCreated / (m_pSB->MaterialSkin.vUVTile[4] * 0.001f) );
-			uint32 nUVTileNum = m_pSB->MaterialSkin.vUVTile[0] * m_pSB->MaterialSkin.vUVTile[1];
-			switch( m_pSB->MaterialSkin.vUVTile[3] )	
-			{
-			case 0:		// Loop
-				nTileFrameID %= nUVTileNum;
-				break;
-			case 1:		// Ping Pong
-				nTileFrameID %= (nUVTileNum * 2);
-				nTileFrameID = (nTileFrameID < nUVTileNum) ? nTileFrameID : (2*nUVTileNum-nTileFrameID-1);
-				break;
-			case 2:		// Hold
-				if( nTileFrameID >= nUVTileNum )
-					nTileFrameID = nUVTileNum - 1;
-				break;
-			default:	// Loop
-				nTileFrameID %= nUVTileNum;
-				break;
-			}
-
-			Vector2D UVOffset = m_pSB->MaterialSkin.getMatKeyFrameUVOffset(m_BatchConfig.m_fTimePassedFromCreated);
-			Vector3D TexIndexUVOffset(
-				(float)nTileFrameID, 
-				UVOffset.x + m_pSB->MaterialSkin.vUVSpeed[0] * m_BatchConfig.m_fTimePassedFromCreated,
-				UVOffset.y + m_pSB->MaterialSkin.vUVSpeed[1] * m_BatchConfig.m_fTimePassedFromCreated);
-			
-			pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("TexIndexUVOffset", TexIndexUVOffset);
+			pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("TexIndexUVOffset", GetTexIndexUVOffset());
 		}
 
 		default:
 			break;
 		}
 
-		Vector4D DiffColor = m_pSB->MaterialSkin.getMatKeyFrameColor(m_BatchConfig.m_fTimePassedFromCreated);
-		DiffColor.w = m_BatchConfig.m_fBatchAlpha;
-		pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("vMaterialColor", DiffColor);
+		pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("vMaterialColor", GetMaterialColor());
 
 
 		m_pSB->pVBO->bindVAO();
@@ -196,6 +169,141 @@ void ISGPRenderBatch::Render()
 	}
 }
 
+Vector3D ISGPRenderBatch::GetTexIndexUVOffset() const
+{
+	jassert( m_pSB );
+
+	uint32 nTileFrameID = m_pSB->MaterialSkin.vUVTile[2] + uint32( m_BatchConfig.m_fTimePassedFromCreated / (m_pSB->MaterialSkin.vUVTile[4] * 0.001f) );
+	uint32 nUVTileNum = m_pSB->MaterialSkin.vUVTile[0] * m_pSB->MaterialSkin.vUVTile[1];
+	switch( m_pSB->MaterialSkin.vUVTile[3] )	
+	{
+	case 0:		// Loop
+		nTileFrameID %= nUVTileNum;
+		break;
+	case 1:		// Ping Pong
+		nTileFrameID %= (nUVTileNum * 2);
+		nTileFrameID = (nTileFrameID < nUVTileNum) ? nTileFrameID : (2*nUVTileNum-nTileFrameID-1);
+		break;
+	case 2:		// Hold
+		if( nTileFrameID >= nUVTileNum )
+			nTileFrameID = nUVTileNum - 1;
+		break;
+	default:	// Loop
+		nTileFrameID %= nUVTileNum;
+		break;
+	}
+
+	Vector2D UVOffset = m_pSB->MaterialSkin.getMatKeyFrameUVOffset(m_BatchConfig.m_fTimePassedFromCreated);
+	return Vector3D(
+		(float)nTileFrameID, 
+		UVOffset.x + m_pSB->MaterialSkin.vUVSpeed[0] * m_BatchConfig.m_fTimePassedFromCreated,
+		UVOffset.y + m_pSB->MaterialSkin.vUVSpeed[1] * m_BatchConfig.m_fTimePassedFromCreated);
+}
+
+Vector4D ISGPRenderBatch::GetMaterialColor() const
+{
+	jassert( m_pSB );
+
+	Vector4D DiffColor = m_pSB->MaterialSkin.getMatKeyFrameColor(m_BatchConfig.m_fTimePassedFromCreated);
+	DiffColor.w = m_BatchConfig.m_fBatchAlpha;
+	return DiffColor;
+}
+
+bool ISGPRenderBatch::CanBeInstanced() const
+{
+	return m_pSB && (getInstancingShaderType(m_pSB->MaterialSkin.nShaderType) != SGPST_SHADER_NUM);
+}
+
+bool ISGPRenderBatch::CanBeInstancedWith(const ISGPRenderBatch& other) const
+{
+	// Same mesh, same textures. Every lightmapped instance has its own lightmap texture
+	// (no lightmap atlas), so only instances sharing the lightmap are drawn together.
+	return (other.m_pSB == m_pSB) &&
+		(other.m_BatchConfig.m_nReplacedTextureID == m_BatchConfig.m_nReplacedTextureID) &&
+		( !m_pSB->MaterialSkin.bLightMap || (other.m_BatchConfig.m_nLightMapTextureID == m_BatchConfig.m_nLightMapTextureID) );
+}
+
+void ISGPRenderBatch::GetInstanceData(SGPVertex_STATIC_Instance& InstanceData) const
+{
+	memcpy( InstanceData.vMatWorld, &m_MatWorld._11, sizeof(float)*16 );
+
+	Vector4D DiffColor = GetMaterialColor();
+	InstanceData.vMaterialColor[0] = DiffColor.x;
+	InstanceData.vMaterialColor[1] = DiffColor.y;
+	InstanceData.vMaterialColor[2] = DiffColor.z;
+	InstanceData.vMaterialColor[3] = DiffColor.w;
+
+	Vector3D TexIndexUVOffset = GetTexIndexUVOffset();
+	InstanceData.vTexIndexUVOffset[0] = TexIndexUVOffset.x;
+	InstanceData.vTexIndexUVOffset[1] = TexIndexUVOffset.y;
+	InstanceData.vTexIndexUVOffset[2] = TexIndexUVOffset.z;
+	InstanceData.vTexIndexUVOffset[3] = 0;
+}
+
+void ISGPRenderBatch::RenderInstanced(GLuint InstanceVBID, uint32 FirstInstance, uint32 NumInstances)
+{
+	COpenGLShaderManager *pShaderManager = static_cast<COpenGLShaderManager*>(m_RenderDevice->GetShaderManager());
+
+	const int ShaderProgramIdx = getInstancingShaderType(m_pSB->MaterialSkin.nShaderType);
+	COpenGLSLShaderProgram* pProgram = pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx);
+	if( m_ShaderProgramIdx != ShaderProgramIdx )
+	{
+		pProgram->useProgram();
+		m_ShaderProgramIdx = ShaderProgramIdx;
+	}
+
+	Matrix4x4 ViewProj;
+	if( m_RenderDevice->getCurrentRenderStage() == SGPRS_WATERREFLECTION )
+		ViewProj = m_RenderDevice->getOpenGLWaterRenderer()->m_MirrorViewMatrix * m_RenderDevice->getOpenGLWaterRenderer()->m_ObliqueNearPlaneReflectionProjMatrix;
+	else
+		ViewProj = m_RenderDevice->getOpenGLCamera()->m_mViewProjMatrix;
+
+	pProgram->setShaderUniform("ViewProjMatrix", ViewProj);
+	pProgram->setShaderUniform("fFarPlane", m_RenderDevice->getOpenGLCamera()->m_fFar);
+	pProgram->setShaderUniform("SunColor", m_RenderDevice->getOpenGLSkydomeRenderer()->getSunColorAndIntensity());
+
+	// Lightmap texture
+	if( m_pSB->MaterialSkin.nTextureNum == 2 )
+	{
+		m_RenderDevice->GetTextureManager()->getTextureByID(m_BatchConfig.m_nLightMapTextureID)->pSGPTexture->BindTexture2D(1);
+		pProgram->setShaderUniform("gSampler1", 1);
+	}
+	// Diffuse texture
+	if( m_BatchConfig.m_nReplacedTextureID != 0 )
+		m_RenderDevice->GetTextureManager()->getTextureByID(m_BatchConfig.m_nReplacedTextureID)->pSGPTexture->BindTexture2D(0);
+	else
+		m_RenderDevice->GetTextureManager()->getTextureByID(m_pSB->MaterialSkin.nTextureID[0])->pSGPTexture->BindTexture2D(0);
+	pProgram->setShaderUniform("gSampler0", 0);
+
+	Vector4D TextureAtlas((float)m_pSB->MaterialSkin.vUVTile[0], (float)m_pSB->MaterialSkin.vUVTile[1], 1.0f/m_pSB->MaterialSkin.vUVTile[0], 1.0f/m_pSB->MaterialSkin.vUVTile[1]);
+	pProgram->setShaderUniform("TextureAtlas", TextureAtlas);
+
+
+	m_pSB->pVBO->bindVAO();
+
+	// Per instance attributes, pointing at the first instance of this run in the frame instance buffer
+	const GLsizei nStride = sizeof(SGPVertex_STATIC_Instance);
+	const uint32 nOffset = FirstInstance * nStride;
+	m_RenderDevice->extGlBindBuffer(GL_ARRAY_BUFFER, InstanceVBID);
+	for( GLuint i = 0; i < 4; i++ )
+	{
+		m_pSB->pVBO->setVAOPointer(8+i, 4, GL_FLOAT, GL_FALSE, nStride, (GLvoid *)BUFFER_OFFSET(nOffset + 4*i*sizeof(float)));
+		m_RenderDevice->extGlVertexAttribDivisor(8+i, 1);
+	}
+	m_pSB->pVBO->setVAOPointer(12, 4, GL_FLOAT, GL_FALSE, nStride, (GLvoid *)BUFFER_OFFSET(nOffset + 16*sizeof(float)));
+	m_RenderDevice->extGlVertexAttribDivisor(12, 1);
+	m_pSB->pVBO->setVAOPointer(13, 3, GL_FLOAT, GL_FALSE, nStride, (GLvoid *)BUFFER_OFFSET(nOffset + 20*sizeof(float)));
+	m_RenderDevice->extGlVertexAttribDivisor(13, 1);
+
+	m_RenderDevice->extGlDrawElementsInstanced( m_RenderDevice->primitiveTypeToGL( m_pSB->MaterialSkin.nPrimitiveType ),
+					m_pSB->nNumIndis, 
+					GL_UNSIGNED_SHORT,
+					(void*)0,
+					NumInstances );
+
+	m_pSB->pVBO->unBindVAO();
+}
+
 // opaque
 void COpaqueRenderBatch::BuildQueueValue()
 {
@@ -205,6 +313,7 @@ void COpaqueRenderBatch::BuildQueueValue()
 	{
 		stQueueValue.ulpriority = m_pSB->MaterialSkin.nTextureID[0];
 		stQueueValue.ulshader = m_pSB->MaterialSkin.nShaderType;
+		stQueueValue.ulstaticbuffer = m_pSB->nSBID & 0xFFF;
 	}
 	else if( m_pVC )
 	{
@@ -220,7 +329,7 @@ void COpaqueRenderBatch::BuildQueueValue()
 
 	Vector4D BoundingBOXCenter = m_BBOXCenter * m_MatWorld;
 	Vector4D dis = BoundingBOXCenter - m_RenderDevice->getOpenGLCamera()->GetPos();
-	stQueueValue.uldistance = uint32( dis.GetLength() );
+	stQueueValue.uldistance = jmin( uint32( dis.GetLength() ), (uint32)0xFFFFF );
 
 	return;
 }
@@ -272,9 +381,9 @@ void CSkinAnimRenderBatch::BuildQueueValue()
 	memset( &stQueueValue.ulQueueValue, 0x00, sizeof(uint64) );
 
 	stQueueValue.ulshader = SGPST_SKELETONANIM;
-	stQueueValue.ultboid = (uint16)m_TBOID;
 	if( m_pSB )
 	{
+		stQueueValue.ulstaticbuffer = (uint16)(m_pSB->nSBID & 0xFFFF);
 		stQueueValue.ulpriority = m_pSB->MaterialSkin.nTextureID[0];
 	}
 	else
@@ -300,6 +409,9 @@ void CSkinAnimRenderBatch::PreRender()
 			m_RenderDevice->GetTextureManager()->getTextureByID( m_RenderDevice->getOpenGLTerrainRenderer()->getLightmapTextureID() )->pSGPTexture->BindTexture2D(1);
 			pShaderManager->GetGLSLShaderProgram(m_ShaderProgramIdx)->setShaderUniform("gSamplerLightmap", 1);			
 
+			// Bone palette is shared by all skin batches
+			static_cast<COpenGLVertexCacheManager*>(m_RenderDevice->GetVertexCacheManager())->BindBonePalette(2);
+
 			m_SkinAnimShaderLightmapTexSetted = true;
 		}
 		
@@ -391,8 +503,8 @@ void CSkinAnimRenderBatch::Render()
 		pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("SunColor", m_RenderDevice->getOpenGLSkydomeRenderer()->getSunColorAndIntensity());
 		pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("SunDirection", -m_RenderDevice->GetWorldSystemManager()->getWorldSun()->getNormalizedSunDirection());
 		
-		if( m_RenderDevice->GetVertexCacheManager()->BindTextureBufferObjectByID(m_TBOID, 2) )
-			pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("jointTex", 2);
+		pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("jointTex", 2);
+		pShaderManager->GetGLSLShaderProgram(ShaderProgramIdx)->setShaderUniform("BoneOffset", (int32)m_BoneOffset);
 
 
 		m_pSB->pVBO->bindVAO();
@@ -519,19 +631,22 @@ void CParticleLineRenderBatch::PreRender()
 		}
 	}
 
+	COpenGLRenderStateCache* pState = m_RenderDevice->getRenderStateCache();
 	if(COpenGLConfig::getInstance()->FullScreenAntiAlias)
 	{
-		glLineWidth(jlimit(m_RenderDevice->DimSmoothedLine[0], m_RenderDevice->DimSmoothedLine[1], m_pParticleBuffer->m_Thickness));
+		pState->setLineWidth(jlimit(m_RenderDevice->DimSmoothedLine[0], m_RenderDevice->DimSmoothedLine[1], m_pParticleBuffer->m_Thickness));
 	}
 	else
 	{
-		glLineWidth(jlimit(m_RenderDevice->DimAliasedLine[0], m_RenderDevice->DimAliasedLine[1], m_pParticleBuffer->m_Thickness));
+		pState->setLineWidth(jlimit(m_RenderDevice->DimAliasedLine[0], m_RenderDevice->DimAliasedLine[1], m_pParticleBuffer->m_Thickness));
 	}
+	pState->apply();
 }
 
 void CParticleLineRenderBatch::PostRender()
 {
-	glLineWidth( 1 );
+	// consecutive line batches mostly have the same thickness
+	m_RenderDevice->getRenderStateCache()->setLineWidth( 1 );
 }
 
 void CParticleLineRenderBatch::Render()
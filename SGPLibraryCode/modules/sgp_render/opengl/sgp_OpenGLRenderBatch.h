@@ -40,6 +40,17 @@ public:
 
 	BatchType			GetBatchType() { return m_BatchType; }
 
+	// Static mesh geometry instancing
+	// one draw call for NumInstances batches, instance data of this batch is at FirstInstance
+	bool				CanBeInstanced() const;
+	bool				CanBeInstancedWith(const ISGPRenderBatch& other) const;
+	void				GetInstanceData(SGPVertex_STATIC_Instance& InstanceData) const;
+	void				RenderInstanced(GLuint InstanceVBID, uint32 FirstInstance, uint32 NumInstances);
+
+	// Texture anim and material color of static buffer batch
+	Vector3D			GetTexIndexUVOffset() const;
+	Vector4D			GetMaterialColor() const;
+
 public:
 	BatchType				m_BatchType;
 	Vector4D				m_BBOXCenter;
@@ -73,7 +84,8 @@ public:
 		struct
 		{
 			uint64 ulReserved				: 2;    // unused bits
-			uint64 uldistance				: 32;	// object distance from camera
+			uint64 uldistance				: 20;	// object distance from camera (clamped)
+			uint64 ulstaticbuffer			: 12;	// 12 bits for static buffer ID (0-4096), same mesh batches are neighbours for instancing
 			uint64 ulpriority				: 14;   // 14 bits for user given priority (0-16384) (usually Tex ID)
 			uint64 ulshader					: 10;	// 10 bits for shader (0-1024) (usually shader ID)
 			uint64 ulqueue_id				: 6;	// 6 bits for user given queue (0-64)
@@ -233,7 +245,7 @@ public:
 		{
 			uint64 ulReserved				: 18;   // unused bits
 			uint64 ulpriority				: 14;   // 14 bits for user given priority (0-16384) (usually Tex ID)
-			uint64 ultboid					: 16;	// 16 bits for TBO ID (0-65536)
+			uint64 ulstaticbuffer			: 16;	// 16 bits for static buffer ID (0-65536)
 			uint64 ulshader					: 10;	// 10 bits for shader (0-1024) (usually shader ID)
 			uint64 ulqueue_id				: 6;	// 6 bits for user given queue (0-64)
 		};
@@ -241,7 +253,7 @@ public:
 	} stQueueValue;
 
 
-	uint32 m_TBOID;
+	uint32 m_BoneOffset;					// first texel of instance bones in bone palette
 };
 
 class CLineRenderBatch : public ISGPRenderBatch
@@ -650,22 +650,12 @@ void COpenGLRenderDevice::InitOpenGLRenderState()
 {
 	// Set the depth buffer to be entirely cleared to 1.0 values.
     glClearDepth(1.0f);
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	//glShadeModel(GL_SMOOTH);
 
-    // Enable depth testing.
-    glEnable(GL_DEPTH_TEST);
-	glDepthMask(GL_TRUE);
-	glDepthFunc(GL_LEQUAL);
-
-    // Set the polygon winding to front facing for the right handed system.
-    glFrontFace(GL_CCW);
-
-    // Enable back face culling.
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-	glColorMask( GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE );
+	// Fill mode, depth testing with GL_LEQUAL and depth write, 
+	// CCW front face for the right handed system, back face culling, color write.
+	// Blend, stencil and polygon offset disabled
+	m_RenderStateCache.reset();
 
 
 //#ifdef GL_EXT_separate_specular_color
@@ -706,13 +696,17 @@ bool COpenGLRenderDevice::beginScene( bool bClearColorBuffer, bool bClearDepthBu
 	}
 	if (bClearDepthBuffer)
 	{
-		glDepthMask(GL_TRUE);
+		m_RenderStateCache.setDepthMask(GL_TRUE);
 		mask |= GL_DEPTH_BUFFER_BIT;
 	}
 
 	if (bClearStencilBuffer)
 		mask |= GL_STENCIL_BUFFER_BIT;
 
+	// glClear uses color / depth / stencil write masks
+	m_RenderStateCache.apply();
+	m_RenderStateCache.beginFrame();
+
 	if (mask)
 		glClear(mask);
 
@@ -726,6 +720,9 @@ bool COpenGLRenderDevice::endScene()
 {
 	glFlush();
 
+	// Frame is over, per-frame arrays are rebuilt by the next world update
+	LinearArena::getFrameArena().reset();
+
 #if SGP_WINDOWS
 	return SwapBuffers(HDc) != FALSE;
 #elif SGP_LINUX
@@ -747,7 +744,8 @@ bool COpenGLRenderDevice::endScene()
 
 void COpenGLRenderDevice::clearZBuffer()
 {
-	glDepthMask(GL_TRUE);
+	m_RenderStateCache.setDepthMask(GL_TRUE);
+	m_RenderStateCache.apply();
 	glClear(GL_DEPTH_BUFFER_BIT);
 }
 
@@ -1236,6 +1234,9 @@ void COpenGLRenderDevice::FlushRenderBatch()
 
 	getOpenGLMaterialRenderer()->AfterDrawRenderBatch();	
 
+	// Restore default render state left pending by the last material pass
+	m_RenderStateCache.apply();
+
 	// Clear Dynamic Buffer
 	GetVertexCacheManager()->ForcedClearAll();
 
@@ -1253,7 +1254,7 @@ void COpenGLRenderDevice::FlushEditorLinesRenderBatch(bool bNoDepthLine, float L
 
 
 	if( LineWidth != 1.0f )
-		glLineWidth( LineWidth );
+		m_RenderStateCache.setLineWidth( LineWidth );
 
 	if( bNoDepthLine )
 	{
@@ -1266,10 +1267,12 @@ void COpenGLRenderDevice::FlushEditorLinesRenderBatch(bool bNoDepthLine, float L
 	}
 
 	if( LineWidth != 1.0f )
-		glLineWidth( 1.0f );
+		m_RenderStateCache.setLineWidth( 1.0f );
 
 	getOpenGLMaterialRenderer()->AfterDrawRenderBatch();
 
+	m_RenderStateCache.apply();
+
 	// Clear Dynamic Buffer
 	GetVertexCacheManager()->ForcedClearAll();
 
@@ -1300,6 +1303,8 @@ void COpenGLRenderDevice::EndRenderText()
 
 	getOpenGLMaterialRenderer()->OnePassPostRenderMaterial(0);
 	getOpenGLMaterialRenderer()->PopMaterial();
+
+	m_RenderStateCache.apply();
 }
 
 void COpenGLRenderDevice::SetActiveFont(const char* FontName)
@@ -9,6 +9,7 @@
 class SGPDeviceWin32;
 #elif SGP_LINUX
 class SGPDeviceLinux;
+struct SExposedVideoData;
 #elif SGP_MAC
 class SGPDeviceMacOSX;
 #elif SGP_IOS
@@ -243,6 +244,9 @@ public:
 	COpenGLWaterRenderer* getOpenGLWaterRenderer() { return m_pWaterRenderer; }
 	COpenGLGrassRenderer* getOpenGLGrassRenderer() { return m_pGrassRenderer; }
 
+	//! Get fixed function render state cache, material properties set state through it
+	COpenGLRenderStateCache* getRenderStateCache() { return &m_RenderStateCache; }
+
 private:
 	COpenGLRenderDevice();
 
@@ -266,6 +270,7 @@ private:
 	COpenGLWaterRenderer*   m_pWaterRenderer;
 	COpenGLGrassRenderer*	m_pGrassRenderer;
 	COpenGLConfig*			m_pOpenGLConfig;
+	COpenGLRenderStateCache	m_RenderStateCache;
 	SDimension2D			m_ScreenSize;
 	SDimension2D			m_CurrentRTSize;
 	SGP_PIXEL_FORMAT		m_PixelFormat;
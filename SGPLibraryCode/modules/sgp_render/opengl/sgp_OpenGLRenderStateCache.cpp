@@ -0,0 +1,224 @@
+const GLenum COpenGLRenderStateCache::s_CapabilityToGL[COpenGLRenderStateCache::eCapCount] =
+{
+	GL_DEPTH_TEST,
+	GL_BLEND,
+	GL_STENCIL_TEST,
+	GL_CULL_FACE,
+	GL_POLYGON_OFFSET_FILL,
+	GL_POLYGON_OFFSET_LINE,
+	GL_SAMPLE_ALPHA_TO_COVERAGE_ARB,
+	GL_MULTISAMPLE_ARB,
+	GL_LINE_SMOOTH,
+	GL_POINT_SMOOTH
+};
+
+COpenGLRenderStateCache::COpenGLRenderStateCache()
+	: m_TouchedCapabilities(0), m_TouchedStates(0),
+	  m_NumStateChanges(0), m_NumRedundantStates(0),
+	  m_LastFrameStateChanges(0), m_LastFrameRedundantStates(0)
+{
+	getDefaultState(m_Pending);
+	m_Current = m_Pending;
+}
+
+void COpenGLRenderStateCache::getDefaultState(SRenderState& s)
+{
+	// Same as COpenGLRenderDevice::InitOpenGLRenderState(), multisample is enabled in a new context
+	s.Capabilities = (1u << eCapDepthTest) | (1u << eCapCullFace) | (1u << eCapMultisample);
+
+	s.DepthFunc = GL_LEQUAL;
+	s.DepthMask = GL_TRUE;
+
+	s.BlendEquation = GL_FUNC_ADD;
+	s.BlendSrcRGB = s.BlendSrcAlpha = GL_ONE;
+	s.BlendDstRGB = s.BlendDstAlpha = GL_ZERO;
+
+	s.StencilFunc = GL_ALWAYS;
+	s.StencilRef = 0;
+	s.StencilMask = 0xFFFFFFFF;
+	s.StencilFail = s.StencilZFail = s.StencilZPass = GL_KEEP;
+	s.StencilWriteMask = 0xFFFFFFFF;
+
+	s.CullFaceMode = GL_BACK;
+	s.FrontFace = GL_CCW;
+	s.PolygonMode = GL_FILL;
+	s.ColorMask[0] = s.ColorMask[1] = s.ColorMask[2] = s.ColorMask[3] = GL_TRUE;
+
+	s.PointSize = 1.0f;
+	s.LineWidth = 1.0f;
+	s.PolygonOffsetFactor = 0;
+	s.PolygonOffsetUnits = 0;
+}
+
+void COpenGLRenderStateCache::reset()
+{
+	getDefaultState(m_Pending);
+
+	// Send everything, the state of the context is unknown
+	for( int cap = 0; cap < eCapCount; cap++ )
+	{
+		if( m_Pending.Capabilities & (1u << cap) )
+			glEnable( s_CapabilityToGL[cap] );
+		else
+			glDisable( s_CapabilityToGL[cap] );
+	}
+	for( int group = 0; group < eStateCount; group++ )
+		applyState( (StateGroup)group );
+
+	m_Current = m_Pending;
+	m_TouchedCapabilities = 0;
+	m_TouchedStates = 0;
+}
+
+void COpenGLRenderStateCache::beginFrame()
+{
+	m_LastFrameStateChanges = m_NumStateChanges;
+	m_LastFrameRedundantStates = m_NumRedundantStates;
+	m_NumStateChanges = 0;
+	m_NumRedundantStates = 0;
+}
+
+void COpenGLRenderStateCache::apply()
+{
+	if( m_TouchedCapabilities )
+	{
+		const uint32 changed = (m_Pending.Capabilities ^ m_Current.Capabilities) & m_TouchedCapabilities;
+		for( int cap = 0; cap < eCapCount; cap++ )
+		{
+			const uint32 bit = 1u << cap;
+			if( !(m_TouchedCapabilities & bit) )
+				continue;
+
+			if( changed & bit )
+			{
+				if( m_Pending.Capabilities & bit )
+					glEnable( s_CapabilityToGL[cap] );
+				else
+					glDisable( s_CapabilityToGL[cap] );
+				m_NumStateChanges++;
+			}
+			else
+				m_NumRedundantStates++;
+		}
+		m_Current.Capabilities = m_Pending.Capabilities;
+		m_TouchedCapabilities = 0;
+	}
+
+	if( m_TouchedStates )
+	{
+		for( int group = 0; group < eStateCount; group++ )
+		{
+			if( !(m_TouchedStates & (1u << group)) )
+				continue;
+
+			if( isStateEqual( (StateGroup)group ) )
+			{
+				m_NumRedundantStates++;
+				continue;
+			}
+			applyState( (StateGroup)group );
+			m_NumStateChanges++;
+		}
+		m_Current = m_Pending;
+		m_TouchedStates = 0;
+	}
+}
+
+bool COpenGLRenderStateCache::isStateEqual(StateGroup group) const
+{
+	const SRenderState& p = m_Pending;
+	const SRenderState& c = m_Current;
+
+	switch( group )
+	{
+	case eStateDepthFunc:
+		return p.DepthFunc == c.DepthFunc;
+	case eStateDepthMask:
+		return p.DepthMask == c.DepthMask;
+	case eStateBlendEquation:
+		return p.BlendEquation == c.BlendEquation;
+	case eStateBlendFunc:
+		return (p.BlendSrcRGB == c.BlendSrcRGB) && (p.BlendDstRGB == c.BlendDstRGB) &&
+			(p.BlendSrcAlpha == c.BlendSrcAlpha) && (p.BlendDstAlpha == c.BlendDstAlpha);
+	case eStateStencilFunc:
+		return (p.StencilFunc == c.StencilFunc) && (p.StencilRef == c.StencilRef) && (p.StencilMask == c.StencilMask);
+	case eStateStencilOp:
+		return (p.StencilFail == c.StencilFail) && (p.StencilZFail == c.StencilZFail) && (p.StencilZPass == c.StencilZPass);
+	case eStateStencilWriteMask:
+		return p.StencilWriteMask == c.StencilWriteMask;
+	case eStateCullFace:
+		return p.CullFaceMode == c.CullFaceMode;
+	case eStateFrontFace:
+		return p.FrontFace == c.FrontFace;
+	case eStatePolygonMode:
+		return p.PolygonMode == c.PolygonMode;
+	case eStateColorMask:
+		return (p.ColorMask[0] == c.ColorMask[0]) && (p.ColorMask[1] == c.ColorMask[1]) &&
+			(p.ColorMask[2] == c.ColorMask[2]) && (p.ColorMask[3] == c.ColorMask[3]);
+	case eStatePointSize:
+		return p.PointSize == c.PointSize;
+	case eStateLineWidth:
+		return p.LineWidth == c.LineWidth;
+	case eStatePolygonOffset:
+		return (p.PolygonOffsetFactor == c.PolygonOffsetFactor) && (p.PolygonOffsetUnits == c.PolygonOffsetUnits);
+	default:
+		break;
+	}
+	return true;
+}
+
+void COpenGLRenderStateCache::applyState(StateGroup group)
+{
+	const SRenderState& p = m_Pending;
+
+	switch( group )
+	{
+	case eStateDepthFunc:
+		glDepthFunc( p.DepthFunc );
+		break;
+	case eStateDepthMask:
+		glDepthMask( p.DepthMask );
+		break;
+	case eStateBlendEquation:
+		glBlendEquation( p.BlendEquation );
+		break;
+	case eStateBlendFunc:
+		if( (p.BlendSrcRGB == p.BlendSrcAlpha) && (p.BlendDstRGB == p.BlendDstAlpha) )
+			glBlendFunc( p.BlendSrcRGB, p.BlendDstRGB );
+		else
+			glBlendFuncSeparate( p.BlendSrcRGB, p.BlendDstRGB, p.BlendSrcAlpha, p.BlendDstAlpha );
+		break;
+	case eStateStencilFunc:
+		glStencilFunc( p.StencilFunc, p.StencilRef, p.StencilMask );
+		break;
+	case eStateStencilOp:
+		glStencilOp( p.StencilFail, p.StencilZFail, p.StencilZPass );
+		break;
+	case eStateStencilWriteMask:
+		glStencilMask( p.StencilWriteMask );
+		break;
+	case eStateCullFace:
+		glCullFace( p.CullFaceMode );
+		break;
+	case eStateFrontFace:
+		glFrontFace( p.FrontFace );
+		break;
+	case eStatePolygonMode:
+		glPolygonMode( GL_FRONT_AND_BACK, p.PolygonMode );
+		break;
+	case eStateColorMask:
+		glColorMask( p.ColorMask[0], p.ColorMask[1], p.ColorMask[2], p.ColorMask[3] );
+		break;
+	case eStatePointSize:
+		glPointSize( p.PointSize );
+		break;
+	case eStateLineWidth:
+		glLineWidth( p.LineWidth );
+		break;
+	case eStatePolygonOffset:
+		glPolygonOffset( p.PolygonOffsetFactor, p.PolygonOffsetUnits );
+		break;
+	default:
+		break;
+	}
+}
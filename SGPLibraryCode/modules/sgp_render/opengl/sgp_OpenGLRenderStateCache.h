@@ -0,0 +1,175 @@
+#ifndef __SGP_OPENGLRENDERSTATECACHE_HEADER__
+#define __SGP_OPENGLRENDERSTATECACHE_HEADER__
+
+/*
+	Fixed function render state (blend, depth, stencil, cull, raster) of the OpenGL device.
+
+	Material properties do not call OpenGL directly, they write the wanted state into
+	this cache. apply() compares the wanted state with the state OpenGL already has and
+	only issues the calls for differences.
+	OpenGLMaterial::Pass::PreRender() applies, PostRender() does not: the default values
+	restored by End() stay pending and are dropped if the next pass wants the same state.
+	Code drawing or clearing without material pass must call apply() first.
+*/
+class COpenGLRenderStateCache
+{
+public:
+	// glEnable / glDisable capabilities
+	enum Capability
+	{
+		eCapDepthTest = 0,
+		eCapBlend,
+		eCapStencilTest,
+		eCapCullFace,
+		eCapPolygonOffsetFill,
+		eCapPolygonOffsetLine,
+		eCapSampleAlphaToCoverage,
+		eCapMultisample,
+		eCapLineSmooth,
+		eCapPointSmooth,
+
+		eCapCount
+	};
+
+	COpenGLRenderStateCache();
+	~COpenGLRenderStateCache() {}
+
+	// Sets the initial render state of the device and sends all of it to OpenGL
+	void reset();
+
+	// Issues OpenGL calls for pending state which differs from current OpenGL state
+	void apply();
+
+	// Per frame counters
+	void beginFrame();
+	uint32 getNumStateChanges() const { return m_NumStateChanges; }
+	uint32 getNumRedundantStates() const { return m_NumRedundantStates; }
+	uint32 getLastFrameStateChanges() const { return m_LastFrameStateChanges; }
+	uint32 getLastFrameRedundantStates() const { return m_LastFrameRedundantStates; }
+
+
+	inline void enable(Capability cap, bool bEnable)
+	{
+		const uint32 bit = 1u << cap;
+		m_Pending.Capabilities = bEnable ? (m_Pending.Capabilities | bit) : (m_Pending.Capabilities & ~bit);
+		m_TouchedCapabilities |= bit;
+	}
+
+	inline void setDepthFunc(GLenum func)		{ m_Pending.DepthFunc = func; touch(eStateDepthFunc); }
+	inline void setDepthMask(GLboolean flag)	{ m_Pending.DepthMask = flag; touch(eStateDepthMask); }
+	inline void setBlendEquation(GLenum mode)	{ m_Pending.BlendEquation = mode; touch(eStateBlendEquation); }
+	inline void setBlendFunc(GLenum src, GLenum dst) { setBlendFuncSeparate(src, dst, src, dst); }
+	inline void setBlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+	{
+		m_Pending.BlendSrcRGB = srcRGB;
+		m_Pending.BlendDstRGB = dstRGB;
+		m_Pending.BlendSrcAlpha = srcAlpha;
+		m_Pending.BlendDstAlpha = dstAlpha;
+		touch(eStateBlendFunc);
+	}
+	inline void setStencilFunc(GLenum func, GLint ref, GLuint mask)
+	{
+		m_Pending.StencilFunc = func;
+		m_Pending.StencilRef = ref;
+		m_Pending.StencilMask = mask;
+		touch(eStateStencilFunc);
+	}
+	inline void setStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+	{
+		m_Pending.StencilFail = fail;
+		m_Pending.StencilZFail = zfail;
+		m_Pending.StencilZPass = zpass;
+		touch(eStateStencilOp);
+	}
+	inline void setStencilWriteMask(GLuint mask)	{ m_Pending.StencilWriteMask = mask; touch(eStateStencilWriteMask); }
+	inline void setCullFace(GLenum mode)		{ m_Pending.CullFaceMode = mode; touch(eStateCullFace); }
+	inline void setFrontFace(GLenum mode)		{ m_Pending.FrontFace = mode; touch(eStateFrontFace); }
+	inline void setPolygonMode(GLenum mode)		{ m_Pending.PolygonMode = mode; touch(eStatePolygonMode); }
+	inline void setColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+	{
+		m_Pending.ColorMask[0] = red;
+		m_Pending.ColorMask[1] = green;
+		m_Pending.ColorMask[2] = blue;
+		m_Pending.ColorMask[3] = alpha;
+		touch(eStateColorMask);
+	}
+	inline void setPointSize(GLfloat size)		{ m_Pending.PointSize = size; touch(eStatePointSize); }
+	inline void setLineWidth(GLfloat width)		{ m_Pending.LineWidth = width; touch(eStateLineWidth); }
+	inline void setPolygonOffset(GLfloat factor, GLfloat units)
+	{
+		m_Pending.PolygonOffsetFactor = factor;
+		m_Pending.PolygonOffsetUnits = units;
+		touch(eStatePolygonOffset);
+	}
+
+private:
+	// Non capability state groups, one OpenGL call (or call sequence) each
+	enum StateGroup
+	{
+		eStateDepthFunc = 0,
+		eStateDepthMask,
+		eStateBlendEquation,
+		eStateBlendFunc,
+		eStateStencilFunc,
+		eStateStencilOp,
+		eStateStencilWriteMask,
+		eStateCullFace,
+		eStateFrontFace,
+		eStatePolygonMode,
+		eStateColorMask,
+		eStatePointSize,
+		eStateLineWidth,
+		eStatePolygonOffset,
+
+		eStateCount
+	};
+
+	struct SRenderState
+	{
+		uint32		Capabilities;		// bit per Capability
+
+		GLenum		DepthFunc;
+		GLboolean	DepthMask;
+
+		GLenum		BlendEquation;
+		GLenum		BlendSrcRGB, BlendDstRGB, BlendSrcAlpha, BlendDstAlpha;
+
+		GLenum		StencilFunc;
+		GLint		StencilRef;
+		GLuint		StencilMask;
+		GLenum		StencilFail, StencilZFail, StencilZPass;
+		GLuint		StencilWriteMask;
+
+		GLenum		CullFaceMode;
+		GLenum		FrontFace;
+		GLenum		PolygonMode;
+		GLboolean	ColorMask[4];
+
+		GLfloat		PointSize;
+		GLfloat		LineWidth;
+		GLfloat		PolygonOffsetFactor, PolygonOffsetUnits;
+	};
+
+	inline void touch(StateGroup group) { m_TouchedStates |= 1u << group; }
+
+	static void getDefaultState(SRenderState& s);
+
+	bool isStateEqual(StateGroup group) const;
+	void applyState(StateGroup group);
+
+	static const GLenum s_CapabilityToGL[eCapCount];
+
+	SRenderState	m_Current;				// what OpenGL has
+	SRenderState	m_Pending;				// what was asked for since last apply()
+	uint32			m_TouchedCapabilities;
+	uint32			m_TouchedStates;
+
+	uint32			m_NumStateChanges;		// OpenGL state calls issued this frame
+	uint32			m_NumRedundantStates;	// state writes which needed no call this frame
+	uint32			m_LastFrameStateChanges;
+	uint32			m_LastFrameRedundantStates;
+
+	SGP_DECLARE_NON_COPYABLE (COpenGLRenderStateCache)
+};
+
+#endif		// __SGP_OPENGLRENDERSTATECACHE_HEADER__
@@ -68,9 +68,32 @@ public:
 	static GLuint			m_CurrentProgramID; // current used Program ID
 
 private:
+	// Active uniform of the program, resolved once after linking
+	struct SGLSLUniform
+	{
+		String	Name;				// Uniform name, without "[0]" for arrays
+		uint32	NameHash;
+		GLint	Location;
+		int		ShadowOffset;		// Offset of the shadow copy in m_UniformShadow
+		int		ShadowCapacity;		// Bytes reserved for the shadow copy
+		int		ShadowElementSize;	// Bytes per element of the values in shadow copy
+		int		ShadowBytes;		// Bytes of valid values in shadow copy, 0 if never set
+	};
+
+	void buildUniformTable();
+	int findUniform(const char* sName) const;
+	// Compare the values with the shadow copy of the uniform and update it,
+	// return false if the values were set already and uploading could be skipped.
+	bool updateUniformShadow(int iUniform, const void* pValues, int iElementSize, int32 iCount);
+
+	static uint32 getUniformNameHash(const char* sName, int iLength);
+
 	COpenGLRenderDevice*	m_pRenderDevice;	// Render Device
 	GLuint					m_ProgramID;		// OpenGL ID of program
 	bool					m_bLinked;			// Whether program was linked and is ready to use
+
+	Array<SGLSLUniform>		m_Uniforms;			// Uniform table
+	HeapBlock<uint8>		m_UniformShadow;	// CPU side copy of uniform values
 };
 
 
@@ -83,6 +83,14 @@ void COpenGLShaderManager::loadAllShaders()
 	loadSingleShader(SGPST_WATER_RENDER, Shader_waterRender_VS_String, Shader_waterRender_PS_String);
 #include "GLSL/glsl_grass_instance.h"
 	loadSingleShader(SGPST_GRASS_INSTANCING, Shader_grassRender_VS_String, Shader_grassRender_PS_String);
+#include "GLSL/glsl_texture_instance.h"
+	loadSingleShader(SGPST_INSTANCING_TEXTURE, Shader_texture_instance_VS_String, Shader_texture_instance_PS_String);
+#include "GLSL/glsl_texture_alphatest_instance.h"
+	loadSingleShader(SGPST_INSTANCING_TEXTURE_ALPHATEST, Shader_texture_alphatest_instance_VS_String, Shader_texture_alphatest_instance_PS_String);
+#include "GLSL/glsl_lightmap_instance.h"
+	loadSingleShader(SGPST_INSTANCING_LIGHTMAP, Shader_lightmap_instance_VS_String, Shader_lightmap_instance_PS_String);
+#include "GLSL/glsl_lightmap_alphatest_instance.h"
+	loadSingleShader(SGPST_INSTANCING_LIGHTMAP_ALPHATEST, Shader_lightmap_alphatest_instance_VS_String, Shader_lightmap_alphatest_instance_PS_String);
 }
 
 COpenGLSLShaderProgram* COpenGLShaderManager::GetGLSLShaderProgram(int index)
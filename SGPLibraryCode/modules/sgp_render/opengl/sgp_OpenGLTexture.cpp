@@ -10,7 +10,7 @@ COpenGLTexture::COpenGLTexture(ISGPImage* origImage, const String& name, COpenGL
 	m_ColorFormat(SGPPF_A8R8G8B8), RenderDevice(renderdevice), m_Image(0), /*m_MipImage(0),*/
 	OpenGLTextureID(0), InternalFormat(GL_RGBA), PixelFormat(GL_BGRA_EXT),
 	PixelType(GL_UNSIGNED_BYTE), HasMipMaps(bHasMipmaps),
-	MipMapLevels(0),
+	MipMapLevels(0), ImagePitch(0),
 	IsRenderTarget(false), 	/*ReadOnlyLock(false),*/
 	TextureTarget(GL_TEXTURE_2D),
 	TextureMagFilter(TEXTURE_FILTER_MAG_BILINEAR), TextureMinFilter(TEXTURE_FILTER_MIN_BILINEAR),
@@ -46,6 +46,10 @@ COpenGLTexture::COpenGLTexture(ISGPImage* origImage, const String& name, COpenGL
 	}
 
 	uploadTexture();
+
+	// GPU has its own copy now
+	delete m_Image;
+	m_Image = NULL;
 }
 
 
@@ -54,7 +58,7 @@ COpenGLTexture::COpenGLTexture(const String& name, COpenGLRenderDevice* renderde
 	: ISGPTexture(name), 
 	m_ColorFormat(SGPPF_A8R8G8B8), RenderDevice(renderdevice), m_Image(0), /*m_MipImage(0),*/
 	OpenGLTextureID(0), InternalFormat(GL_RGBA), PixelFormat(GL_BGRA_EXT),
-	PixelType(GL_UNSIGNED_BYTE), MipMapLevels(0), HasMipMaps(false),
+	PixelType(GL_UNSIGNED_BYTE), MipMapLevels(0), ImagePitch(0), HasMipMaps(false),
 	IsRenderTarget(false),
 	/*ReadOnlyLock(false), */TextureTarget(GL_TEXTURE_2D),
 	TextureMagFilter(TEXTURE_FILTER_MAG_BILINEAR), TextureMinFilter(TEXTURE_FILTER_MIN_BILINEAR),
@@ -499,6 +503,7 @@ void COpenGLTexture::uploadTexture()
 
 	// now get image data and upload to GPU
 	void* source = image->lock();
+	ImagePitch = image->getPitch();
 
 	glTexImage2D(GL_TEXTURE_2D, 0, InternalFormat, image->getDimension().Width,
 		image->getDimension().Height, 0, PixelFormat, PixelType, source);
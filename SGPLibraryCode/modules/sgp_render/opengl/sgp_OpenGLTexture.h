@@ -37,12 +37,7 @@ public:
 
 	//! returns pitch of texture (in bytes)
 	virtual uint32 getPitch() const
-	{ 	
-		if (m_Image)
-			return m_Image->getPitch();
-		else
-			return 0;
-	}
+	{ return ImagePitch; }
 
 	//! return whether this texture has mipmaps
 	virtual bool hasMipMaps() const 
@@ -154,6 +149,7 @@ protected:
 	bool HasMipMaps;					// texture has mipmaps?
 	bool IsRenderTarget;
 	uint32 MipMapLevels;				// texture mipmap levels
+	uint32 ImagePitch;					// pitch of uploaded image, CPU copy is freed after upload
 
 	//bool ReadOnlyLock;
 
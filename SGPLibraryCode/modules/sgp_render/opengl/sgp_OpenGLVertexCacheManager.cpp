@@ -5,13 +5,14 @@ float COpenGLVertexCacheManager::m_fSin[CIRCLE_SLIDES_MAX] = {0};
 float COpenGLVertexCacheManager::m_fCos[CIRCLE_SLIDES_MAX] = {0};
 
 COpenGLVertexCacheManager::COpenGLVertexCacheManager(COpenGLRenderDevice* pRenderDevice) 
-	: m_pRenderDevice(pRenderDevice), m_pFullScreenQuadVAO(NULL)
+	: m_pRenderDevice(pRenderDevice), m_pFullScreenQuadVAO(NULL),
+	  m_pBonePaletteTBO(NULL), m_BonePaletteTBOBoneNum(0), m_BonePaletteFrame(0)
 {
 	for( int i=0; i<CIRCLE_SLIDES_MAX; i++ )
 	{
 		float a = i * 2.0f * float_Pi / CIRCLE_SLIDES_MAX;
-		m_fSin[i] = std::sinf(a);
-		m_fCos[i] = std::cosf(a);
+		m_fSin[i] = sinf(a);
+		m_fCos[i] = cosf(a);
 	}
 
 	m_UPOSVCCache.add( new COpenGLDynamicBuffer(	INIT_DB_MAXSIZE, 
@@ -90,14 +91,12 @@ COpenGLVertexCacheManager::~COpenGLVertexCacheManager()
 			delete m_pSB[i];
 	}
 
-	// Last Chance release all TBO
-	for( int i=0; i<m_pTBO.size(); i++ )
+	// Last Chance release bone palette TBO
+	if( m_pBonePaletteTBO )
 	{
-		if( m_pTBO[i] )
-		{
-			m_pTBO[i]->deleteTBO();
-			delete m_pTBO[i];
-		}
+		m_pBonePaletteTBO->deleteTBO();
+		delete m_pBonePaletteTBO;
+		m_pBonePaletteTBO = NULL;
 	}
 	
 
@@ -150,6 +149,10 @@ void COpenGLVertexCacheManager::ForcedCommitAll(void)
 		if( m_UPOSTEXVCCache[i]->IsNotEmpty() )
 			m_UPOSTEXVCCache[i]->Commit();
 	}
+
+	// Bones of all skeleton batches in one upload
+	if( m_BonePalette.size() > 0 )
+		UploadBonePalette();
 }
 
 /**
@@ -173,6 +176,10 @@ void COpenGLVertexCacheManager::ForcedClearAll(void)
 		if( m_UPOSTEXVCCache[i]->IsNotEmpty() )
 			m_UPOSTEXVCCache[i]->Clear();
 	}
+
+	// Start a new bone palette, slots are appended again when rendered
+	m_BonePalette.clearQuick();
+	m_BonePaletteFrame++;
 }
 
 /**
@@ -740,61 +747,59 @@ void COpenGLVertexCacheManager::ClearStaticBuffer( uint32 nSBufferID )
 	if( nSBufferID == 0 )
 		return;
 
-	int i = 0;
-	for( i=0; i<m_pSB.size(); i++ )
+	const int i = FindStaticBufferIndex(nSBufferID);
+	if( i >= 0 )
 	{
-		if( m_pSB[i]->nSBID == nSBufferID )
-		{
-			delete m_pSB[i];
-			break;
-		}
-	}
-
-	if( i<m_pSB.size() )
+		delete m_pSB[i];
 		m_pSB.remove(i);
+	}
 }
 
-void COpenGLVertexCacheManager::ClearAllTextureBufferObject()
+int COpenGLVertexCacheManager::FindStaticBufferIndex( uint32 nSBufferID ) const
 {
-	for( int i=0; i<m_pTBO.size(); i++ )
+	int iStart = 0;
+	int iEnd = m_pSB.size();
+	while( iStart < iEnd )
 	{
-		if( m_pTBO[i] )
-		{
-			m_pTBO[i]->deleteTBO();
-			delete m_pTBO[i];
-			m_pTBO.getReference(i) = NULL;
-		}
-		
+		const int iMid = (iStart + iEnd) >> 1;
+		const uint32 nMidID = m_pSB.getUnchecked(iMid)->nSBID;
+		if( nMidID == nSBufferID )
+			return iMid;
+		if( nMidID < nSBufferID )
+			iStart = iMid + 1;
+		else
+			iEnd = iMid;
 	}
-	m_pTBO.clear();
+	return -1;
+}
+
+void COpenGLVertexCacheManager::ClearAllTextureBufferObject()
+{
+	m_BonePaletteSlots.clear();
+	m_FreeBonePaletteSlots.clear();
+	m_BonePalette.clearQuick();
 }
 
 void COpenGLVertexCacheManager::ClearTextureBufferObject( uint32 nTBOID )
 {
-	if( nTBOID == 0xFFFFFFFF || nTBOID >= (uint32)m_pTBO.size() )
+	if( nTBOID == 0xFFFFFFFF || nTBOID >= (uint32)m_BonePaletteSlots.size() )
 		return;
 
-	if( m_pTBO[nTBOID] )
-	{
-		m_pTBO[nTBOID]->deleteTBO();
-		delete m_pTBO[nTBOID];
-		m_pTBO.getReference(nTBOID) = NULL;
-	}
+	BonePaletteSlot& Slot = m_BonePaletteSlots.getReference(nTBOID);
+	if( Slot.nBoneNum == 0 )
+		return;
 
-	m_pTBO.remove(nTBOID);
+	// Slot is kept, IDs of other slots should not change
+	Slot.pBoneMatrixBuffer = NULL;
+	Slot.nBoneNum = 0;
+	m_FreeBonePaletteSlots.add(nTBOID);
 }
 
 
 void* COpenGLVertexCacheManager::GetStaticBufferByID(uint32 nSBufferID)
 {
-	int i = 0;
-	for( i=0; i<m_pSB.size(); i++ )
-	{
-		if( m_pSB[i]->nSBID == nSBufferID )
-			break;
-	}
-
-	if( i == m_pSB.size() )
+	const int i = FindStaticBufferIndex(nSBufferID);
+	if( i < 0 )
 		return NULL;
 
 	return (void*)m_pSB[i];
@@ -802,14 +807,8 @@ void* COpenGLVertexCacheManager::GetStaticBufferByID(uint32 nSBufferID)
 
 void COpenGLVertexCacheManager::RenderStaticBuffer( uint32 nSBufferID, const Matrix4x4& matWorld, const RenderBatchConfig& config )
 {
-	int i = 0;
-	for( i=0; i<m_pSB.size(); i++ )
-	{
-		if( m_pSB[i]->nSBID == nSBufferID )
-			break;
-	}
-
-	if( i == m_pSB.size() )
+	const int i = FindStaticBufferIndex(nSBufferID);
+	if( i < 0 )
 		return;
 
 	COpenGLStaticBuffer *pStaticBuffer = m_pSB[i];
@@ -860,14 +859,8 @@ void COpenGLVertexCacheManager::RenderStaticBuffer( uint32 nSBufferID, const Mat
 
 void COpenGLVertexCacheManager::RenderSkeletonMesh( uint32 nSBufferID, const Matrix4x4& matWorld, uint32 nTBOID, const RenderBatchConfig& config )
 {
-	int i = 0;
-	for( i=0; i<m_pSB.size(); i++ )
-	{
-		if( m_pSB[i]->nSBID == nSBufferID )
-			break;
-	}
-
-	if( i == m_pSB.size() )
+	const int i = FindStaticBufferIndex(nSBufferID);
+	if( i < 0 )
 		return;
 
 	COpenGLStaticBuffer *pStaticBuffer = m_pSB[i];
@@ -878,13 +871,17 @@ void COpenGLVertexCacheManager::RenderSkeletonMesh( uint32 nSBufferID, const Mat
 	if( (StaticBufferSkin.nShaderType == SGPST_SKELETONANIM) ||
 		(StaticBufferSkin.nShaderType == SGPST_SKELETONANIM_ALPHATEST) )
 	{
+		const uint32 nBoneOffset = AppendToBonePalette(nTBOID);
+		if( nBoneOffset == 0xFFFFFFFF )
+			return;
+
 		CSkinAnimRenderBatch newRenderBatch(GetDevice());
 		newRenderBatch.m_BBOXCenter = pStaticBuffer->BoundingBox.vcCenter;
 		newRenderBatch.m_MatWorld = matWorld;
 		newRenderBatch.m_BatchConfig = config;
 		newRenderBatch.m_pSB = pStaticBuffer;
 		newRenderBatch.m_pVC = NULL;
-		newRenderBatch.m_TBOID = nTBOID;
+		newRenderBatch.m_BoneOffset = nBoneOffset;
 		newRenderBatch.BuildQueueValue();
 		GetDevice()->getOpenGLMaterialRenderer()->PushSkinAnimRenderBatch(newRenderBatch);
 	}
@@ -894,61 +891,62 @@ void COpenGLVertexCacheManager::RenderSkeletonMesh( uint32 nSBufferID, const Mat
 }
 
 /**
- * Create a texture buffer object for the given Model Resource
- * return a index to that buffer for later rendering processes.
+ * Create a bone palette slot for the given Model Resource
+ * return a index to that slot for later rendering processes.
+ * All slots share one texture buffer object, see UploadBonePalette().
  * -> IN:  uint32        - index of Model Resource index of m_MF1Models Array in ModelManager
- * -> OUT: uint32        - ID to the created TBO (0xFFFFFFFF for error)
+ * -> OUT: uint32        - ID to the created slot (0xFFFFFFFF for error)
  */
 uint32 COpenGLVertexCacheManager::CreateTextureBufferObjectByID(uint32 ModelResourceID)
 {
 	CMF1FileResource* pMF1Res =	GetDevice()->GetModelManager()->getModelByID(ModelResourceID);
-	if( pMF1Res && pMF1Res->pModelMF1 )
+	if( pMF1Res && pMF1Res->pModelMF1 && (pMF1Res->pModelMF1->m_iNumBones > 0) )
 	{
-		uint32 TBOID = m_pTBO.size();
-		if( pMF1Res->pModelMF1->m_iNumBones > 0 )
-		{
-			COpenGLTextureBufferObject *pTBO = new COpenGLTextureBufferObject(GetDevice());
-			pTBO->createTBO();
-			pTBO->bindTBO();
-			pTBO->initTBOBuffer(pMF1Res->pModelMF1->m_iNumBones, GL_STREAM_DRAW);
+		BonePaletteSlot NewSlot;
+		NewSlot.pBoneMatrixBuffer = NULL;
+		NewSlot.nBoneNum = pMF1Res->pModelMF1->m_iNumBones;
+		NewSlot.nPaletteOffset = 0;
+		NewSlot.nPaletteFrame = m_BonePaletteFrame - 1;
 
-
-			m_pTBO.add( pTBO );
+		if( m_FreeBonePaletteSlots.size() > 0 )
+		{
+			uint32 TBOID = m_FreeBonePaletteSlots.getLast();
+			m_FreeBonePaletteSlots.removeLast();
+			m_BonePaletteSlots.set(TBOID, NewSlot);
 			return TBOID;
 		}
+
+		m_BonePaletteSlots.add(NewSlot);
+		return (uint32)(m_BonePaletteSlots.size() - 1);
 	}
 
 	return 0xFFFFFFFF;
 }
 
 /**
- * Update a texture buffer object for the given TBO ID
- * -> IN:   float*	- BoneMatrix Buffer data (updated data for TBO)
+ * Update a bone palette slot for the given TBO ID
+ * Nothing is uploaded here, the buffer is copied to the palette when the slot is rendered
+ * so it must stay valid until the slot is cleared.
+ * -> IN:   float*	- BoneMatrix Buffer data (3x4 matrix per bone)
  *			uint32  - Bone Count 
  *			uint32  - index of TBO ID
  */
 void COpenGLVertexCacheManager::UpdateTextureBufferObjectByID(float* pBoneMatrixBuffer, uint32 nBoneCount, uint32 TBOID)
 {
-	if( TBOID == 0xFFFFFFFF || !pBoneMatrixBuffer )
+	if( TBOID >= (uint32)m_BonePaletteSlots.size() || !pBoneMatrixBuffer )
 		return;
 
-	COpenGLTextureBufferObject *pTBO = m_pTBO.getReference(TBOID);
-
-	if( pTBO )
-	{
-		pTBO->bindTBO();
+	BonePaletteSlot& Slot = m_BonePaletteSlots.getReference(TBOID);
+	if( Slot.nBoneNum == 0 )
+		return;
 
-		float* MatrixData = (float*)pTBO->mapBufferToMemory(GL_WRITE_ONLY);
-			memcpy(MatrixData, pBoneMatrixBuffer, sizeof(float)*12*nBoneCount);
-		pTBO->unmapBuffer();
-  
-		pTBO->unbindTBO();
-	}
+	Slot.pBoneMatrixBuffer = pBoneMatrixBuffer;
+	Slot.nBoneNum = nBoneCount;
 }
 
 
 /**
- * Bind a texture buffer object for the given TBO ID to one texture unit
+ * Bind the bone palette TBO to one texture unit
  * -> IN:   
  *			uint32  - index of TBO ID
  *			int		- texture unit to bind texture to
@@ -956,14 +954,72 @@ void COpenGLVertexCacheManager::UpdateTextureBufferObjectByID(float* pBoneMatrix
  */
 bool COpenGLVertexCacheManager::BindTextureBufferObjectByID(uint32 TBOID, int iTextureUnit)
 {
-	if( TBOID == 0xFFFFFFFF )
+	if( TBOID >= (uint32)m_BonePaletteSlots.size() || (m_BonePaletteSlots[TBOID].nBoneNum == 0) )
+		return false;
+
+	return BindBonePalette(iTextureUnit);
+}
+
+bool COpenGLVertexCacheManager::BindBonePalette(int iTextureUnit)
+{
+	if( !m_pBonePaletteTBO )
 		return false;
 
-	COpenGLTextureBufferObject *pTBO = m_pTBO.getReference(TBOID);
+	return m_pBonePaletteTBO->bindTextureBuffer(iTextureUnit);
+}
+
+uint32 COpenGLVertexCacheManager::AppendToBonePalette( uint32 nTBOID )
+{
+	if( nTBOID >= (uint32)m_BonePaletteSlots.size() )
+		return 0xFFFFFFFF;
+
+	BonePaletteSlot& Slot = m_BonePaletteSlots.getReference(nTBOID);
+	if( (Slot.nBoneNum == 0) || !Slot.pBoneMatrixBuffer )
+		return 0xFFFFFFFF;
 
-	return pTBO->bindTextureBuffer(iTextureUnit);
+	// Meshes of one instance share its bones
+	if( Slot.nPaletteFrame != m_BonePaletteFrame )
+	{
+		// 3 RGBA32F texels per bone
+		Slot.nPaletteOffset = (uint32)m_BonePalette.size() / 4;
+		Slot.nPaletteFrame = m_BonePaletteFrame;
+		m_BonePalette.addArray(Slot.pBoneMatrixBuffer, 12 * Slot.nBoneNum);
+	}
+	return Slot.nPaletteOffset;
 }
 
+void COpenGLVertexCacheManager::UploadBonePalette()
+{
+	const int nBoneNum = m_BonePalette.size() / 12;
+
+	if( !m_pBonePaletteTBO )
+	{
+		m_pBonePaletteTBO = new COpenGLTextureBufferObject(GetDevice());
+		m_pBonePaletteTBO->createTBO();
+	}
+
+	m_pBonePaletteTBO->bindTBO();
+
+	// Grow palette TBO
+	if( nBoneNum > m_BonePaletteTBOBoneNum )
+	{
+		if( m_BonePaletteTBOBoneNum == 0 )
+			m_BonePaletteTBOBoneNum = INIT_BONEPALETTE_BONENUM;
+		while( m_BonePaletteTBOBoneNum < nBoneNum )
+			m_BonePaletteTBOBoneNum *= 2;
+		m_pBonePaletteTBO->initTBOBuffer(m_BonePaletteTBOBoneNum, GL_STREAM_DRAW);
+	}
+
+	uint32 nSizeData = sizeof(float) * m_BonePalette.size();
+	float* pData = (float*)m_pBonePaletteTBO->mapSubBufferToMemory(GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT, 0, nSizeData);
+	if( pData )
+	{
+		memcpy(pData, m_BonePalette.getRawDataPointer(), nSizeData);
+		m_pBonePaletteTBO->unmapBuffer();
+	}
+
+	m_pBonePaletteTBO->unbindTBO();
+}
 
 
 
@@ -1697,6 +1753,9 @@ void COpenGLVertexCacheManager::RenderFullScreenQuadWithoutMaterial()
 {
 	if( m_pFullScreenQuadVAO )
 	{		
+		// no material pass, send pending render state first
+		GetDevice()->getRenderStateCache()->apply();
+
 		m_pFullScreenQuadVAO->bindVAO();
 		glDrawElements( GL_TRIANGLES,
 						6, 
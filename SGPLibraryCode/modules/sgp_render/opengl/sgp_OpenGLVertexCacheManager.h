@@ -114,11 +114,41 @@ public:
 public:
 	inline COpenGLRenderDevice*	GetDevice() { return m_pRenderDevice; }
 
+	// Binds the bone palette of all skeleton instances, false before the first upload
+	bool				BindBonePalette(int iTextureUnit);
+
 private:
+	// m_pSB is sorted by nSBID (IDs only grow), returns -1 if not found
+	int								FindStaticBufferIndex( uint32 nSBufferID ) const;
+
+	// Copies bones of one slot to the palette once per frame, returns the first texel of it (0xFFFFFFFF if no bone data)
+	uint32							AppendToBonePalette( uint32 nTBOID );
+	void							UploadBonePalette();
+
+	/*
+		Bone palette: all skeleton instances share one texture buffer object.
+		A TBO ID is a slot which only remembers the bone matrix buffer of its instance,
+		the bones of every rendered slot are appended to m_BonePalette and the palette
+		is uploaded once in ForcedCommitAll(). Skin batches only carry their texel offset.
+	*/
+	struct BonePaletteSlot
+	{
+		const float*	pBoneMatrixBuffer;		// owned by the instance, 3x4 matrix per bone
+		uint32			nBoneNum;				// 0 if the slot is free
+		uint32			nPaletteOffset;			// first texel in this frame palette
+		uint32			nPaletteFrame;			// m_BonePaletteFrame when appended
+	};
+
 	COpenGLRenderDevice*			m_pRenderDevice;
 
-	Array<COpenGLStaticBuffer*>			m_pSB;					// Static Mesh
-	Array<COpenGLTextureBufferObject*>	m_pTBO;					// Texture Buffer object
+	Array<COpenGLStaticBuffer*>		m_pSB;						// Static Mesh
+
+	Array<BonePaletteSlot>			m_BonePaletteSlots;
+	Array<uint32>					m_FreeBonePaletteSlots;
+	Array<float>					m_BonePalette;				// bones of this frame, 12 floats per bone
+	COpenGLTextureBufferObject*		m_pBonePaletteTBO;
+	int								m_BonePaletteTBOBoneNum;	// size of palette TBO in bones
+	uint32							m_BonePaletteFrame;
 	
 	Array<COpenGLDynamicBuffer*>	m_UPOSVCCache;				// untransformed position + vertex color only
 	Array<COpenGLDynamicBuffer*>	m_UPOSTEXCache;				// untransformed position + texcoord 
@@ -129,6 +159,7 @@ private:
 
 	static const int INIT_SB_RESOURCENUM = 1024;
 	static const int INIT_DB_MAXSIZE = 8196;
+	static const int INIT_BONEPALETTE_BONENUM = 4096;
 
 	static uint32 StaticBuffer_ID;
 
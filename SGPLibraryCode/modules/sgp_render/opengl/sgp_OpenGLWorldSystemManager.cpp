@@ -3,7 +3,7 @@
 COpenGLWorldSystemManager::COpenGLWorldSystemManager(COpenGLRenderDevice* pRenderDevice, Logger* pLogger)
 	: m_pRenderDevice(pRenderDevice), m_pLogger(pLogger), 
 	  m_pWorldMap(NULL), m_pTerrain(NULL), m_pSkydome(NULL), m_pWorldSun(NULL), m_pWater(NULL), m_pGrass(NULL),
-	  m_pWorldMapRawMemoryAddress(NULL)
+	  m_pWorldMapMappedFile(NULL)
 {
 	m_VisibleSceneObjectArray.ensureStorageAllocated(INIT_SCENEOBJECTARRAYSIZE);
 	m_VisibleChunkArray.ensureStorageAllocated(SGPTS_LARGE*SGPTS_LARGE / 3);
@@ -29,9 +29,9 @@ COpenGLWorldSystemManager::~COpenGLWorldSystemManager()
 		delete m_pGrass;
 	m_pGrass = NULL;
 
-	if( m_pWorldMapRawMemoryAddress )
-		delete [] m_pWorldMapRawMemoryAddress;
-	m_pWorldMapRawMemoryAddress = NULL;
+	if( m_pWorldMapMappedFile )
+		delete m_pWorldMapMappedFile;
+	m_pWorldMapMappedFile = NULL;
 
 
 }
@@ -170,9 +170,12 @@ void COpenGLWorldSystemManager::addSceneObject( ISGPObject* obj, uint32 ConfigIn
 	obj->m_iSceneID = iSceneID;
 	obj->m_iConfigIndex = ConfigIndex;
 
+	Vector4D CamPos;
+	m_pRenderDevice->getCamreaPosition( &CamPos );
+
 	// create mesh instance and add it to map data struct
 	CStaticMeshInstance *pStaticModel = new CStaticMeshInstance(m_pRenderDevice);
-	pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex );
+	pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex, getSceneObjectLoadingPriority(obj, CamPos) );
 	pStaticModel->setPosition( obj->m_fPosition[0], obj->m_fPosition[1], obj->m_fPosition[2] );
 	pStaticModel->setRotationXYZ( obj->m_fRotationXYZ[0], obj->m_fRotationXYZ[1], obj->m_fRotationXYZ[2] );
 	pStaticModel->setScale( obj->m_fScale );
@@ -420,15 +423,14 @@ void COpenGLWorldSystemManager::initializeCollisionSet()
 					v1 = v1 * modelMatrix;
 					v2 = v2 * modelMatrix;
 
-					m_CollisionTree.addTriangle(v0, v1, v2, NULL);
-					m_CollisionTree.addTriangle(v0, v2, v1, NULL);
+					m_CollisionTree.addTriangle(v0, v1, v2, NULL, true);
 				}
 			}
 		}
 	}
 
 	m_pLogger->writeToLog(String("Start building Collision Tree..."), ELL_INFORMATION);
-	m_CollisionTree.build(3, 1, 50);
+	m_CollisionTree.build();
 	m_pLogger->writeToLog(String("Finish building Collision Tree..."), ELL_INFORMATION);
 }
 
@@ -613,7 +615,7 @@ void COpenGLWorldSystemManager::saveWorldToFile(const String& WorkingDir, const
 
 void COpenGLWorldSystemManager::loadWorldFromFile(const String& WorkingDir, const String& WorldMapFileName, bool bLoadObjs)
 {
-	m_pWorldMapRawMemoryAddress = CSGPWorldMap::LoadWorldMap(m_pWorldMap, WorkingDir, WorldMapFileName);
+	m_pWorldMapMappedFile = CSGPWorldMap::LoadWorldMap(m_pWorldMap, WorkingDir, WorldMapFileName);
 
 	setWorldName( File::getCurrentWorkingDirectory().getChildFile(String(m_pWorldMap->m_Header.m_cFilename)).getFileNameWithoutExtension() );
 
@@ -679,6 +681,9 @@ void COpenGLWorldSystemManager::loadWorldFromFile(const String& WorkingDir, cons
 			m_SenceObjectArray.add(pObj);
 		}
 
+		Vector4D CamPos;
+		m_pRenderDevice->getCamreaPosition( &CamPos );
+
 		ISGPObject** pEnd = m_SenceObjectArray.end();
 		for( ISGPObject** pBegin = m_SenceObjectArray.begin(); pBegin < pEnd; pBegin++ )
 		{
@@ -688,7 +693,7 @@ void COpenGLWorldSystemManager::loadWorldFromFile(const String& WorkingDir, cons
 
 			// create mesh instance and add it to map data struct
 			CStaticMeshInstance *pStaticModel = new CStaticMeshInstance(m_pRenderDevice);
-			pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex );
+			pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex, getSceneObjectLoadingPriority(obj, CamPos) );
 			pStaticModel->setPosition( obj->m_fPosition[0], obj->m_fPosition[1], obj->m_fPosition[2] );
 			pStaticModel->setRotationXYZ( obj->m_fRotationXYZ[0], obj->m_fRotationXYZ[1], obj->m_fRotationXYZ[2] );
 			pStaticModel->setScale( obj->m_fScale );
@@ -794,12 +799,15 @@ void COpenGLWorldSystemManager::loadObjectToWorldForEditor(ISGPObject* pObjArray
 		m_SenceObjectArray.add(pObj);
 	}
 
+	Vector4D CamPos;
+	m_pRenderDevice->getCamreaPosition( &CamPos );
+
 	for( uint32 i=0; i<count ;i++ )
 	{
 		ISGPObject* obj =  &(pObjArray[i]);
 		// create mesh instance and add it to map data struct
 		CStaticMeshInstance *pStaticModel = new CStaticMeshInstance(m_pRenderDevice);
-		pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex );
+		pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex, getSceneObjectLoadingPriority(obj, CamPos) );
 		pStaticModel->setPosition( obj->m_fPosition[0], obj->m_fPosition[1], obj->m_fPosition[2] );
 		pStaticModel->setRotationXYZ( obj->m_fRotationXYZ[0], obj->m_fRotationXYZ[1], obj->m_fRotationXYZ[2] );
 		pStaticModel->setScale( obj->m_fScale );
@@ -872,9 +880,14 @@ void COpenGLWorldSystemManager::updateWorld(float fDeltaTimeInSecond)
 		}
 	}
 
-	// Update Sky dome
 	Vector4D CamPos;
 	m_pRenderDevice->getCamreaPosition( &CamPos );
+
+	// Nearer unloaded scene objects will be loaded earlier
+	if( m_pRenderDevice->isResLoadingMultiThread() )
+		updateSceneObjectLoadingPriority( m_pRenderDevice->GetMTResourceLoader(), CamPos );
+
+	// Update Sky dome
 	m_pRenderDevice->getOpenGLSkydomeRenderer()->update(fDeltaTimeInSecond, m_pSkydome, CamPos);
 	
 	// Update Grass
@@ -882,6 +895,7 @@ void COpenGLWorldSystemManager::updateWorld(float fDeltaTimeInSecond)
 
 
 	// get all visible Scene Object and update
+	// This frame time is already counted as skipped time by the invisible update above
 	m_VisibleSceneObjectArray.clearQuick();
 	getVisibleSceneObjectArray(ViewFrustum, m_VisibleChunkArray, m_VisibleSceneObjectArray);
 	
@@ -889,7 +903,7 @@ void COpenGLWorldSystemManager::updateWorld(float fDeltaTimeInSecond)
 	for( ISGPObject** pVisibleObjBegin = m_VisibleSceneObjectArray.begin(); pVisibleObjBegin < pVisibleObjEnd; pVisibleObjBegin++ )
 	{
 		m_SceneIDToInstanceMap[(*pVisibleObjBegin)->getSceneObjectID()]->setVisible(true);
-		m_SceneIDToInstanceMap[(*pVisibleObjBegin)->getSceneObjectID()]->update(fDeltaTimeInSecond);
+		m_SceneIDToInstanceMap[(*pVisibleObjBegin)->getSceneObjectID()]->update(0);
 	}
 }
 
@@ -906,7 +920,7 @@ void COpenGLWorldSystemManager::shutdownWorld()
 	m_pRenderDevice->getOpenGLGrassRenderer()->releaseGrassTexture();
 
 
-	HashMap<uint32, CStaticMeshInstance*>::Iterator i (m_SceneIDToInstanceMap);
+	FlatHashMap<uint32, CStaticMeshInstance*>::Iterator i (m_SceneIDToInstanceMap);
 	while( i.next() )
 	{
 		CStaticMeshInstance* pInstance = i.getValue();
@@ -935,9 +949,9 @@ void COpenGLWorldSystemManager::shutdownWorld()
 		delete m_pGrass;
 	m_pGrass = NULL;
 
-	if( m_pWorldMapRawMemoryAddress )
-		delete [] m_pWorldMapRawMemoryAddress;
-	m_pWorldMapRawMemoryAddress = NULL;
+	if( m_pWorldMapMappedFile )
+		delete m_pWorldMapMappedFile;
+	m_pWorldMapMappedFile = NULL;
 }
 
 void COpenGLWorldSystemManager::renderWorld()
@@ -1780,7 +1794,7 @@ void COpenGLWorldSystemManager::releaseTerrainRenderer()
 	}
 }
 
-void COpenGLWorldSystemManager::getVisibleSceneObjectArray(const Frustum& ViewFrustum, const Array<CSGPTerrainChunk*>& VisibleChunkArray, Array<ISGPObject*>& VisibleSceneObjectArray)
+void COpenGLWorldSystemManager::getVisibleSceneObjectArray(const Frustum& ViewFrustum, const FrameTerrainChunkArray& VisibleChunkArray, Array<ISGPObject*>& VisibleSceneObjectArray)
 {
 	Frustum MirroredViewFrustum;
 	if( needRenderWater() )
@@ -1789,6 +1803,10 @@ void COpenGLWorldSystemManager::getVisibleSceneObjectArray(const Frustum& ViewFr
 	}
 
 
+	// Collect bounding box of objects in visible chunks, they are culled in one batch
+	m_SceneObjectBounds.clear();
+	m_SceneObjectCandidates.clearQuick();
+
 	CSGPTerrainChunk** pEnd = VisibleChunkArray.end();
 	for( CSGPTerrainChunk** pBegin = VisibleChunkArray.begin(); pBegin < pEnd; pBegin++ )
 	{
@@ -1799,11 +1817,26 @@ void COpenGLWorldSystemManager::getVisibleSceneObjectArray(const Frustum& ViewFr
 		{
 			AABBox objAABB;
 			objAABB.Construct( &((*pObjBegin)->getBoundingBox()) );
-			if( objAABB.Intersects(ViewFrustum) )
-				VisibleSceneObjectArray.addIfNotAlreadyThere(*pObjBegin);
-			if( needRenderWater() && objAABB.Intersects(MirroredViewFrustum) )
-				VisibleSceneObjectArray.addIfNotAlreadyThere(*pObjBegin);
+			m_SceneObjectBounds.add( objAABB );
+			m_SceneObjectCandidates.add( *pObjBegin );
 		}
 	}
+
+	const int nNumMask = (m_SceneObjectBounds.size() + 31) / 32;
+	m_SceneObjectVisibleMask.resize( nNumMask );
+	m_SceneObjectBounds.cullToMask( ViewFrustum, m_SceneObjectVisibleMask.getRawDataPointer() );
+	if( needRenderWater() )
+	{
+		m_SceneObjectMirroredVisibleMask.resize( nNumMask );
+		m_SceneObjectBounds.cullToMask( MirroredViewFrustum, m_SceneObjectMirroredVisibleMask.getRawDataPointer() );
+		for( int i=0; i<nNumMask; i++ )
+			m_SceneObjectVisibleMask.getReference(i) |= m_SceneObjectMirroredVisibleMask[i];
+	}
+
+	for( int i=0; i<m_SceneObjectCandidates.size(); i++ )
+	{
+		if( m_SceneObjectVisibleMask[i >> 5] & (1u << (i & 31)) )
+			VisibleSceneObjectArray.addIfNotAlreadyThere( m_SceneObjectCandidates[i] );
+	}
 }
 
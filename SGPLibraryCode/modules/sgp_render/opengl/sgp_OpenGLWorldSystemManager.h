@@ -234,7 +234,7 @@ private:
 	void initializeTerrainRenderer(bool bLoadFromMap = false);
 	void releaseTerrainRenderer();
 
-	void getVisibleSceneObjectArray(const Frustum& ViewFrustum, const Array<CSGPTerrainChunk*>& VisibleChunkArray, Array<ISGPObject*>& VisibleSceneObjectArray);
+	void getVisibleSceneObjectArray(const Frustum& ViewFrustum, const FrameTerrainChunkArray& VisibleChunkArray, Array<ISGPObject*>& VisibleSceneObjectArray);
 
 private:
 	COpenGLRenderDevice*			m_pRenderDevice;
@@ -250,11 +250,18 @@ private:
 	CSGPWater*						m_pWater;
 	CSGPGrass*						m_pGrass;
 
-	uint8*							m_pWorldMapRawMemoryAddress;
+	MemoryMappedFile*				m_pWorldMapMappedFile;
 
 	Array<ISGPObject*>				m_VisibleSceneObjectArray;
-	Array<CSGPTerrainChunk*>		m_VisibleChunkArray;
-	Array<CSGPTerrainChunk*>		m_WaterMirrorVisibleChunkArray;
+	// Per-frame arrays, their storage is taken from the frame arena
+	FrameTerrainChunkArray			m_VisibleChunkArray;
+	FrameTerrainChunkArray			m_WaterMirrorVisibleChunkArray;
+
+	// Batch culling data used by getVisibleSceneObjectArray()
+	AABBoxArray						m_SceneObjectBounds;
+	Array<ISGPObject*, DummyCriticalSection, ArenaArrayAllocationBase<ISGPObject*, DummyCriticalSection> > m_SceneObjectCandidates;
+	Array<uint32>					m_SceneObjectVisibleMask;
+	Array<uint32>					m_SceneObjectMirroredVisibleMask;
 
 };
 
@@ -128,6 +128,7 @@ sgp_ImplementSingleton_SingleThreaded( COpenGLConfig );
 #include "sgp_OpenGLExtensionHandler.cpp"
 #include "sgp_OpenGLCamera.cpp"
 #include "sgp_OpenGLHelpers.cpp"
+#include "sgp_OpenGLRenderStateCache.cpp"
 #include "sgp_OpenGLRenderDevice.cpp"
 #include "sgp_OpenGLTexture.cpp"
 #include "sgp_OpenGLSLShader.cpp"
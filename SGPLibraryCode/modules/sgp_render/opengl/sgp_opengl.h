@@ -31,6 +31,9 @@ namespace sgp
 #ifndef __SGP_OPENGLCONFIG_HEADER__
  #include "sgp_OpenGLConfig.h"
 #endif
+#ifndef __SGP_OPENGLRENDERSTATECACHE_HEADER__
+ #include "sgp_OpenGLRenderStateCache.h"
+#endif
 #ifndef __SGP_OPENGLHELPERS_HEADER__
  #include "sgp_OpenGLHelpers.h"
 #endif
@@ -30,7 +30,12 @@ private:
 		static COpenGLES2RenderDevice* m_pRD;
 		static int compareElements( SGPVertex_GRASS_Cluster first, SGPVertex_GRASS_Cluster second ) noexcept;
 	};
-	Array<SGPVertex_GRASS_Cluster> m_GrassClusterInstanceArray;		// GrassCluster data array
+	Array<SGPVertex_GRASS_Cluster, DummyCriticalSection,
+		ArenaArrayAllocationBase<SGPVertex_GRASS_Cluster, DummyCriticalSection> > m_GrassClusterInstanceArray;	// GrassCluster data array, in the frame arena
+
+	AABBoxArray m_GrassClusterBounds;								// Bounding box of GrassClusters to be culled
+	Array<const SGPGrassCluster*> m_GrassClusterCandidates;			// GrassClusters of m_GrassClusterBounds
+	Array<int> m_GrassClusterVisibleIndex;							// Culling result of m_GrassClusterBounds
 
 
 	SGPVertex_GRASS				m_grassVertex[4*3];
@@ -284,6 +284,9 @@ bool COpenGLES2RenderDevice::beginScene( bool bClearColorBuffer, bool bClearDept
 //! presents the rendered scene on the screen, returns false if failed
 bool COpenGLES2RenderDevice::endScene()
 {
+	// Frame is over, per-frame arrays are rebuilt by the next world update
+	LinearArena::getFrameArena().reset();
+
 	return true;
 }
 
@@ -3,7 +3,7 @@
 COpenGLES2WorldSystemManager::COpenGLES2WorldSystemManager(COpenGLES2RenderDevice* pRenderDevice, Logger* pLogger)
 	: m_pRenderDevice(pRenderDevice), m_pLogger(pLogger), 
 	  m_pWorldMap(NULL), m_pTerrain(NULL), m_pSkydome(NULL), m_pWorldSun(NULL), m_pWater(NULL), m_pGrass(NULL),
-	  m_pWorldMapRawMemoryAddress(NULL)
+	  m_pWorldMapMappedFile(NULL)
 {
 	m_VisibleSceneObjectArray.ensureStorageAllocated(INIT_SCENEOBJECTARRAYSIZE);
 	m_VisibleChunkArray.ensureStorageAllocated(SGPTS_LARGE*SGPTS_LARGE / 3);
@@ -28,9 +28,9 @@ COpenGLES2WorldSystemManager::~COpenGLES2WorldSystemManager()
 		delete m_pGrass;
 	m_pGrass = NULL;
 
-	if( m_pWorldMapRawMemoryAddress )
-		delete [] m_pWorldMapRawMemoryAddress;
-	m_pWorldMapRawMemoryAddress = NULL;
+	if( m_pWorldMapMappedFile )
+		delete m_pWorldMapMappedFile;
+	m_pWorldMapMappedFile = NULL;
 }
 
 void COpenGLES2WorldSystemManager::createTerrain( SGP_TERRAIN_SIZE terrainsize, bool bUsePerlinNoise, uint16 maxTerrainHeight )
@@ -218,7 +218,7 @@ Vector3D COpenGLES2WorldSystemManager::getTerrainNormal(float positionX, float p
 
 void COpenGLES2WorldSystemManager::loadWorldFromFile(const String& WorkingDir, const String& WorldMapFileName, bool bLoadObjs)
 {
-	m_pWorldMapRawMemoryAddress = CSGPWorldMap::LoadWorldMap(m_pWorldMap, WorkingDir, WorldMapFileName);
+	m_pWorldMapMappedFile = CSGPWorldMap::LoadWorldMap(m_pWorldMap, WorkingDir, WorldMapFileName);
 
 	setWorldName( File::getCurrentWorkingDirectory().getChildFile(String(m_pWorldMap->m_Header.m_cFilename)).getFileNameWithoutExtension() );
 
@@ -284,6 +284,9 @@ void COpenGLES2WorldSystemManager::loadWorldFromFile(const String& WorkingDir, c
 			m_SenceObjectArray.add(pObj);
 		}
 
+		Vector4D CamPos;
+		m_pRenderDevice->getCamreaPosition( &CamPos );
+
 		ISGPObject** pEnd = m_SenceObjectArray.end();
 		for( ISGPObject** pBegin = m_SenceObjectArray.begin(); pBegin < pEnd; pBegin++ )
 		{
@@ -293,7 +296,7 @@ void COpenGLES2WorldSystemManager::loadWorldFromFile(const String& WorkingDir, c
 
 			// create mesh instance and add it to map data struct
 			CStaticMeshInstance *pStaticModel = new CStaticMeshInstance(m_pRenderDevice);
-			pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex );
+			pStaticModel->changeModel( String(obj->getMF1FileName()), obj->m_iConfigIndex, getSceneObjectLoadingPriority(obj, CamPos) );
 			pStaticModel->setPosition( obj->m_fPosition[0], obj->m_fPosition[1], obj->m_fPosition[2] );
 			pStaticModel->setRotationXYZ( obj->m_fRotationXYZ[0], obj->m_fRotationXYZ[1], obj->m_fRotationXYZ[2] );
 			pStaticModel->setScale( obj->m_fScale );
@@ -441,6 +444,10 @@ void COpenGLES2WorldSystemManager::updateWorld(float fDeltaTimeInSecond)
 
 	Vector4D CamPos;
 	m_pRenderDevice->getCamreaPosition( &CamPos );
+
+	// Nearer unloaded scene objects will be loaded earlier
+	if( m_pRenderDevice->isResLoadingMultiThread() )
+		updateSceneObjectLoadingPriority( m_pRenderDevice->GetMTResourceLoader(), CamPos );
 	
 	// Update Sky dome
 	m_pRenderDevice->getOpenGLSkydomeRenderer()->update(fDeltaTimeInSecond, m_pSkydome, CamPos);
@@ -450,6 +457,7 @@ void COpenGLES2WorldSystemManager::updateWorld(float fDeltaTimeInSecond)
 
 
 	// get all visible Scene Object and update
+	// This frame time is already counted as skipped time by the invisible update above
 	m_VisibleSceneObjectArray.clearQuick();
 	getVisibleSceneObjectArray(ViewFrustum, m_VisibleChunkArray, m_VisibleSceneObjectArray);
 	
@@ -457,7 +465,7 @@ void COpenGLES2WorldSystemManager::updateWorld(float fDeltaTimeInSecond)
 	for( ISGPObject** pVisibleObjBegin = m_VisibleSceneObjectArray.begin(); pVisibleObjBegin < pVisibleObjEnd; pVisibleObjBegin++ )
 	{
 		m_SceneIDToInstanceMap[(*pVisibleObjBegin)->getSceneObjectID()]->setVisible(true);
-		m_SceneIDToInstanceMap[(*pVisibleObjBegin)->getSceneObjectID()]->update(fDeltaTimeInSecond);
+		m_SceneIDToInstanceMap[(*pVisibleObjBegin)->getSceneObjectID()]->update(0);
 	}
 }
 
@@ -475,7 +483,7 @@ void COpenGLES2WorldSystemManager::shutdownWorld()
 	m_pRenderDevice->getOpenGLGrassRenderer()->releaseGrassTexture();
 
 
-	HashMap<uint32, CStaticMeshInstance*>::Iterator i (m_SceneIDToInstanceMap);
+	FlatHashMap<uint32, CStaticMeshInstance*>::Iterator i (m_SceneIDToInstanceMap);
 	while( i.next() )
 	{
 		CStaticMeshInstance* pInstance = i.getValue();
@@ -504,9 +512,9 @@ void COpenGLES2WorldSystemManager::shutdownWorld()
 		delete m_pGrass;
 	m_pGrass = NULL;
 
-	if( m_pWorldMapRawMemoryAddress )
-		delete [] m_pWorldMapRawMemoryAddress;
-	m_pWorldMapRawMemoryAddress = NULL;
+	if( m_pWorldMapMappedFile )
+		delete m_pWorldMapMappedFile;
+	m_pWorldMapMappedFile = NULL;
 }
 
 void COpenGLES2WorldSystemManager::renderWorld()
@@ -818,7 +826,7 @@ void COpenGLES2WorldSystemManager::releaseTerrainRenderer()
 	}
 }
 
-void COpenGLES2WorldSystemManager::getVisibleSceneObjectArray(const Frustum& ViewFrustum, const Array<CSGPTerrainChunk*>& VisibleChunkArray, Array<ISGPObject*>& VisibleSceneObjectArray)
+void COpenGLES2WorldSystemManager::getVisibleSceneObjectArray(const Frustum& ViewFrustum, const FrameTerrainChunkArray& VisibleChunkArray, Array<ISGPObject*>& VisibleSceneObjectArray)
 {
 	Frustum MirroredViewFrustum;
 	if( needRenderWater() )
@@ -827,6 +835,10 @@ void COpenGLES2WorldSystemManager::getVisibleSceneObjectArray(const Frustum& Vie
 	}
 
 
+	// Collect bounding box of objects in visible chunks, they are culled in one batch
+	m_SceneObjectBounds.clear();
+	m_SceneObjectCandidates.clearQuick();
+
 	CSGPTerrainChunk** pEnd = VisibleChunkArray.end();
 	for( CSGPTerrainChunk** pBegin = VisibleChunkArray.begin(); pBegin < pEnd; pBegin++ )
 	{
@@ -837,12 +849,27 @@ void COpenGLES2WorldSystemManager::getVisibleSceneObjectArray(const Frustum& Vie
 		{
 			AABBox objAABB;
 			objAABB.Construct( &((*pObjBegin)->getBoundingBox()) );
-			if( objAABB.Intersects(ViewFrustum) )
-				VisibleSceneObjectArray.addIfNotAlreadyThere(*pObjBegin);
-			if( needRenderWater() && objAABB.Intersects(MirroredViewFrustum) )
-				VisibleSceneObjectArray.addIfNotAlreadyThere(*pObjBegin);
+			m_SceneObjectBounds.add( objAABB );
+			m_SceneObjectCandidates.add( *pObjBegin );
 		}
 	}
+
+	const int nNumMask = (m_SceneObjectBounds.size() + 31) / 32;
+	m_SceneObjectVisibleMask.resize( nNumMask );
+	m_SceneObjectBounds.cullToMask( ViewFrustum, m_SceneObjectVisibleMask.getRawDataPointer() );
+	if( needRenderWater() )
+	{
+		m_SceneObjectMirroredVisibleMask.resize( nNumMask );
+		m_SceneObjectBounds.cullToMask( MirroredViewFrustum, m_SceneObjectMirroredVisibleMask.getRawDataPointer() );
+		for( int i=0; i<nNumMask; i++ )
+			m_SceneObjectVisibleMask.getReference(i) |= m_SceneObjectMirroredVisibleMask[i];
+	}
+
+	for( int i=0; i<m_SceneObjectCandidates.size(); i++ )
+	{
+		if( m_SceneObjectVisibleMask[i >> 5] & (1u << (i & 31)) )
+			VisibleSceneObjectArray.addIfNotAlreadyThere( m_SceneObjectCandidates[i] );
+	}
 }
 
 void COpenGLES2WorldSystemManager::initializeWaterRenderer()
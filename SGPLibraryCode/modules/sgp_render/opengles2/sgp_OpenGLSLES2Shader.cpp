@@ -115,6 +115,9 @@ void COpenGLSLES2ShaderProgram::deleteProgram()
 		return;
 	m_bLinked = false;
 	glDeleteProgram(m_ProgramID);
+
+	m_Uniforms.clear();
+	m_UniformShadow.free();
 }
 
 bool COpenGLSLES2ShaderProgram::addShaderToProgram(COpenGLSLES2Shader* pShader)
@@ -171,6 +174,8 @@ bool COpenGLSLES2ShaderProgram::linkProgram()
 	m_bLinked = true;
 #endif
 
+	buildUniformTable();
+
 	return m_bLinked;
 }
 
@@ -183,87 +188,185 @@ void COpenGLSLES2ShaderProgram::useProgram()
 	}
 }
 
+void COpenGLSLES2ShaderProgram::buildUniformTable()
+{
+	m_Uniforms.clear();
+
+	GLint iNumUniforms = 0;
+	GLint iMaxNameLength = 0;
+	glGetProgramiv(m_ProgramID, GL_ACTIVE_UNIFORMS, &iNumUniforms);
+	glGetProgramiv(m_ProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &iMaxNameLength);
+
+	HeapBlock<GLchar> Name(iMaxNameLength + 1);
+	int iShadowSize = 0;
+
+	for( GLint i=0; i<iNumUniforms; i++ )
+	{
+		GLsizei iLength = 0;
+		GLint iArraySize = 0;
+		GLenum Type = 0;
+		glGetActiveUniform(m_ProgramID, i, iMaxNameLength + 1, &iLength, &iArraySize, &Type, Name);
+		Name[iLength] = 0;
+
+		// Built-in uniforms have no location
+		if( strncmp(Name, "gl_", 3) == 0 )
+			continue;
+
+		// Array uniform is reported as "name[0]"
+		if( (iLength > 3) && (strcmp(Name + iLength - 3, "[0]") == 0) )
+		{
+			iLength -= 3;
+			Name[iLength] = 0;
+		}
+
+		SGLSLUniform Uniform;
+		Uniform.Name = String(Name.getData());
+		Uniform.NameHash = getUniformNameHash(Name, iLength);
+		Uniform.Location = glGetUniformLocation(m_ProgramID, Name);
+		Uniform.ShadowOffset = iShadowSize;
+		Uniform.ShadowCapacity = iArraySize * sizeof(Matrix4x4);
+		Uniform.ShadowElementSize = 0;
+		Uniform.ShadowBytes = 0;
+
+		iShadowSize += Uniform.ShadowCapacity;
+		m_Uniforms.add(Uniform);
+	}
+
+	m_UniformShadow.allocate(jmax(iShadowSize, 1), true);
+}
+
+uint32 COpenGLSLES2ShaderProgram::getUniformNameHash(const char* sName, int iLength)
+{
+	uint32 Hash = 0;
+	for( int i=0; i<iLength; i++ )
+		Hash = Hash * 31 + (uint8)sName[i];
+	return Hash;
+}
+
+int COpenGLSLES2ShaderProgram::findUniform(const char* sName) const
+{
+	int iLength = (int)strlen(sName);
+	if( (iLength > 3) && (strcmp(sName + iLength - 3, "[0]") == 0) )
+		iLength -= 3;
+
+	const uint32 Hash = getUniformNameHash(sName, iLength);
+	for( int i=0; i<m_Uniforms.size(); i++ )
+	{
+		const SGLSLUniform& Uniform = m_Uniforms.getReference(i);
+		if( (Uniform.NameHash == Hash) &&
+			(strncmp(Uniform.Name.getCharPointer().getAddress(), sName, iLength) == 0) &&
+			(Uniform.Name.length() == iLength) )
+			return i;
+	}
+	return -1;
+}
+
+bool COpenGLSLES2ShaderProgram::updateUniformShadow(int iUniform, const void* pValues, int iElementSize, int32 iCount)
+{
+	SGLSLUniform& Uniform = m_Uniforms.getReference(iUniform);
+	const int iBytes = iElementSize * iCount;
+
+	// Values not fitting in shadow copy are always uploaded
+	if( iBytes > Uniform.ShadowCapacity )
+	{
+		Uniform.ShadowBytes = 0;
+		return true;
+	}
+
+	uint8* pShadow = m_UniformShadow + Uniform.ShadowOffset;
+	if( (Uniform.ShadowElementSize == iElementSize) && (iBytes <= Uniform.ShadowBytes) &&
+		(memcmp(pShadow, pValues, iBytes) == 0) )
+		return false;
+
+	memcpy(pShadow, pValues, iBytes);
+	if( Uniform.ShadowElementSize != iElementSize )
+		Uniform.ShadowBytes = 0;
+	Uniform.ShadowElementSize = iElementSize;
+	Uniform.ShadowBytes = jmax(Uniform.ShadowBytes, iBytes);
+	return true;
+}
+
 // Setting vectors
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, const Vector2D& vVector)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform2fv(Location, 1, &(vVector.x));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, &(vVector.x), sizeof(Vector2D), 1) )
+		glUniform2fv(m_Uniforms.getReference(iUniform).Location, 1, &(vVector.x));
 }
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, Vector2D* vVectors, int32 iCount)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform2fv(Location, iCount, (GLfloat*)(vVectors));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, (GLfloat*)(vVectors), sizeof(Vector2D), iCount) )
+		glUniform2fv(m_Uniforms.getReference(iUniform).Location, iCount, (GLfloat*)(vVectors));
 }
 
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, const Vector3D& vVector)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform3fv(Location, 1, &(vVector.x));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, &(vVector.x), sizeof(Vector3D), 1) )
+		glUniform3fv(m_Uniforms.getReference(iUniform).Location, 1, &(vVector.x));
 }
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, Vector3D* vVectors, int32 iCount)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform3fv(Location, iCount, (GLfloat*)(vVectors));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, (GLfloat*)(vVectors), sizeof(Vector3D), iCount) )
+		glUniform3fv(m_Uniforms.getReference(iUniform).Location, iCount, (GLfloat*)(vVectors));
 }
 
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, const Vector4D& vVector)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform4fv(Location, 1, &(vVector.x));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, &(vVector.x), sizeof(Vector4D), 1) )
+		glUniform4fv(m_Uniforms.getReference(iUniform).Location, 1, &(vVector.x));
 }
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, Vector4D* vVectors, int32 iCount)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform4fv(Location, iCount, (GLfloat*)(vVectors));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, (GLfloat*)(vVectors), sizeof(Vector4D), iCount) )
+		glUniform4fv(m_Uniforms.getReference(iUniform).Location, iCount, (GLfloat*)(vVectors));
 }
 
 // Setting floats
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, float* fValues, int32 iCount)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform1fv(Location, iCount, fValues);
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, fValues, sizeof(float), iCount) )
+		glUniform1fv(m_Uniforms.getReference(iUniform).Location, iCount, fValues);
 }
 
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, const float fValue)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform1fv(Location, 1, &fValue);
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, &fValue, sizeof(float), 1) )
+		glUniform1fv(m_Uniforms.getReference(iUniform).Location, 1, &fValue);
 }
 
 // Setting 4x4 matrices
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, Matrix4x4* mMatrices, int32 iCount)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniformMatrix4fv(Location, iCount, false, (GLfloat*)mMatrices);
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, (GLfloat*)mMatrices, sizeof(Matrix4x4), iCount) )
+		glUniformMatrix4fv(m_Uniforms.getReference(iUniform).Location, iCount, false, (GLfloat*)mMatrices);
 }
 
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, const Matrix4x4& mMatrix)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniformMatrix4fv(Location, 1, false, (GLfloat*)(&mMatrix._11));
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, (GLfloat*)(&mMatrix._11), sizeof(Matrix4x4), 1) )
+		glUniformMatrix4fv(m_Uniforms.getReference(iUniform).Location, 1, false, (GLfloat*)(&mMatrix._11));
 }
 
 // Setting integers
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, int32* iValues, int32 iCount)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform1iv(Location, iCount, iValues);
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, iValues, sizeof(int32), iCount) )
+		glUniform1iv(m_Uniforms.getReference(iUniform).Location, iCount, iValues);
 }
 
 void COpenGLSLES2ShaderProgram::setShaderUniform(const char* sName, const int32 iValue)
 {
-	GLint Location = 0;
-	Location = glGetUniformLocation(m_ProgramID, sName);
-	glUniform1iv(Location, 1, &iValue);
-}
\ No newline at end of file
+	const int iUniform = findUniform(sName);
+	if( (iUniform >= 0) && updateUniformShadow(iUniform, &iValue, sizeof(int32), 1) )
+		glUniform1iv(m_Uniforms.getReference(iUniform).Location, 1, &iValue);
+}
@@ -19,6 +19,11 @@
 		primitives. */
 		SGPDT_OPENGLES2,
 
+		//! Null device, available on all platforms.
+		/** Creates no window, context or API objects, all submitted
+		work is written to a command log. Used for headless benchmarks and tests. */
+		SGPDT_NULL,
+
 		//! No driver, just for counting the elements
 		SGPDT_COUNT
 	};
@@ -0,0 +1,111 @@
+
+CSGPRenderQueue::CSGPRenderQueue(int iNumLists, int iInitPacketNum)
+	: m_iCurrentBuffer(0), m_iNumPackets(0), m_iCapacity(0), m_iNumLists(iNumLists)
+{
+	m_ListStart.calloc(iNumLists + 1);
+	m_ListOffset.calloc(iNumLists);
+	m_Histogram.calloc(RADIX_SIZE);
+	ensurePacketCapacity(jmax(iInitPacketNum, 1));
+}
+
+CSGPRenderQueue::~CSGPRenderQueue()
+{
+}
+
+void CSGPRenderQueue::ensurePacketCapacity(int iNumPackets)
+{
+	if( iNumPackets <= m_iCapacity )
+		return;
+
+	m_iCapacity = jmax(iNumPackets, m_iCapacity * 2);
+	m_Buffers[0].realloc(m_iCapacity);
+	m_Buffers[1].realloc(m_iCapacity);
+}
+
+void CSGPRenderQueue::clear()
+{
+	m_iNumPackets = 0;
+	m_iCurrentBuffer = 0;
+	for( int i=0; i<=m_iNumLists; i++ )
+		m_ListStart[i] = 0;
+}
+
+void CSGPRenderQueue::add(uint32 ListIndex, uint64 QueueValue, uint32 BatchIndex)
+{
+	jassert( (int)ListIndex < m_iNumLists );
+
+	ensurePacketCapacity(m_iNumPackets + 1);
+
+	SGPRenderPacket& Packet = m_Buffers[m_iCurrentBuffer][m_iNumPackets++];
+	Packet.QueueValue = QueueValue;
+	Packet.BatchIndex = BatchIndex;
+	Packet.ListIndex = ListIndex;
+}
+
+void CSGPRenderQueue::sort()
+{
+	if( m_iNumPackets == 0 )
+		return;
+
+	// Find bits which are not the same in all queue values, digits without them need no pass
+	const SGPRenderPacket* pSrc = m_Buffers[m_iCurrentBuffer];
+	uint64 KeyAnd = pSrc[0].QueueValue;
+	uint64 KeyOr = pSrc[0].QueueValue;
+	for( int i=1; i<m_iNumPackets; i++ )
+	{
+		KeyAnd &= pSrc[i].QueueValue;
+		KeyOr |= pSrc[i].QueueValue;
+	}
+	const uint64 KeyDiff = KeyAnd ^ KeyOr;
+
+	// LSD radix sort of queue value, one stable counting pass per digit
+	for( int d=0; d<RADIX_DIGITS; d++ )
+	{
+		const int iShift = d * RADIX_BITS;
+		if( ((KeyDiff >> iShift) & RADIX_MASK) == 0 )
+			continue;
+
+		uint32* pCount = m_Histogram;
+		memset(pCount, 0, sizeof(uint32) * RADIX_SIZE);
+		for( int i=0; i<m_iNumPackets; i++ )
+			pCount[(uint32)(pSrc[i].QueueValue >> iShift) & RADIX_MASK]++;
+
+		uint32 Offset = 0;
+		for( int j=0; j<RADIX_SIZE; j++ )
+		{
+			uint32 Count = pCount[j];
+			pCount[j] = Offset;
+			Offset += Count;
+		}
+
+		SGPRenderPacket* pDst = m_Buffers[1 - m_iCurrentBuffer];
+		for( int i=0; i<m_iNumPackets; i++ )
+			pDst[ pCount[(uint32)(pSrc[i].QueueValue >> iShift) & RADIX_MASK]++ ] = pSrc[i];
+
+		m_iCurrentBuffer = 1 - m_iCurrentBuffer;
+		pSrc = pDst;
+	}
+
+	// Group packets by render list, also a stable counting pass
+	for( int i=0; i<=m_iNumLists; i++ )
+		m_ListStart[i] = 0;
+	for( int i=0; i<m_iNumPackets; i++ )
+		m_ListStart[pSrc[i].ListIndex + 1]++;
+
+	bool bOneList = false;
+	for( int i=0; i<m_iNumLists; i++ )
+	{
+		bOneList = bOneList || (m_ListStart[i+1] == m_iNumPackets);
+		m_ListStart[i+1] += m_ListStart[i];
+		m_ListOffset[i] = m_ListStart[i];
+	}
+
+	if( bOneList )
+		return;
+
+	SGPRenderPacket* pDst = m_Buffers[1 - m_iCurrentBuffer];
+	for( int i=0; i<m_iNumPackets; i++ )
+		pDst[ m_ListOffset[pSrc[i].ListIndex]++ ] = pSrc[i];
+
+	m_iCurrentBuffer = 1 - m_iCurrentBuffer;
+}
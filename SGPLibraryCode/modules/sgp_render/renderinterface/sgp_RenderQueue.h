@@ -0,0 +1,63 @@
+#ifndef __SGP_RENDERQUEUE_HEADER__
+#define __SGP_RENDERQUEUE_HEADER__
+
+/**
+	Draw packet of render queue (16 bytes)
+	The batch parameters (matrices, buffers...) stay in the render batch pool,
+	the packet only refers to them by index.
+*/
+struct SGPRenderPacket
+{
+	uint64	QueueValue;		// 64 bit sort key built by render batch
+	uint32	BatchIndex;		// Index of render batch in its pool
+	uint32	ListIndex;		// Render list (drawing stage) of the batch
+};
+
+/**
+	Render queue of all render batches in one frame.
+	sort() orders packets by render list, then by queue value with a LSD radix sort
+	(one counting pass per 11 bit digit, digits which are the same in all packets are skipped).
+	Packets with the same list and queue value keep the order they were added.
+	Packet buffers only grow, so there is no heap allocation once the queue has warmed up.
+*/
+class CSGPRenderQueue
+{
+public:
+	CSGPRenderQueue(int iNumLists, int iInitPacketNum);
+	~CSGPRenderQueue();
+
+	void clear();
+	void add(uint32 ListIndex, uint64 QueueValue, uint32 BatchIndex);
+	void sort();
+
+	inline int size() const										{ return m_iNumPackets; }
+	inline const SGPRenderPacket& getPacket(int index) const	{ return m_Buffers[m_iCurrentBuffer][index]; }
+
+	// Packets of a render list are from getListStart() to getListEnd()-1 after sorting
+	inline int getListStart(int ListIndex) const	{ return m_ListStart[ListIndex]; }
+	inline int getListEnd(int ListIndex) const		{ return m_ListStart[ListIndex+1]; }
+	inline int getListSize(int ListIndex) const		{ return m_ListStart[ListIndex+1] - m_ListStart[ListIndex]; }
+
+private:
+	// 64 bit queue value is sorted in 6 digits of 11 bits
+	static const int RADIX_BITS = 11;
+	static const int RADIX_DIGITS = 6;
+	static const int RADIX_SIZE = 1 << RADIX_BITS;
+	static const uint32 RADIX_MASK = RADIX_SIZE - 1;
+
+	void ensurePacketCapacity(int iNumPackets);
+
+	HeapBlock<SGPRenderPacket>	m_Buffers[2];		// Packets and sorting buffer
+	int							m_iCurrentBuffer;	// Which buffer holds the packets
+	int							m_iNumPackets;
+	int							m_iCapacity;
+
+	int							m_iNumLists;
+	HeapBlock<int>				m_ListStart;		// m_iNumLists + 1 entries
+	HeapBlock<int>				m_ListOffset;		// Write position of each list when sorting
+	HeapBlock<uint32>			m_Histogram;		// Digit histogram when sorting
+
+	SGP_DECLARE_NON_COPYABLE (CSGPRenderQueue)
+};
+
+#endif		// __SGP_RENDERQUEUE_HEADER__
@@ -1,197 +1,340 @@
+CSGPResourceLoaderMuitiThread::CSGPResourceLoaderMuitiThread(ISGPRenderDevice* pDevice)
+	: m_pDevice(pDevice), m_LoadingScheduler( jmax(1, SystemStats::getNumCpus() - 1) ), m_LoadingJob(*this),
+	  m_SyncBudgetInMs(DEFAULT_SYNC_BUDGET_MS), m_SyncBudgetInBytes(DEFAULT_SYNC_BUDGET_BYTES),
+	  m_LastSyncCreatedModels(0), m_LastSyncCreatedTextures(0), m_LastSyncUploadedBytes(0), m_LastSyncTimeInMs(0)
+{
+	SGP_LOG_INFO("Create Resource Loading Workers : " << getNumWorkerThreads());
+}
 
+CSGPResourceLoaderMuitiThread::~CSGPResourceLoaderMuitiThread()
+{
+	SGP_LOG_INFO("Shutdown Resource Loading Jobs");
 
-void CSGPResourceLoaderMuitiThread::run()
+	waitForLoadingJobs();
+
+	removeAll();
+}
+
+void CSGPResourceLoaderMuitiThread::waitForLoadingJobs()
 {
-    // this is the code that runs this thread - we'll loop continuously,
+	// Jobs still queued return at once, running ones finish the file they are loading
+	m_bShutdown = 1;
+	m_LoadingScheduler.waitForCounter(m_LoadingJobCounter);
+}
 
-    // threadShouldExit() returns true when the stopThread() method has been
-    // called, so we should check it often, and exit as soon as it gets flagged.
-    while (! threadShouldExit())
-    {
-        // sleep a bit so the threads don't all grind the CPU to a halt..
-        wait (interval);
+void CSGPResourceLoaderMuitiThread::addLoadingJob()
+{
+	m_LoadingScheduler.addJob(&m_LoadingJob, &m_LoadingJobCounter);
+}
 
+void CSGPResourceLoaderMuitiThread::runLoadingJob()
+{
+	if( m_bShutdown.get() != 0 )
+		return;
+
+	SGPLoadingJob job;
+
+	{
 		const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
+		// Cancelled records leave jobs with nothing to load
+		if( !popLoadingJob(job) )
+			return;
+	}
 
-		// Deleting
-		// DO Release models
-		for( int i=0; i<m_DeletingModels.size(); i++ )
-		{
-			if( !m_DeletingModels.getReference(i).pMF1Resource )
-				continue;
-			if( m_DeletingModels.getReference(i).bReady )
-				continue;
-			if( m_DeletingModels.getReference(i).pMF1Resource->getReferenceCount() > 0 )
-			{
-				m_DeletingModels.remove(i);
-				i--;
-				continue;
-			}
-			if( m_pDevice->getRenderDeviceTime() - m_DeletingModels.getReference(i).pMF1Resource->deleteTimeStamp > RESOURCE_BONE_TO_FREE_KEEPTIME )
-			{
-				Logger::getCurrentLogger()->writeToLog(String("Delete MF1 Model in Other Thread") + m_DeletingModels.getReference(i).MF1AbsoluteFileName, ELL_INFORMATION);
+	// Disk I/O, resourceArrayLock is NOT held here
+	if( job.bModel )
+		loadModel(job);
+	else
+		loadTexture(job);
+}
 
-				// Immediately, try to unRegisterMT used textures			
-				m_pDevice->GetModelManager()->unRegisterSkinTexturesMT(m_DeletingModels.getReference(i).pMF1Resource);
+bool CSGPResourceLoaderMuitiThread::popLoadingJob(SGPLoadingJob& job)
+{
+	int bestModel = -1;
+	int bestTexture = -1;
+	int numPending = 0;
 
-				// Setting flags, In Render Thread, will release render resource				
-				m_DeletingModels.getReference(i).bReady = true;
-			}
-		}
+	for( int i=0; i<m_LoadingModels.size(); i++ )
+	{
+		const SGPModelRecord& Record = m_LoadingModels.getReference(i);
+		if( Record.bLoading )
+			continue;
+		numPending++;
+		if( (bestModel == -1) || (Record.fPriority < m_LoadingModels.getReference(bestModel).fPriority) )
+			bestModel = i;
+	}
+	for( int i=0; i<m_LoadingTextures.size(); i++ )
+	{
+		const SGPTextureRecord& Record = m_LoadingTextures.getReference(i);
+		if( Record.bLoading )
+			continue;
+		numPending++;
+		if( (bestTexture == -1) || (Record.fPriority < m_LoadingTextures.getReference(bestTexture).fPriority) )
+			bestTexture = i;
+	}
 
-		// Do Release Textures
-		for( int i=0; i<m_DeletingTextures.size(); i++ )
-		{
-			if( !m_DeletingTextures.getReference(i).pTexResource )
-				continue;
-			if( m_DeletingTextures.getReference(i).bReady )
-				continue;
+	if( numPending == 0 )
+		return false;
 
-			if( m_DeletingTextures.getReference(i).pTexResource->getReferenceCount() > 0 )
-			{
-				m_DeletingTextures.remove(i);
-				i--;
-				continue;
-			}
-			if( m_pDevice->getRenderDeviceTime() - m_DeletingTextures.getReference(i).pTexResource->deleteTimeStamp > RESOURCE_BONE_TO_FREE_KEEPTIME )
-			{
-				// Setting flags, In Render Thread, will release render resource
-				// Also Remove StringToTextureIDMap and TextureArray in TextureManager
-				Logger::getCurrentLogger()->writeToLog(String("Delete texture in Other Thread") + m_DeletingTextures.getReference(i).TexFileName, ELL_INFORMATION);
-				m_DeletingTextures.getReference(i).bReady = true;
-			}
-		}
-			
+	if( (bestModel != -1) &&
+		((bestTexture == -1) || (m_LoadingModels.getReference(bestModel).fPriority <= m_LoadingTextures.getReference(bestTexture).fPriority)) )
+	{
+		SGPModelRecord& Record = m_LoadingModels.getReference(bestModel);
+		Record.bLoading = true;
 
+		job.FileName = Record.MF1AbsoluteFileName;
+		job.BF1FileIndex = Record.BF1FileIndex;
+		job.fPriority = Record.fPriority;
+		job.bModel = true;
+	}
+	else
+	{
+		SGPTextureRecord& Record = m_LoadingTextures.getReference(bestTexture);
+		Record.bLoading = true;
 
-		// Loading
-		// Do Load Models
-		for( int i=0; i<m_DeletingModels.size(); i++ )
+		job.FileName = Record.TexFileName;
+		job.fPriority = Record.fPriority;
+		job.bModel = false;
+	}
+	return true;
+}
+
+void CSGPResourceLoaderMuitiThread::processDeletingRecords()
+{
+	// Deleting
+	// DO Release models
+	for( int i=0; i<m_DeletingModels.size(); i++ )
+	{
+		if( !m_DeletingModels.getReference(i).pMF1Resource )
+			continue;
+		if( m_DeletingModels.getReference(i).bReady )
+			continue;
+		if( m_DeletingModels.getReference(i).pMF1Resource->getReferenceCount() > 0 )
 		{
-			if( m_DeletingModels.getReference(i).pMF1Resource != NULL )
-				continue;
-			else
-			{
-				int idx = m_LoadingModels.indexOf( m_DeletingModels.getReference(i) );
-				if( idx != -1 )
-				{
-					if(	m_LoadingModels.getReference(idx).nRefCount > 0 )
-						m_LoadingModels.getReference(idx).nRefCount--;
-					else
-					{
-						m_LoadingModels.remove(idx);
-						m_DeletingModels.remove(i);
-						i--;
-					}
-				}
-			}
+			m_DeletingModels.remove(i);
+			i--;
+			continue;
 		}
-		for( int i=0; i<m_LoadingModels.size(); i++ )
+		if( m_pDevice->getRenderDeviceTime() - m_DeletingModels.getReference(i).pMF1Resource->deleteTimeStamp > RESOURCE_BONE_TO_FREE_KEEPTIME )
 		{
-			if( m_LoadingModels.getReference(i).bReady )
-				continue;
-			//Load Raw MF1 file data 
-			m_LoadingModels.getReference(i).pMF1Resource = new CMF1FileResource();
-			m_LoadingModels.getReference(i).pMF1Resource->pMF1RawMemoryAddress = 
-				CSGPModelMF1::LoadMF1( 	m_LoadingModels.getReference(i).pMF1Resource->pModelMF1,
-										m_pDevice->GetModelManager()->getWorkingDirection(),
-										m_LoadingModels.getReference(i).MF1AbsoluteFileName );
-			if( m_LoadingModels.getReference(i).BF1FileIndex != 0xFFFF )
-			{
-				String BoneAnimFileName = m_LoadingModels.getReference(i).MF1AbsoluteFileName.dropLastCharacters(3) + String( "bf1" );		
-				m_LoadingModels.getReference(i).pMF1Resource->pBF1RawMemoryAddress.add(
-					CSGPModelMF1::LoadBone(	m_LoadingModels.getReference(i).pMF1Resource->pModelMF1,
-											m_pDevice->GetModelManager()->getWorkingDirection(),
-											BoneAnimFileName, 0 ) );
-			}
+			SGP_LOG_INFO("Delete MF1 Model in Other Thread" << m_DeletingModels.getReference(i).MF1AbsoluteFileName);
 
-			// If MF1 files can not be opened, delete this Model Resource
-			if( !m_LoadingModels.getReference(i).pMF1Resource->pMF1RawMemoryAddress )
-			{
-				delete m_LoadingModels.getReference(i).pMF1Resource;
-				m_LoadingModels.getReference(i).pMF1Resource = NULL;
-				m_LoadingModels.remove(i);
-				i--;
-			}
-			else
-			{
-				Logger::getCurrentLogger()->writeToLog(String("Loading MF1 Model in Other Thread : ") + m_LoadingModels.getReference(i).MF1AbsoluteFileName, ELL_INFORMATION);
-				
-				// Immediately, try to registerMT used textures			
-				m_pDevice->GetModelManager()->registerSkinTexturesMT(m_LoadingModels.getReference(i).pMF1Resource);
+			// Immediately, try to unRegisterMT used textures			
+			m_pDevice->GetModelManager()->unRegisterSkinTexturesMT(m_DeletingModels.getReference(i).pMF1Resource);
 
-				// Setting flags, In Render Thread, will create render resource			
-				m_LoadingModels.getReference(i).bReady = true;
-			}
+			// Setting flags, In Render Thread, will release render resource				
+			m_DeletingModels.getReference(i).bReady = true;
 		}
+	}
 
-		// Loading
-		// Do Load Textures
-		for( int i=0; i<m_DeletingTextures.size(); i++ )
+	// Do Release Textures
+	for( int i=0; i<m_DeletingTextures.size(); i++ )
+	{
+		if( !m_DeletingTextures.getReference(i).pTexResource )
+			continue;
+		if( m_DeletingTextures.getReference(i).bReady )
+			continue;
+
+		if( m_DeletingTextures.getReference(i).pTexResource->getReferenceCount() > 0 )
 		{
-			if( m_DeletingTextures.getReference(i).pTexResource != NULL )
-				continue;
-			else
-			{
-				int idx = m_LoadingTextures.indexOf( m_DeletingTextures.getReference(i) );
-				if( idx != -1 )
-				{
-					if( m_LoadingTextures.getReference(idx).nRefCount > 0 )
-						m_LoadingTextures.getReference(idx).nRefCount--;
-					else
-					{
-						m_LoadingTextures.remove(idx);
-						m_DeletingTextures.remove(i);
-						i--;
-					}
-				}
-			}
+			m_DeletingTextures.remove(i);
+			i--;
+			continue;
+		}
+		if( m_pDevice->getRenderDeviceTime() - m_DeletingTextures.getReference(i).pTexResource->deleteTimeStamp > RESOURCE_BONE_TO_FREE_KEEPTIME )
+		{
+			// Setting flags, In Render Thread, will release render resource
+			// Also Remove StringToTextureIDMap and TextureArray in TextureManager
+			SGP_LOG_INFO("Delete texture in Other Thread" << m_DeletingTextures.getReference(i).TexFileName);
+			m_DeletingTextures.getReference(i).bReady = true;
 		}
+	}
+
+	// Cancel loaded models which are unregistered before render resource created
+	// (not loaded ones have been cancelled in addDeletingModel)
+	for( int i=0; i<m_DeletingModels.size(); i++ )
+	{
+		if( m_DeletingModels.getReference(i).pMF1Resource != NULL )
+			continue;
 
-		for( int i=0; i<m_LoadingTextures.size(); i++ )
+		int idx = m_ReadyModels.indexOf( m_DeletingModels.getReference(i) );
+		if( idx == -1 )
+			continue;
+
+		SGPModelRecord& ReadyRecord = m_ReadyModels.getReference(idx);
+		if(	ReadyRecord.nRefCount > 0 )
+			ReadyRecord.nRefCount--;
+		else
 		{
-			if( m_LoadingTextures.getReference(i).bReady )
-				continue;
-			//Load Raw texture data
-			m_LoadingTextures.getReference(i).pTexResource = new CTextureResource();
-			m_LoadingTextures.getReference(i).pTexResource->pSGPImage = m_pDevice->GetTextureManager()->createImageFromFile(m_LoadingTextures.getReference(i).TexFileName);
-			
-			// If texture files can not be opened, delete this texture Resource
-			if( !m_LoadingTextures.getReference(i).pTexResource->pSGPImage )
-			{
-				delete m_LoadingTextures.getReference(i).pTexResource;
-				m_LoadingTextures.getReference(i).pTexResource = NULL;
-				m_LoadingTextures.remove(i);
-				i--;
-			}
-			else
-			{
-				Logger::getCurrentLogger()->writeToLog(String("Loading texture in Other Thread : ") + m_LoadingTextures.getReference(i).TexFileName, ELL_INFORMATION);
+			m_pDevice->GetModelManager()->unRegisterSkinTexturesMT(ReadyRecord.pMF1Resource);
+			delete ReadyRecord.pMF1Resource;
+			m_ReadyModels.remove(idx);
+		}
+		m_DeletingModels.remove(i);
+		i--;
+	}
 
-				// Setting flags, In Render Thread, will create render resource
-				m_LoadingTextures.getReference(i).bReady = true;
-			}
+	// Cancel loaded textures which are unregistered before render resource created
+	for( int i=0; i<m_DeletingTextures.size(); i++ )
+	{
+		if( m_DeletingTextures.getReference(i).pTexResource != NULL )
+			continue;
+
+		int idx = m_ReadyTextures.indexOf( m_DeletingTextures.getReference(i) );
+		if( idx == -1 )
+			continue;
+
+		SGPTextureRecord& ReadyRecord = m_ReadyTextures.getReference(idx);
+		if( ReadyRecord.nRefCount > 0 )
+			ReadyRecord.nRefCount--;
+		else
+		{
+			delete ReadyRecord.pTexResource->pSGPImage;
+			delete ReadyRecord.pTexResource;
+			m_ReadyTextures.remove(idx);
 		}
-    }
+		m_DeletingTextures.remove(i);
+		i--;
+	}
+}
+
+void CSGPResourceLoaderMuitiThread::loadModel(const SGPLoadingJob& job)
+{
+	//Load Raw MF1 file data 
+	CMF1FileResource* pMF1Resource = new CMF1FileResource();
+	pMF1Resource->pMF1MappedFile = 
+		CSGPModelMF1::LoadMF1( 	pMF1Resource->pModelMF1,
+								m_pDevice->GetModelManager()->getWorkingDirection(),
+								job.FileName );
+	if( pMF1Resource->pMF1MappedFile && (job.BF1FileIndex != 0xFFFF) )
+	{
+		String BoneAnimFileName = job.FileName.dropLastCharacters(3) + String( "bf1" );		
+		pMF1Resource->pBF1MappedFiles.add(
+			CSGPModelMF1::LoadBone(	pMF1Resource->pModelMF1,
+									m_pDevice->GetModelManager()->getWorkingDirection(),
+									BoneAnimFileName, 0 ) );
+	}
+
+	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
+
+	SGPModelRecord Record;
+	Record.MF1AbsoluteFileName = job.FileName;
+	int idx = m_LoadingModels.indexOf( Record );
+
+	// If MF1 files can not be opened, delete this Model Resource
+	if( !pMF1Resource->pMF1MappedFile )
+	{
+		delete pMF1Resource;
+		pMF1Resource = NULL;
+		if( idx != -1 )
+			m_LoadingModels.remove(idx);
+		return;
+	}
+
+	// Cancelled during loading
+	if( idx == -1 )
+	{
+		delete pMF1Resource;
+		pMF1Resource = NULL;
+		return;
+	}
+
+	SGP_LOG_INFO("Loading MF1 Model in Other Thread : " << job.FileName);
+
+	SGPModelRecord ReadyRecord = m_LoadingModels.remove(idx);
+	ReadyRecord.pMF1Resource = pMF1Resource;
+
+	// Immediately, try to registerMT used textures			
+	m_pDevice->GetModelManager()->registerSkinTexturesMT(pMF1Resource, ReadyRecord.fPriority);
+
+	// Setting flags, In Render Thread, will create render resource			
+	ReadyRecord.bReady = true;
+	ReadyRecordSorter sorter;
+	m_ReadyModels.addSorted(sorter, ReadyRecord);
+}
+
+void CSGPResourceLoaderMuitiThread::loadTexture(const SGPLoadingJob& job)
+{
+	//Load Raw texture data
+	CTextureResource* pTexResource = new CTextureResource();
+	pTexResource->pSGPImage = m_pDevice->GetTextureManager()->createImageFromFile(job.FileName);
+
+	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
+
+	SGPTextureRecord Record;
+	Record.TexFileName = job.FileName;
+	int idx = m_LoadingTextures.indexOf( Record );
+
+	// If texture files can not be opened, delete this texture Resource
+	if( !pTexResource->pSGPImage )
+	{
+		delete pTexResource;
+		pTexResource = NULL;
+		if( idx != -1 )
+			m_LoadingTextures.remove(idx);
+		return;
+	}
+
+	// Cancelled during loading
+	if( idx == -1 )
+	{
+		delete pTexResource->pSGPImage;
+		pTexResource->pSGPImage = NULL;
+		delete pTexResource;
+		pTexResource = NULL;
+		return;
+	}
+
+	SGP_LOG_INFO("Loading texture in Other Thread : " << job.FileName);
+
+	SGPTextureRecord ReadyRecord = m_LoadingTextures.remove(idx);
+	ReadyRecord.pTexResource = pTexResource;
+
+	// Setting flags, In Render Thread, will create render resource
+	ReadyRecord.bReady = true;
+	ReadyRecordSorter sorter;
+	m_ReadyTextures.addSorted(sorter, ReadyRecord);
 }
 
 
-void CSGPResourceLoaderMuitiThread::addLoadingTexture(const String& texturename, bool bGenMipMap)
+void CSGPResourceLoaderMuitiThread::addLoadingTexture(const String& texturename, bool bGenMipMap, float fPriority)
 {
 	SGPTextureRecord Record;
 	Record.TexFileName = texturename;
 	Record.bGenMipMap = bGenMipMap;
+	Record.fPriority = fPriority;
 	
 	{
 		const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
 		int idx = m_LoadingTextures.indexOf( Record );
 		if( idx != -1 )
+		{
 			m_LoadingTextures.getReference(idx).nRefCount++;
-		else
-			m_LoadingTextures.add(Record);
+			m_LoadingTextures.getReference(idx).fPriority = jmin( m_LoadingTextures.getReference(idx).fPriority, fPriority );
+			return;
+		}
+
+		idx = m_ReadyTextures.indexOf( Record );
+		if( idx != -1 )
+		{
+			m_ReadyTextures.getReference(idx).nRefCount++;
+			if( fPriority < m_ReadyTextures.getReference(idx).fPriority )
+			{
+				// Moved up to keep the array sorted
+				SGPTextureRecord ReadyRecord = m_ReadyTextures.remove(idx);
+				ReadyRecord.fPriority = fPriority;
+				ReadyRecordSorter sorter;
+				m_ReadyTextures.addSorted(sorter, ReadyRecord);
+			}
+			return;
+		}
+
+		m_LoadingTextures.add(Record);
 	}
+
+	addLoadingJob();
 }
 
 void CSGPResourceLoaderMuitiThread::addDeletingTexture(CTextureResource *pTextureRes, const String& texturename)
@@ -206,28 +349,63 @@ void CSGPResourceLoaderMuitiThread::addDeletingTexture(CTextureResource *pTextur
 	{
 		const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
-		m_DeletingTextures.add(Record);
+		// Texture has not been loaded, cancel it immediately
+		if( !pTextureRes )
+		{
+			int idx = m_LoadingTextures.indexOf( Record );
+			if( idx != -1 )
+			{
+				if( m_LoadingTextures.getReference(idx).nRefCount > 0 )
+					m_LoadingTextures.getReference(idx).nRefCount--;
+				else
+					m_LoadingTextures.remove(idx);
+				return;
+			}
+		}
 
+		m_DeletingTextures.add(Record);
 	}
 }
 
-void CSGPResourceLoaderMuitiThread::addLoadingModel(const String& modelname, uint16 BF1FileIndex)
+void CSGPResourceLoaderMuitiThread::addLoadingModel(const String& modelname, uint16 BF1FileIndex, float fPriority)
 {
 
 	SGPModelRecord Record;
 	Record.MF1AbsoluteFileName = modelname;
 	Record.BF1FileIndex = BF1FileIndex;
+	Record.fPriority = fPriority;
+	Record.NameHash = WChar_tStringHash(modelname.toWideCharPointer(), modelname.length());
 
 	{
 		const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
 		int idx = m_LoadingModels.indexOf( Record );
 		if( idx != -1 )
+		{
 			m_LoadingModels.getReference(idx).nRefCount++;
-		else
-			m_LoadingModels.add(Record);
+			m_LoadingModels.getReference(idx).fPriority = jmin( m_LoadingModels.getReference(idx).fPriority, fPriority );
+			return;
+		}
+
+		idx = m_ReadyModels.indexOf( Record );
+		if( idx != -1 )
+		{
+			m_ReadyModels.getReference(idx).nRefCount++;
+			if( fPriority < m_ReadyModels.getReference(idx).fPriority )
+			{
+				// Moved up to keep the array sorted
+				SGPModelRecord ReadyRecord = m_ReadyModels.remove(idx);
+				ReadyRecord.fPriority = fPriority;
+				ReadyRecordSorter sorter;
+				m_ReadyModels.addSorted(sorter, ReadyRecord);
+			}
+			return;
+		}
+
+		m_LoadingModels.add(Record);
 	}
 
+	addLoadingJob();
 }
 
 void CSGPResourceLoaderMuitiThread::addDeletingModel(CMF1FileResource *pModelRes, const String& modelname)
@@ -241,80 +419,284 @@ void CSGPResourceLoaderMuitiThread::addDeletingModel(CMF1FileResource *pModelRes
 	{
 		const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
+		// Model has not been loaded, cancel it immediately
+		if( !pModelRes )
+		{
+			int idx = m_LoadingModels.indexOf( Record );
+			if( idx != -1 )
+			{
+				if( m_LoadingModels.getReference(idx).nRefCount > 0 )
+					m_LoadingModels.getReference(idx).nRefCount--;
+				else
+					m_LoadingModels.remove(idx);
+				return;
+			}
+		}
+
 		m_DeletingModels.add(Record);
-	}	
+	}
 }
 
-
-void CSGPResourceLoaderMuitiThread::syncRenderResource()
+void CSGPResourceLoaderMuitiThread::updateLoadingModelPriority(Array<SGPLoadingPriority>& PriorityArray)
 {
+	if( PriorityArray.size() == 0 )
+		return;
+
+	PrioritySorter sorter;
+	PriorityArray.sort(sorter);
+
+	// Every instance of a model adds an entry with the same hash,
+	// keep one per model with the smallest priority (the nearest instance)
+	int numUnique = 1;
+	for( int i=1; i<PriorityArray.size(); i++ )
+	{
+		const SGPLoadingPriority& Priority = PriorityArray.getReference(i);
+		SGPLoadingPriority& LastUnique = PriorityArray.getReference(numUnique - 1);
+		if( Priority.NameHash == LastUnique.NameHash )
+			LastUnique.fPriority = jmin(LastUnique.fPriority, Priority.fPriority);
+		else
+			PriorityArray.getReference(numUnique++) = Priority;
+	}
+	PriorityArray.removeRange(numUnique, PriorityArray.size() - numUnique);
+
 	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
-	for( int i=0; i<m_LoadingTextures.size(); i++ )
+	for( int i=0; i<m_LoadingModels.size(); i++ )
 	{
-		if( m_LoadingTextures.getReference(i).bReady &&
-			m_LoadingTextures.getReference(i).pTexResource &&
-			m_LoadingTextures.getReference(i).pTexResource->pSGPImage )
+		SGPModelRecord& Record = m_LoadingModels.getReference(i);
+		if( Record.bLoading )
+			continue;
+
+		// Binary search in sorted priority array
+		int start = 0;
+		int end = PriorityArray.size();
+		while( start < end )
 		{
-			// In render thread, create render resource
-			m_pDevice->GetTextureManager()->registerTextureFromResourceMT(m_LoadingTextures.getReference(i));
-			delete m_LoadingTextures.getReference(i).pTexResource->pSGPImage;
-			m_LoadingTextures.getReference(i).pTexResource->pSGPImage = NULL;
-			Logger::getCurrentLogger()->writeToLog(String("Create Render texture in Render Thread") + m_LoadingTextures.getReference(i).TexFileName, ELL_INFORMATION);
-			
-			m_LoadingTextures.remove(i);
-			i--;
+			const int mid = (start + end) >> 1;
+			const SGPLoadingPriority& Priority = PriorityArray.getReference(mid);
+			if( Priority.NameHash == Record.NameHash )
+			{
+				Record.fPriority = Priority.fPriority;
+				break;
+			}
+			if( Priority.NameHash < Record.NameHash )
+				start = mid + 1;
+			else
+				end = mid;
 		}
 	}
+}
+
+
+void CSGPResourceLoaderMuitiThread::syncRenderResource()
+{
+	const double startTime = Time::getMillisecondCounterHiRes();
+
+	Array<SGPModelRecord> ReleasingModels;
+	Array<SGPModelRecord> CreatingModels;
+	Array<SGPTextureRecord> CreatingTextures;
+	uint32 nUploadedBytes = 0;
+	double SyncBudgetInMs = 0;
 
-	for( int i=0; i<m_DeletingTextures.size(); i++ )
 	{
-		if( m_DeletingTextures.getReference(i).bReady &&
-			m_DeletingTextures.getReference(i).pTexResource )
+		const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
+
+		// Records whose keep time has passed are flagged ready for releasing
+		processDeletingRecords();
+
+		// Releasing textures is cheap, and the maps of TextureManager are read by workers
+		// (registerTextureMT()), so they are released with the lock
+		for( int i=0; i<m_DeletingTextures.size(); i++ )
 		{
-			// In render thread, Also Remove StringToTextureIDMap and TextureArray in TextureManager
-			m_pDevice->GetTextureManager()->unRegisterTextureFromResourceMT(m_DeletingTextures.getReference(i));
-			Logger::getCurrentLogger()->writeToLog(String("Delete Render texture in Render Thread") + m_DeletingTextures.getReference(i).TexFileName, ELL_INFORMATION);
-			
-			m_DeletingTextures.remove(i);
-			i--;
+			if( m_DeletingTextures.getReference(i).bReady &&
+				m_DeletingTextures.getReference(i).pTexResource )
+			{
+				// In render thread, Also Remove StringToTextureIDMap and TextureArray in TextureManager
+				m_pDevice->GetTextureManager()->unRegisterTextureFromResourceMT(m_DeletingTextures.getReference(i));
+				SGP_LOG_INFO("Delete Render texture in Render Thread" << m_DeletingTextures.getReference(i).TexFileName);
+				
+				m_DeletingTextures.remove(i);
+				i--;
+			}
+		}
+
+		// Models are only used in render thread, they are released below
+		for( int i=0; i<m_DeletingModels.size(); i++ )
+		{
+			if( m_DeletingModels.getReference(i).bReady &&
+				m_DeletingModels.getReference(i).pMF1Resource )
+			{
+				ReleasingModels.add( m_DeletingModels.remove(i) );
+				i--;
+			}
 		}
+
+		// The nearest ready records within the bytes budget, at least one.
+		// They stay in the ready arrays until they are registered below, so the same
+		// resource added meanwhile is found there and counted in nRefCount.
+		int iTexture = 0;
+		int iModel = 0;
+		while( (iTexture < m_ReadyTextures.size()) || (iModel < m_ReadyModels.size()) )
+		{
+			if( (iTexture + iModel > 0) && (m_SyncBudgetInBytes > 0) && (nUploadedBytes >= m_SyncBudgetInBytes) )
+				break;
+
+			// Textures first when priorities are same, models will use them
+			if( (iTexture < m_ReadyTextures.size()) &&
+				((iModel == m_ReadyModels.size()) || (m_ReadyTextures.getReference(iTexture).fPriority <= m_ReadyModels.getReference(iModel).fPriority)) )
+			{
+				const SGPTextureRecord& Record = m_ReadyTextures.getReference(iTexture++);
+				nUploadedBytes += getTextureRenderResourceSize(Record.pTexResource->pSGPImage);
+				CreatingTextures.add(Record);
+			}
+			else
+			{
+				const SGPModelRecord& Record = m_ReadyModels.getReference(iModel++);
+				nUploadedBytes += getModelRenderResourceSize(Record.pMF1Resource->pModelMF1);
+				CreatingModels.add(Record);
+			}
+		}
+
+		SyncBudgetInMs = m_SyncBudgetInMs;
 	}
 
+	// GL objects are created and released without the lock
+	for( int i=0; i<ReleasingModels.size(); i++ )
+	{
+		// In render thread, release render resource
+		// In render thread, Also Remove m_StringToModelIDMap and MF1Models Array in ModelManager
+		m_pDevice->GetModelManager()->releaseRenderResourceMT(ReleasingModels.getReference(i));
 
-	for( int i=0; i<m_LoadingModels.size(); i++ )
+		SGP_LOG_INFO("Delete Static Mesh in Render Thread" << ReleasingModels.getReference(i).MF1AbsoluteFileName);
+	}
+
+	// In the order they were taken, until the time budget is used up,
+	// the others are left in the ready arrays for next frame
+	int nCreatedTextures = 0;
+	int nCreatedModels = 0;
+	while( (nCreatedTextures < CreatingTextures.size()) || (nCreatedModels < CreatingModels.size()) )
 	{
-		if( m_LoadingModels.getReference(i).bReady &&
-			m_LoadingModels.getReference(i).pMF1Resource &&
-			m_LoadingModels.getReference(i).pMF1Resource->pMF1RawMemoryAddress )
+		if( (nCreatedTextures + nCreatedModels > 0) && (SyncBudgetInMs > 0) &&
+			(Time::getMillisecondCounterHiRes() - startTime >= SyncBudgetInMs) )
+			break;
+
+		if( (nCreatedTextures < CreatingTextures.size()) &&
+			((nCreatedModels == CreatingModels.size()) ||
+			 (CreatingTextures.getReference(nCreatedTextures).fPriority <= CreatingModels.getReference(nCreatedModels).fPriority)) )
 		{
 			// In render thread, create render resource
-			// In render thread, Also set new m_StringToModelIDMap and MF1Models Array in ModelManager
-			m_pDevice->GetModelManager()->createRenderResourceMT(m_LoadingModels.getReference(i));
+			m_pDevice->GetTextureManager()->createTextureFromResourceMT(CreatingTextures.getReference(nCreatedTextures++));
+		}
+		else
+		{
+			m_pDevice->GetModelManager()->createRenderResourceMT(CreatingModels.getReference(nCreatedModels++));
+		}
+	}
 
-			Logger::getCurrentLogger()->writeToLog(String("Create Static Mesh in Render Thread") + m_LoadingModels.getReference(i).MF1AbsoluteFileName, ELL_INFORMATION);
+	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
-			m_LoadingModels.remove(i);
-			i--;
-		}
+	m_LastSyncUploadedBytes = 0;
 
+	for( int i=0; i<nCreatedTextures; i++ )
+	{
+		// Only render thread removes ready records
+		const int idx = m_ReadyTextures.indexOf( CreatingTextures.getReference(i) );
+		jassert( idx != -1 );
+		SGPTextureRecord Record = m_ReadyTextures.remove(idx);
+
+		m_LastSyncUploadedBytes += getTextureRenderResourceSize(Record.pTexResource->pSGPImage);
+
+		// In render thread, Also set StringToTextureIDMap and TextureArray in TextureManager
+		m_pDevice->GetTextureManager()->registerTextureFromResourceMT(Record);
+		delete Record.pTexResource->pSGPImage;
+		Record.pTexResource->pSGPImage = NULL;
+		SGP_LOG_INFO("Create Render texture in Render Thread" << Record.TexFileName);
 	}
-	for( int i=0; i<m_DeletingModels.size(); i++ )
+
+	for( int i=0; i<nCreatedModels; i++ )
 	{
-		if( m_DeletingModels.getReference(i).bReady &&
-			m_DeletingModels.getReference(i).pMF1Resource )
-		{
-			// In render thread, release render resource
-			// In render thread, Also Remove m_StringToModelIDMap and MF1Models Array in ModelManager
-			m_pDevice->GetModelManager()->releaseRenderResourceMT(m_DeletingModels.getReference(i));
+		const int idx = m_ReadyModels.indexOf( CreatingModels.getReference(i) );
+		jassert( idx != -1 );
+		SGPModelRecord Record = m_ReadyModels.remove(idx);
 
-			Logger::getCurrentLogger()->writeToLog(String("Delete Static Mesh in Render Thread") + m_DeletingModels.getReference(i).MF1AbsoluteFileName, ELL_INFORMATION);
+		m_LastSyncUploadedBytes += getModelRenderResourceSize(Record.pMF1Resource->pModelMF1);
 
-			m_DeletingModels.remove(i);
-			i--;
-		}
+		// In render thread, Also set new m_StringToModelIDMap and MF1Models Array in ModelManager
+		m_pDevice->GetModelManager()->registerRenderResourceMT(Record);
 
+		SGP_LOG_INFO("Create Static Mesh in Render Thread" << Record.MF1AbsoluteFileName);
+	}
+
+	m_LastSyncCreatedModels = nCreatedModels;
+	m_LastSyncCreatedTextures = nCreatedTextures;
+	m_LastSyncTimeInMs = Time::getMillisecondCounterHiRes() - startTime;
+}
+
+uint32 CSGPResourceLoaderMuitiThread::getModelRenderResourceSize(const CSGPModelMF1* pMF1Model)
+{
+	if( !pMF1Model )
+		return 0;
+
+	uint32 nBytes = 0;
+	for( uint32 i=0; i<pMF1Model->m_Header.m_iNumMeshes; i++ )
+	{
+		const SGPMF1Mesh& MF1Mesh = pMF1Model->m_pLOD0Meshes[i];
+		nBytes += MF1Mesh.m_iNumVerts * sizeof(SGPMF1Vertex);
+		nBytes += MF1Mesh.m_iNumIndices * sizeof(uint16);
+		nBytes += MF1Mesh.m_iNumUV0 * sizeof(SGPMF1TexCoord);
+		nBytes += MF1Mesh.m_iNumUV1 * sizeof(SGPMF1TexCoord);
+		nBytes += MF1Mesh.m_iNumVertexColor * sizeof(SGPMF1VertexColor);
 	}
+	return nBytes;
+}
+
+uint32 CSGPResourceLoaderMuitiThread::getTextureRenderResourceSize(ISGPImage* pImage)
+{
+	if( !pImage )
+		return 0;
+
+	// Compressed images report no image size, all mipmap levels are uploaded
+	if( pImage->IsDDSImage() )
+	{
+		SGPImageDDS* pDDSImage = static_cast<SGPImageDDS*>(pImage);
+		uint32 nBytes = 0;
+		for( int i=0; i<pDDSImage->getNumberOfMipmaps(); i++ )
+			nBytes += pDDSImage->getMipmapDataBytes(i);
+		return pDDSImage->isCubemap() ? nBytes * 6 : nBytes;
+	}
+#if defined (BUILD_OGLES2)
+	if( pImage->IsPVRTCImage() )
+		return PVRTGetTextureDataSize( static_cast<SGPImagePVRTC*>(pImage)->getTextureHeader() );
+#endif
+
+	return pImage->getImageDataSizeInBytes();
+}
+
+void CSGPResourceLoaderMuitiThread::setSyncRenderResourceBudget(double fMilliseconds, uint32 nBytes)
+{
+	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
+
+	m_SyncBudgetInMs = fMilliseconds;
+	m_SyncBudgetInBytes = nBytes;
+}
+
+void CSGPResourceLoaderMuitiThread::getLoaderStats(SGPResourceLoaderStats& Stats)
+{
+	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
+
+	Stats = SGPResourceLoaderStats();
+
+	Stats.nPendingModels = m_LoadingModels.size();
+	Stats.nPendingTextures = m_LoadingTextures.size();
+	Stats.nReadyModels = m_ReadyModels.size();
+	Stats.nReadyTextures = m_ReadyTextures.size();
+	Stats.nDeletingModels = m_DeletingModels.size();
+	Stats.nDeletingTextures = m_DeletingTextures.size();
+
+	Stats.nLastSyncCreatedModels = m_LastSyncCreatedModels;
+	Stats.nLastSyncCreatedTextures = m_LastSyncCreatedTextures;
+	Stats.nLastSyncUploadedBytes = m_LastSyncUploadedBytes;
+	Stats.fLastSyncTimeInMs = m_LastSyncTimeInMs;
 }
 
 
@@ -323,31 +705,21 @@ void CSGPResourceLoaderMuitiThread::removeAll()
 	const GenericScopedLock<CriticalSection> s1 (resourceArrayLock);
 
 	// Created in Loading thread, but not created render resource textures and models
-	for( int i=0; i<m_LoadingTextures.size(); i++ )
+	for( int i=0; i<m_ReadyTextures.size(); i++ )
 	{
-		if( m_LoadingTextures.getReference(i).bReady &&
-			m_LoadingTextures.getReference(i).pTexResource &&
-			m_LoadingTextures.getReference(i).pTexResource->pSGPImage )
-		{
-			delete m_LoadingTextures.getReference(i).pTexResource;
-			m_LoadingTextures.getReference(i).pTexResource = NULL;
-			delete m_LoadingTextures.getReference(i).pTexResource->pSGPImage;
-			m_LoadingTextures.getReference(i).pTexResource->pSGPImage = NULL;
-		}
+		delete m_ReadyTextures.getReference(i).pTexResource->pSGPImage;
+		delete m_ReadyTextures.getReference(i).pTexResource;
 	}
 
-	for( int i=0; i<m_LoadingModels.size(); i++ )
+	for( int i=0; i<m_ReadyModels.size(); i++ )
 	{
-		if( m_LoadingModels.getReference(i).bReady &&
-			m_LoadingModels.getReference(i).pMF1Resource )
-		{
-			delete m_LoadingModels.getReference(i).pMF1Resource;
-			m_LoadingModels.getReference(i).pMF1Resource = NULL;
-		}
+		delete m_ReadyModels.getReference(i).pMF1Resource;
 	}
 
 	m_LoadingModels.clear();
 	m_LoadingTextures.clear();
+	m_ReadyModels.clear();
+	m_ReadyTextures.clear();
 
 	for( int i=0; i<m_DeletingModels.size(); i++ )
 	{
@@ -356,7 +728,7 @@ void CSGPResourceLoaderMuitiThread::removeAll()
 			// Immediately, try to unRegisterMT used textures			
 			m_pDevice->GetModelManager()->unRegisterSkinTexturesMT(m_DeletingModels.getReference(i).pMF1Resource);
 			m_pDevice->GetModelManager()->releaseRenderResourceMT(m_DeletingModels.getReference(i));
-			Logger::getCurrentLogger()->writeToLog(String("Delete Static Mesh in Render Thread") + m_DeletingModels.getReference(i).MF1AbsoluteFileName, ELL_INFORMATION);
+			SGP_LOG_INFO("Delete Static Mesh in Render Thread" << m_DeletingModels.getReference(i).MF1AbsoluteFileName);
 		}
 	}
 	for( int i=0; i<m_DeletingTextures.size(); i++ )
@@ -364,7 +736,7 @@ void CSGPResourceLoaderMuitiThread::removeAll()
 		if( m_DeletingTextures.getReference(i).pTexResource )
 		{
 			m_pDevice->GetTextureManager()->unRegisterTextureFromResourceMT(m_DeletingTextures.getReference(i));
-			Logger::getCurrentLogger()->writeToLog(String("Delete Render texture in Render Thread") + m_DeletingTextures.getReference(i).TexFileName, ELL_INFORMATION);
+			SGP_LOG_INFO("Delete Render texture in Render Thread" << m_DeletingTextures.getReference(i).TexFileName);
 		}
 	}
 
@@ -3,7 +3,9 @@
 
 class CTextureResource;
 class CMF1FileResource;
+class CSGPModelMF1;
 class ISGPRenderDevice;
+class ISGPImage;
 
 struct SGPTextureRecord
 {
@@ -18,7 +20,10 @@ struct SGPTextureRecord
 	
 	bool bGenMipMap;
 
-	SGPTextureRecord() : pTexResource(NULL), bReady(false), bGenMipMap(false), nRefCount(0) {}
+	bool bLoading;						// Raw data is being loaded by one worker thread
+	float fPriority;					// Loading priority, smaller value will be loaded earlier
+
+	SGPTextureRecord() : pTexResource(NULL), bReady(false), nRefCount(0), bGenMipMap(false), bLoading(false), fPriority(0) {}
 	~SGPTextureRecord()	{}
 
 	bool operator== (const SGPTextureRecord& other) const noexcept
@@ -39,8 +44,12 @@ struct SGPModelRecord
 	
 	uint32 nRefCount;					// reference count before resource be created in render thread
 
+	bool bLoading;						// Raw data is being loaded by one worker thread
+	float fPriority;					// Loading priority, smaller value will be loaded earlier
+	uint64 NameHash;					// WChar_tStringHash of MF1AbsoluteFileName, used for updating priority
+
 
-	SGPModelRecord() : pMF1Resource(NULL), BF1FileIndex(0xFFFF), bReady(false), nRefCount(0) {}
+	SGPModelRecord() : pMF1Resource(NULL), BF1FileIndex(0xFFFF), bReady(false), nRefCount(0), bLoading(false), fPriority(0), NameHash(0) {}
 	~SGPModelRecord() {}
 	bool operator== (const SGPModelRecord& other) const noexcept
 	{
@@ -49,63 +58,176 @@ struct SGPModelRecord
 };
 
 
+// Used for updating loading priority of models which have not been loaded
+struct SGPLoadingPriority
+{
+	uint64 NameHash;					// WChar_tStringHash of MF1 file name
+	float fPriority;					// New loading priority (usually squared distance to camera)
 
+	SGPLoadingPriority() : NameHash(0), fPriority(0) {}
+	SGPLoadingPriority(uint64 hash, float priority) : NameHash(hash), fPriority(priority) {}
+};
 
 
 
+// Statistics of resource loader, used for keeping frame time steady while streaming
+struct SGPResourceLoaderStats
+{
+	uint32 nPendingModels;				// Models waiting for or in loading from disk
+	uint32 nPendingTextures;			// Textures waiting for or in loading from disk
+	uint32 nReadyModels;				// Models loaded, waiting for render resource creating
+	uint32 nReadyTextures;				// Textures loaded, waiting for render resource creating
+	uint32 nDeletingModels;				// Models waiting for releasing
+	uint32 nDeletingTextures;			// Textures waiting for releasing
+
+	uint32 nLastSyncCreatedModels;		// Models created in last syncRenderResource()
+	uint32 nLastSyncCreatedTextures;	// Textures created in last syncRenderResource()
+	uint32 nLastSyncUploadedBytes;		// Bytes uploaded in last syncRenderResource()
+	double fLastSyncTimeInMs;			// Time used by last syncRenderResource()
+
+	SGPResourceLoaderStats() : nPendingModels(0), nPendingTextures(0), nReadyModels(0), nReadyTextures(0),
+		nDeletingModels(0), nDeletingTextures(0),
+		nLastSyncCreatedModels(0), nLastSyncCreatedTextures(0), nLastSyncUploadedBytes(0), fLastSyncTimeInMs(0) {}
+};
 
 
-
-
-class CSGPResourceLoaderMuitiThread : public Thread
+/*
+	Resource loader running on its own JobScheduler.
+
+	Loading records are the job queue, one scheduler job is added for every new record.
+	A running job picks the pending record with the smallest priority value and does
+	the disk I/O WITHOUT holding resourceArrayLock, the lock only guards the record arrays.
+	Records unregistered before being picked are cancelled and never loaded.
+	The jobs block on file I/O, so they are kept off the shared scheduler which runs
+	the per-frame jobs (e.g. the bone updates of CSGPInstanceManager).
+	Loaded records are moved to the ready arrays, which are kept sorted by priority.
+	Render resources are still created in render thread by syncRenderResource(),
+	within a per-frame budget of time and uploaded bytes. It takes the most urgent
+	ready records under the lock, but creates their GL objects without it, so the
+	workers are not blocked by the uploads.
+*/
+class CSGPResourceLoaderMuitiThread
 {
 public:
-    CSGPResourceLoaderMuitiThread(ISGPRenderDevice* pDevice)
-        : Thread ("Resource Loader Multi Thread"), m_pDevice (pDevice)
-    {
-        interval = 10;
+	CSGPResourceLoaderMuitiThread(ISGPRenderDevice* pDevice);
+	~CSGPResourceLoaderMuitiThread();
 
-		Logger::getCurrentLogger()->writeToLog(String("Create Resource Loading Thread"), ELL_INFORMATION);
+	void addLoadingTexture(const String& texturename, bool bGenMipMap, float fPriority = 0);
+	void addDeletingTexture(CTextureResource *pTextureRes, const String& texturename);
+	void addLoadingModel(const String& modelname, uint16 BF1FileIndex, float fPriority = 0);
+	void addDeletingModel(CMF1FileResource *pModelRes, const String& modelname);
 
-        // give the threads a background priority (lower)
-        startThread(3);
-    }
+	// Reset loading priority of models which have not been picked by worker threads
+	// PriorityArray will be sorted by NameHash within this function, and entries with the same
+	// NameHash are merged into one with the smallest priority
+	void updateLoadingModelPriority(Array<SGPLoadingPriority>& PriorityArray);
 
-    ~CSGPResourceLoaderMuitiThread()
-    {
-		Logger::getCurrentLogger()->writeToLog(String("Shutdown Resource Loading Thread"), ELL_INFORMATION);
+	// Called every frame in render thread, create render resource of loaded records
+	// until time or bytes budget is used up, leftover records are carried to next frame
+	void syncRenderResource();
+	void removeAll();
 
-		removeAll();
+	// Budget of syncRenderResource() per frame, 0 means no limit
+	void setSyncRenderResourceBudget(double fMilliseconds, uint32 nBytes);
+	void getLoaderStats(SGPResourceLoaderStats& Stats);
 
-        // allow the thread 2 seconds to stop cleanly - should be plenty of time.
-        stopThread (2000);
-    }
+	int getNumWorkerThreads() const { return m_LoadingScheduler.getNumWorkers(); }
 
-    void run();
+private:
+	//==============================================================================
+	// Added to the scheduler once per new record, loads the most urgent pending record
+	class LoadingJob : public JobScheduler::Job
+	{
+	public:
+		LoadingJob(CSGPResourceLoaderMuitiThread& loader) : owner(loader) {}
 
-	void addLoadingTexture(const String& texturename, bool bGenMipMap);
-	void addDeletingTexture(CTextureResource *pTextureRes, const String& texturename);
-	void addLoadingModel(const String& modelname, uint16 BF1FileIndex);
-	void addDeletingModel(CMF1FileResource *pModelRes, const String& modelname);
+		void runJob() { owner.runLoadingJob(); }
 
-	void syncRenderResource();
-	void removeAll();
+	private:
+		CSGPResourceLoaderMuitiThread& owner;
 
-private:
-    int interval;
+		SGP_DECLARE_NON_COPYABLE (LoadingJob)
+	};
+
+	struct SGPLoadingJob
+	{
+		String FileName;				// Texture file name OR absolute path of MF1 file
+		uint16 BF1FileIndex;			// Only for model job
+		bool bModel;					// true : MF1 model, false : texture
+		float fPriority;				// Loading priority of the record
+
+		SGPLoadingJob() : BF1FileIndex(0xFFFF), bModel(false), fPriority(0) {}
+	};
+
+	class PrioritySorter
+	{
+	public:
+		static int compareElements( const SGPLoadingPriority& first, const SGPLoadingPriority& second ) noexcept
+		{
+			return (first.NameHash < second.NameHash) ? -1 : ((second.NameHash < first.NameHash) ? 1 : 0);
+		}
+	};
+
+	// Ready records in priority order, records with the same priority keep the order they are added
+	class ReadyRecordSorter
+	{
+	public:
+		template <class RecordType>
+		static int compareElements( const RecordType& first, const RecordType& second ) noexcept
+		{
+			return (first.fPriority < second.fPriority) ? -1 : ((second.fPriority < first.fPriority) ? 1 : 0);
+		}
+	};
+
+	void runLoadingJob();
+	void addLoadingJob();
 
+	// Must be called with resourceArrayLock held
+	void processDeletingRecords();
+	// Pick pending record with the smallest priority value and mark it loading,
+	// return false if nothing to load. Must be called with resourceArrayLock held
+	bool popLoadingJob(SGPLoadingJob& job);
+
+	void loadModel(const SGPLoadingJob& job);
+	void loadTexture(const SGPLoadingJob& job);
+
+	void waitForLoadingJobs();
+
+	// Estimated bytes of vertex / index data uploaded when creating render resource
+	static uint32 getModelRenderResourceSize(const CSGPModelMF1* pMF1Model);
+	// Bytes of texture data uploaded when creating render resource, every mipmap level
+	static uint32 getTextureRenderResourceSize(ISGPImage* pImage);
+
+private:
 	CriticalSection resourceArrayLock;
 
 	ISGPRenderDevice* m_pDevice;
 
+	JobScheduler m_LoadingScheduler;
+	LoadingJob m_LoadingJob;
+	JobScheduler::Counter m_LoadingJobCounter;
+	Atomic<int> m_bShutdown;				// Set in destructor, queued jobs return at once
 	
-	Array<SGPModelRecord> m_LoadingModels;
+	Array<SGPModelRecord> m_LoadingModels;				// Pending and being loaded records
 	Array<SGPTextureRecord> m_LoadingTextures;
 
+	Array<SGPModelRecord> m_ReadyModels;				// Loaded records, sorted by ReadyRecordSorter
+	Array<SGPTextureRecord> m_ReadyTextures;
+
 	Array<SGPModelRecord> m_DeletingModels;
 	Array<SGPTextureRecord> m_DeletingTextures;
 
+	double m_SyncBudgetInMs;
+	uint32 m_SyncBudgetInBytes;
+
+	uint32 m_LastSyncCreatedModels;
+	uint32 m_LastSyncCreatedTextures;
+	uint32 m_LastSyncUploadedBytes;
+	double m_LastSyncTimeInMs;
+
 	static const int RESOURCE_BONE_TO_FREE_KEEPTIME = 1 * 60 * 1000;	// 1 mins
+	static const int DEFAULT_SYNC_BUDGET_MS = 4;
+	static const uint32 DEFAULT_SYNC_BUDGET_BYTES = 8 * 1024 * 1024;	// 8M
 
     SGP_DECLARE_NON_COPYABLE (CSGPResourceLoaderMuitiThread)
 };
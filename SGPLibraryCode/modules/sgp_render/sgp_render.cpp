@@ -49,6 +49,13 @@ namespace sgp
 #include "effectsystem/sgp_EffectSystemManager.cpp"
 
 #include "renderinterface/sgp_ResourceMultiThreadLoader.cpp"
+#include "renderinterface/sgp_RenderQueue.cpp"
 
 #include "font/sgp_FontManager.cpp"
+
+#include "nulldevice/sgp_NullCommandLog.cpp"
+#include "nulldevice/sgp_NullTexture.cpp"
+#include "nulldevice/sgp_NullVertexCacheManager.cpp"
+#include "nulldevice/sgp_NullParticleRenderer.cpp"
+#include "nulldevice/sgp_NullRenderDevice.cpp"
 }
\ No newline at end of file
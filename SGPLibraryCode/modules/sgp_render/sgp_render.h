@@ -30,6 +30,9 @@ namespace sgp
 #ifndef __SGP_RENDERSTAGES_HEADER__
  #include "renderinterface/sgp_RenderStages.h"
 #endif
+#ifndef __SGP_RENDERQUEUE_HEADER__
+ #include "renderinterface/sgp_RenderQueue.h"
+#endif
 
 #ifndef	__SGP_IMAGE_HEADER__
  #include "texturesystem/sgp_Image.h"
@@ -179,6 +182,25 @@ namespace sgp
 	#endif
 #endif
 
+namespace sgp
+{
+#ifndef __SGP_NULLCOMMANDLOG_HEADER__
+ #include "nulldevice/sgp_NullCommandLog.h"
+#endif
+#ifndef __SGP_NULLTEXTURE_HEADER__
+ #include "nulldevice/sgp_NullTexture.h"
+#endif
+#ifndef __SGP_NULLVERTEXCACHEMANAGER_HEADER__
+ #include "nulldevice/sgp_NullVertexCacheManager.h"
+#endif
+#ifndef __SGP_NULLPARTICLERENDERER_HEADER__
+ #include "nulldevice/sgp_NullParticleRenderer.h"
+#endif
+#ifndef __SGP_NULLRENDERDEVICE_HEADER__
+ #include "nulldevice/sgp_NullRenderDevice.h"
+#endif
+}
+
 
 
 #endif	// __SGP_RENDER_HEADER__
\ No newline at end of file
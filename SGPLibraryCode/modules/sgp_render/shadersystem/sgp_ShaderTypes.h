@@ -212,6 +212,15 @@
 		// local vertex position and local UV as static VB
 		// instanced position + normal + UV index + vertex color + wind params as dynamic VB
 		SGPST_GRASS_INSTANCING,
+#if !defined(BUILD_OGLES2)
+		//! Used for static mesh geometry instancing rendering
+		// same shading as SGPST_TEXTURE and SGPST_LIGHTMAP (with alphatest)
+		// world matrix + material color + texture anim params as per-instance VB
+		SGPST_INSTANCING_TEXTURE,
+		SGPST_INSTANCING_TEXTURE_ALPHATEST,
+		SGPST_INSTANCING_LIGHTMAP,
+		SGPST_INSTANCING_LIGHTMAP_ALPHATEST,
+#endif
 
 		//! This value is not used. just for counting the elements num
 		SGPST_SHADER_NUM,
@@ -279,9 +288,34 @@
 		"water_refraction",
 		"water_surfacerender",
 		"grass_instance",
+#if !defined(BUILD_OGLES2)
+		"texture_instance",
+		"texture_alphatest_instance",
+		"lightmap_instance",
+		"lightmap_alphatest_instance",
+#endif
 		0
 	};
 
+	//! Geometry instancing shader type of a static mesh shader type
+	// returns SGPST_SHADER_NUM if batches of this shader type can not be drawn instanced
+	inline SGP_SHADER_TYPE getInstancingShaderType(SGP_SHADER_TYPE nShaderType)
+	{
+#if !defined(BUILD_OGLES2)
+		switch( nShaderType )
+		{
+		case SGPST_TEXTURE:				return SGPST_INSTANCING_TEXTURE;
+		case SGPST_TEXTURE_ALPHATEST:		return SGPST_INSTANCING_TEXTURE_ALPHATEST;
+		case SGPST_LIGHTMAP:				return SGPST_INSTANCING_LIGHTMAP;
+		case SGPST_LIGHTMAP_ALPHATEST:		return SGPST_INSTANCING_LIGHTMAP_ALPHATEST;
+		default:							break;
+		}
+#else
+		(void)nShaderType;
+#endif
+		return SGPST_SHADER_NUM;
+	}
+
 
 
 #endif		// __SGP_SHADERTYPES_HEADER__
\ No newline at end of file
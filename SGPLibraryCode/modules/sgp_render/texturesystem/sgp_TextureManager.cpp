@@ -35,7 +35,7 @@ CSGPTextureManager::~CSGPTextureManager()
 	m_Textures.clear(true);
 
 
-	HashMap<uint64, uint32>::Iterator i (m_StringToTextureIDMap);
+	FlatHashMap<uint64, uint32>::Iterator i (m_StringToTextureIDMap);
 	while( i.next() )
 	{
 		uint32 TexID = i.getValue();
@@ -340,7 +340,7 @@ uint32 CSGPTextureManager::registerTexture(const String& texturename, bool bGenM
 }
 
 //! register a Texture from a file. (Multi-thread version)
-uint32 CSGPTextureManager::registerTextureMT(const String& texturename, bool bGenMipMap)
+uint32 CSGPTextureManager::registerTextureMT(const String& texturename, bool bGenMipMap, float fPriority)
 {
 	uint32 TexID = getTextureIDByName(texturename);
 	if( TexID != 0 )
@@ -350,7 +350,7 @@ uint32 CSGPTextureManager::registerTextureMT(const String& texturename, bool bGe
 	}
 
 
-	m_pRenderDevice->GetMTResourceLoader()->addLoadingTexture(texturename, bGenMipMap);	
+	m_pRenderDevice->GetMTResourceLoader()->addLoadingTexture(texturename, bGenMipMap, fPriority);	
 
 	return 0;
 }
@@ -466,14 +466,18 @@ uint32 CSGPTextureManager::registerEmptyTexture(const SDimension2D& size,
 	return TexID;
 }
 
-uint32 CSGPTextureManager::registerTextureFromResourceMT(SGPTextureRecord Record)
+void CSGPTextureManager::createTextureFromResourceMT(SGPTextureRecord Record)
 {
-	uint64 HashVal = WChar_tStringHash(Record.TexFileName.toWideCharPointer(), Record.TexFileName.length());
-
 	Record.pTexResource->pSGPTexture = m_pRenderDevice->createTexture(
 		Record.pTexResource->pSGPImage,
 		Record.TexFileName,
 		Record.bGenMipMap);
+}
+
+uint32 CSGPTextureManager::registerTextureFromResourceMT(SGPTextureRecord Record)
+{
+	uint64 HashVal = WChar_tStringHash(Record.TexFileName.toWideCharPointer(), Record.TexFileName.length());
+
 	Record.pTexResource->incReferenceCount();
 	for( uint32 i=0; i<Record.nRefCount; i++ )
 		Record.pTexResource->incReferenceCount();
@@ -174,7 +174,8 @@ public:
 
 	//////////////////////////////////////////////////////////////////////////////
 	// Multi-Thread version of Function registerTexture
-	uint32 registerTextureMT(const String& texturename, bool bGenMipMap=false);
+	//\param fPriority Loading priority, smaller value will be loaded earlier
+	uint32 registerTextureMT(const String& texturename, bool bGenMipMap=false, float fPriority=0);
 
 	// Multi-Thread version of unRegister Function
 	void unRegisterTextureByNameMT( const String& texturename );
@@ -183,6 +184,9 @@ public:
 	// Below two functions called by ResourceMuitiThreadLoader
 	// called from render-thread, when background thread has loaded texture raw data,
 	// creating / releasing render resource
+	// createTextureFromResourceMT() only creates the texture, it is called without the lock of
+	// resource loader, registerTextureFromResourceMT() then adds it to TextureManager with the lock
+	void createTextureFromResourceMT( SGPTextureRecord Record );
 	uint32 registerTextureFromResourceMT( SGPTextureRecord Record );
 	void unRegisterTextureFromResourceMT( SGPTextureRecord Record );
 
@@ -207,7 +211,7 @@ private:
 	OwnedArray<CTextureResource> m_Textures;
 
 	// Hashmap of texture file path string to Index of Texture Array
-	HashMap<uint64, uint32>		m_StringToTextureIDMap;
+	FlatHashMap<uint64, uint32>		m_StringToTextureIDMap;
 };
 
 
@@ -28,6 +28,8 @@ public:
 
 	virtual void*		GetStaticBufferByID(uint32 nSBufferID) = 0;
 
+	// Bone buffer of one skeleton instance, the OpenGL device packs all of them into one shared
+	// bone palette, the bone matrix buffer given in Update must stay valid until the TBO is cleared
 	virtual uint32		CreateTextureBufferObjectByID(uint32 ModelResourceID) = 0;
 	virtual void		UpdateTextureBufferObjectByID(float* pBoneMatrixBuffer, uint32 nBoneCount, uint32 TBOID) = 0;
 	virtual bool		BindTextureBufferObjectByID(uint32 TBOID, int iTextureUnit) = 0;
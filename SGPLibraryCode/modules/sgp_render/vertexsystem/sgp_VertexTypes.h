@@ -120,6 +120,14 @@ struct SGPVertex_GRASS_Cluster
 	float vWindParams[4];		// Wind Offset for X and Z direction [0] [2]
 };
 
+// static mesh instance Params (instancing rendering)
+struct SGPVertex_STATIC_Instance
+{
+	float vMatWorld[16];		// world matrix
+	float vMaterialColor[4];	// [3] is batch alpha
+	float vTexIndexUVOffset[4];	// [0] is tiled texture index, [1] [2] is UV offset
+};
+
 // SGPVT_GRASS ( used for OpenGL ES 2.0 grass render )
 struct SGPVertex_GRASS_GLES2
 {
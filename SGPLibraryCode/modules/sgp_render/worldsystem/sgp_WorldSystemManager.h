@@ -20,7 +20,7 @@ public:
 		CSGPWorldConfig::deleteInstance();
 		CSGPLightMapGenConfig::deleteInstance();
 
-		HashMap<uint32, CStaticMeshInstance*>::Iterator i (m_SceneIDToInstanceMap);
+		FlatHashMap<uint32, CStaticMeshInstance*>::Iterator i (m_SceneIDToInstanceMap);
 		while( i.next() )
 		{
 			CStaticMeshInstance* pInstance = i.getValue();
@@ -275,13 +275,45 @@ public:
 	// get all visible scene object
 	virtual Array<ISGPObject*>& getVisibleObjectArray() = 0;
 
+protected:
+	// Reset loading priority of scene objects whose MF1 model has not been loaded yet,
+	// nearer objects will be loaded earlier by resource loading threads
+	inline void updateSceneObjectLoadingPriority(CSGPResourceLoaderMuitiThread* pMTResourceLoader, const Vector4D& CamPos)
+	{
+		m_LoadingPriorityArray.clearQuick();
+
+		ISGPObject** pEnd = m_SenceObjectArray.end();
+		for( ISGPObject** pBegin = m_SenceObjectArray.begin(); pBegin < pEnd; pBegin++ )
+		{
+			if( !(*pBegin) )
+				continue;
+			CStaticMeshInstance* pInstance = m_SceneIDToInstanceMap[(*pBegin)->getSceneObjectID()];
+			if( pInstance->getMF1ModelResourceID() != 0xFFFFFFFF )
+				continue;
+
+			const String& ModelFileName = pInstance->getModelFileName();
+			m_LoadingPriorityArray.add( SGPLoadingPriority( WChar_tStringHash(ModelFileName.toWideCharPointer(), ModelFileName.length()),
+															getSceneObjectLoadingPriority(*pBegin, CamPos) ) );
+		}
+
+		pMTResourceLoader->updateLoadingModelPriority( m_LoadingPriorityArray );
+	}
+
+	// Loading priority of scene object is squared distance to camera
+	static inline float getSceneObjectLoadingPriority(const ISGPObject* obj, const Vector4D& CamPos)
+	{
+		Vector3D vDist( obj->m_fPosition[0] - CamPos.x, obj->m_fPosition[1] - CamPos.y, obj->m_fPosition[2] - CamPos.z );
+		return vDist.GetLengthSquared();
+	}
+
 protected:
 	String									m_WorldName;			// WorldName
 	CSGPWorldConfig*						m_pWorldMapConfig;		// World config setting
 
 	Array<ISGPObject*>						m_SenceObjectArray;		// sence object Array( array index is scene obj id )
-	HashMap<uint32, CStaticMeshInstance*>	m_SceneIDToInstanceMap;	// scene obj id to MeshInstance map
+	FlatHashMap<uint32, CStaticMeshInstance*>	m_SceneIDToInstanceMap;	// scene obj id to MeshInstance map
 	Array<ISGPLightObject*>					m_LightObjectArray;		// scene light object Array( array index is light obj id )
+	Array<SGPLoadingPriority>				m_LoadingPriorityArray;	// loading priority of not loaded scene objects
 
 protected:
 	// Init m_SenceObjectArray Array size also m_SceneIDToInstanceMap and m_SceneNameToObjMap hash map slot number
@@ -34,7 +34,7 @@ void CSGPQuadTree::Shutdown()
 	}
 }
 
-void CSGPQuadTree::GetVisibleTerrainChunk(NodeType* pNode, const Frustum& ViewFrustum, Array<CSGPTerrainChunk*>& VisibleChunkArray)
+void CSGPQuadTree::GetVisibleTerrainChunk(NodeType* pNode, const Frustum& ViewFrustum, FrameTerrainChunkArray& VisibleChunkArray)
 {
 	if( pNode )
 	{
@@ -1,6 +1,9 @@
 #ifndef __SGP_QUADTREE_HEADER__
 #define __SGP_QUADTREE_HEADER__
 
+// Visible terrain chunks, rebuilt every frame in memory from the frame arena
+typedef Array<CSGPTerrainChunk*, DummyCriticalSection, ArenaArrayAllocationBase<CSGPTerrainChunk*, DummyCriticalSection> > FrameTerrainChunkArray;
+
 class CSGPQuadTree
 {
 private:	
@@ -22,7 +25,7 @@ public:
 	//! creates the Quad tree from terrain
 	void InitializeFromTerrain(CSGPTerrain* pTerrain);
 	void Shutdown();
-	void GetVisibleTerrainChunk(NodeType* pNode, const Frustum& ViewFrustum, Array<CSGPTerrainChunk*>& VisibleChunkArray);
+	void GetVisibleTerrainChunk(NodeType* pNode, const Frustum& ViewFrustum, FrameTerrainChunkArray& VisibleChunkArray);
 
 
 
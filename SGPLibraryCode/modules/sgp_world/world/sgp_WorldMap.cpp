@@ -5,10 +5,10 @@ static uint32 s_CurFileOffset = 0;
 
 
 
-uint8* CSGPWorldMap::LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& WorkingDir, const String& Filename)
+MemoryMappedFile* CSGPWorldMap::LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& WorkingDir, const String& Filename)
 {
+	MemoryMappedFile* pMappedFile = NULL;
 	uint8 * ucpBuffer = 0;	
-	uint32 iFileSize = 0;
 
 	String AbsolutePath(Filename);
 	// Identify by their absolute filenames if possible.
@@ -17,19 +17,16 @@ uint8* CSGPWorldMap::LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& Wor
 		AbsolutePath = WorkingDir +	File::separatorString + String(Filename);
 	}
 
+	// Map the file copy-on-write, only the pages of pointers relocated below will be copied,
+	// the others are read from disk when they are first used
+	pMappedFile = new MemoryMappedFile( File(AbsolutePath), MemoryMappedFile::copyOnWrite );
+	if( (pMappedFile->getData() == nullptr) || (pMappedFile->getSize() < sizeof(CSGPWorldMap)) )
 	{
-		ScopedPointer<FileInputStream> WorldMapFileStream( File(AbsolutePath).createInputStream() );
-		if( WorldMapFileStream == nullptr )
-		{
-			Logger::getCurrentLogger()->writeToLog(String("Could not open Worldmap File:") + Filename, ELL_ERROR);
-			return NULL;
-		}
-		iFileSize = (uint32)WorldMapFileStream->getTotalLength();
-
-		ucpBuffer = new uint8 [iFileSize];
-
-		WorldMapFileStream->read(ucpBuffer, iFileSize);
+		Logger::getCurrentLogger()->writeToLog(String("Could not open Worldmap File:") + Filename, ELL_ERROR);
+		delete pMappedFile;
+		return NULL;
 	}
+	ucpBuffer = (uint8 *)pMappedFile->getData();
 
 	// Make sure header is valid
 	pOutWorldMap = (CSGPWorldMap *)ucpBuffer;
@@ -37,8 +34,7 @@ uint8* CSGPWorldMap::LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& Wor
 	if(pOutWorldMap->m_Header.m_iId != 0xCAFEDBEE || pOutWorldMap->m_Header.m_iVersion != 1)
 	{
 		Logger::getCurrentLogger()->writeToLog(Filename + String(" is not a valid WorldMap File!"), ELL_ERROR);
-		delete [] ucpBuffer;
-		ucpBuffer = NULL;
+		delete pMappedFile;
 		return NULL;
 	}
 
@@ -150,7 +146,7 @@ uint8* CSGPWorldMap::LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& Wor
 			pOutWorldMap->m_GrassData.m_ppChunkGrassCluster = NULL;
 	}
 
-	return ucpBuffer;
+	return pMappedFile;
 }
 
 bool CSGPWorldMap::SaveWorldMap(const String& WorkingDir, const String& szFilename)
@@ -267,6 +263,10 @@ bool CSGPWorldMap::SaveWorldMap(const String& WorkingDir, const String& szFilena
 		AbsolutePath = WorkingDir +	File::separatorString + szFilename;
 	}
 
+	// The old file may still be memory mapped by the loader (even to this object's data),
+	// so remove it and write a new file rather than truncating it in place
+	File(AbsolutePath).deleteFile();
+
 	ScopedPointer<FileOutputStream> fileStream( File(AbsolutePath).createOutputStream() );
 	if (fileStream != nullptr && fileStream->openedOk() )
     {
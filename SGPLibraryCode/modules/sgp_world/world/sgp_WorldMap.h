@@ -256,8 +256,8 @@ public:
 	}
 
 	//Load an World map file
-	//Return the raw memory allocated from file
-	static uint8* LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& WorkingDir, const String& Filename);
+	//Return the memory mapped file which holds the loaded data, delete it when no longer used
+	static MemoryMappedFile* LoadWorldMap(CSGPWorldMap* &pOutWorldMap, const String& WorkingDir, const String& Filename);
 
 	//Save an World map file
 	bool SaveWorldMap(const String& WorkingDir, const String& szFilename);
@@ -0,0 +1,265 @@
+/*
+	Tests and microbenchmarks of FlatHashMap against the chained HashMap.
+
+	Standalone console program, it only needs sgp_core:
+	compile it together with SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+	(and link the platform thread library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_FlatHashMap.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+
+using namespace sgp;
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+//==============================================================================
+// Every key of the reference HashMap is in the FlatHashMap with the same value,
+// and iterating the FlatHashMap visits each of its items once
+template <typename KeyType, typename ValueType>
+static bool haveSameItems(const FlatHashMap<KeyType, ValueType>& flatMap, const HashMap<KeyType, ValueType>& reference)
+{
+	if( flatMap.size() != reference.size() )
+		return false;
+
+	for( typename HashMap<KeyType, ValueType>::Iterator i (reference); i.next(); )
+		if( !flatMap.contains(i.getKey()) || !(flatMap[i.getKey()] == i.getValue()) )
+			return false;
+
+	int numVisited = 0;
+	for( typename FlatHashMap<KeyType, ValueType>::Iterator i (flatMap); i.next(); )
+	{
+		if( !reference.contains(i.getKey()) || !(reference[i.getKey()] == i.getValue()) )
+			return false;
+		numVisited++;
+	}
+	return numVisited == reference.size();
+}
+
+// Random set / remove / removeValue against HashMap, with key ranges small enough
+// to replace and remove existing keys often
+static void testRandomOperations(Random& random, int keyRange, int numOperations)
+{
+	FlatHashMap<uint32, int> flatMap(8);
+	HashMap<uint32, int> reference;
+	bool bSame = true, bLookupsSame = true;
+
+	for( int op=0; op<numOperations; op++ )
+	{
+		// Scene object IDs are sequential, texture IDs are spread out
+		const uint32 key = (random.nextInt(4) == 0) ? (uint32) random.nextInt() : (uint32) random.nextInt(keyRange);
+		const int value = random.nextInt(16);
+
+		switch( random.nextInt(10) )
+		{
+		case 0: case 1: case 2:
+			flatMap.remove( key );
+			reference.remove( key );
+			break;
+		case 3:
+			if( random.nextInt(50) == 0 )
+			{
+				flatMap.removeValue( value );
+				reference.removeValue( value );
+			}
+			break;
+		default:
+			flatMap.set( key, value );
+			reference.set( key, value );
+			break;
+		}
+
+		bLookupsSame = bLookupsSame && (flatMap.contains(key) == reference.contains(key)) && (flatMap[key] == reference[key]);
+		if( (op % 1000) == 0 )
+			bSame = bSame && haveSameItems( flatMap, reference );
+	}
+	bSame = bSame && haveSameItems( flatMap, reference );
+
+	expect( bLookupsSame, "random operations : lookups" );
+	expect( bSame, "random operations : contents" );
+	expect( (flatMap.getNumSlots() & (flatMap.getNumSlots() - 1)) == 0 && flatMap.size() * 8 <= flatMap.getNumSlots() * 7, "power of two table, 7/8 full at most" );
+}
+
+// uint64 name hashes as used by the texture and model managers, and String keys
+static void testOtherKeyTypes(Random& random)
+{
+	FlatHashMap<uint64, uint32> flatMap;
+	HashMap<uint64, uint32> reference;
+	for( uint32 i=0; i<20000; i++ )
+	{
+		const uint64 key = ((uint64) (uint32) random.nextInt() << 32) | (uint32) random.nextInt();
+		flatMap.set( key, i );
+		reference.set( key, i );
+	}
+	expect( haveSameItems(flatMap, reference), "uint64 keys" );
+
+	FlatHashMap<String, int> stringMap;
+	for( int i=0; i<1000; i++ )
+		stringMap.set( "texture_" + String(i) + ".dds", i );
+	bool bFound = true;
+	for( int i=0; i<1000; i++ )
+		bFound = bFound && (stringMap["texture_" + String(i) + ".dds"] == i);
+	expect( bFound && !stringMap.contains("texture_1000.dds") && stringMap.size() == 1000, "String keys" );
+}
+
+// Keys hashing to the same slot make long runs, which must not break lookups or removal
+static void testCollidingKeys()
+{
+	FlatHashMap<uint32, int> flatMap;
+	HashMap<uint32, int> reference;
+
+	// Multiples of a large power of two, like aligned addresses
+	for( int i=0; i<3000; i++ )
+	{
+		flatMap.set( (uint32) i << 19, i );
+		reference.set( (uint32) i << 19, i );
+	}
+	for( int i=0; i<3000; i+=3 )
+	{
+		flatMap.remove( (uint32) i << 19 );
+		reference.remove( (uint32) i << 19 );
+	}
+	expect( haveSameItems(flatMap, reference), "colliding keys" );
+
+	flatMap.remapTable( 8 );
+	expect( haveSameItems(flatMap, reference) && flatMap.getNumSlots() * 7 >= flatMap.size() * 8, "remapTable to fewer slots" );
+
+	flatMap.clear();
+	expect( flatMap.size() == 0 && !flatMap.contains(3u << 19), "clear" );
+}
+
+// Value which counts its live copies
+struct CountedValue
+{
+	CountedValue() : value(0)								{ ++numLive; }
+	CountedValue(int v) : value(v)							{ ++numLive; }
+	CountedValue(const CountedValue& other) : value(other.value)	{ ++numLive; }
+	~CountedValue()											{ --numLive; }
+	CountedValue& operator= (const CountedValue& other)		{ value = other.value; return *this; }
+	bool operator== (const CountedValue& other) const		{ return value == other.value; }
+
+	int value;
+	static int numLive;
+};
+
+int CountedValue::numLive = 0;
+
+// Values are destroyed once, on remove, clear or when the map is deleted
+static void testValueLifetime()
+{
+	{
+		FlatHashMap<int, CountedValue> flatMap(8);
+		for( int i=0; i<1000; i++ )
+			flatMap.set( i, CountedValue(i) );
+		for( int i=0; i<1000; i+=2 )
+			flatMap.remove( i );
+		flatMap.remapTable( 4096 );
+		const int numLive = CountedValue::numLive;
+		expect( flatMap.size() == 500 && numLive == 500 && flatMap[999].value == 999, "values removed" );
+
+		flatMap.removeValue( CountedValue(1) );
+		expect( flatMap.size() == 499 && CountedValue::numLive == 499, "removeValue" );
+	}
+	expect( CountedValue::numLive == 0, "values destroyed with the map" );
+
+	FlatHashMap<int, String> stringMap;
+	for( int i=0; i<100; i++ )
+		stringMap.set( i, "value" + String(i) );
+	stringMap.clear();
+	stringMap.set( 7, "seven" );
+	expect( stringMap.size() == 1 && stringMap[7] == "seven" && stringMap[8].isEmpty(), "String values" );
+}
+
+//==============================================================================
+template <class MapType>
+static void runMapBenchmark(const char* szMapName, const Array<uint32>& keys, const Array<uint32>& missingKeys, int numRepeats)
+{
+	double insertTime = 0, hitTime = 0, missTime = 0, iterateTime = 0;
+	int64 checksum = 0;
+
+	for( int repeat=0; repeat<numRepeats; repeat++ )
+	{
+		MapType map;
+
+		double startTime = Time::getMillisecondCounterHiRes();
+		for( int i=0; i<keys.size(); i++ )
+			map.set( keys.getUnchecked(i), i );
+		insertTime += Time::getMillisecondCounterHiRes() - startTime;
+
+		startTime = Time::getMillisecondCounterHiRes();
+		for( int i=keys.size(); --i >= 0; )
+			checksum += map[keys.getUnchecked(i)];
+		hitTime += Time::getMillisecondCounterHiRes() - startTime;
+
+		startTime = Time::getMillisecondCounterHiRes();
+		for( int i=0; i<missingKeys.size(); i++ )
+			checksum += map.contains( missingKeys.getUnchecked(i) ) ? 1 : 0;
+		missTime += Time::getMillisecondCounterHiRes() - startTime;
+
+		startTime = Time::getMillisecondCounterHiRes();
+		for( typename MapType::Iterator i (map); i.next(); )
+			checksum += i.getValue();
+		iterateTime += Time::getMillisecondCounterHiRes() - startTime;
+	}
+
+	const double toNanoseconds = 1000000.0 / ((double) keys.size() * numRepeats);
+	std::printf("%-12s %7d items : insert %6.1f ns, hit %6.1f ns, miss %6.1f ns, iterate %6.1f ns per item (checksum %lld)\n",
+		szMapName, keys.size(), insertTime * toNanoseconds, hitTime * toNanoseconds, missTime * toNanoseconds,
+		iterateTime * toNanoseconds, (long long) checksum);
+}
+
+static void runBenchmarks(Random& random)
+{
+	const int numSizes = 4;
+	const int sizes[numSizes] = { 100, 1000, 10000, 100000 };
+
+	for( int s=0; s<numSizes; s++ )
+	{
+		// Sequential IDs like the scene object IDs, the misses are the IDs after them
+		Array<uint32> keys, missingKeys;
+		for( int i=0; i<sizes[s]; i++ )
+		{
+			keys.add( (uint32) i + 1 );
+			missingKeys.add( (uint32) (sizes[s] + i + 1) );
+		}
+		// Looked up in a different order than inserted
+		for( int i=keys.size(); --i > 0; )
+			keys.swap( i, random.nextInt(i + 1) );
+
+		const int numRepeats = jmax( 1, 2000000 / sizes[s] );
+		runMapBenchmark< HashMap<uint32, int> >( "HashMap", keys, missingKeys, numRepeats );
+		runMapBenchmark< FlatHashMap<uint32, int> >( "FlatHashMap", keys, missingKeys, numRepeats );
+	}
+}
+
+//==============================================================================
+int main()
+{
+	Random random(2024);
+
+	testRandomOperations( random, 64, 200000 );
+	testRandomOperations( random, 5000, 200000 );
+	testOtherKeyTypes( random );
+	testCollidingKeys();
+	testValueLifetime();
+
+	runBenchmarks( random );
+
+	std::printf( (g_iNumFailures == 0) ? "All FlatHashMap tests passed\n" : "%d FlatHashMap tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,550 @@
+/*
+	Stress test and microbenchmarks of JobScheduler.
+
+	Standalone console program, it only needs sgp_core:
+	compile it together with SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+	(and link the platform thread library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_JobScheduler.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass. Run it under a thread / address sanitizer
+	to check counters are not touched after they are deleted.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+
+using namespace sgp;
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+//==============================================================================
+// Adds the values of [begin, end) into one atomic sum
+struct SumRange
+{
+	void operator() (int begin, int end) const
+	{
+		int64 sum = 0;
+		for( int i=begin; i<end; i++ )
+			sum += values[i];
+		*pTotal += sum;
+	}
+
+	const int* values;
+	Atomic<int64>* pTotal;
+};
+
+// Counts how often it has run, and checks the job it depends on has finished
+class CountingJob : public JobScheduler::Job
+{
+public:
+	CountingJob() : pDependency(nullptr), bRanBeforeDependency(false) {}
+
+	void runJob()
+	{
+		if( pDependency != nullptr && pDependency->numRuns.get() == 0 )
+			bRanBeforeDependency = true;
+		++numRuns;
+	}
+
+	Atomic<int> numRuns;
+	CountingJob* pDependency;
+	bool bRanBeforeDependency;
+};
+
+// Adds jobs to the scheduler from another thread
+class ProducerThread : public Thread
+{
+public:
+	ProducerThread(JobScheduler& s, int index, int numJobs_)
+		: Thread( "Job Producer " + String(index) ), scheduler(s), numJobs(numJobs_) {}
+
+	void run()
+	{
+		CountingJob* jobs = new CountingJob [numJobs];
+		JobScheduler::Counter counter;
+
+		for( int i=0; i<numJobs; i++ )
+			scheduler.addJob( jobs + i, &counter );
+		scheduler.waitForCounter( counter );
+
+		for( int i=0; i<numJobs; i++ )
+			if( jobs[i].numRuns.get() != 1 )
+				++numWrongRuns;
+		delete [] jobs;
+	}
+
+	JobScheduler& scheduler;
+	const int numJobs;
+	Atomic<int> numWrongRuns;
+};
+
+//==============================================================================
+// parallelFor with a counter on the stack, repeated, this is the case where a worker
+// finishing the last job could still hold the counter when it goes out of scope
+static void testParallelForSum(JobScheduler& scheduler)
+{
+	const int numValues = 10000;
+	HeapBlock<int> values(numValues);
+	int64 expected = 0;
+	for( int i=0; i<numValues; i++ )
+	{
+		values[i] = i * 7 - 3;
+		expected += values[i];
+	}
+
+	bool bAllCorrect = true;
+	for( int iteration=0; iteration<2000; iteration++ )
+	{
+		Atomic<int64> total;
+		SumRange sum = { values, &total };
+		scheduler.parallelFor( 0, numValues, sum, 1 + (iteration % 64) );
+		bAllCorrect = bAllCorrect && (total.get() == expected);
+	}
+	expect( bAllCorrect, "parallelFor sums" );
+}
+
+// Counters on the heap, deleted as soon as the wait returns
+static void testCounterDeletedAfterWait(JobScheduler& scheduler)
+{
+	const int numJobs = 8;
+	CountingJob jobs[numJobs];
+
+	for( int iteration=0; iteration<5000; iteration++ )
+	{
+		JobScheduler::Counter* pCounter = new JobScheduler::Counter();
+		for( int i=0; i<numJobs; i++ )
+			scheduler.addJob( jobs + i, pCounter );
+		scheduler.waitForCounter( *pCounter );
+		delete pCounter;
+	}
+
+	bool bAllRan = true;
+	for( int i=0; i<numJobs; i++ )
+		bAllRan = bAllRan && (jobs[i].numRuns.get() == 5000);
+	expect( bAllRan, "counter deleted after wait" );
+}
+
+// Chains of jobs, each one depends on the counter of the previous one
+static void testDependencies(JobScheduler& scheduler)
+{
+	const int chainLength = 64;
+	const int numChains = 32;
+
+	for( int iteration=0; iteration<50; iteration++ )
+	{
+		OwnedArray<JobScheduler::Counter> counters;
+		CountingJob* jobs = new CountingJob [chainLength * numChains];
+		CountingJob noiseJob;
+		JobScheduler::Counter noiseCounter;
+
+		for( int c=0; c<numChains; c++ )
+		{
+			for( int i=0; i<chainLength; i++ )
+			{
+				const int index = c * chainLength + i;
+				JobScheduler::Counter* pDependency = (i > 0) ? counters.getLast() : nullptr;
+				JobScheduler::Counter* pCounter = new JobScheduler::Counter();
+				counters.add( pCounter );
+
+				jobs[index].pDependency = (i > 0) ? (jobs + index - 1) : nullptr;
+				scheduler.addJob( jobs + index, pCounter, pDependency );
+
+				// Independent jobs in between, so the chains are interleaved with other work
+				scheduler.addJob( &noiseJob, &noiseCounter );
+			}
+		}
+
+		for( int i=0; i<counters.size(); i++ )
+			scheduler.waitForCounter( *counters[i] );
+		scheduler.waitForCounter( noiseCounter );
+
+		bool bOrdered = true;
+		for( int i=0; i<chainLength * numChains; i++ )
+			bOrdered = bOrdered && (jobs[i].numRuns.get() == 1) && !jobs[i].bRanBeforeDependency;
+		expect( bOrdered, "dependency chains" );
+		delete [] jobs;
+	}
+}
+
+// Several threads adding jobs at the same time, plus the main thread
+static void testConcurrentProducers(JobScheduler& scheduler)
+{
+	OwnedArray<ProducerThread> producers;
+	for( int i=0; i<4; i++ )
+		producers.add( new ProducerThread(scheduler, i, 20000) );
+	for( int i=0; i<producers.size(); i++ )
+		producers[i]->startThread();
+
+	const int numValues = 4096;
+	HeapBlock<int> values(numValues);
+	for( int i=0; i<numValues; i++ )
+		values[i] = 1;
+	bool bSumsCorrect = true;
+	for( int iteration=0; iteration<500; iteration++ )
+	{
+		Atomic<int64> total;
+		SumRange sum = { values, &total };
+		scheduler.parallelFor( 0, numValues, sum, 16 );
+		bSumsCorrect = bSumsCorrect && (total.get() == numValues);
+	}
+
+	int numWrongRuns = 0;
+	for( int i=0; i<producers.size(); i++ )
+	{
+		producers[i]->waitForThreadToExit(-1);
+		numWrongRuns += producers[i]->numWrongRuns.get();
+	}
+
+	expect( bSumsCorrect && numWrongRuns == 0, "concurrent producers" );
+}
+
+// Records whether it ran on the main thread while the main thread was waiting for another counter
+class OtherCounterJob : public JobScheduler::Job
+{
+public:
+	void runJob()
+	{
+		if( Thread::getCurrentThreadId() == mainThreadId && bMainThreadWaiting.get() != 0 )
+			++numRunByWaitingThread;
+		Thread::sleep(1);
+	}
+
+	static Thread::ThreadID mainThreadId;
+	static Atomic<int> bMainThreadWaiting;
+	static Atomic<int> numRunByWaitingThread;
+};
+
+Thread::ThreadID OtherCounterJob::mainThreadId = 0;
+Atomic<int> OtherCounterJob::bMainThreadWaiting;
+Atomic<int> OtherCounterJob::numRunByWaitingThread;
+
+// A thread waiting for a counter only runs the jobs of that counter, slow jobs
+// of other counters (like file loading) are left to the workers
+static void testWaitRunsOnlyItsJobs(JobScheduler& scheduler)
+{
+	OtherCounterJob::mainThreadId = Thread::getCurrentThreadId();
+
+	const int numOtherJobs = 200;
+	OtherCounterJob otherJob;
+	JobScheduler::Counter otherCounter;
+	for( int i=0; i<numOtherJobs; i++ )
+		scheduler.addJob( &otherJob, &otherCounter );
+
+	const int numValues = 4096;
+	HeapBlock<int> values(numValues);
+	for( int i=0; i<numValues; i++ )
+		values[i] = 1;
+
+	bool bSumsCorrect = true;
+	OtherCounterJob::bMainThreadWaiting = 1;
+	for( int iteration=0; iteration<100; iteration++ )
+	{
+		Atomic<int64> total;
+		SumRange sum = { values, &total };
+		scheduler.parallelFor( 0, numValues, sum, 64 );
+		bSumsCorrect = bSumsCorrect && (total.get() == numValues);
+	}
+	OtherCounterJob::bMainThreadWaiting = 0;
+
+	scheduler.waitForCounter( otherCounter );
+	expect( bSumsCorrect && OtherCounterJob::numRunByWaitingThread.get() == 0, "wait only runs the jobs of its counter" );
+}
+
+// Adds jobs with a counter another thread is already waiting for
+class LateProducerThread : public Thread
+{
+public:
+	LateProducerThread(JobScheduler& s, JobScheduler::Counter& c, CountingJob* j, int numJobs_)
+		: Thread( "Late Job Producer" ), scheduler(s), counter(c), jobs(j), numJobs(numJobs_) {}
+
+	void run()
+	{
+		for( int i=0; i<numJobs; i++ )
+		{
+			Thread::sleep(2);
+			scheduler.addJob( jobs + i, &counter );
+		}
+	}
+
+	JobScheduler& scheduler;
+	JobScheduler::Counter& counter;
+	CountingJob* jobs;
+	const int numJobs;
+};
+
+// Keeps the only worker busy until the late jobs have run, or for 5 seconds
+class BusyWorkerJob : public JobScheduler::Job
+{
+public:
+	BusyWorkerJob(CountingJob* j, int numJobs_) : jobs(j), numJobs(numJobs_), bTimedOut(false) {}
+
+	void runJob()
+	{
+		bStarted = 1;
+		const uint32 startTime = Time::getMillisecondCounter();
+
+		for( int i=0; i<numJobs; i++ )
+		{
+			while( jobs[i].numRuns.get() == 0 && !bTimedOut )
+			{
+				Thread::sleep(1);
+				bTimedOut = (Time::getMillisecondCounter() - startTime) > 5000;
+			}
+		}
+	}
+
+	CountingJob* jobs;
+	const int numJobs;
+	Atomic<int> bStarted;
+	bool bTimedOut;
+};
+
+// The waiting thread sleeps while the worker runs a job of its counter, and must
+// wake up to run the jobs queued by another thread meanwhile
+static void testWaitWakesForQueuedJobs()
+{
+	JobScheduler scheduler(1);
+	const int numJobs = 20;
+	CountingJob jobs[numJobs];
+	JobScheduler::Counter counter;
+
+	BusyWorkerJob busyJob( jobs, numJobs );
+	scheduler.addJob( &busyJob, &counter );
+	while( busyJob.bStarted.get() == 0 )
+		Thread::sleep(1);
+
+	LateProducerThread producer( scheduler, counter, jobs, numJobs );
+	producer.startThread();
+	scheduler.waitForCounter( counter );
+	producer.waitForThreadToExit(-1);
+
+	bool bAllRan = !busyJob.bTimedOut;
+	for( int i=0; i<numJobs; i++ )
+		bAllRan = bAllRan && (jobs[i].numRuns.get() == 1);
+	expect( bAllRan, "waiting thread wakes for jobs queued by another thread" );
+}
+
+//==============================================================================
+// Thread started for every task, the way the engine's loaders used to do it
+class SumThread : public Thread
+{
+public:
+	SumThread() : Thread("Sum Thread") {}
+	void run()			{ sum (begin, end); }
+
+	SumRange sum;
+	int begin, end;
+};
+
+// Bone palette of one skeleton instance, evaluated like CSkeletonMeshInstance::updateBones():
+// two key frames interpolated per bone, then concatenated with the parent bone's matrix
+struct SkeletonInstance
+{
+	enum { NumBones = 64, NumKeyFrames = 32 };
+
+	float fAnimTime;
+	float KeyFrames[NumBones][NumKeyFrames][7];		// quaternion xyzw, translation xyz
+	float BoneMatrices[NumBones][12];				// 3x4 row major
+
+	void updateBones()
+	{
+		const int frame = (int) fAnimTime;
+		const float t = fAnimTime - (float) frame;
+
+		for( int b=0; b<NumBones; b++ )
+		{
+			const float* k0 = KeyFrames[b][frame % NumKeyFrames];
+			const float* k1 = KeyFrames[b][(frame + 1) % NumKeyFrames];
+
+			float q[4], v[3];
+			for( int i=0; i<4; i++ )
+				q[i] = k0[i] + (k1[i] - k0[i]) * t;
+			for( int i=0; i<3; i++ )
+				v[i] = k0[4+i] + (k1[4+i] - k0[4+i]) * t;
+			const float invLength = 1.0f / std::sqrt( q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3] );
+			for( int i=0; i<4; i++ )
+				q[i] *= invLength;
+
+			const float local[12] =
+			{
+				1 - 2*(q[1]*q[1] + q[2]*q[2]),	2*(q[0]*q[1] - q[2]*q[3]),		2*(q[0]*q[2] + q[1]*q[3]),		v[0],
+				2*(q[0]*q[1] + q[2]*q[3]),		1 - 2*(q[0]*q[0] + q[2]*q[2]),	2*(q[1]*q[2] - q[0]*q[3]),		v[1],
+				2*(q[0]*q[2] - q[1]*q[3]),		2*(q[1]*q[2] + q[0]*q[3]),		1 - 2*(q[0]*q[0] + q[1]*q[1]),	v[2]
+			};
+
+			float* m = BoneMatrices[b];
+			if( b == 0 )
+			{
+				memcpy( m, local, sizeof(local) );
+				continue;
+			}
+
+			const float* p = BoneMatrices[(b - 1) / 2];
+			for( int r=0; r<3; r++ )
+			{
+				for( int c=0; c<4; c++ )
+					m[r*4+c] = p[r*4] * local[c] + p[r*4+1] * local[4+c] + p[r*4+2] * local[8+c] + ((c == 3) ? p[r*4+3] : 0.0f);
+			}
+		}
+	}
+};
+
+// Runs updateBones() of instances [begin, end), like CSGPInstanceManager's bone jobs
+struct UpdateBonesRange
+{
+	void operator() (int begin, int end) const
+	{
+		for( int i=begin; i<end; i++ )
+			pInstances[i].updateBones();
+	}
+
+	SkeletonInstance* pInstances;
+};
+
+static void runBoneUpdateBenchmark(JobScheduler& scheduler)
+{
+	const int numInstances = 256;
+	const int numFrames = 100;
+	HeapBlock<SkeletonInstance> instances(numInstances);
+	Random random(11);
+
+	for( int i=0; i<numInstances; i++ )
+	{
+		float* pKey = &instances[i].KeyFrames[0][0][0];
+		for( int k=0; k<SkeletonInstance::NumBones * SkeletonInstance::NumKeyFrames * 7; k++ )
+			pKey[k] = random.nextFloat() - 0.5f;
+		instances[i].fAnimTime = random.nextFloat() * SkeletonInstance::NumKeyFrames;
+	}
+
+	HeapBlock<float> startTimes(numInstances);
+	for( int i=0; i<numInstances; i++ )
+		startTimes[i] = instances[i].fAnimTime;
+
+	UpdateBonesRange update = { instances };
+	float checksum[2] = { 0, 0 };
+	double frameTime[2] = { 0, 0 };
+
+	// The same frames serially and with parallelFor, the results must be the same
+	for( int pass=0; pass<2; pass++ )
+	{
+		for( int i=0; i<numInstances; i++ )
+			instances[i].fAnimTime = startTimes[i];
+
+		const double startTime = Time::getMillisecondCounterHiRes();
+		for( int frame=0; frame<numFrames; frame++ )
+		{
+			for( int i=0; i<numInstances; i++ )
+				instances[i].fAnimTime += 0.5f;
+
+			if( pass == 0 )
+				update( 0, numInstances );
+			else
+				scheduler.parallelFor( 0, numInstances, update, 1 );
+		}
+		frameTime[pass] = (Time::getMillisecondCounterHiRes() - startTime) / numFrames;
+
+		for( int i=0; i<numInstances; i++ )
+			checksum[pass] += instances[i].BoneMatrices[SkeletonInstance::NumBones - 1][3];
+	}
+
+	std::printf("bone update, %d skeletons of %d bones : serial %.3f ms, parallelFor %.3f ms per frame, %.2fx (%d workers + main thread, checksum %s)\n",
+		numInstances, (int) SkeletonInstance::NumBones, frameTime[0], frameTime[1], frameTime[0] / frameTime[1],
+		scheduler.getNumWorkers(), (checksum[0] == checksum[1]) ? "same" : "DIFFERENT");
+}
+
+static void runBenchmarks(JobScheduler& scheduler)
+{
+	// Overhead of one empty job
+	{
+		const int numJobs = 200000;
+		CountingJob* jobs = new CountingJob [numJobs];
+		JobScheduler::Counter counter;
+
+		const double startTime = Time::getMillisecondCounterHiRes();
+		for( int i=0; i<numJobs; i++ )
+			scheduler.addJob( jobs + i, &counter );
+		scheduler.waitForCounter( counter );
+		const double elapsed = Time::getMillisecondCounterHiRes() - startTime;
+
+		std::printf("empty job            : %8.3f us per job\n", elapsed * 1000.0 / numJobs);
+		delete [] jobs;
+	}
+
+	// parallelFor against a serial loop and against one thread per range
+	const int numValues = 1 << 22;
+	HeapBlock<int> values(numValues);
+	for( int i=0; i<numValues; i++ )
+		values[i] = i & 0xFF;
+
+	const int numRuns = 20;
+	const int numRanges = (scheduler.getNumWorkers() + 1) * 4;
+	Atomic<int64> total;
+	SumRange sum = { values, &total };
+
+	double startTime = Time::getMillisecondCounterHiRes();
+	for( int run=0; run<numRuns; run++ )
+		sum( 0, numValues );
+	const double serialTime = (Time::getMillisecondCounterHiRes() - startTime) / numRuns;
+
+	startTime = Time::getMillisecondCounterHiRes();
+	for( int run=0; run<numRuns; run++ )
+		scheduler.parallelFor( 0, numValues, sum );
+	const double parallelTime = (Time::getMillisecondCounterHiRes() - startTime) / numRuns;
+
+	startTime = Time::getMillisecondCounterHiRes();
+	for( int run=0; run<numRuns; run++ )
+	{
+		OwnedArray<SumThread> threads;
+		for( int i=0; i<numRanges; i++ )
+		{
+			SumThread* pThread = new SumThread();
+			threads.add( pThread );
+			pThread->sum = sum;
+			pThread->begin = (int) ((int64) numValues * i / numRanges);
+			pThread->end = (int) ((int64) numValues * (i + 1) / numRanges);
+			pThread->startThread();
+		}
+		for( int i=0; i<threads.size(); i++ )
+			threads[i]->waitForThreadToExit(-1);
+	}
+	const double threadTime = (Time::getMillisecondCounterHiRes() - startTime) / numRuns;
+
+	std::printf("sum of %d ints  : serial %.3f ms, parallelFor %.3f ms, thread per range %.3f ms (%d workers)\n",
+		numValues, serialTime, parallelTime, threadTime, scheduler.getNumWorkers());
+
+	runBoneUpdateBenchmark( scheduler );
+}
+
+//==============================================================================
+int main()
+{
+	// At least 3 workers so that stealing and contention happen on small machines too
+	JobScheduler scheduler( jmax(3, SystemStats::getNumCpus() - 1) );
+
+	testParallelForSum( scheduler );
+	testCounterDeletedAfterWait( scheduler );
+	testDependencies( scheduler );
+	testConcurrentProducers( scheduler );
+	testWaitRunsOnlyItsJobs( scheduler );
+	testWaitWakesForQueuedJobs();
+
+	// The shared scheduler used by the engine
+	testParallelForSum( JobScheduler::getSharedScheduler() );
+
+	runBenchmarks( scheduler );
+
+	std::printf( (g_iNumFailures == 0) ? "All JobScheduler tests passed\n" : "%d JobScheduler tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,404 @@
+/*
+	Regression test of the skeleton key frame lookup.
+
+	CSkeletonMeshInstance and CMeshComponent sample bone tracks with the
+	Calculate*AtTime() functions of sgp_modelFileBone.h, which find key frames with
+	FindKeyFrameAtTime(). This calls them on random key frame chains and compares
+	them against a brute-force linear scan of every key frame (the samplers used
+	before), the results must be bit-identical.
+
+	Standalone console program, it needs sgp_core, sgp_math and sgp_model:
+	compile it together with their module cpp files (and link the platform
+	thread library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_KeyFrameLookup.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+			../SGPLibraryCode/modules/sgp_math/sgp_math.cpp
+			../SGPLibraryCode/modules/sgp_model/sgp_model.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+#include "../SGPLibraryCode/modules/sgp_math/sgp_math.h"
+#include "../SGPLibraryCode/modules/sgp_model/sgp_model.h"
+
+using namespace sgp;
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+// Same as ISGPInstanceManager::DefaultSecondsPerFrame
+static const float SecondsPerFrame = 1.0f / 30;
+
+//==============================================================================
+// The samplers before FindKeyFrameAtTime, linear scan of every key frame
+static Vector3D linearTranslation(const KeyFrameBlock* pKeyFrames, float fTime)
+{
+	Vector3D vTrans;
+	float fInterp = 0.0f;
+
+	if( pKeyFrames->m_nextBlock == NULL && pKeyFrames->m_iNumber == 1 )
+	{
+		vTrans.Set( pKeyFrames->m_KeyFrames[0].m_fParam[0], pKeyFrames->m_KeyFrames[0].m_fParam[1], pKeyFrames->m_KeyFrames[0].m_fParam[2] );
+	}
+	else if( pKeyFrames->m_iNumber > 1 )
+	{
+		const SGPMF1KeyFrame *pLastKeyFrame = pKeyFrames->m_KeyFrames;
+		for( const KeyFrameBlock *pCurBlock = pKeyFrames; pCurBlock != NULL; pCurBlock = pCurBlock->m_nextBlock )
+		{
+			for( int i=0; i<pCurBlock->m_iNumber; i++ )
+			{
+				if( pCurBlock->m_KeyFrames[i].m_iFrameID * SecondsPerFrame >= fTime )
+				{
+					if( pCurBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
+						fInterp = 0;
+					else
+						fInterp = (fTime / SecondsPerFrame - pLastKeyFrame->m_iFrameID) /
+							float(pCurBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
+
+					vTrans.Set( pLastKeyFrame->m_fParam[0] + (pCurBlock->m_KeyFrames[i].m_fParam[0] - pLastKeyFrame->m_fParam[0]) * fInterp,
+								pLastKeyFrame->m_fParam[1] + (pCurBlock->m_KeyFrames[i].m_fParam[1] - pLastKeyFrame->m_fParam[1]) * fInterp,
+								pLastKeyFrame->m_fParam[2] + (pCurBlock->m_KeyFrames[i].m_fParam[2] - pLastKeyFrame->m_fParam[2]) * fInterp );
+					return vTrans;
+				}
+				pLastKeyFrame = &pCurBlock->m_KeyFrames[i];
+			}
+		}
+	}
+	return vTrans;
+}
+
+static Quaternion linearRotation(const KeyFrameBlock* pKeyFrames, float fTime)
+{
+	Quaternion vRots;
+	float fInterp = 0.0f;
+
+	if( pKeyFrames->m_nextBlock == NULL && pKeyFrames->m_iNumber == 1 )
+	{
+		return Quaternion( pKeyFrames->m_KeyFrames[0].m_fParam[0], pKeyFrames->m_KeyFrames[0].m_fParam[1],
+						   pKeyFrames->m_KeyFrames[0].m_fParam[2], pKeyFrames->m_KeyFrames[0].m_fParam[3] );
+	}
+	else if( pKeyFrames->m_iNumber > 1 )
+	{
+		const SGPMF1KeyFrame *pLastKeyFrame = pKeyFrames->m_KeyFrames;
+		for( const KeyFrameBlock *pCurBlock = pKeyFrames; pCurBlock != NULL; pCurBlock = pCurBlock->m_nextBlock )
+		{
+			for( int i=0; i<pCurBlock->m_iNumber; i++ )
+			{
+				if( pCurBlock->m_KeyFrames[i].m_iFrameID * SecondsPerFrame >= fTime )
+				{
+					if( pCurBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
+						fInterp = 0;
+					else
+						fInterp = (fTime / SecondsPerFrame - pLastKeyFrame->m_iFrameID) /
+							float(pCurBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
+
+					Quaternion vCurRots( pCurBlock->m_KeyFrames[i].m_fParam[0], pCurBlock->m_KeyFrames[i].m_fParam[1],
+										 pCurBlock->m_KeyFrames[i].m_fParam[2], pCurBlock->m_KeyFrames[i].m_fParam[3] );
+					vRots.x = pLastKeyFrame->m_fParam[0];
+					vRots.y = pLastKeyFrame->m_fParam[1];
+					vRots.z = pLastKeyFrame->m_fParam[2];
+					vRots.w = pLastKeyFrame->m_fParam[3];
+					vRots.Slerp(vCurRots, fInterp);
+					return vRots;
+				}
+				pLastKeyFrame = &pCurBlock->m_KeyFrames[i];
+			}
+		}
+	}
+	return vRots;
+}
+
+static float linearScale(const ScaleKeyFrameBlock* pKeyFrames, float fTime)
+{
+	float scale = 1.0f;
+	float fInterp = 0.0f;
+
+	if( pKeyFrames->m_nextBlock == NULL && pKeyFrames->m_iNumber == 1 )
+	{
+		return pKeyFrames->m_KeyFrames[0].m_scale;
+	}
+	else if( pKeyFrames->m_iNumber > 1 )
+	{
+		const SGPMF1ScaleKeyFrame *pLastKeyFrame = pKeyFrames->m_KeyFrames;
+		for( const ScaleKeyFrameBlock *pCurBlock = pKeyFrames; pCurBlock != NULL; pCurBlock = pCurBlock->m_nextBlock )
+		{
+			for( int i=0; i<pCurBlock->m_iNumber; i++ )
+			{
+				if( pCurBlock->m_KeyFrames[i].m_iFrameID * SecondsPerFrame >= fTime )
+				{
+					if( pCurBlock->m_KeyFrames[i].m_iFrameID == pLastKeyFrame->m_iFrameID )
+						fInterp = 0;
+					else
+						fInterp = (fTime / SecondsPerFrame - pLastKeyFrame->m_iFrameID) /
+							float(pCurBlock->m_KeyFrames[i].m_iFrameID - pLastKeyFrame->m_iFrameID);
+
+					scale = pLastKeyFrame->m_scale + (pCurBlock->m_KeyFrames[i].m_scale - pLastKeyFrame->m_scale) * fInterp;
+					return scale;
+				}
+				pLastKeyFrame = &pCurBlock->m_KeyFrames[i];
+			}
+		}
+	}
+	return scale;
+}
+
+static bool linearVisible(const VisibleKeyFrameBlock* pKeyFrames, float fTime)
+{
+	bool bVisible = true;
+
+	if( pKeyFrames->m_nextBlock == NULL && pKeyFrames->m_iNumber == 1 )
+	{
+		return pKeyFrames->m_KeyFrames[0].m_Visible;
+	}
+	else if( pKeyFrames->m_iNumber > 1 )
+	{
+		bVisible = pKeyFrames->m_KeyFrames[0].m_Visible;
+		for( const VisibleKeyFrameBlock *pCurBlock = pKeyFrames; pCurBlock != NULL; pCurBlock = pCurBlock->m_nextBlock )
+		{
+			for( int i=0; i<pCurBlock->m_iNumber; i++ )
+			{
+				if( pCurBlock->m_KeyFrames[i].m_iFrameID * SecondsPerFrame == fTime )
+					return pCurBlock->m_KeyFrames[i].m_Visible;
+				if( pCurBlock->m_KeyFrames[i].m_iFrameID * SecondsPerFrame > fTime )
+					return bVisible;
+				bVisible = pCurBlock->m_KeyFrames[i].m_Visible;
+			}
+		}
+	}
+	return bVisible;
+}
+
+//==============================================================================
+// A chain of key frame blocks with increasing frame IDs. Frame IDs repeat sometimes,
+// and blocks after the first one may be empty, like the blocks of appended animation files
+template <typename BlockType, typename KeyFrameType>
+class KeyFrameChain
+{
+public:
+	KeyFrameChain(Random& random, int maxNumBlocks, int maxKeysPerBlock)
+	{
+		const int numBlocks = 1 + random.nextInt(maxNumBlocks);
+		uint32 FrameID = (uint32) random.nextInt(10);
+
+		for( int b=0; b<numBlocks; b++ )
+		{
+			BlockType* pBlock = new BlockType();
+			const int numKeys = (b == 0) ? 2 + random.nextInt(maxKeysPerBlock - 1) : random.nextInt(maxKeysPerBlock + 1);
+
+			pBlock->m_iNumber = (uint16) numKeys;
+			pBlock->m_KeyFrames = new KeyFrameType [jmax(1, numKeys)];
+			for( int k=0; k<numKeys; k++ )
+			{
+				pBlock->m_KeyFrames[k].m_iFrameID = FrameID;
+				setValue( pBlock->m_KeyFrames[k], random );
+				if( random.nextInt(5) != 0 )
+					FrameID += 1 + (uint32) random.nextInt(4);
+			}
+
+			if( blocks.size() > 0 )
+				blocks.getLast()->m_nextBlock = pBlock;
+			blocks.add( pBlock );
+		}
+		lastFrameID = FrameID;
+	}
+
+	~KeyFrameChain()
+	{
+		for( int i=0; i<blocks.size(); i++ )
+		{
+			delete [] blocks[i]->m_KeyFrames;
+			delete blocks[i];
+		}
+	}
+
+	const BlockType* getFirstBlock() const		{ return blocks[0]; }
+
+	// On a key, between keys, before the first key or after the last one
+	float getRandomTime(Random& random) const
+	{
+		switch( random.nextInt(3) )
+		{
+		case 0:		return random.nextInt(lastFrameID + 2) * SecondsPerFrame;
+		case 1:		return (random.nextFloat() * (lastFrameID + 2) - 1.0f) * SecondsPerFrame;
+		default:	return (float)random.nextInt(lastFrameID + 2) / 30;
+		}
+	}
+
+private:
+	static void setValue(SGPMF1KeyFrame& KeyFrame, Random& random)
+	{
+		for( int i=0; i<4; i++ )
+			KeyFrame.m_fParam[i] = random.nextFloat() * 2.0f - 1.0f;
+	}
+	static void setValue(SGPMF1ScaleKeyFrame& KeyFrame, Random& random)		{ KeyFrame.m_scale = random.nextFloat() * 2.0f; }
+	static void setValue(SGPMF1VisibleKeyFrame& KeyFrame, Random& random)	{ KeyFrame.m_Visible = random.nextBool(); }
+
+	Array<BlockType*> blocks;
+	uint32 lastFrameID;
+};
+
+// Brute-force FindKeyFrameAtTime : the first key frame not earlier than fTime and the one before it
+template <typename BlockType, typename KeyFrameType>
+static const KeyFrameType* linearFindKeyFrame(const BlockType* pFirstBlock, float fTime, const KeyFrameType* &pLastKeyFrame)
+{
+	pLastKeyFrame = pFirstBlock->m_KeyFrames;
+	for( const BlockType *pCurBlock = pFirstBlock; pCurBlock != NULL; pCurBlock = pCurBlock->m_nextBlock )
+	{
+		for( int i=0; i<pCurBlock->m_iNumber; i++ )
+		{
+			if( pCurBlock->m_KeyFrames[i].m_iFrameID * SecondsPerFrame >= fTime )
+				return &pCurBlock->m_KeyFrames[i];
+			pLastKeyFrame = &pCurBlock->m_KeyFrames[i];
+		}
+	}
+	return NULL;
+}
+
+static bool isSameFloat(float a, float b)
+{
+	return memcmp( &a, &b, sizeof(float) ) == 0;
+}
+
+//==============================================================================
+static void testFindKeyFrame(Random& random, int maxNumBlocks, int maxKeysPerBlock)
+{
+	bool bSame = true;
+	for( int chain=0; chain<500; chain++ )
+	{
+		KeyFrameChain<ScaleKeyFrameBlock, SGPMF1ScaleKeyFrame> KeyFrames( random, maxNumBlocks, maxKeysPerBlock );
+		for( int sample=0; sample<200; sample++ )
+		{
+			const float fTime = KeyFrames.getRandomTime( random );
+
+			const SGPMF1ScaleKeyFrame *pLinearLast = NULL, *pSearchLast = NULL;
+			const SGPMF1ScaleKeyFrame *pLinear = linearFindKeyFrame( KeyFrames.getFirstBlock(), fTime, pLinearLast );
+			const SGPMF1ScaleKeyFrame *pSearch = FindKeyFrameAtTime( KeyFrames.getFirstBlock(), fTime, SecondsPerFrame, pSearchLast );
+			bSame = bSame && (pLinear == pSearch) && (pLinearLast == pSearchLast);
+		}
+	}
+	expect( bSame, "FindKeyFrameAtTime" );
+}
+
+// Bones without a track keep the default transform
+static void testEmptyTracks()
+{
+	const Vector3D vTrans = CalculateTranslationAtTime( NULL, 1.0f, SecondsPerFrame );
+	const Quaternion vRots = CalculateRotationAtTime( NULL, 1.0f, SecondsPerFrame );
+	expect( vTrans.x == 0 && vTrans.y == 0 && vTrans.z == 0, "no translation track" );
+	expect( vRots.x == 0 && vRots.y == 0 && vRots.z == 0 && vRots.w == 1.0f, "no rotation track" );
+	expect( CalculateScaleAtTime( NULL, 1.0f, SecondsPerFrame ) == 1.0f, "no scale track" );
+	expect( CalculateVisibleAtTime( NULL, 1.0f, SecondsPerFrame ), "no visible track" );
+}
+
+//==============================================================================
+static void testTranslationAndRotation(Random& random, int maxNumBlocks, int maxKeysPerBlock)
+{
+	bool bSameTranslation = true, bSameRotation = true;
+	for( int chain=0; chain<500; chain++ )
+	{
+		KeyFrameChain<KeyFrameBlock, SGPMF1KeyFrame> KeyFrames( random, maxNumBlocks, maxKeysPerBlock );
+		for( int sample=0; sample<200; sample++ )
+		{
+			const float fTime = KeyFrames.getRandomTime( random );
+
+			const Vector3D vLinearTrans = linearTranslation( KeyFrames.getFirstBlock(), fTime );
+			const Vector3D vSearchTrans = CalculateTranslationAtTime( KeyFrames.getFirstBlock(), fTime, SecondsPerFrame );
+			bSameTranslation = bSameTranslation && isSameFloat(vLinearTrans.x, vSearchTrans.x) &&
+				isSameFloat(vLinearTrans.y, vSearchTrans.y) && isSameFloat(vLinearTrans.z, vSearchTrans.z);
+
+			const Quaternion vLinearRots = linearRotation( KeyFrames.getFirstBlock(), fTime );
+			const Quaternion vSearchRots = CalculateRotationAtTime( KeyFrames.getFirstBlock(), fTime, SecondsPerFrame );
+			bSameRotation = bSameRotation && isSameFloat(vLinearRots.x, vSearchRots.x) && isSameFloat(vLinearRots.y, vSearchRots.y) &&
+				isSameFloat(vLinearRots.z, vSearchRots.z) && isSameFloat(vLinearRots.w, vSearchRots.w);
+		}
+	}
+	expect( bSameTranslation, "translation key frames" );
+	expect( bSameRotation, "rotation key frames" );
+}
+
+static void testScale(Random& random, int maxNumBlocks, int maxKeysPerBlock)
+{
+	bool bSame = true;
+	for( int chain=0; chain<500; chain++ )
+	{
+		KeyFrameChain<ScaleKeyFrameBlock, SGPMF1ScaleKeyFrame> KeyFrames( random, maxNumBlocks, maxKeysPerBlock );
+		for( int sample=0; sample<200; sample++ )
+		{
+			const float fTime = KeyFrames.getRandomTime( random );
+			bSame = bSame && isSameFloat( linearScale(KeyFrames.getFirstBlock(), fTime), CalculateScaleAtTime(KeyFrames.getFirstBlock(), fTime, SecondsPerFrame) );
+		}
+	}
+	expect( bSame, "scale key frames" );
+}
+
+static void testVisible(Random& random, int maxNumBlocks, int maxKeysPerBlock)
+{
+	bool bSame = true;
+	for( int chain=0; chain<500; chain++ )
+	{
+		KeyFrameChain<VisibleKeyFrameBlock, SGPMF1VisibleKeyFrame> KeyFrames( random, maxNumBlocks, maxKeysPerBlock );
+		for( int sample=0; sample<200; sample++ )
+		{
+			const float fTime = KeyFrames.getRandomTime( random );
+			bSame = bSame && (linearVisible(KeyFrames.getFirstBlock(), fTime) == CalculateVisibleAtTime(KeyFrames.getFirstBlock(), fTime, SecondsPerFrame));
+		}
+	}
+	expect( bSame, "visible key frames" );
+}
+
+// Lookup time of a long clip, sampled at every frame
+static void runBenchmark(Random& random)
+{
+	KeyFrameChain<KeyFrameBlock, SGPMF1KeyFrame> KeyFrames( random, 4, 500 );
+	const int numSamples = 200000;
+	float fSum = 0;
+
+	double startTime = Time::getMillisecondCounterHiRes();
+	for( int i=0; i<numSamples; i++ )
+		fSum += linearTranslation( KeyFrames.getFirstBlock(), (i % 2000) * SecondsPerFrame ).x;
+	const double linearTime = Time::getMillisecondCounterHiRes() - startTime;
+
+	startTime = Time::getMillisecondCounterHiRes();
+	for( int i=0; i<numSamples; i++ )
+		fSum -= CalculateTranslationAtTime( KeyFrames.getFirstBlock(), (i % 2000) * SecondsPerFrame, SecondsPerFrame ).x;
+	const double searchTime = Time::getMillisecondCounterHiRes() - startTime;
+
+	std::printf("translation sample   : linear %.3f us, CalculateTranslationAtTime %.3f us (checksum %g)\n",
+		linearTime * 1000.0 / numSamples, searchTime * 1000.0 / numSamples, fSum);
+}
+
+//==============================================================================
+int main()
+{
+	Random random(12345);
+
+	// Short chains hit the block boundaries often, long ones the binary search
+	testFindKeyFrame( random, 1, 4 );
+	testFindKeyFrame( random, 5, 8 );
+	testFindKeyFrame( random, 3, 200 );
+	testTranslationAndRotation( random, 1, 4 );
+	testTranslationAndRotation( random, 5, 8 );
+	testTranslationAndRotation( random, 3, 200 );
+	testScale( random, 5, 8 );
+	testScale( random, 3, 200 );
+	testVisible( random, 5, 8 );
+	testVisible( random, 3, 200 );
+	testEmptyTracks();
+
+	runBenchmark( random );
+
+	std::printf( (g_iNumFailures == 0) ? "All key frame lookup tests passed\n" : "%d key frame lookup tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
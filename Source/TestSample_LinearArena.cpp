@@ -0,0 +1,334 @@
+/*
+	Tests of LinearArena and ArenaArrayAllocationBase, and a count of the heap calls
+	per frame made by per-frame arrays on the heap and in the frame arena.
+
+	The frame below does what the world manager does every frame: it refills the
+	visible chunk, culling candidate and grass cluster arrays, and sorts through a
+	temporary array inside a function. The heap calls are counted for the whole
+	process, by hooking malloc with glibc, or with the debug CRT's allocation hook
+	with Visual C++ (other builds only count operator new).
+
+	Standalone console program, it only needs sgp_core:
+	compile it together with SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+	(and link the platform thread library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_LinearArena.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+
+#if SGP_MSVC && defined (_DEBUG)
+ #include <crtdbg.h>
+#endif
+
+using namespace sgp;
+
+
+//==============================================================================
+// Number of heap allocations made by the process
+static int g_iNumHeapCalls = 0;
+
+#if SGP_MSVC && defined (_DEBUG)
+static int countingAllocHook(int allocType, void*, size_t, int, long, const unsigned char*, int, int)
+{
+	if( allocType != _HOOK_FREE )
+		g_iNumHeapCalls++;
+	return TRUE;
+}
+
+static void startCountingHeapCalls()		{ _CrtSetAllocHook( (_CRT_ALLOC_HOOK)countingAllocHook ); }
+
+#elif defined (__GLIBC__)
+extern "C"
+{
+	void* __libc_malloc(size_t);
+	void* __libc_calloc(size_t, size_t);
+	void* __libc_realloc(void*, size_t);
+
+	void* malloc(size_t size)					{ g_iNumHeapCalls++; return __libc_malloc(size); }
+	void* calloc(size_t num, size_t size)		{ g_iNumHeapCalls++; return __libc_calloc(num, size); }
+	void* realloc(void* ptr, size_t size)		{ g_iNumHeapCalls++; return __libc_realloc(ptr, size); }
+}
+
+static void startCountingHeapCalls()		{}
+
+#else
+void* operator new(size_t size)
+{
+	g_iNumHeapCalls++;
+	if( void* p = std::malloc(size) )
+		return p;
+	throw std::bad_alloc();
+}
+void* operator new[](size_t size)		{ return operator new(size); }
+void operator delete(void* p) noexcept		{ std::free(p); }
+void operator delete[](void* p) noexcept	{ std::free(p); }
+
+static void startCountingHeapCalls()		{}
+#endif
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+//==============================================================================
+// Same size as SGPVertex_GRASS_Cluster
+struct GrassCluster
+{
+	float vPosition[4];
+	uint32 PackedNormal;
+	uint32 Color;
+	float TexIndex[2];
+};
+
+class GrassClusterSorter
+{
+public:
+	static int compareElements(const GrassCluster& first, const GrassCluster& second) noexcept
+	{
+		return (first.vPosition[2] < second.vPosition[2]) ? -1 : ((second.vPosition[2] < first.vPosition[2]) ? 1 : 0);
+	}
+};
+
+// The per-frame arrays of the world manager, with their storage on the heap
+// (as they were) or in the frame arena
+template <template <class> class StorageType, class ScratchStorageType>
+class WorldFrame
+{
+public:
+	WorldFrame()
+	{
+		m_VisibleChunkArray.ensureStorageAllocated(256);
+	}
+
+	// Fills the arrays with numVisible items, and checks their contents
+	bool update(int numVisible)
+	{
+		m_VisibleChunkArray.clearQuick();
+		m_SceneObjectCandidates.clearQuick();
+		m_GrassClusterInstanceArray.clearQuick();
+
+		for( int i=0; i<numVisible; i++ )
+		{
+			m_VisibleChunkArray.add( (void*)(pointer_sized_int)(i * 16 + 16) );
+			m_SceneObjectCandidates.add( (void*)(pointer_sized_int)(i * 32 + 32) );
+			m_SceneObjectCandidates.add( (void*)(pointer_sized_int)(i * 32 + 48) );
+
+			GrassCluster Cluster;
+			Cluster.vPosition[0] = (float)i;
+			Cluster.vPosition[1] = 0;
+			Cluster.vPosition[2] = (float)((i * 7919) % numVisible);
+			Cluster.vPosition[3] = 1.0f;
+			Cluster.PackedNormal = Cluster.Color = (uint32)i;
+			Cluster.TexIndex[0] = Cluster.TexIndex[1] = 0;
+			m_GrassClusterInstanceArray.add( Cluster );
+		}
+
+		GrassClusterSorter sorter;
+		m_GrassClusterInstanceArray.sort( sorter );
+
+		bool bCorrect = (m_VisibleChunkArray.size() == numVisible) && (m_SceneObjectCandidates.size() == numVisible * 2);
+		for( int i=0; i<numVisible; i++ )
+		{
+			bCorrect = bCorrect && (m_VisibleChunkArray[i] == (void*)(pointer_sized_int)(i * 16 + 16)) &&
+				(m_SceneObjectCandidates[i * 2 + 1] == (void*)(pointer_sized_int)(i * 32 + 48)) &&
+				(m_GrassClusterInstanceArray.getReference(i).vPosition[2] == (float)i);
+		}
+
+		return bCorrect && (sortByDistance() == numVisible);
+	}
+
+private:
+	// A temporary array inside a function, like the distances used for sorting
+	int sortByDistance()
+	{
+		ScratchStorageType distances;
+		for( int i=0; i<m_VisibleChunkArray.size(); i++ )
+			distances.add( (float)((i * 31) % 97) );
+
+		DefaultElementComparator<float> comparator;
+		distances.sort( comparator );
+
+		int numSorted = (distances.size() > 0) ? 1 : 0;
+		for( int i=1; i<distances.size(); i++ )
+			if( distances[i - 1] <= distances[i] )
+				numSorted++;
+		return numSorted;
+	}
+
+	typename StorageType<void*>::ArrayType m_VisibleChunkArray;
+	typename StorageType<void*>::ArrayType m_SceneObjectCandidates;
+	typename StorageType<GrassCluster>::ArrayType m_GrassClusterInstanceArray;
+};
+
+template <class ElementType>
+struct HeapStorage
+{
+	typedef Array<ElementType> ArrayType;
+};
+
+template <class ElementType>
+struct FrameArenaStorage
+{
+	typedef Array<ElementType, DummyCriticalSection, ArenaArrayAllocationBase<ElementType, DummyCriticalSection> > ArrayType;
+};
+
+typedef Array<float, DummyCriticalSection, ArenaArrayAllocationBase<float, DummyCriticalSection, ScratchArenaSource> > ScratchFloatArray;
+
+// Runs frames with a varying number of visible items, the first frames grow the arrays.
+// Returns the heap calls of each frame.
+template <class WorldFrameType>
+static Array<int> runFrames(WorldFrameType& world, int numFrames, bool bResetFrameArena, bool& bCorrect)
+{
+	Random random(7);
+	Array<int> heapCallsPerFrame;
+	heapCallsPerFrame.ensureStorageAllocated(numFrames);
+
+	for( int frame=0; frame<numFrames; frame++ )
+	{
+		const int numVisible = (frame < 10) ? 500 + frame * 300 : 500 + random.nextInt(3000);
+		const int numHeapCallsBefore = g_iNumHeapCalls;
+
+		{
+			// The scratch arena is only rewound, the temporary arrays are freed here
+			LinearArena::ScopedRewind rewind( LinearArena::getScratchArena() );
+			bCorrect = world.update( numVisible ) && bCorrect;
+		}
+
+		// What the render device does in endScene()
+		if( bResetFrameArena )
+			LinearArena::getFrameArena().reset();
+
+		heapCallsPerFrame.add( g_iNumHeapCalls - numHeapCallsBefore );
+	}
+	return heapCallsPerFrame;
+}
+
+static void testHeapCallsPerFrame()
+{
+	const int numFrames = 60;
+	const int numWarmUpFrames = 20;
+
+	// The scratch arena of this thread is created before counting
+	LinearArena::getScratchArena();
+
+	bool bHeapCorrect = true, bArenaCorrect = true;
+	WorldFrame<HeapStorage, Array<float> > heapWorld;
+	const Array<int> heapCalls = runFrames( heapWorld, numFrames, false, bHeapCorrect );
+
+	WorldFrame<FrameArenaStorage, ScratchFloatArray> arenaWorld;
+	const Array<int> arenaCalls = runFrames( arenaWorld, numFrames, true, bArenaCorrect );
+
+	int numHeapCalls = 0, numArenaCalls = 0, numArenaCallsAfterWarmUp = 0;
+	for( int i=0; i<numFrames; i++ )
+	{
+		numHeapCalls += heapCalls[i];
+		numArenaCalls += arenaCalls[i];
+		if( i >= numWarmUpFrames )
+			numArenaCallsAfterWarmUp += arenaCalls[i];
+	}
+
+	expect( bHeapCorrect && bArenaCorrect, "per-frame array contents" );
+	expect( numArenaCallsAfterWarmUp == 0, "no heap calls per frame after warm-up with the arenas" );
+	std::printf("heap calls in %d frames : %d with heap arrays, %d with the arenas (%d after frame %d), frame arena %d KB in %d heap blocks\n",
+		numFrames, numHeapCalls, numArenaCalls, numArenaCallsAfterWarmUp, numWarmUpFrames,
+		(int)(LinearArena::getFrameArena().getCapacity() / 1024), LinearArena::getFrameArena().getNumHeapAllocations());
+}
+
+//==============================================================================
+static void testArena()
+{
+	LinearArena arena(256);
+
+	// Alignment, and blocks taken when the current one is full
+	bool bAligned = true;
+	for( int i=0; i<1000; i++ )
+	{
+		const size_t alignment = (size_t)1 << (i % 8);
+		void* p = arena.allocate( 1 + (i % 100), alignment );
+		bAligned = bAligned && ((((pointer_sized_int)p) & (alignment - 1)) == 0);
+	}
+	expect( bAligned, "allocations aligned" );
+
+	// After a reset the blocks are merged, the same use doesn't take more blocks
+	arena.reset();
+	const int numBlocks = arena.getNumHeapAllocations();
+	for( int cycle=0; cycle<10; cycle++ )
+	{
+		for( int i=0; i<1000; i++ )
+			arena.allocate( 1 + (i % 100), (size_t)1 << (i % 8) );
+		arena.reset();
+	}
+	expect( arena.getNumHeapAllocations() == numBlocks && arena.getNumBytesUsed() == 0, "blocks merged on reset" );
+
+	// Growing the last allocation in place, and copying the contents when it can't be
+	char* p = (char*)arena.allocate( 16, 16 );
+	memcpy( p, "0123456789abcdef", 16 );
+	char* grown = (char*)arena.reallocate( p, 16, 32 );
+	char* moved = (char*)arena.reallocate( grown, 32, arena.getCapacity() * 2 );
+	expect( grown == p && moved != p && memcmp(moved, "0123456789abcdef", 16) == 0, "reallocate" );
+
+	// A rewind gives back what was allocated inside the scope
+	arena.reset();
+	arena.allocate( 100 );
+	const size_t numBytesUsed = arena.getNumBytesUsed();
+	{
+		LinearArena::ScopedRewind rewind( arena );
+		for( int i=0; i<100; i++ )
+			arena.allocate( 1000 );
+	}
+	expect( arena.getNumBytesUsed() == numBytesUsed, "scoped rewind" );
+}
+
+// An arena array starts over when the arena has been reset, with its previous capacity
+static void testArenaArrayAfterReset()
+{
+	LinearArena& frameArena = LinearArena::getFrameArena();
+	FrameArenaStorage<int>::ArrayType values;
+
+	for( int frame=0; frame<5; frame++ )
+	{
+		values.clearQuick();
+		for( int i=0; i<5000; i++ )
+			values.add( i * frame );
+
+		bool bCorrect = (values.size() == 5000);
+		for( int i=0; i<values.size(); i++ )
+			bCorrect = bCorrect && (values[i] == i * frame);
+		expect( bCorrect, "arena array contents" );
+		frameArena.reset();
+	}
+
+	values.clearQuick();
+	const size_t numBytesBefore = frameArena.getNumBytesUsed();
+	values.add( 1 );
+	expect( frameArena.getNumBytesUsed() - numBytesBefore >= 5000 * sizeof(int), "previous capacity after reset" );
+	frameArena.reset();
+}
+
+//==============================================================================
+int main()
+{
+	startCountingHeapCalls();
+
+	testArena();
+	testArenaArrayAfterReset();
+	testHeapCallsPerFrame();
+
+	LinearArena::releaseScratchArena();
+
+	std::printf( (g_iNumFailures == 0) ? "All LinearArena tests passed\n" : "%d LinearArena tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
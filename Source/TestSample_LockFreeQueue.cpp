@@ -0,0 +1,286 @@
+/*
+	Multithreaded stress test of SPSCQueue and MPMCQueue.
+
+	Standalone console program, it only needs sgp_core:
+	compile it together with SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+	(and link the platform thread library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_LockFreeQueue.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass. Run it under a thread sanitizer to check
+	the memory ordering of the queues as well.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+
+using namespace sgp;
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+// Called when push() found the queue full or pop() found it empty. Spinning only works
+// when the other side runs on another core, so after a few tries the CPU is given away
+static void waitBeforeRetry(int& numRetries)
+{
+	if( ++numRetries < 16 )
+		Thread::yield();
+	else
+		Thread::sleep(1);
+}
+
+//==============================================================================
+// Element bigger than one word, so a torn copy shows up as a wrong check value
+struct QueueItem
+{
+	uint32 producer;
+	uint32 sequence;
+	uint32 check;
+
+	QueueItem() : producer(0), sequence(0), check(0) {}
+	QueueItem(uint32 p, uint32 s) : producer(p), sequence(s), check(makeCheck(p, s)) {}
+
+	static uint32 makeCheck(uint32 p, uint32 s)		{ return (p * 2654435761u) ^ (s * 40503u) ^ 0x5A5A5A5Au; }
+	bool isIntact() const							{ return check == makeCheck(producer, sequence); }
+};
+
+//==============================================================================
+// Pushes numItems values 0, 1, 2... into an SPSCQueue
+class SPSCProducerThread : public Thread
+{
+public:
+	SPSCProducerThread(SPSCQueue<QueueItem>& q, int numItems_)
+		: Thread("SPSC Producer"), queue(q), numItems(numItems_) {}
+
+	void run()
+	{
+		for( int i=0; i<numItems; i++ )
+		{
+			const QueueItem item(0, (uint32) i);
+			for( int numRetries=0; !queue.push(item); )
+				waitBeforeRetry(numRetries);
+		}
+	}
+
+	SPSCQueue<QueueItem>& queue;
+	const int numItems;
+};
+
+// One producer and one consumer, the values must come out complete and in order
+static void testSPSCOrder(int capacity, int numItems)
+{
+	SPSCQueue<QueueItem> queue(capacity);
+	SPSCProducerThread producer(queue, numItems);
+	producer.startThread();
+
+	bool bInOrder = true;
+	for( int i=0; i<numItems; i++ )
+	{
+		QueueItem item;
+		for( int numRetries=0; !queue.pop(item); )
+			waitBeforeRetry(numRetries);
+		bInOrder = bInOrder && item.isIntact() && (item.sequence == (uint32) i);
+	}
+	producer.waitForThreadToExit(-1);
+
+	QueueItem item;
+	expect( bInOrder, "SPSC values in order" );
+	expect( !queue.pop(item) && queue.getNumReady() == 0, "SPSC empty at the end" );
+}
+
+// Full and empty are reported at the capacity, also after the positions have wrapped around
+static void testSPSCBounds()
+{
+	SPSCQueue<QueueItem> queue(5);
+	expect( queue.getCapacity() == 8, "SPSC capacity rounded up" );
+
+	bool bBoundsCorrect = true;
+	for( int lap=0; lap<1000; lap++ )
+	{
+		for( int i=0; i<queue.getCapacity(); i++ )
+			bBoundsCorrect = bBoundsCorrect && queue.push(QueueItem(0, (uint32) i));
+		bBoundsCorrect = bBoundsCorrect && !queue.push(QueueItem()) && (queue.getNumReady() == queue.getCapacity());
+
+		QueueItem item;
+		for( int i=0; i<queue.getCapacity(); i++ )
+			bBoundsCorrect = bBoundsCorrect && queue.pop(item) && (item.sequence == (uint32) i);
+		bBoundsCorrect = bBoundsCorrect && !queue.pop(item);
+	}
+	expect( bBoundsCorrect, "SPSC full and empty" );
+}
+
+//==============================================================================
+// Pushes numItems values tagged with its index into an MPMCQueue
+class MPMCProducerThread : public Thread
+{
+public:
+	MPMCProducerThread(MPMCQueue<QueueItem>& q, int index_, int numItems_)
+		: Thread("MPMC Producer " + String(index_)), queue(q), index(index_), numItems(numItems_) {}
+
+	void run()
+	{
+		for( int i=0; i<numItems; i++ )
+		{
+			const QueueItem item((uint32) index, (uint32) i);
+			for( int numRetries=0; !queue.push(item); )
+				waitBeforeRetry(numRetries);
+		}
+	}
+
+	MPMCQueue<QueueItem>& queue;
+	const int index;
+	const int numItems;
+};
+
+// Pops until the shared count of consumed values reaches the total
+class MPMCConsumerThread : public Thread
+{
+public:
+	MPMCConsumerThread(MPMCQueue<QueueItem>& q, int index_, int numProducers_, Atomic<int>& consumed, int totalItems_)
+		: Thread("MPMC Consumer " + String(index_)), queue(q), numProducers(numProducers_),
+		  numConsumed(consumed), totalItems(totalItems_),
+		  lastSequence(numProducers_), received(numProducers_, true), bOrdered(true), bIntact(true)
+	{
+		for( int i=0; i<numProducers; i++ )
+			lastSequence[i] = -1;
+	}
+
+	void run()
+	{
+		int numRetries = 0;
+		while( numConsumed.get() < totalItems )
+		{
+			QueueItem item;
+			if( !queue.pop(item) )
+			{
+				waitBeforeRetry(numRetries);
+				continue;
+			}
+			numRetries = 0;
+			++numConsumed;
+
+			if( !item.isIntact() || (int) item.producer >= numProducers )
+			{
+				bIntact = false;
+				continue;
+			}
+
+			// The values of one producer are taken from the queue in order, so every
+			// consumer sees them in increasing order
+			if( (int) item.sequence <= lastSequence[item.producer] )
+				bOrdered = false;
+			lastSequence[item.producer] = (int) item.sequence;
+			received[item.producer] += (int64) item.sequence + 1;
+		}
+	}
+
+	MPMCQueue<QueueItem>& queue;
+	const int numProducers;
+	Atomic<int>& numConsumed;
+	const int totalItems;
+
+	HeapBlock<int> lastSequence;
+	HeapBlock<int64> received;			// sum of sequence + 1 for each producer
+	bool bOrdered, bIntact;
+};
+
+// Several producers and consumers, every value must be taken exactly once
+static void testMPMC(int numProducers, int numConsumers, int capacity, int numItemsPerProducer)
+{
+	MPMCQueue<QueueItem> queue(capacity);
+	Atomic<int> numConsumed;
+	const int totalItems = numProducers * numItemsPerProducer;
+
+	OwnedArray<MPMCConsumerThread> consumers;
+	for( int i=0; i<numConsumers; i++ )
+		consumers.add( new MPMCConsumerThread(queue, i, numProducers, numConsumed, totalItems) );
+	OwnedArray<MPMCProducerThread> producers;
+	for( int i=0; i<numProducers; i++ )
+		producers.add( new MPMCProducerThread(queue, i, numItemsPerProducer) );
+
+	for( int i=0; i<consumers.size(); i++ )
+		consumers[i]->startThread();
+	for( int i=0; i<producers.size(); i++ )
+		producers[i]->startThread();
+
+	for( int i=0; i<producers.size(); i++ )
+		producers[i]->waitForThreadToExit(-1);
+	for( int i=0; i<consumers.size(); i++ )
+		consumers[i]->waitForThreadToExit(-1);
+
+	// Each value counted once gives n * (n + 1) / 2 per producer, a lost or duplicated one changes it
+	const int64 expectedSum = (int64) numItemsPerProducer * (numItemsPerProducer + 1) / 2;
+	bool bOrdered = true, bIntact = true, bSumsCorrect = true;
+	for( int p=0; p<numProducers; p++ )
+	{
+		int64 sum = 0;
+		for( int c=0; c<consumers.size(); c++ )
+			sum += consumers[c]->received[p];
+		bSumsCorrect = bSumsCorrect && (sum == expectedSum);
+	}
+	for( int c=0; c<consumers.size(); c++ )
+	{
+		bOrdered = bOrdered && consumers[c]->bOrdered;
+		bIntact = bIntact && consumers[c]->bIntact;
+	}
+
+	QueueItem item;
+	const String testName( "MPMC " + String(numProducers) + " producers, " + String(numConsumers) + " consumers, capacity " + String(capacity) );
+	expect( bIntact, (testName + " : values intact").toUTF8() );
+	expect( bSumsCorrect && numConsumed.get() == totalItems, (testName + " : every value once").toUTF8() );
+	expect( bOrdered, (testName + " : per producer order").toUTF8() );
+	expect( !queue.pop(item) && queue.getNumReady() == 0, (testName + " : empty at the end").toUTF8() );
+}
+
+// Full and empty are reported at the capacity, also after the positions have wrapped around
+static void testMPMCBounds()
+{
+	MPMCQueue<QueueItem> queue(3);
+	expect( queue.getCapacity() == 4, "MPMC capacity rounded up" );
+
+	bool bBoundsCorrect = true;
+	for( int lap=0; lap<1000; lap++ )
+	{
+		for( int i=0; i<queue.getCapacity(); i++ )
+			bBoundsCorrect = bBoundsCorrect && queue.push(QueueItem(0, (uint32) i));
+		bBoundsCorrect = bBoundsCorrect && !queue.push(QueueItem()) && (queue.getNumReady() == queue.getCapacity());
+
+		QueueItem item;
+		for( int i=0; i<queue.getCapacity(); i++ )
+			bBoundsCorrect = bBoundsCorrect && queue.pop(item) && (item.sequence == (uint32) i);
+		bBoundsCorrect = bBoundsCorrect && !queue.pop(item);
+	}
+	expect( bBoundsCorrect, "MPMC full and empty" );
+}
+
+//==============================================================================
+int main()
+{
+	testSPSCBounds();
+	testMPMCBounds();
+
+	// A small capacity keeps the queue full or empty most of the time, so both
+	// sides wait on each other; a large one lets them run apart
+	testSPSCOrder( 2, 20000 );
+	testSPSCOrder( 1024, 1000000 );
+
+	testMPMC( 1, 1, 16, 100000 );
+	testMPMC( 4, 1, 16, 50000 );
+	testMPMC( 1, 4, 16, 200000 );
+	testMPMC( 4, 4, 2, 10000 );
+	testMPMC( 4, 4, 1024, 100000 );
+	testMPMC( 8, 8, 64, 20000 );
+
+	std::printf( (g_iNumFailures == 0) ? "All lock-free queue tests passed\n" : "%d lock-free queue tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+/*
+	Tests of the SIMD math kernels against their Scalar versions.
+
+	MatrixMultiply / Vector4TransformCoord / MatrixLerp (sgp_MathSIMD.h) and the
+	batch culling of AABBoxArray use SSE when SGP_MATH_USE_SSE is set (see sgp_math.h),
+	this compares them with the Scalar reference on random inputs. Without SSE the
+	kernels are the Scalar versions and the test only checks the plumbing.
+
+	Standalone console program, it needs sgp_core and sgp_math:
+	compile it together with SGPLibraryCode/modules/sgp_core/sgp_core.cpp and
+	SGPLibraryCode/modules/sgp_math/sgp_math.cpp (and link the platform thread
+	library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_MathSIMD.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+			../SGPLibraryCode/modules/sgp_math/sgp_math.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+#include "../SGPLibraryCode/modules/sgp_math/sgp_math.h"
+
+using namespace sgp;
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+static float randomFloat(Random& random, float fRange)
+{
+	return (random.nextFloat() * 2.0f - 1.0f) * fRange;
+}
+
+// The compiler may contract the Scalar versions into FMA, so results are compared
+// with a relative tolerance instead of bit by bit
+static bool isNearlyEqual(float a, float b)
+{
+	return std::fabs(a - b) <= 1e-5f * jmax(1.0f, std::fabs(a), std::fabs(b));
+}
+
+static bool isNearlyEqual(const float* pA, const float* pB, int nCount)
+{
+	for( int i=0; i<nCount; i++ )
+		if( !isNearlyEqual(pA[i], pB[i]) )
+			return false;
+	return true;
+}
+
+//==============================================================================
+static void testMatrixMultiply(Random& random)
+{
+	bool bSame = true;
+	for( int n=0; n<10000; n++ )
+	{
+		float A[16], B[16], M[16], MScalar[16];
+		for( int i=0; i<16; i++ )
+		{
+			A[i] = randomFloat(random, 10.0f);
+			B[i] = randomFloat(random, 10.0f);
+		}
+
+		MatrixMultiply(A, B, M);
+		MatrixMultiplyScalar(A, B, MScalar);
+		bSame = bSame && isNearlyEqual(M, MScalar, 16);
+	}
+	expect( bSame, "MatrixMultiply" );
+
+	// Matrix4x4::operator* goes through the kernel
+	Matrix4x4 mA, mB;
+	mA.RotationX(0.3f);
+	mB.Identity();
+	mB.Translate(1.0f, 2.0f, 3.0f);
+	const Matrix4x4 mResult = mA * mB;
+	float MScalar[16];
+	MatrixMultiplyScalar((const float*)&mA, (const float*)&mB, MScalar);
+	expect( isNearlyEqual((const float*)&mResult, MScalar, 16), "Matrix4x4 multiply" );
+}
+
+static void testVector4TransformCoord(Random& random)
+{
+	bool bSame = true;
+	for( int n=0; n<10000; n++ )
+	{
+		float V[4], M[16], Out[4], OutScalar[4];
+		for( int i=0; i<4; i++ )
+			V[i] = randomFloat(random, 100.0f);
+		for( int i=0; i<16; i++ )
+			M[i] = randomFloat(random, 2.0f);
+		// Keep w away from 0
+		M[3] = M[7] = M[11] = 0.0f;
+		M[15] = 1.0f + random.nextFloat();
+
+		Vector4TransformCoord(V, M, Out);
+		Vector4TransformCoordScalar(V, M, OutScalar);
+		bSame = bSame && isNearlyEqual(Out, OutScalar, 4) && (Out[3] == 1.0f);
+	}
+	expect( bSame, "Vector4TransformCoord" );
+}
+
+static void testMatrixLerp(Random& random)
+{
+	bool bSame = true;
+	for( int n=0; n<10000; n++ )
+	{
+		float A[16], AScalar[16], B[16];
+		for( int i=0; i<16; i++ )
+		{
+			A[i] = AScalar[i] = randomFloat(random, 10.0f);
+			B[i] = randomFloat(random, 10.0f);
+		}
+		const float t = random.nextFloat();
+
+		MatrixLerp(A, B, t);
+		MatrixLerpScalar(AScalar, B, t);
+		bSame = bSame && isNearlyEqual(A, AScalar, 16);
+	}
+	expect( bSame, "MatrixLerp" );
+}
+
+//==============================================================================
+// Scalar culling of one box, the same test as the tail loop of AABBoxArray::cullBlock()
+static bool isBoxVisible(const AABBox& aabb, const Frustum& frustum)
+{
+	for( int p=0; p<Frustum::VF_PLANE_COUNT; p++ )
+	{
+		const Plane& plane = frustum.planes[p];
+		const float x = (plane.m_vcNormal.x >= 0.0f) ? aabb.vcMin.x : aabb.vcMax.x;
+		const float y = (plane.m_vcNormal.y >= 0.0f) ? aabb.vcMin.y : aabb.vcMax.y;
+		const float z = (plane.m_vcNormal.z >= 0.0f) ? aabb.vcMin.z : aabb.vcMax.z;
+		if( ((x*plane.m_vcNormal.x + y*plane.m_vcNormal.y + z*plane.m_vcNormal.z) + plane.m_fDistance) > 0.0f )
+			return false;
+	}
+	return true;
+}
+
+static void testAABBoxArrayCulling(Random& random)
+{
+	bool bSame = true;
+	int nVisible = 0, nCulled = 0;
+	for( int n=0; n<200; n++ )
+	{
+		// Sizes which are not a multiple of 4 or 32 test the tail of the blocks
+		const int nNumBoxes = 1 + random.nextInt(300);
+
+		Frustum frustum;
+		for( int p=0; p<Frustum::VF_PLANE_COUNT; p++ )
+		{
+			Vector3D vcNormal( randomFloat(random, 1.0f), randomFloat(random, 1.0f), randomFloat(random, 1.0f) );
+			vcNormal.Normalize();
+			frustum.planes[p].Set( vcNormal, -50.0f - random.nextFloat() * 50.0f );
+		}
+
+		AABBoxArray boxes;
+		Array<AABBox> reference;
+		for( int i=0; i<nNumBoxes; i++ )
+		{
+			const Vector3D vcCenter( randomFloat(random, 150.0f), randomFloat(random, 150.0f), randomFloat(random, 150.0f) );
+			const Vector3D vcHalf( random.nextFloat() * 10.0f, random.nextFloat() * 10.0f, random.nextFloat() * 10.0f );
+			boxes.add( vcCenter - vcHalf, vcCenter + vcHalf );
+
+			AABBox aabb;
+			aabb.vcMin = vcCenter - vcHalf;
+			aabb.vcMax = vcCenter + vcHalf;
+			reference.add( aabb );
+		}
+
+		HeapBlock<uint32> VisibleMask( (nNumBoxes + 31) / 32 );
+		boxes.cullToMask( frustum, VisibleMask );
+
+		HeapBlock<int> VisibleIndices( nNumBoxes );
+		const int nNumVisible = boxes.cullToIndices( frustum, VisibleIndices );
+
+		int nIndex = 0;
+		for( int i=0; i<nNumBoxes; i++ )
+		{
+			const bool bVisible = isBoxVisible( reference[i], frustum );
+			const bool bMaskVisible = (VisibleMask[i >> 5] & (1u << (i & 31))) != 0;
+			bSame = bSame && (bVisible == bMaskVisible);
+
+			if( bVisible )
+			{
+				bSame = bSame && (nIndex < nNumVisible) && (VisibleIndices[nIndex] == i);
+				nIndex++;
+				nVisible++;
+			}
+			else
+				nCulled++;
+		}
+		bSame = bSame && (nIndex == nNumVisible);
+	}
+	expect( bSame, "AABBoxArray culling" );
+	// Random frustums must give both cases, otherwise the test proves nothing
+	expect( nVisible > 0 && nCulled > 0, "AABBoxArray culling covers visible and culled boxes" );
+}
+
+//==============================================================================
+int main()
+{
+	Random random(2024);
+
+#if SGP_MATH_USE_SSE
+	std::printf("Testing SSE kernels against the Scalar versions\n");
+#else
+	std::printf("No SSE in this build, the kernels are the Scalar versions\n");
+#endif
+
+	testMatrixMultiply( random );
+	testVector4TransformCoord( random );
+	testMatrixLerp( random );
+	testAABBoxArrayCulling( random );
+
+	std::printf( (g_iNumFailures == 0) ? "All math SIMD tests passed\n" : "%d math SIMD tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
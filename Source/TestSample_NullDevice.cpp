@@ -0,0 +1,182 @@
+/*
+	Renders frames through the null render device and checks its command log.
+
+	Console program, needs no window nor GL context: the null device is created
+	by createDevice(SGPDT_NULL) on every platform. On Linux build and run it with
+
+		cd Builds/Linux && make test
+
+	or compile it together with every module cpp of SGPLibraryCode, e.g.
+
+		g++ -O2 -I../SGPLibraryCode -I../OtherLib/FreeType/include TestSample_NullDevice.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp ... ../SGPLibraryCode/modules/sgp_enginedevice/sgp_enginedevice.cpp
+			-lGL -lX11 -lfreetype -lpthread -ldl
+
+	Returns 0 when all tests pass.
+*/
+
+#include "../SGPLibraryCode/SGPHeader.h"
+
+using namespace sgp;
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+//==============================================================================
+// Creates an opaque box which can be drawn instanced
+static uint32 createBoxBuffer(ISGPRenderDevice* pRenderDevice)
+{
+	SGPVertex_UPOS_TEXTURE Verts[8];
+	for( int i=0; i<8; i++ )
+	{
+		Verts[i].x = (i & 1) ? 1.0f : -1.0f;
+		Verts[i].y = (i & 2) ? 1.0f : -1.0f;
+		Verts[i].z = (i & 4) ? 1.0f : -1.0f;
+		Verts[i].tu = (i & 1) ? 1.0f : 0.0f;
+		Verts[i].tv = (i & 2) ? 1.0f : 0.0f;
+	}
+	const uint16 Indis[36] =
+	{
+		0,1,3, 0,3,2,  4,6,7, 4,7,5,  0,4,5, 0,5,1,
+		2,3,7, 2,7,6,  0,2,6, 0,6,4,  1,5,7, 1,7,3
+	};
+
+	SGPSkin skin;
+	skin.nShaderType = SGPST_TEXTURE;
+	skin.nPrimitiveType = SGPPT_TRIANGLES;
+
+	AABBox BoundingBox;
+	BoundingBox.vcMin.Set(-1.0f, -1.0f, -1.0f);
+	BoundingBox.vcMax.Set( 1.0f,  1.0f,  1.0f);
+	BoundingBox.vcCenter.Set(0, 0, 0);
+
+	return pRenderDevice->GetVertexCacheManager()->CreateStaticBuffer(
+		SGPVT_UPOS_TEXTURE, skin, BoundingBox, 8, 36, Verts, Indis );
+}
+
+static uint32 countInstancedDraws(const CSGPNullCommandLog& CommandLog, uint32 nInstanceNum)
+{
+	uint32 nDraws = 0;
+	for( int i=0; i<CommandLog.getNumCommands(); i++ )
+	{
+		const SGPNullCommand& Command = CommandLog.getCommand(i);
+		if( (Command.Type == SGPNC_DRAW_INSTANCED) && (Command.Count == nInstanceNum) )
+			nDraws++;
+	}
+	return nDraws;
+}
+
+//==============================================================================
+static void testRenderFrame(SGPDevice* pDevice)
+{
+	CNullRenderDevice* pRenderDevice = static_cast<CNullRenderDevice*>(pDevice->getRenderDevice());
+	CSGPNullCommandLog& CommandLog = pRenderDevice->getCommandLog();
+
+	expect( pRenderDevice->getVideoDriverType() == SGPDT_NULL, "null driver type" );
+
+	CommandLog.clear();
+	CommandLog.setRecording(true);
+
+	pRenderDevice->setViewPort( SViewPort(0, 0, 800, 600) );
+	pRenderDevice->setViewMatrixLookAt( Vector4D(0, 5.0f, -10.0f), Vector4D(0, 0, 0), Vector4D(0, 1.0f, 0) );
+
+	uint32 nBoxSBID = createBoxBuffer(pRenderDevice);
+	expect( nBoxSBID != 0, "static buffer created" );
+
+	const uint32 nFrameIndex = CommandLog.getFrameIndex();
+
+	// One frame : three boxes with the same config, one debug box and one text
+	pDevice->run();
+	pRenderDevice->beginScene();
+
+	RenderBatchConfig config;
+	Matrix4x4 matWorld;
+	for( int i=0; i<3; i++ )
+	{
+		matWorld.Identity();
+		matWorld.Translate( float(i) * 3.0f, 0, 0 );
+		pRenderDevice->GetVertexCacheManager()->RenderStaticBuffer( nBoxSBID, matWorld, config );
+	}
+
+	AABBox DebugBox;
+	DebugBox.vcMin.Set(-2.0f, -2.0f, -2.0f);
+	DebugBox.vcMax.Set( 2.0f,  2.0f,  2.0f);
+	pRenderDevice->GetVertexCacheManager()->RenderBox( DebugBox, Colour(255, 0, 0) );
+
+	pRenderDevice->DrawTextInPos( 10, 10, SGPFDL_DEFAULT, 16, 255, 255, 255, L"frame %d", 1 );
+
+	pRenderDevice->FlushRenderBatch();
+	pRenderDevice->endScene();
+
+	expect( CommandLog.getFrameIndex() == nFrameIndex + 1, "beginScene starts one frame" );
+	expect( CommandLog.getCommandCount(SGPNC_SET_VIEWPORT) == 1, "viewport set" );
+	expect( CommandLog.getCommandCount(SGPNC_SET_CAMERA) >= 1, "camera set" );
+	expect( CommandLog.getCommandCount(SGPNC_CREATE_STATICBUFFER) == 1, "one static buffer created" );
+	expect( CommandLog.getCommandCount(SGPNC_BEGIN_SCENE) == 1, "one beginScene" );
+	expect( CommandLog.getCommandCount(SGPNC_END_SCENE) == 1, "one endScene" );
+	expect( CommandLog.getCommandCount(SGPNC_FLUSH_RENDERBATCH) == 1, "one flush" );
+	expect( CommandLog.getCommandCount(SGPNC_DRAW_STATICBUFFER) == 3, "three static buffer batches" );
+	expect( CommandLog.getCommandCount(SGPNC_DRAW_INSTANCED) == 1, "boxes merged into one instanced draw" );
+	expect( countInstancedDraws(CommandLog, 3) == 1, "instanced draw of three boxes" );
+	expect( CommandLog.getCommandCount(SGPNC_DRAW_DEBUG) == 1, "one debug box" );
+	expect( CommandLog.getCommandCount(SGPNC_DRAW_TEXT) == 1, "one text" );
+
+	// Log order : the frame begins first and ends last
+	expect( CommandLog.getNumCommands() > 0 &&
+		CommandLog.getCommand(CommandLog.getNumCommands()-1).Type == SGPNC_END_SCENE, "endScene recorded last" );
+	for( int i=0; i<CommandLog.getNumCommands(); i++ )
+	{
+		const SGPNullCommand& Command = CommandLog.getCommand(i);
+		if( Command.Type == SGPNC_DRAW_STATICBUFFER )
+			expect( (Command.Frame == nFrameIndex + 1) && (Command.ObjectID == nBoxSBID), "batch recorded in the frame with its buffer ID" );
+	}
+
+	// Next frame with nothing queued, the instanced run must not be flushed again
+	CommandLog.clear();
+	pRenderDevice->beginScene();
+	pRenderDevice->FlushRenderBatch();
+	pRenderDevice->endScene();
+
+	expect( CommandLog.getFrameIndex() == nFrameIndex + 2, "second frame" );
+	expect( CommandLog.getCommandCount(SGPNC_DRAW_INSTANCED) == 0, "instance runs are reset after flush" );
+	expect( CommandLog.getNumCommands() == 3, "empty frame records begin, flush and end only" );
+
+	// Without recording only the counters are updated
+	CommandLog.clear();
+	CommandLog.setRecording(false);
+	pRenderDevice->beginScene();
+	pRenderDevice->endScene();
+	expect( CommandLog.getNumCommands() == 0, "nothing stored when not recording" );
+	expect( CommandLog.getCommandCount(SGPNC_BEGIN_SCENE) == 1, "counters updated when not recording" );
+
+	pRenderDevice->GetVertexCacheManager()->ClearStaticBuffer( nBoxSBID );
+}
+
+//==============================================================================
+int main()
+{
+	ConsoleLogger logger( String("TestSample_NullDevice") );
+	Logger::setCurrentLogger( &logger );
+
+	SGPDevice* device = createDevice( SGPDT_NULL, 800, 600, 32, false, false, false, false, &logger );
+	expect( device != nullptr, "null device created" );
+	expect( device != nullptr && device->getRenderDevice() != nullptr, "null render device created" );
+
+	if( device && device->getRenderDevice() )
+		testRenderFrame( device );
+
+	delete device;
+	Logger::setCurrentLogger( nullptr );
+
+	std::printf( (g_iNumFailures == 0) ? "All null device tests passed\n" : "%d null device tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
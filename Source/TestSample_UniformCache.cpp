@@ -0,0 +1,420 @@
+/*
+	Test of the uniform location cache and uniform shadowing of COpenGLSLShaderProgram.
+
+	The shader program is compiled here against a recording GL stub instead of
+	COpenGLRenderDevice: the stub plays the driver, keeps the uniform values of each
+	program and counts the calls. The test checks the values the driver ends up with
+	are always the ones which were set, and counts the driver calls a frame of
+	render batches makes with the cache against the two calls per setShaderUniform()
+	(glGetUniformLocation and glUniform*) it made before.
+
+	Standalone console program, it needs sgp_core and sgp_math but no OpenGL:
+	compile it together with SGPLibraryCode/modules/sgp_core/sgp_core.cpp and
+	SGPLibraryCode/modules/sgp_math/sgp_math.cpp (and link the platform thread
+	library), e.g. on Linux
+
+		g++ -O2 -I../SGPLibraryCode -I../SGPLibraryCode/modules TestSample_UniformCache.cpp
+			../SGPLibraryCode/modules/sgp_core/sgp_core.cpp
+			../SGPLibraryCode/modules/sgp_math/sgp_math.cpp -lpthread -ldl
+
+	Returns 0 when all tests pass.
+*/
+
+#include "../SGPLibraryCode/AppConfig.h"
+#include "../SGPLibraryCode/modules/sgp_core/sgp_core.h"
+#include "../SGPLibraryCode/modules/sgp_math/sgp_math.h"
+
+using namespace sgp;
+
+
+// GL types and enums used by the shader program, no GL header is needed
+typedef unsigned int	GLenum;
+typedef unsigned int	GLuint;
+typedef int				GLint;
+typedef int				GLsizei;
+typedef float			GLfloat;
+typedef char			GLchar;
+typedef unsigned char	GLboolean;
+
+#define GL_FALSE						0
+#define GL_TRUE							1
+#define GL_FRAGMENT_SHADER				0x8B30
+#define GL_VERTEX_SHADER				0x8B31
+#define GL_COMPILE_STATUS				0x8B81
+#define GL_LINK_STATUS					0x8B82
+#define GL_INFO_LOG_LENGTH				0x8B84
+#define GL_ACTIVE_UNIFORMS				0x8B86
+#define GL_ACTIVE_UNIFORM_MAX_LENGTH	0x8B87
+#define GL_FLOAT_VEC4					0x8B52
+
+
+namespace sgp
+{
+//==============================================================================
+// Recording GL stub in place of the render device. Every program has the active
+// uniforms given to setActiveUniforms() before it is linked.
+class COpenGLRenderDevice
+{
+public:
+	struct StubUniform
+	{
+		GLuint Program;
+		String Name;
+		GLint ArraySize;
+		HeapBlock<uint8> Values;			// what the driver holds, room for ArraySize matrices
+	};
+
+	struct CallCounts
+	{
+		int GetUniformLocation;
+		int Uniform;
+		int UniformBytes;
+
+		CallCounts() : GetUniformLocation(0), Uniform(0), UniformBytes(0) {}
+	};
+
+	COpenGLRenderDevice() : m_CurrentProgram(0) {}
+
+	void setActiveUniforms(const StringArray& Names, const Array<int>& ArraySizes)
+	{
+		m_PendingNames = Names;
+		m_PendingArraySizes = ArraySizes;
+	}
+
+	// The values the driver holds for a uniform of a program, NULL if there is no such uniform
+	const uint8* getDriverValues(GLuint Program, const char* sName) const
+	{
+		for( int i=0; i<m_Uniforms.size(); i++ )
+			if( m_Uniforms[i]->Program == Program && m_Uniforms[i]->Name == sName )
+				return m_Uniforms[i]->Values;
+		return NULL;
+	}
+
+	CallCounts m_Calls;
+
+	// Shaders
+	GLuint extGlCreateShader(GLenum)											{ return 1; }
+	void extGlShaderSource(GLuint, GLsizei, const char**, const GLint*)		{}
+	void extGlCompileShader(GLuint)												{}
+	void extGlGetShaderiv(GLuint, GLenum, GLint* param)							{ *param = GL_TRUE; }
+	void extGlGetShaderInfoLog(GLuint, GLsizei, GLsizei* length, GLchar*)		{ *length = 0; }
+	void extGlDeleteShader(GLuint)												{}
+
+	// Programs
+	GLuint extGlCreateProgram()													{ return ++s_LastProgramID; }
+	void extGlAttachShader(GLuint, GLuint)										{}
+	void extGlUseProgram(GLuint Program)										{ m_CurrentProgram = Program; }
+	void extGlGetProgramInfoLog(GLuint, GLsizei, GLsizei* length, GLchar*)		{ *length = 0; }
+
+	void extGlLinkProgram(GLuint Program)
+	{
+		for( int i=0; i<m_PendingNames.size(); i++ )
+		{
+			StubUniform* pUniform = new StubUniform();
+			pUniform->Program = Program;
+			pUniform->Name = m_PendingNames[i];
+			pUniform->ArraySize = m_PendingArraySizes[i];
+			pUniform->Values.allocate( pUniform->ArraySize * sizeof(Matrix4x4), true );
+			m_Uniforms.add( pUniform );
+		}
+	}
+
+	void extGlDeleteProgram(GLuint Program)
+	{
+		for( int i=m_Uniforms.size(); --i >= 0; )
+			if( m_Uniforms[i]->Program == Program )
+				m_Uniforms.remove(i);
+	}
+
+	void extGlGetProgramiv(GLuint Program, GLenum type, GLint* param)
+	{
+		*param = 0;
+		for( int i=0; i<m_Uniforms.size(); i++ )
+		{
+			if( m_Uniforms[i]->Program != Program )
+				continue;
+			if( type == GL_ACTIVE_UNIFORMS )
+				*param += 1;
+			else if( type == GL_ACTIVE_UNIFORM_MAX_LENGTH )
+				*param = jmax( *param, m_Uniforms[i]->Name.length() + 4 );
+		}
+		if( type == GL_LINK_STATUS )
+			*param = GL_TRUE;
+	}
+
+	// Arrays are reported as "name[0]", like the drivers do
+	void extGlGetActiveUniform(GLuint Program, GLuint index, GLsizei maxLength, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+	{
+		const StubUniform* pUniform = m_Uniforms[ findUniformByIndex(Program, (int)index) ];
+		const String Name( pUniform->ArraySize > 1 ? pUniform->Name + "[0]" : pUniform->Name );
+		Name.copyToUTF8( name, (size_t)maxLength );
+		*length = Name.length();
+		*size = pUniform->ArraySize;
+		*type = GL_FLOAT_VEC4;
+	}
+
+	GLint extGlGetUniformLocation(GLuint Program, const char* name)
+	{
+		m_Calls.GetUniformLocation++;
+		String Name(name);
+		if( Name.endsWith("[0]") )
+			Name = Name.dropLastCharacters(3);
+		for( int i=0, index=0; i<m_Uniforms.size(); i++ )
+		{
+			if( m_Uniforms[i]->Program != Program )
+				continue;
+			if( m_Uniforms[i]->Name == Name )
+				return index;
+			index++;
+		}
+		return -1;
+	}
+
+	// Uniforms, written into the uniform of the current program
+	void extGlUniform1fv(GLint loc, GLsizei count, const GLfloat* v)							{ upload( loc, v, 1 * sizeof(GLfloat), count ); }
+	void extGlUniform2fv(GLint loc, GLsizei count, const GLfloat* v)							{ upload( loc, v, 2 * sizeof(GLfloat), count ); }
+	void extGlUniform3fv(GLint loc, GLsizei count, const GLfloat* v)							{ upload( loc, v, 3 * sizeof(GLfloat), count ); }
+	void extGlUniform4fv(GLint loc, GLsizei count, const GLfloat* v)							{ upload( loc, v, 4 * sizeof(GLfloat), count ); }
+	void extGlUniform1iv(GLint loc, GLsizei count, const GLint* v)								{ upload( loc, v, sizeof(GLint), count ); }
+	void extGlUniformMatrix4fv(GLint loc, GLsizei count, GLboolean, const GLfloat* v)			{ upload( loc, v, 16 * sizeof(GLfloat), count ); }
+
+private:
+	int findUniformByIndex(GLuint Program, int index) const
+	{
+		for( int i=0; i<m_Uniforms.size(); i++ )
+			if( m_Uniforms[i]->Program == Program && index-- == 0 )
+				return i;
+		return -1;
+	}
+
+	void upload(GLint loc, const void* pValues, int iElementSize, GLsizei count)
+	{
+		m_Calls.Uniform++;
+		m_Calls.UniformBytes += iElementSize * count;
+		if( loc < 0 )
+			return;
+
+		StubUniform* pUniform = m_Uniforms[ findUniformByIndex(m_CurrentProgram, loc) ];
+		const int iBytes = jmin( iElementSize * count, (int)(pUniform->ArraySize * sizeof(Matrix4x4)) );
+		memcpy( pUniform->Values, pValues, iBytes );
+	}
+
+	// Program IDs are unique over all stub devices, COpenGLSLShaderProgram keeps the
+	// current program in a static
+	static GLuint s_LastProgramID;
+	GLuint m_CurrentProgram;
+	OwnedArray<StubUniform> m_Uniforms;
+	StringArray m_PendingNames;
+	Array<int> m_PendingArraySizes;
+};
+
+GLuint COpenGLRenderDevice::s_LastProgramID = 0;
+
+#include "../SGPLibraryCode/modules/sgp_render/opengl/sgp_OpenGLSLShader.h"
+#include "../SGPLibraryCode/modules/sgp_render/opengl/sgp_OpenGLSLShader.cpp"
+}
+
+
+static int g_iNumFailures = 0;
+
+static void expect(bool bResult, const char* szTestName)
+{
+	if( !bResult )
+	{
+		std::printf("FAILED : %s\n", szTestName);
+		g_iNumFailures++;
+	}
+}
+
+//==============================================================================
+// A linked program with the uniforms of the static mesh batches
+static COpenGLSLShaderProgram* createBatchProgram(COpenGLRenderDevice& Device)
+{
+	StringArray Names;
+	Array<int> ArraySizes;
+	Names.add("modelViewProjMatrix");	ArraySizes.add(1);
+	Names.add("worldMatrix");			ArraySizes.add(1);
+	Names.add("fFarPlane");				ArraySizes.add(1);
+	Names.add("SunColor");				ArraySizes.add(1);
+	Names.add("gSampler0");				ArraySizes.add(1);
+	Names.add("gSampler1");				ArraySizes.add(1);
+	Names.add("vMaterialColor");		ArraySizes.add(1);
+	Names.add("TexIndexUVOffset");		ArraySizes.add(1);
+	Names.add("vLightColors");			ArraySizes.add(4);
+	Device.setActiveUniforms( Names, ArraySizes );
+
+	COpenGLSLShaderProgram* pProgram = new COpenGLSLShaderProgram( &Device );
+	pProgram->createProgram();
+	pProgram->linkProgram();
+	return pProgram;
+}
+
+static bool driverHolds(COpenGLRenderDevice& Device, COpenGLSLShaderProgram* pProgram, const char* sName, const void* pValues, int iBytes)
+{
+	const uint8* pDriverValues = Device.getDriverValues( pProgram->GetProgramID(), sName );
+	return (pDriverValues != NULL) && (memcmp(pDriverValues, pValues, iBytes) == 0);
+}
+
+//==============================================================================
+static void testLookupAndSkipping()
+{
+	COpenGLRenderDevice Device;
+	ScopedPointer<COpenGLSLShaderProgram> pProgram( createBatchProgram(Device) );
+	pProgram->useProgram();
+
+	// Locations are resolved once when the program is linked
+	const int iLinkLookups = Device.m_Calls.GetUniformLocation;
+	Matrix4x4 MVP;
+	MVP.Identity();
+	pProgram->setShaderUniform( "modelViewProjMatrix", MVP );
+	pProgram->setShaderUniform( "gSampler0", 0 );
+	expect( Device.m_Calls.GetUniformLocation == iLinkLookups, "no glGetUniformLocation after linking" );
+	expect( Device.m_Calls.Uniform == 2, "first values are uploaded" );
+	expect( driverHolds(Device, pProgram, "modelViewProjMatrix", &MVP._11, sizeof(Matrix4x4)), "matrix uploaded" );
+
+	// The same values again are skipped, a different one is uploaded
+	pProgram->setShaderUniform( "modelViewProjMatrix", MVP );
+	pProgram->setShaderUniform( "gSampler0", 0 );
+	expect( Device.m_Calls.Uniform == 2, "same values skipped" );
+	pProgram->setShaderUniform( "gSampler0", 1 );
+	const int32 iOne = 1;
+	expect( Device.m_Calls.Uniform == 3 && driverHolds(Device, pProgram, "gSampler0", &iOne, sizeof(int32)), "changed value uploaded" );
+
+	// Unknown names make no driver calls at all
+	pProgram->setShaderUniform( "notInTheShader", 1.0f );
+	expect( Device.m_Calls.Uniform == 3 && Device.m_Calls.GetUniformLocation == iLinkLookups, "unknown uniform ignored" );
+
+	// "name[0]" is the array uniform, a shorter upload of the same values is skipped
+	Vector4D Colors[4] = { Vector4D(1,0,0,1), Vector4D(0,1,0,1), Vector4D(0,0,1,1), Vector4D(1,1,1,1) };
+	pProgram->setShaderUniform( "vLightColors[0]", Colors, 4 );
+	expect( Device.m_Calls.Uniform == 4 && driverHolds(Device, pProgram, "vLightColors", Colors, sizeof(Colors)), "array uniform uploaded" );
+	pProgram->setShaderUniform( "vLightColors", Colors, 2 );
+	expect( Device.m_Calls.Uniform == 4, "prefix of array skipped" );
+	Colors[3].x = 0.5f;
+	pProgram->setShaderUniform( "vLightColors", Colors, 4 );
+	expect( Device.m_Calls.Uniform == 5 && driverHolds(Device, pProgram, "vLightColors", Colors, sizeof(Colors)), "changed array element uploaded" );
+
+	// The same bytes through another glUniform function are uploaded again
+	pProgram->setShaderUniform( "vLightColors", (float*)Colors, 16 );
+	expect( Device.m_Calls.Uniform == 6, "element size change uploaded" );
+}
+
+// Each program shadows its own values, and a relinked program starts over
+static void testProgramsAreSeparate()
+{
+	COpenGLRenderDevice Device;
+	ScopedPointer<COpenGLSLShaderProgram> pProgramA( createBatchProgram(Device) );
+	ScopedPointer<COpenGLSLShaderProgram> pProgramB( createBatchProgram(Device) );
+	const float fFarPlane = 1000.0f;
+
+	pProgramA->useProgram();
+	pProgramA->setShaderUniform( "fFarPlane", fFarPlane );
+	pProgramB->useProgram();
+	pProgramB->setShaderUniform( "fFarPlane", fFarPlane );
+	expect( Device.m_Calls.Uniform == 2 && driverHolds(Device, pProgramB, "fFarPlane", &fFarPlane, sizeof(float)), "value uploaded to each program" );
+
+	pProgramB->deleteProgram();
+	Device.m_Calls = COpenGLRenderDevice::CallCounts();
+	StringArray Names;
+	Names.add("fFarPlane");
+	Array<int> ArraySizes;
+	ArraySizes.add(1);
+	Device.setActiveUniforms( Names, ArraySizes );
+	pProgramB->createProgram();
+	pProgramB->linkProgram();
+	pProgramB->useProgram();
+	pProgramB->setShaderUniform( "fFarPlane", fFarPlane );
+	expect( Device.m_Calls.Uniform == 1 && driverHolds(Device, pProgramB, "fFarPlane", &fFarPlane, sizeof(float)), "relinked program uploads again" );
+}
+
+//==============================================================================
+// One frame of static mesh batches the way COpenGLRenderBatch::Render() sets them:
+// the matrices change per batch, the rest is mostly the same for every batch
+static int renderFrame(COpenGLSLShaderProgram** pPrograms, int iNumPrograms, int iNumBatches, int iFrame, Random& random, COpenGLRenderDevice& Device, bool& bDriverCorrect)
+{
+	const float fFarPlane = 2000.0f;
+	const Vector4D SunColor( 1.0f, 0.9f, 0.8f, 1.0f + iFrame * 0.01f );
+	const Vector4D MaterialColors[3] = { Vector4D(1,1,1,1), Vector4D(1,0.5f,0.5f,1), Vector4D(0.5f,0.5f,1,0.5f) };
+	int iNumSetCalls = 0;
+
+	for( int i=0; i<iNumBatches; i++ )
+	{
+		COpenGLSLShaderProgram* pProgram = pPrograms[ (i * iNumPrograms) / iNumBatches ];
+		pProgram->useProgram();
+
+		Matrix4x4 MVP, World;
+		MVP.Identity();
+		World.Identity();
+		World._41 = MVP._41 = (float)random.nextInt(100);
+		World._42 = MVP._42 = (float)random.nextInt(100);
+		MVP._43 = iFrame * 0.5f;
+		const Vector4D& MaterialColor = MaterialColors[ random.nextInt(3) ];
+		const Vector4D UVOffset( 0, 0, 1, 1 );
+
+		pProgram->setShaderUniform( "modelViewProjMatrix", MVP );
+		pProgram->setShaderUniform( "worldMatrix", World );
+		pProgram->setShaderUniform( "fFarPlane", fFarPlane );
+		pProgram->setShaderUniform( "SunColor", SunColor );
+		pProgram->setShaderUniform( "gSampler0", 0 );
+		pProgram->setShaderUniform( "gSampler1", 1 );
+		pProgram->setShaderUniform( "vMaterialColor", MaterialColor );
+		pProgram->setShaderUniform( "TexIndexUVOffset", UVOffset );
+		iNumSetCalls += 8;
+
+		// At draw time the driver must hold exactly what was set
+		const int32 iSampler0 = 0, iSampler1 = 1;
+		bDriverCorrect = bDriverCorrect &&
+			driverHolds(Device, pProgram, "modelViewProjMatrix", &MVP._11, sizeof(Matrix4x4)) &&
+			driverHolds(Device, pProgram, "worldMatrix", &World._11, sizeof(Matrix4x4)) &&
+			driverHolds(Device, pProgram, "fFarPlane", &fFarPlane, sizeof(float)) &&
+			driverHolds(Device, pProgram, "SunColor", &SunColor, sizeof(Vector4D)) &&
+			driverHolds(Device, pProgram, "gSampler0", &iSampler0, sizeof(int32)) &&
+			driverHolds(Device, pProgram, "gSampler1", &iSampler1, sizeof(int32)) &&
+			driverHolds(Device, pProgram, "vMaterialColor", &MaterialColor, sizeof(Vector4D)) &&
+			driverHolds(Device, pProgram, "TexIndexUVOffset", &UVOffset, sizeof(Vector4D));
+	}
+	return iNumSetCalls;
+}
+
+static void testFrameOfBatches()
+{
+	COpenGLRenderDevice Device;
+	const int iNumPrograms = 4;
+	const int iNumBatches = 3000;
+	COpenGLSLShaderProgram* pPrograms[iNumPrograms];
+	for( int i=0; i<iNumPrograms; i++ )
+		pPrograms[i] = createBatchProgram( Device );
+
+	Random random(42);
+	bool bDriverCorrect = true;
+	const int iNumFrames = 10;
+	int iNumSetCalls = 0;
+
+	Device.m_Calls = COpenGLRenderDevice::CallCounts();
+	for( int iFrame=0; iFrame<iNumFrames; iFrame++ )
+		iNumSetCalls += renderFrame( pPrograms, iNumPrograms, iNumBatches, iFrame, random, Device, bDriverCorrect );
+
+	expect( bDriverCorrect, "driver holds the values set in every batch" );
+	expect( Device.m_Calls.GetUniformLocation == 0, "no glGetUniformLocation per frame" );
+
+	// Before the cache every setShaderUniform() was a glGetUniformLocation and a glUniform* call
+	const int iCallsBefore = 2 * iNumSetCalls / iNumFrames;
+	const int iCallsNow = (Device.m_Calls.GetUniformLocation + Device.m_Calls.Uniform) / iNumFrames;
+	expect( iCallsNow < iCallsBefore / 2, "driver calls reduced" );
+	std::printf("%d batches per frame : %d driver calls before, %d with the cache, %d eliminated (%d bytes uploaded)\n",
+		iNumBatches, iCallsBefore, iCallsNow, iCallsBefore - iCallsNow, Device.m_Calls.UniformBytes / iNumFrames);
+
+	for( int i=0; i<iNumPrograms; i++ )
+		delete pPrograms[i];
+}
+
+//==============================================================================
+int main()
+{
+	testLookupAndSkipping();
+	testProgramsAreSeparate();
+	testFrameOfBatches();
+
+	std::printf( (g_iNumFailures == 0) ? "All uniform cache tests passed\n" : "%d uniform cache tests failed\n", g_iNumFailures );
+	return (g_iNumFailures == 0) ? 0 : 1;
+}
@@ -356,6 +356,7 @@ int main()
 	ptestModel->playAnim(1.0f, 10, 58, true, true);				// idle
 	ptestModel->playUpperBodyAnim(1.0f, 75, 99, true, true);	// run
 	ptestModel->setEnableUpperBodyAnim(true);	
+	renderdevice->GetInstanceManager()->addSkeletonInstance(ptestModel);
 	//ptestModel->addAttachment(SGPATTDEF_LEFTHAND, String(L"Avatar\\hammer.mf1"));
 
 #if 1
@@ -445,6 +446,7 @@ int main()
 	uint32 LastYPos = receiver.getYPosition();
 	double averageMS = 0;
 	double averageFPS = 0;
+	uint32 nFrameIndex = 0;
 	while(device->run() && renderdevice)
 	{
 		if(receiver.IsKeyDown(KEY_F1))
@@ -674,11 +676,12 @@ int main()
 
 		renderdevice->GetWorldSystemManager()->updateWorld( (float)frameDeltaTime );
 
-		ptestModel->update( (float)frameDeltaTime );
+		renderdevice->GetInstanceManager()->updateAllSkeletonInstance( (float)frameDeltaTime, nFrameIndex );
 
-		renderdevice->GetEffectInstanceManager()->updateAllEffectInstance( (float)frameDeltaTime );
+		renderdevice->GetEffectInstanceManager()->updateAllEffectInstance( (float)frameDeltaTime, nFrameIndex );
 
 
+		nFrameIndex++;
 		averageMS += (frameDeltaTime*1000.0 - averageMS) * 0.1;
 		averageFPS = 1000.0 / averageMS;
 		
@@ -757,6 +760,7 @@ int main()
 	renderdevice->deleteRenderToFrameBuffer();
 
 
+	renderdevice->GetInstanceManager()->removeSkeletonInstance(ptestModel);
 	ptestModel->destroyModel();
 	delete ptestModel;
 	ptestModel = NULL;
@@ -184,6 +184,7 @@ public:
     
 private:
 	double		m_AverageMS;
+	uint32		m_nFrameIndex;
 	float		m_LastXPos;
 	float		m_LastYPos;
 	bool        m_bMousePressed;
@@ -281,6 +282,7 @@ bool OGLESIntroducingPVRShell::InitApplication()
     
     
 	m_AverageMS = 0.0;
+	m_nFrameIndex = 0;
     
 	// Create Logger
 	m_pLogger = new PVRShellLogger( String("OpenGL ES 2.0 Logger"), this );
@@ -614,7 +616,7 @@ bool OGLESIntroducingPVRShell::RenderScene()
     
 	m_PlayerRole->update( (float)frameDeltaTime );
     
-    m_pRenderDevice->GetEffectInstanceManager()->updateAllEffectInstance( (float)frameDeltaTime );
+    m_pRenderDevice->GetEffectInstanceManager()->updateAllEffectInstance( (float)frameDeltaTime, m_nFrameIndex++ );
     
 	m_pRenderDevice->setClearColor(0.2f, 0.2f, 0.2f, 1.0f);
     
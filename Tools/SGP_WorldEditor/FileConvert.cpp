@@ -120,7 +120,7 @@ bool MF1FileConvert(CString relativeSrcPath,CString srcDir,CString destDir)
 
 	bool bSuccess;
 	CSGPModelMF1* pModelMF1=NULL;
-	uint8* rawMemory=CSGPModelMF1::LoadMF1(pModelMF1,String(""),String(LPCTSTR(destPath)));
+	MemoryMappedFile* pMappedFile=CSGPModelMF1::LoadMF1(pModelMF1,String(""),String(LPCTSTR(destPath)));
 	if(pModelMF1!=NULL)
 	{
 		// Skin
@@ -174,7 +174,7 @@ bool MF1FileConvert(CString relativeSrcPath,CString srcDir,CString destDir)
 		}
 		bSuccess=pModelMF1->SaveMF1(String(""),String(LPCTSTR(destPath)));
 	}
-	if(rawMemory!=NULL) delete [] rawMemory;
+	if(pMappedFile!=NULL) delete pMappedFile;
 
 	return bSuccess;
 }
@@ -192,7 +192,7 @@ bool MapFileConvert(CString relativeSrcPath,CString srcDir,CString destDir)
 
 	bool bSuccess=true;
 	CSGPWorldMap* pWorldMap=NULL;
-	uint8* rawMemory=CSGPWorldMap::LoadWorldMap(pWorldMap,String(""),String((LPCTSTR)destPath));
+	MemoryMappedFile* pMappedFile=CSGPWorldMap::LoadWorldMap(pWorldMap,String(""),String((LPCTSTR)destPath));
 	if(pWorldMap!=NULL)
 	{
 		// chunk texture file name
@@ -255,7 +255,7 @@ bool MapFileConvert(CString relativeSrcPath,CString srcDir,CString destDir)
 
 		bSuccess = pWorldMap->SaveWorldMap(String(""),String(LPCTSTR(destPath)));
 	}
-	if(rawMemory!=NULL) delete [] rawMemory;
+	if(pMappedFile!=NULL) delete pMappedFile;
 	return bSuccess;
 }*/
 
@@ -293,7 +293,7 @@ bool MF1FileGetInfo(CString relativeSrcPath,CString srcDir,CString destDir,std::
 
 	bool bSuccess = false;
 	CSGPModelMF1* pModelMF1=NULL;
-	uint8* rawMemory=CSGPModelMF1::LoadMF1(pModelMF1,String(""),String(LPCTSTR(destPath)));
+	MemoryMappedFile* pMappedFile=CSGPModelMF1::LoadMF1(pModelMF1,String(""),String(LPCTSTR(destPath)));
 	if(pModelMF1!=NULL)
 	{
 		// Header File Name
@@ -375,7 +375,7 @@ bool MF1FileGetInfo(CString relativeSrcPath,CString srcDir,CString destDir,std::
 		}
 		bSuccess=pModelMF1->SaveMF1(String(""),String(LPCTSTR(destPath)));
 	}
-	if(rawMemory!=NULL) delete [] rawMemory;
+	if(pMappedFile!=NULL) delete pMappedFile;
 
 	return bSuccess;
 }
@@ -427,7 +427,7 @@ bool MapFileGetInfo(CString relativeSrcPath,CString srcDir,CString destDir,std::
 
 	bool bSuccess=true;
 	CSGPWorldMap* pWorldMap=NULL;
-	uint8* rawMemory=CSGPWorldMap::LoadWorldMap(pWorldMap,String(""),String((LPCTSTR)destPath));
+	MemoryMappedFile* pMappedFile=CSGPWorldMap::LoadWorldMap(pWorldMap,String(""),String((LPCTSTR)destPath));
 	if(pWorldMap!=NULL)
 	{
 		// Map File Name
@@ -549,6 +549,6 @@ bool MapFileGetInfo(CString relativeSrcPath,CString srcDir,CString destDir,std::
 		}
 		bSuccess = pWorldMap->SaveWorldMap(String(""),String(LPCTSTR(destPath)));
 	}
-	if(rawMemory!=NULL) delete [] rawMemory;
+	if(pMappedFile!=NULL) delete pMappedFile;
 	return bSuccess;
 }
\ No newline at end of file